@@ -24,6 +24,11 @@
 #endif
 
 #if defined(CONFIG_NATIVE_POSIX_STDOUT_CONSOLE)
+static int native_posix_str_out(const char *str, size_t len)
+{
+	return fwrite(str, 1, len, stdout);
+}
+
 /**
  *
  * @brief Initialize the driver that provides the printk output
@@ -39,8 +44,8 @@ static void native_posix_stdout_init(void)
 	setvbuf(stdout, NULL, _IOLBF, 512);
 	setvbuf(stderr, NULL, _IOLBF, 512);
 
-	extern void __printk_hook_install(int (*fn)(int));
 	__printk_hook_install(putchar);
+	__printk_str_hook_install(native_posix_str_out);
 }
 
 /**
@@ -203,6 +203,25 @@ static int flash_sim_read(const struct device *dev, const off_t offset,
 	return 0;
 }
 
+#ifdef CONFIG_FLASH_MMAP_API
+static int flash_sim_mmap(const struct device *dev, const off_t offset,
+			  const size_t len, const void **ptr)
+{
+	/* Direct access would bypass the simulated read timing */
+	if (IS_ENABLED(CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING)) {
+		return -ENOTSUP;
+	}
+
+	if (!flash_range_is_valid(dev, offset, len)) {
+		return -EINVAL;
+	}
+
+	*ptr = FLASH(offset);
+
+	return 0;
+}
+#endif /* CONFIG_FLASH_MMAP_API */
+
 static int flash_sim_write(const struct device *dev, const off_t offset,
 			   const void *data, const size_t len)
 {
@@ -368,6 +387,9 @@ static const struct flash_driver_api flash_sim_api = {
 #ifdef CONFIG_FLASH_PAGE_LAYOUT
 	.page_layout = flash_sim_page_layout,
 #endif
+#ifdef CONFIG_FLASH_MMAP_API
+	.mmap = flash_sim_mmap,
+#endif
 };
 
 #ifdef CONFIG_ARCH_POSIX
@@ -133,6 +133,22 @@ static int flash_nrf_read(const struct device *dev, off_t addr,
 	return 0;
 }
 
+#if defined(CONFIG_FLASH_MMAP_API)
+static int flash_nrf_mmap(const struct device *dev, off_t addr, size_t len,
+			  const void **ptr)
+{
+	if (is_regular_addr_valid(addr, len)) {
+		addr += DT_REG_ADDR(SOC_NV_FLASH_NODE);
+	} else if (!is_uicr_addr_valid(addr, len)) {
+		return -EINVAL;
+	}
+
+	*ptr = (const void *)addr;
+
+	return 0;
+}
+#endif /* CONFIG_FLASH_MMAP_API */
+
 static int flash_nrf_write(const struct device *dev, off_t addr,
 			     const void *data, size_t len)
 {
@@ -247,6 +263,9 @@ static const struct flash_driver_api flash_nrf_api = {
 #if defined(CONFIG_FLASH_PAGE_LAYOUT)
 	.page_layout = flash_nrf_pages_layout,
 #endif
+#if defined(CONFIG_FLASH_MMAP_API)
+	.mmap = flash_nrf_mmap,
+#endif
 };
 
 static int nrf_flash_init(const struct device *dev)
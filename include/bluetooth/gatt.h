@@ -918,6 +918,29 @@ struct bt_gatt_notify_params {
 int bt_gatt_notify_cb(struct bt_conn *conn,
 		      struct bt_gatt_notify_params *params);
 
+/** @brief Notify attribute value change to several connections.
+ *
+ *  This function works in the same way as @ref bt_gatt_notify_cb for
+ *  each of the given connections, except that the attribute handle and
+ *  its Client Characteristic Configuration are looked up only once for all
+ *  of them. NULL entries, connections which are not connected and
+ *  connections whose Client Characteristic Configuration is not set to
+ *  notifications only are skipped.
+ *
+ *  The notification is encoded in a separate ATT PDU queued on each
+ *  connection, so that a failure to send it to one connection does not
+ *  prevent sending it to the others.
+ *
+ *  @param conns Array of connection objects.
+ *  @param num_conns Number of connection objects in @p conns.
+ *  @param params Notification parameters.
+ *
+ *  @return Number of connections the notification was queued for, or a
+ *  negative value in case of error.
+ */
+int bt_gatt_notify_multicast(struct bt_conn **conns, uint16_t num_conns,
+			     struct bt_gatt_notify_params *params);
+
 /** @brief Notify multiple attribute value change.
  *
  *  @param conn Connection object.
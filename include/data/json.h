@@ -592,6 +592,121 @@ int json_obj_parse(char *json, size_t len,
 	const struct json_obj_descr *descr, size_t descr_len,
 	void *val);
 
+/** Maximum nesting of objects and arrays decoded by json_obj_stream */
+#define JSON_OBJ_STREAM_MAX_DEPTH 8
+
+/* An object or array being decoded by json_obj_stream (internal) */
+struct json_obj_stream_frame {
+	/* Object fields, or array element descriptor */
+	const struct json_obj_descr *descr;
+
+	/* Struct holding the object, or the parent of the array */
+	void *val;
+
+	/* Next element of an array */
+	char *field;
+
+	/* Number of object fields, or free array elements */
+	size_t len;
+
+	/* Decoded object fields, or size of an array element */
+	int32_t decoded;
+
+	/* JSON_TOK_OBJECT_START or JSON_TOK_LIST_START */
+	uint8_t type;
+
+	/* Object field whose value is being decoded, or -1 if ignored */
+	int8_t key;
+};
+
+/**
+ * @brief State of an incremental object parser
+ *
+ * All members are internal; use json_obj_stream_init() to set it up.
+ */
+struct json_obj_stream {
+	struct json_obj_stream_frame stack[JSON_OBJ_STREAM_MAX_DEPTH];
+
+	/* Storage for decoded strings */
+	char *buf;
+	size_t buf_size;
+	size_t buf_len;
+
+	/* Destination of the value being lexed, NULL if ignored */
+	void *field;
+
+	/* Fields still matching the key being lexed */
+	uint32_t keys;
+	size_t key_len;
+
+	/* Rest of the literal being lexed */
+	const char *literal;
+
+	char num[12];
+	uint8_t num_len;
+
+	uint8_t state;
+	uint8_t esc;
+	uint8_t depth;
+
+	/* Nesting level inside an ignored object or array */
+	uint16_t skip;
+
+	int ret;
+};
+
+/**
+ * @brief Prepares an incremental parse of a JSON-encoded object
+ *
+ * The object is decoded according to @a descr into @a val, like
+ * json_obj_parse() does, but its encoding can be fed to
+ * json_obj_stream_feed() in chunks of any size, e.g. as they come off
+ * the network.  The chunks do not have to outlive the call they are
+ * passed to, so decoded strings are copied into @a buf instead of
+ * pointing into the input.  Like with json_obj_parse(), strings are
+ * not unescaped.  No memory is allocated.
+ *
+ * @param stream Parser state
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array. Must be less
+ * than 31.
+ *
+ * @param val Pointer to the struct to hold the decoded values
+ *
+ * @param buf Buffer to hold the decoded strings, may be NULL if the
+ * descriptor has no string fields
+ *
+ * @param buf_size Size of @a buf
+ */
+void json_obj_stream_init(struct json_obj_stream *stream,
+			  const struct json_obj_descr *descr, size_t descr_len,
+			  void *val, char *buf, size_t buf_size);
+
+/**
+ * @brief Feeds the next chunk of a JSON-encoded object to the parser
+ *
+ * Values of keys that are not in the descriptor are skipped, whatever
+ * their type.  Objects and arrays may be nested at most
+ * JSON_OBJ_STREAM_MAX_DEPTH deep.  Input that follows the end of the
+ * object is ignored.
+ *
+ * @param stream Parser state, set up by json_obj_stream_init()
+ *
+ * @param data Next chunk of the encoded object
+ *
+ * @param len Length of the chunk
+ *
+ * @return -EAGAIN if the object is not complete yet, -ENOMEM if it is
+ * nested too deep or its strings do not fit the buffer, other < 0 if
+ * error, bitmap of decoded fields once the object is complete (as
+ * returned by json_obj_parse()).  Errors are final: once one is
+ * returned, every further call returns it again.
+ */
+int json_obj_stream_feed(struct json_obj_stream *stream, const char *data,
+			 size_t len);
+
 /**
  * @brief Escapes the string so it can be used to encode JSON objects
  *
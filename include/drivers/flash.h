@@ -108,6 +108,23 @@ typedef int (*flash_api_sfdp_read)(const struct device *dev, off_t offset,
 				   void *data, size_t len);
 typedef int (*flash_api_read_jedec_id)(const struct device *dev, uint8_t *id);
 
+#if defined(CONFIG_FLASH_MMAP_API)
+/**
+ * @brief Get a pointer to a memory mapped flash region.
+ *
+ * Drivers for flash that is mapped into the CPU address space implement
+ * this to let readers access the region directly instead of copying it
+ * through flash_api_read.
+ *
+ * @param dev    Flash device.
+ * @param offset Offset of the region.
+ * @param len    Length of the region.
+ * @param ptr    Set to the address the region is mapped at.
+ */
+typedef int (*flash_api_mmap)(const struct device *dev, off_t offset,
+			      size_t len, const void **ptr);
+#endif /* CONFIG_FLASH_MMAP_API */
+
 __subsystem struct flash_driver_api {
 	flash_api_read read;
 	flash_api_write write;
@@ -121,6 +138,9 @@ __subsystem struct flash_driver_api {
 	flash_api_sfdp_read sfdp_read;
 	flash_api_read_jedec_id read_jedec_id;
 #endif /* CONFIG_FLASH_JESD216_API */
+#if defined(CONFIG_FLASH_MMAP_API)
+	flash_api_mmap mmap;
+#endif /* CONFIG_FLASH_MMAP_API */
 };
 
 /**
@@ -158,6 +178,46 @@ static inline int z_impl_flash_read(const struct device *dev, off_t offset,
 	return api->read(dev, offset, data, len);
 }
 
+/**
+ *  @brief  Get a direct pointer to a memory mapped flash region
+ *
+ *  On devices whose flash is mapped into the CPU address space this
+ *  returns the address of the region, so that it can be compared, checked
+ *  or handed out without copying it through flash_read(). The returned
+ *  memory must only be read, and its content changes with any following
+ *  write or erase of the region.
+ *
+ *  This is not a system call, the mapping is only guaranteed to be
+ *  accessible in supervisor mode.
+ *
+ *  Availability of the mapping is conditional on selecting
+ *  @c CONFIG_FLASH_MMAP_API and support of that functionality in the
+ *  driver underlying @p dev. Callers are expected to fall back to
+ *  flash_read() when -ENOTSUP is returned.
+ *
+ *  @param  dev             : flash device
+ *  @param  offset          : Offset (byte aligned) of the region
+ *  @param  len             : Length of the region
+ *  @param  ptr             : Set to the address of the region on success
+ *
+ *  @retval 0 on success
+ *  @retval -ENOTSUP if the region is not memory mapped
+ *  @retval -EINVAL if the region is outside of the flash
+ */
+static inline int flash_mmap(const struct device *dev, off_t offset,
+			     size_t len, const void **ptr)
+{
+#if defined(CONFIG_FLASH_MMAP_API)
+	const struct flash_driver_api *api =
+		(const struct flash_driver_api *)dev->api;
+
+	if (api->mmap != NULL) {
+		return api->mmap(dev, offset, len, ptr);
+	}
+#endif /* CONFIG_FLASH_MMAP_API */
+	return -ENOTSUP;
+}
+
 /**
  *  @brief  Write buffer into flash memory.
  *
@@ -30,6 +30,10 @@ typedef long long int off_t;
 #include <sys/dlist.h>
 #include <fs/fs_interface.h>
 
+#if defined(CONFIG_FILE_SYSTEM_ASYNC)
+#include <kernel.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -78,6 +82,62 @@ enum {
 /** Flag makes mounted file system read-only */
 #define FS_MOUNT_FLAG_READ_ONLY BIT(1)
 
+#if defined(CONFIG_FILE_SYSTEM_DENTRY_CACHE)
+/**
+ * @brief Cached result of a path lookup on a mount point
+ *
+ * @param path Absolute path of the entry
+ * @param hash Hash of @p path
+ * @param stamp Last use stamp, 0 when the slot is free
+ * @param type Whether file or directory
+ * @param name Name of directory or file
+ * @param size Size of file. 0 if directory
+ */
+struct fs_dentry {
+	char path[CONFIG_FILE_SYSTEM_DENTRY_CACHE_PATH_MAX + 1];
+	uint32_t hash;
+	uint32_t stamp;
+	enum fs_dir_entry_type type;
+	char name[MAX_FILE_NAME + 1];
+	size_t size;
+};
+
+/**
+ * @brief Path lookup cache of a mount point
+ *
+ * Defined with FS_DCACHE_DEFINE().
+ *
+ * @param entries Storage for the cached entries
+ * @param size Number of elements in @p entries
+ * @param lock Protects the entries
+ * @param stamp Last use stamp handed out to an entry
+ * @param gen Incremented each time entries are invalidated
+ */
+struct fs_dcache {
+	struct fs_dentry *entries;
+	size_t size;
+	struct k_mutex lock;
+	uint32_t stamp;
+	uint32_t gen;
+};
+
+/**
+ * @brief Define a path lookup cache
+ *
+ * The cache is attached to a mount point through the @c dcache member of
+ * struct fs_mount_t before mounting it.
+ *
+ * @param name Name of the cache
+ * @param n Number of entries
+ */
+#define FS_DCACHE_DEFINE(name, n)					\
+	static struct fs_dentry _CONCAT(name, _entries)[n];		\
+	static struct fs_dcache name = {				\
+		.entries = _CONCAT(name, _entries),			\
+		.size = (n),						\
+	}
+#endif
+
 /**
  * @brief File system mount info structure
  *
@@ -89,6 +149,10 @@ enum {
  * @param mountp_len Length of Mount point string
  * @param fs Pointer to File system interface of the mount point
  * @param flags Mount flags
+ * @param work_q Work queue servicing asynchronous requests on files of the
+ *        mount point, NULL to use the common file system work queue
+ * @param dcache Cache of the entries recently resolved on the mount point,
+ *        NULL when lookups on the mount point are not cached
  */
 struct fs_mount_t {
 	sys_dnode_t node;
@@ -100,6 +164,12 @@ struct fs_mount_t {
 	size_t mountp_len;
 	const struct fs_file_system_t *fs;
 	uint8_t flags;
+#if defined(CONFIG_FILE_SYSTEM_ASYNC)
+	struct k_work_q *work_q;
+#endif
+#if defined(CONFIG_FILE_SYSTEM_DENTRY_CACHE)
+	struct fs_dcache *dcache;
+#endif
 };
 
 /**
@@ -302,6 +372,132 @@ ssize_t fs_read(struct fs_file_t *zfp, void *ptr, size_t size);
  */
 ssize_t fs_write(struct fs_file_t *zfp, const void *ptr, size_t size);
 
+/**
+ * @brief Scatter/gather buffer descriptor
+ *
+ * Describes one of the buffers passed to fs_readv() and fs_writev().
+ *
+ * @param iov_base Pointer to the buffer
+ * @param iov_len Length of the buffer
+ */
+struct fs_iovec {
+	void *iov_base;
+	size_t iov_len;
+};
+
+/**
+ * @brief Read file into multiple buffers
+ *
+ * Reads data into the @p iovcnt buffers described by @p iov, filling each
+ * buffer completely before proceeding to the next one. File systems that
+ * support it handle the whole vector in one call, others are called once
+ * for each buffer.
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Array of buffer descriptors
+ * @param iovcnt Number of elements in @p iov
+ *
+ * @retval >=0 a number of bytes read, on success; may be lower than the
+ *         total size of the buffers if fewer bytes were available;
+ * @retval <0 a negative errno code on error.
+ */
+ssize_t fs_readv(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		 int iovcnt);
+
+/**
+ * @brief Write file from multiple buffers
+ *
+ * Writes the @p iovcnt buffers described by @p iov, in order, to the file.
+ * File systems that support it handle the whole vector in one call, others
+ * are called once for each buffer.
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Array of buffer descriptors
+ * @param iovcnt Number of elements in @p iov
+ *
+ * @retval >=0 a number of bytes written, on success; a value lower than the
+ *         total size of the buffers means the device may have no free space
+ *         for data;
+ * @retval -ENOTSUP when not implemented by underlying file system driver;
+ * @retval <0 an other negative errno code on error.
+ */
+ssize_t fs_writev(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		  int iovcnt);
+
+#if defined(CONFIG_FILE_SYSTEM_ASYNC)
+/** Operations available for asynchronous requests */
+enum fs_async_op {
+	/** Read as with fs_readv() */
+	FS_ASYNC_READV,
+	/** Write as with fs_writev() */
+	FS_ASYNC_WRITEV,
+	/** Flush as with fs_sync() */
+	FS_ASYNC_SYNC,
+};
+
+struct fs_async_req;
+
+/**
+ * @brief Completion callback of an asynchronous request
+ *
+ * Called from the work queue thread that serviced the request.
+ *
+ * @param req The completed request
+ * @param result Value the synchronous variant of the operation returned
+ */
+typedef void (*fs_async_cb_t)(struct fs_async_req *req, ssize_t result);
+
+/**
+ * @brief Asynchronous file operation request
+ *
+ * The request is initialized once with fs_async_req_init(). The caller
+ * fills in the public fields before each submission and keeps the request,
+ * and the buffers it refers to, unchanged until the callback has been
+ * invoked.
+ *
+ * @param zfp Pointer to the file object
+ * @param op Operation to perform
+ * @param iov Array of buffer descriptors, unused by @c FS_ASYNC_SYNC
+ * @param iovcnt Number of elements in @p iov
+ * @param cb Completion callback, may be NULL
+ */
+struct fs_async_req {
+	struct fs_file_t *zfp;
+	enum fs_async_op op;
+	const struct fs_iovec *iov;
+	int iovcnt;
+	fs_async_cb_t cb;
+	/* internal state */
+	struct k_work work;
+};
+
+/**
+ * @brief Initialize an asynchronous file operation request
+ *
+ * Must be called once before the first submission of @p req, and not while
+ * it is pending. Submitting a request that was not initialized is undefined.
+ *
+ * @param req Request to initialize
+ */
+void fs_async_req_init(struct fs_async_req *req);
+
+/**
+ * @brief Submit an asynchronous file operation
+ *
+ * Queues @p req to the work queue of the mount point of the file. Requests
+ * submitted to the same work queue are completed in submission order, so
+ * several requests may be queued on one file.
+ *
+ * @param req Request to submit
+ *
+ * @retval 0 on success;
+ * @retval -EBADF when the file is not open;
+ * @retval -EBUSY when the request is still pending;
+ * @retval -EINVAL when the request is invalid.
+ */
+int fs_async_submit(struct fs_async_req *req);
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
+
 /**
  * @brief Seek file
  *
@@ -25,6 +25,8 @@ extern "C" {
 #else /* CONFIG_FS_FATFS_LFN */
 #define MAX_FILE_NAME 12 /* Uses 8.3 SFN */
 #endif /* CONFIG_FS_FATFS_LFN */
+#elif defined(CONFIG_FILE_SYSTEM_LOGFS)
+#define MAX_FILE_NAME 23
 #else /* filesystem selection */
 /* Use standard 8.3 when no filesystem is explicitly selected */
 #define MAX_FILE_NAME 12
@@ -41,11 +43,16 @@ struct fs_mount_t;
  *
  * @param Pointer to FATFS file object structure
  * @param mp Pointer to mount point structure
+ * @param dcache_hash Hash of the path the file was opened with, to find its
+ *        entry in the path lookup cache of the mount point
  */
 struct fs_file_t {
 	void *filep;
 	const struct fs_mount_t *mp;
 	fs_mode_t flags;
+#if defined(CONFIG_FILE_SYSTEM_DENTRY_CACHE)
+	uint32_t dcache_hash;
+#endif
 };
 
 /**
@@ -22,6 +22,8 @@ extern "C" {
  * @param open Opens or creates a file, depending on flags given
  * @param read Reads nbytes number of bytes
  * @param write Writes nbytes number of bytes
+ * @param readv Reads into an array of buffers, optional
+ * @param writev Writes an array of buffers, optional
  * @param lseek Moves the file position to a new location in the file
  * @param tell Retrieves the current position in the file
  * @param truncate Truncates/expands the file to the new length
@@ -46,6 +48,10 @@ struct fs_file_system_t {
 	ssize_t (*read)(struct fs_file_t *filp, void *dest, size_t nbytes);
 	ssize_t (*write)(struct fs_file_t *filp,
 					const void *src, size_t nbytes);
+	ssize_t (*readv)(struct fs_file_t *filp, const struct fs_iovec *iov,
+			 int iovcnt);
+	ssize_t (*writev)(struct fs_file_t *filp, const struct fs_iovec *iov,
+			  int iovcnt);
 	int (*lseek)(struct fs_file_t *filp, off_t off, int whence);
 	off_t (*tell)(struct fs_file_t *filp);
 	int (*truncate)(struct fs_file_t *filp, off_t length);
@@ -0,0 +1,126 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_FS_LOGFS_H_
+#define ZEPHYR_INCLUDE_FS_LOGFS_H_
+
+#include <zephyr/types.h>
+#include <kernel.h>
+#include <fs/fs.h>
+#include <storage/flash_map.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Append-only log file system
+ * @defgroup logfs Log file system
+ * @ingroup file_system_api
+ *
+ * The log file system stores a flat set of files in whole flash sectors.
+ * Every sector belongs to one file and carries a small header naming the
+ * file; file data is programmed straight into the sector behind it.
+ * Sectors are taken from the partition in a ring, so that erases are
+ * spread evenly when logs are removed in the order they were written.
+ *
+ * Writes always append to the end of a file.  Data is durable once the
+ * file is synced or closed.  Each sync writes a small length record at
+ * the end of the sector being appended to, so a file can be synced
+ * until its sector is full.  Truncation to a shorter length erases the
+ * sectors past the new end, newest first, and then records the new
+ * length in the sector holding it; an interrupted truncate leaves a
+ * prefix of the old content.  Files can not be renamed and there are no
+ * subdirectories.
+ *
+ * @{
+ */
+
+/** File system type identifier, out of the range of in-tree types */
+#define FS_LOGFS (FS_TYPE_EXTERNAL_BASE + 0x100)
+
+/** Maximum length of a file name, without terminating NUL */
+#define FS_LOGFS_NAME_MAX 23
+
+/** Maximum supported flash write block size */
+#define FS_LOGFS_WBUF_SIZE 32
+
+/** @cond INTERNAL_HIDDEN */
+struct fs_logfs_sector {
+	/* Allocation sequence number, 0 for a free sector */
+	uint32_t seq;
+	/* Committed and written data bytes in the sector */
+	uint32_t len;
+	/* End of the programmed data area */
+	uint32_t end;
+	/* Next sector of the same file, or UINT16_MAX */
+	uint16_t next;
+	/* Number of record slots used */
+	uint16_t slots;
+	/* Slot of the last valid record */
+	uint16_t rec;
+	/* Index of the owning file */
+	uint8_t file;
+	uint8_t flags;
+};
+
+struct fs_logfs_file {
+	char name[FS_LOGFS_NAME_MAX + 1];
+	/* Size of the file, including bytes pending in wbuf */
+	uint32_t size;
+	uint16_t first;
+	uint16_t last;
+	uint8_t open_cnt;
+	bool used;
+	bool writer;
+	uint8_t pending;
+	uint8_t wbuf[FS_LOGFS_WBUF_SIZE];
+};
+/** @endcond */
+
+/** @brief File system info structure for a log file system mount */
+struct fs_logfs {
+	/* These structures are filled automatically at mount. */
+	const struct flash_area *area;
+	struct k_mutex mutex;
+	uint32_t sector_size;
+	uint32_t sector_count;
+	uint32_t seq;
+	uint16_t alloc;
+	uint16_t write_size;
+	uint16_t data_off;
+	uint8_t erased_val;
+	struct fs_logfs_sector sectors[CONFIG_FS_LOGFS_MAX_SECTORS];
+	struct fs_logfs_file files[CONFIG_FS_LOGFS_MAX_FILES];
+};
+
+/**
+ * @brief Map file data at the current position for reading.
+ *
+ * Provides direct access to the flash holding the file data starting at
+ * the current file position, without copying.  The region ends at most
+ * at the end of the flash sector holding the data; advance the position
+ * with fs_seek() to map the data that follows.
+ *
+ * @param zfp Pointer to a file opened on a log file system mount
+ * @param ptr Receives the address of the mapped data
+ * @param len Receives the number of bytes available at @p ptr, 0 at the
+ *        end of the file
+ *
+ * @retval 0 on success
+ * @retval -ENOTSUP if the flash device can not be mapped, or the data at
+ *         the current position is not yet programmed to flash
+ * @retval -EBADF if the file is not open
+ */
+int fs_logfs_mmap(struct fs_file_t *zfp, const void **ptr, size_t *len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_FS_LOGFS_H_ */
@@ -43,6 +43,8 @@ extern "C" {
  * @param write_block_size Alignment size
  * @param nvs_lock Mutex
  * @param flash_device Flash Device
+ * @param gc_work Background garbage collection work item
+ * @param bg_gc_sector Sector produced by the last background gc
  */
 struct nvs_fs {
 	off_t offset;		/* filesystem offset in flash */
@@ -57,6 +59,13 @@ struct nvs_fs {
 	struct k_mutex nvs_lock;
 	const struct device *flash_device;
 	const struct flash_parameters *flash_parameters;
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	struct k_work gc_work;
+	struct k_sem gc_done;
+	atomic_t gc_pending;
+	uint32_t bg_gc_sector;	/* write sector the last background gc gave up in */
+	uint16_t free_sectors;	/* erased sectors following the write sector */
+#endif
 };
 
 /**
@@ -82,6 +91,18 @@ struct nvs_fs {
  */
 int nvs_init(struct nvs_fs *fs, const char *dev_name);
 
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+/**
+ * @brief nvs_gc_flush
+ *
+ * Waits for the background garbage collection submitted for the file system
+ * to complete. Returns at once when none is pending.
+ *
+ * @param fs Pointer to file system
+ */
+void nvs_gc_flush(struct nvs_fs *fs);
+#endif
+
 /**
  * @brief nvs_clear
  *
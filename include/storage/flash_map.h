@@ -149,6 +149,25 @@ void flash_area_close(const struct flash_area *fa);
 int flash_area_read(const struct flash_area *fa, off_t off, void *dst,
 		    size_t len);
 
+/**
+ * @brief Get a direct pointer to flash area data
+ *
+ * Get the address at which a region of the flash area is memory mapped,
+ * so that it can be read in place instead of copied with flash_area_read().
+ * The returned memory must only be read and is only valid until the region
+ * is written or erased.
+ *
+ * @param[in]  fa  Flash area
+ * @param[in]  off Offset relative from beginning of flash area
+ * @param[in]  len Length of the region
+ * @param[out] ptr Set to the address of the region
+ *
+ * @return  0 on success, -ENOTSUP if the flash area is not memory mapped,
+ * other negative errno code on fail.
+ */
+int flash_area_mmap(const struct flash_area *fa, off_t off, size_t len,
+		    const void **ptr);
+
 /**
  * @brief Write data to flash area
  *
@@ -24,6 +24,7 @@
 #ifndef ZEPHYR_INCLUDE_SYS_BASE64_H_
 #define ZEPHYR_INCLUDE_SYS_BASE64_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <zephyr/types.h>
 
@@ -72,6 +73,92 @@ int base64_encode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 int base64_decode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 		  size_t slen);
 
+/**
+ * @brief          State of a chunked base64 encoding or decoding
+ */
+struct base64_stream {
+	uint32_t acc;
+	uint8_t len;
+	uint8_t pad;
+	bool end;
+};
+
+/**
+ * @brief          Initialize the state of a chunked encoding or decoding
+ *
+ * @param stream   stream state
+ */
+void base64_stream_init(struct base64_stream *stream);
+
+/**
+ * @brief          Encode a chunk of data into base64 format
+ *
+ * Complete blocks of 3 bytes are encoded, the remaining bytes are kept in
+ * the stream state for the next chunk or base64_encode_finish().
+ *
+ * @param stream   stream state
+ * @param dst      destination buffer
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written
+ * @param src      source buffer
+ * @param slen     amount of data to be encoded
+ *
+ * @return         0 if successful, or -ENOMEM if the buffer is too small,
+ *                 in which case the chunk is not consumed and *olen is set
+ *                 to the required size.
+ */
+int base64_encode_update(struct base64_stream *stream, uint8_t *dst,
+			 size_t dlen, size_t *olen, const uint8_t *src,
+			 size_t slen);
+
+/**
+ * @brief          Finish a chunked encoding
+ *
+ * The remaining bytes are encoded with padding. Unlike base64_encode(),
+ * the output is not NUL terminated.
+ *
+ * @param stream   stream state, reinitialized on success
+ * @param dst      destination buffer, 4 bytes are enough
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written
+ *
+ * @return         0 if successful, or -ENOMEM if the buffer is too small.
+ */
+int base64_encode_finish(struct base64_stream *stream, uint8_t *dst,
+			 size_t dlen, size_t *olen);
+
+/**
+ * @brief          Decode a chunk of base64-formatted data
+ *
+ * Chunks can be split anywhere. Line breaks are skipped, other white space
+ * is not allowed. Padding is required, and ends the data.
+ *
+ * @param stream   stream state
+ * @param dst      destination buffer, which must hold at least 3 bytes for
+ *                 every 4 characters pending in @a stream and in @a src
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written
+ * @param src      source buffer
+ * @param slen     amount of data to be decoded
+ *
+ * @return         0 if successful, -ENOMEM if the buffer is too small, in
+ *                 which case the chunk is not consumed and *olen is set to
+ *                 the required size, or -EINVAL if the input data is not
+ *                 correct.
+ */
+int base64_decode_update(struct base64_stream *stream, uint8_t *dst,
+			 size_t dlen, size_t *olen, const uint8_t *src,
+			 size_t slen);
+
+/**
+ * @brief          Finish a chunked decoding
+ *
+ * @param stream   stream state, reinitialized
+ *
+ * @return         0 if successful, or -EINVAL if the data was truncated.
+ */
+int base64_decode_finish(struct base64_stream *stream);
+
 #ifdef __cplusplus
 }
 #endif
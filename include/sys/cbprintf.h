@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_CBPRINTF_H_
+#define ZEPHYR_INCLUDE_SYS_CBPRINTF_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup cbprintf_apis Formatted Output APIs
+ * @{
+ */
+
+/**
+ * @brief Signature of the output callback of the cbprintf functions
+ *
+ * The formatted output is delivered in spans: a literal run of the format
+ * string, a converted value or padding.
+ *
+ * @param str Characters to output, not NUL-terminated
+ * @param len Number of characters
+ * @param ctx Context passed to the cbprintf function
+ *
+ * @return 0 on success, < 0 to abort formatting with that error
+ */
+typedef int (*cbprintf_cb)(const char *str, size_t len, void *ctx);
+
+/**
+ * @brief Format a string, delivering the output to a callback
+ *
+ * The conversions supported are those of printk(): \%d, \%i, \%u, \%x,
+ * \%X, \%p, \%s, \%c and \%\%, with field width, the '0' and '-' flags
+ * and the h, hh, l, ll and z length modifiers.
+ *
+ * @param out Output callback
+ * @param ctx Context passed to @a out
+ * @param fmt Format string
+ * @param ... Arguments of the format string
+ *
+ * @return Number of characters output, or the error returned by @a out
+ */
+__printf_like(3, 4)
+int cbprintf(cbprintf_cb out, void *ctx, const char *fmt, ...);
+
+/**
+ * @brief va_list variant of cbprintf()
+ *
+ * @param out Output callback
+ * @param ctx Context passed to @a out
+ * @param fmt Format string
+ * @param ap Arguments of the format string
+ *
+ * @return Number of characters output, or the error returned by @a out
+ */
+__printf_like(3, 0)
+int cbvprintf(cbprintf_cb out, void *ctx, const char *fmt, va_list ap);
+
+/**
+ * @brief Capture a format string and its arguments for later formatting
+ *
+ * The package holds a pointer to @a fmt, which therefore has to stay
+ * valid (usually it is a literal), followed by the arguments. Strings
+ * passed for \%s are copied, so the package can be formatted by
+ * cbpprintf() in another context once the arguments are gone. The
+ * package is self-contained, of the size returned; it has no alignment
+ * requirements and can be copied around as a byte array.
+ *
+ * @param packaged Buffer to hold the package, NULL to only compute its size
+ * @param len Size of @a packaged
+ * @param fmt Format string
+ * @param ... Arguments of the format string
+ *
+ * @return Size of the package, -ENOSPC if it does not fit in @a len bytes
+ */
+__printf_like(3, 4)
+int cbprintf_package(void *packaged, size_t len, const char *fmt, ...);
+
+/**
+ * @brief va_list variant of cbprintf_package()
+ *
+ * @param packaged Buffer to hold the package, NULL to only compute its size
+ * @param len Size of @a packaged
+ * @param fmt Format string
+ * @param ap Arguments of the format string
+ *
+ * @return Size of the package, -ENOSPC if it does not fit in @a len bytes
+ */
+__printf_like(3, 0)
+int cbvprintf_package(void *packaged, size_t len, const char *fmt,
+		      va_list ap);
+
+/**
+ * @brief Format a package built by cbprintf_package()
+ *
+ * @param out Output callback
+ * @param ctx Context passed to @a out
+ * @param packaged Package
+ *
+ * @return Number of characters output, or the error returned by @a out
+ */
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged);
+
+/**
+ * @brief Get the size of a package built by cbprintf_package()
+ *
+ * @param packaged Package
+ *
+ * @return Size of the package in bytes
+ */
+size_t cbprintf_package_len(const void *packaged);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_CBPRINTF_H_ */
@@ -101,6 +101,47 @@ void *z_get_fd_obj(int fd, const struct fd_op_vtable *vtable, int err);
  */
 void *z_get_fd_obj_and_vtable(int fd, const struct fd_op_vtable **vtable);
 
+/**
+ * @brief Get underlying object and vtable pointers, holding a reference.
+ *
+ * This function is meant for the I/O fast path: it takes no lock, and
+ * the reference keeps the entry from being released until z_put_fd_ref()
+ * is called. If the descriptor is freed in the meantime, further lookups
+ * fail, but the descriptor is only reused once all references are put.
+ * The reference does not keep the object open, its owner is responsible
+ * for waking up and failing the calls still using it when it is closed.
+ *
+ * @param fd File descriptor previously returned by z_reserve_fd()
+ * @param obj A pointer to a pointer variable to store the object
+ * @param vtable A pointer to a pointer variable to store the vtable
+ *
+ * @return 0 on success, or -1 in case of error (errno is set)
+ */
+int z_get_fd_ref(int fd, void **obj, const struct fd_op_vtable **vtable);
+
+/**
+ * @brief Put a reference taken by z_get_fd_ref().
+ *
+ * @param fd File descriptor passed to z_get_fd_ref()
+ */
+void z_put_fd_ref(int fd);
+
+/**
+ * @brief Close a file descriptor and its object.
+ *
+ * The descriptor is marked closed, so that further lookups fail, the close
+ * vmethod of the object is called, and the reference taken by the caller
+ * with z_get_fd_ref() is put. Calls blocked on the object in other threads
+ * are woken up by the close vmethod, the descriptor is reused only once
+ * they have returned and put their references.
+ *
+ * @param fd File descriptor referenced by the caller
+ *
+ * @return Result of the close vmethod, or -1 if the descriptor was already
+ * closed (errno is set)
+ */
+int z_close_fd(int fd);
+
 /**
  * @brief Call ioctl vmethod on an object using varargs.
  *
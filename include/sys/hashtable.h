@@ -0,0 +1,241 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Intrusive open-addressing hash table
+ *
+ * The table maps a 32-bit hash and a caller defined key to a struct
+ * sys_hashnode, which is embedded in the caller's own structure the same
+ * way as the nodes of the lists and of the red/black tree. The slots hold
+ * the hash next to the node pointer, so that a lookup only dereferences
+ * nodes whose hash matches.
+ *
+ * Collisions are resolved by linear probing with Robin Hood ordering: an
+ * entry displaces one that is closer to its ideal slot, which keeps probe
+ * sequences short and lets unsuccessful lookups stop early. Removal shifts
+ * the following entries back instead of leaving tombstones.
+ *
+ * The slot array is either provided by the caller, for a table of fixed
+ * capacity, or allocated from a sys_heap and grown as needed.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_HASHTABLE_H_
+#define ZEPHYR_INCLUDE_SYS_HASHTABLE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/types.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sys_heap;
+
+/**
+ * @defgroup hashtable_apis Hash Table APIs
+ * @{
+ */
+
+/** @brief Hash table node, to be embedded in the stored structure */
+struct sys_hashnode {
+	/** Hash of the node key, set on insertion */
+	uint32_t hash;
+};
+
+/** @brief Hash table slot, internal */
+struct sys_hashtable_slot {
+	uint32_t hash;
+	struct sys_hashnode *node;
+};
+
+/**
+ * @brief Key comparison callback
+ *
+ * @param node Node with the same hash as the looked up key
+ * @param key Looked up key
+ *
+ * @return true if @a node holds @a key
+ */
+typedef bool (*sys_hashtable_eq_t)(const struct sys_hashnode *node,
+				   const void *key);
+
+/** @brief Hash table */
+struct sys_hashtable {
+	struct sys_hashtable_slot *slots;
+	uint32_t capacity;
+	uint32_t count;
+	struct sys_heap *heap;
+	sys_hashtable_eq_t eq;
+};
+
+/**
+ * @brief Initialize a hash table of fixed capacity
+ *
+ * At most 7/8 of the slots are used, to keep probe sequences short.
+ *
+ * @param ht Hash table
+ * @param slots Slot array
+ * @param capacity Number of slots, a power of 2
+ * @param eq Key comparison callback
+ */
+void sys_hashtable_init(struct sys_hashtable *ht,
+			struct sys_hashtable_slot *slots, uint32_t capacity,
+			sys_hashtable_eq_t eq);
+
+/**
+ * @brief Initialize a hash table allocated from a heap
+ *
+ * The slot array is allocated on the first insertion and doubled whenever
+ * it is 7/8 full. It is not shrunk on removal.
+ *
+ * @param ht Hash table
+ * @param heap Heap to allocate the slot array from
+ * @param eq Key comparison callback
+ */
+void sys_hashtable_init_heap(struct sys_hashtable *ht, struct sys_heap *heap,
+			     sys_hashtable_eq_t eq);
+
+/**
+ * @brief Free the slot array of a hash table allocated from a heap
+ *
+ * The table is left empty, and can be used again.
+ *
+ * @param ht Hash table
+ */
+void sys_hashtable_free(struct sys_hashtable *ht);
+
+/**
+ * @brief Insert a node
+ *
+ * Keys are not checked for uniqueness, a node inserted with the key of a
+ * node already in the table is found only once the latter is removed.
+ *
+ * @param ht Hash table
+ * @param node Node to insert, not in any table
+ * @param hash Hash of the node key
+ *
+ * @retval 0 on success
+ * @retval -ENOMEM if the table is full or the heap is exhausted
+ */
+int sys_hashtable_insert(struct sys_hashtable *ht, struct sys_hashnode *node,
+			 uint32_t hash);
+
+/**
+ * @brief Look up a key
+ *
+ * @param ht Hash table
+ * @param hash Hash of the key
+ * @param key Key, passed to the comparison callback
+ *
+ * @return Node holding the key, NULL if none
+ */
+struct sys_hashnode *sys_hashtable_find(const struct sys_hashtable *ht,
+					uint32_t hash, const void *key);
+
+/**
+ * @brief Remove the node holding a key
+ *
+ * @param ht Hash table
+ * @param hash Hash of the key
+ * @param key Key, passed to the comparison callback
+ *
+ * @return Removed node, NULL if none
+ */
+struct sys_hashnode *sys_hashtable_remove(struct sys_hashtable *ht,
+					  uint32_t hash, const void *key);
+
+/**
+ * @brief Remove a node
+ *
+ * No key comparison is done, the node is found by its address.
+ *
+ * @param ht Hash table
+ * @param node Node to remove
+ *
+ * @return true if the node was found in the table
+ */
+bool sys_hashtable_remove_node(struct sys_hashtable *ht,
+			       struct sys_hashnode *node);
+
+/**
+ * @brief Get the number of nodes in a hash table
+ *
+ * @param ht Hash table
+ *
+ * @return Number of nodes
+ */
+static inline uint32_t sys_hashtable_count(const struct sys_hashtable *ht)
+{
+	return ht->count;
+}
+
+/**
+ * @brief Iterate over all nodes of a hash table, in no particular order
+ *
+ * The table must not be modified during the iteration.
+ *
+ * @param ht Hash table
+ * @param i uint32_t slot index, used as iterator
+ * @param n struct sys_hashnode pointer, set to each node
+ */
+#define SYS_HASHTABLE_FOR_EACH_NODE(ht, i, n)				\
+	for ((i) = 0U; (i) < (ht)->capacity; (i)++)			\
+		if (((n) = (ht)->slots[(i)].node) == NULL) {		\
+		} else
+
+/**
+ * @brief Hash a 32-bit integer key
+ *
+ * This is the finalizer of MurmurHash3, every input bit affects every
+ * output bit, so sequential keys spread over the whole table.
+ *
+ * @param key Key
+ *
+ * @return Hash
+ */
+static inline uint32_t sys_hash32_u32(uint32_t key)
+{
+	key ^= key >> 16;
+	key *= 0x85ebca6bU;
+	key ^= key >> 13;
+	key *= 0xc2b2ae35U;
+	key ^= key >> 16;
+
+	return key;
+}
+
+/**
+ * @brief Hash a buffer
+ *
+ * This is 32-bit FNV-1a.
+ *
+ * @param data Buffer
+ * @param len Buffer length
+ *
+ * @return Hash
+ */
+static inline uint32_t sys_hash32(const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	uint32_t hash = 0x811c9dc5U;
+
+	while (len--) {
+		hash = (hash ^ *p++) * 0x01000193U;
+	}
+
+	return hash;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_HASHTABLE_H_ */
@@ -11,9 +11,12 @@
  * sys_mutex behaves almost exactly like k_mutex, with the added advantage
  * that a sys_mutex instance can reside in user memory.
  *
- * Further enhancements will support locking/unlocking uncontended sys_mutexes
- * with simple atomic ops instead of syscalls, similar to Linux's
- * FUTEX_LOCK_PI and FUTEX_UNLOCK_PI
+ * With CONFIG_USERSPACE and CONFIG_THREAD_LOCAL_STORAGE, an uncontended
+ * sys_mutex is locked and unlocked with atomic ops on its owner word,
+ * without making syscalls, similar to Linux's FUTEX_LOCK_PI and
+ * FUTEX_UNLOCK_PI. Threads that have to wait do so in the kernel, on a
+ * k_mutex locked on behalf of the owner, so that the owner still inherits
+ * their priority.
  */
 
 #ifdef __cplusplus
@@ -22,15 +25,24 @@ extern "C" {
 
 #ifdef CONFIG_USERSPACE
 #include <sys/atomic.h>
+#include <sys/util.h>
 #include <zephyr/types.h>
 #include <sys_clock.h>
 
+/* Set in the owner word while the kernel tracks the owner of the mutex,
+ * in which case unlocking it has to go through the kernel
+ */
+#define Z_SYS_MUTEX_CONTENDED	BIT(0)
+
 struct sys_mutex {
-	/* Currently unused, but will be used to store state for fast mutexes
-	 * that can be locked/unlocked with atomic ops if there is no
-	 * contention
+	/* Owner id assigned by the kernel to the owning thread, 0 if
+	 * unlocked, possibly with Z_SYS_MUTEX_CONTENDED set
+	 */
+	atomic_t owner;
+	/* Number of times the owner locked the mutex, only accessed by the
+	 * owner
 	 */
-	atomic_t val;
+	uint32_t lock_count;
 };
 
 #define SYS_MUTEX_DEFINE(name) \
@@ -52,11 +64,9 @@ struct sys_mutex {
  */
 static inline void sys_mutex_init(struct sys_mutex *mutex)
 {
-	ARG_UNUSED(mutex);
-
-	/* Nothing to do, kernel-side data structures are initialized at
-	 * boot
-	 */
+	/* Kernel-side data structures are initialized at boot */
+	atomic_clear(&mutex->owner);
+	mutex->lock_count = 0U;
 }
 
 __syscall int z_sys_mutex_kernel_lock(struct sys_mutex *mutex,
@@ -64,6 +74,55 @@ __syscall int z_sys_mutex_kernel_lock(struct sys_mutex *mutex,
 
 __syscall int z_sys_mutex_kernel_unlock(struct sys_mutex *mutex);
 
+struct k_mutex;
+
+/* Slow paths, run by the syscalls on the k_mutex backing the sys_mutex */
+int z_sys_mutex_lock_contended(struct k_mutex *kernel_mutex,
+			       struct sys_mutex *mutex, k_timeout_t timeout);
+
+int z_sys_mutex_unlock_contended(struct k_mutex *kernel_mutex,
+				 struct sys_mutex *mutex);
+
+#ifdef CONFIG_THREAD_LOCAL_STORAGE
+/* Number of mutexes a thread remembers having been validated by the
+ * kernel, a power of 2
+ */
+#define Z_SYS_MUTEX_CHECKED	4
+
+/* Owner id of the current thread, 0 until it has locked a mutex through
+ * the kernel
+ */
+extern __thread atomic_val_t z_sys_mutex_self;
+
+/* Mutexes the kernel let the current thread lock, which it may thus
+ * access directly
+ */
+extern __thread struct sys_mutex *z_sys_mutex_checked[Z_SYS_MUTEX_CHECKED];
+
+static inline struct sys_mutex **z_sys_mutex_checked_slot(
+	struct sys_mutex *mutex)
+{
+	return &z_sys_mutex_checked[((uintptr_t)mutex / sizeof(*mutex)) &
+				    (Z_SYS_MUTEX_CHECKED - 1)];
+}
+
+/* Called once the kernel locked the mutex for the current thread */
+static inline void z_sys_mutex_locked(struct sys_mutex *mutex)
+{
+	z_sys_mutex_self = atomic_get(&mutex->owner) & ~Z_SYS_MUTEX_CONTENDED;
+	*z_sys_mutex_checked_slot(mutex) = mutex;
+}
+
+/* Whether the current thread owning the mutex may be assumed without
+ * asking the kernel, in which case the mutex is accessible
+ */
+static inline bool z_sys_mutex_is_fast(struct sys_mutex *mutex)
+{
+	return z_sys_mutex_self != 0 &&
+	       *z_sys_mutex_checked_slot(mutex) == mutex;
+}
+#endif /* CONFIG_THREAD_LOCAL_STORAGE */
+
 /**
  * @brief Lock a mutex.
  *
@@ -74,6 +133,10 @@ __syscall int z_sys_mutex_kernel_unlock(struct sys_mutex *mutex);
  * A thread is permitted to lock a mutex it has already locked. The operation
  * completes immediately and the lock count is increased by 1.
  *
+ * The first time a thread locks a mutex, the kernel validates it. Later on,
+ * an unlocked mutex is locked without making a syscall, as long as the
+ * thread locks no more than a few different mutexes.
+ *
  * @param mutex Address of the mutex, which may reside in user memory
  * @param timeout Waiting period to lock the mutex,
  *                or one of the special values K_NO_WAIT and K_FOREVER.
@@ -82,12 +145,36 @@ __syscall int z_sys_mutex_kernel_unlock(struct sys_mutex *mutex);
  * @retval -EBUSY Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
  * @retval -EACCESS Caller has no access to provided mutex address
- * @retval -EINVAL Provided mutex not recognized by the kernel
+ * @retval -EINVAL Provided mutex not recognized by the kernel, or its owner
+ *                 is not a live thread
  */
 static inline int sys_mutex_lock(struct sys_mutex *mutex, k_timeout_t timeout)
 {
-	/* For now, make the syscall unconditionally */
-	return z_sys_mutex_kernel_lock(mutex, timeout);
+	int ret;
+
+#ifdef CONFIG_THREAD_LOCAL_STORAGE
+	if (z_sys_mutex_is_fast(mutex)) {
+		if (likely(atomic_cas(&mutex->owner, 0, z_sys_mutex_self))) {
+			mutex->lock_count = 1U;
+			return 0;
+		}
+
+		if ((atomic_get(&mutex->owner) & ~Z_SYS_MUTEX_CONTENDED) ==
+		    z_sys_mutex_self) {
+			mutex->lock_count++;
+			return 0;
+		}
+	}
+#endif
+
+	ret = z_sys_mutex_kernel_lock(mutex, timeout);
+#ifdef CONFIG_THREAD_LOCAL_STORAGE
+	if (ret == 0) {
+		z_sys_mutex_locked(mutex);
+	}
+#endif
+
+	return ret;
 }
 
 /**
@@ -100,6 +187,9 @@ static inline int sys_mutex_lock(struct sys_mutex *mutex, k_timeout_t timeout)
  * the calling thread as many times as it was previously locked by that
  * thread.
  *
+ * A mutex no other thread waited for is unlocked without making a syscall,
+ * under the same conditions as for sys_mutex_lock().
+ *
  * @param mutex Address of the mutex, which may reside in user memory
  * @retval -EACCESS Caller has no access to provided mutex address
  * @retval -EINVAL Provided mutex not recognized by the kernel or mutex wasn't
@@ -108,7 +198,24 @@ static inline int sys_mutex_lock(struct sys_mutex *mutex, k_timeout_t timeout)
  */
 static inline int sys_mutex_unlock(struct sys_mutex *mutex)
 {
-	/* For now, make the syscall unconditionally */
+#ifdef CONFIG_THREAD_LOCAL_STORAGE
+	atomic_val_t self = z_sys_mutex_self;
+
+	if (z_sys_mutex_is_fast(mutex) &&
+	    (atomic_get(&mutex->owner) & ~Z_SYS_MUTEX_CONTENDED) == self) {
+		if (mutex->lock_count > 1U) {
+			mutex->lock_count--;
+			return 0;
+		}
+
+		mutex->lock_count = 0U;
+
+		if (likely(atomic_cas(&mutex->owner, self, 0))) {
+			return 0;
+		}
+	}
+#endif
+
 	return z_sys_mutex_kernel_unlock(mutex);
 }
 
@@ -68,6 +68,21 @@ extern __printf_like(3, 0) int vsnprintk(char *str, size_t size,
 extern __printf_like(3, 0) void z_vprintk(int (*out)(int f, void *c), void *ctx,
 					 const char *fmt, va_list ap);
 
+/**
+ * @brief Install the character output routine for printk
+ *
+ * @param fn putc routine to install
+ */
+extern void __printk_hook_install(int (*fn)(int));
+
+/**
+ * @brief Install a string output routine for printk
+ *
+ * @param fn routine outputting @a len characters from @a str
+ */
+extern void __printk_str_hook_install(int (*fn)(const char *str,
+						size_t len));
+
 #ifdef __cplusplus
 }
 #endif
@@ -405,6 +405,269 @@ int ring_buf_get_finish(struct ring_buf *buf, uint32_t size);
  */
 uint32_t ring_buf_get(struct ring_buf *buf, uint8_t *data, uint32_t size);
 
+/**
+ * @brief A lock-free single producer, single consumer byte ring buffer
+ *
+ * Unlike @ref ring_buf, it needs no locking as long as there is a single
+ * writer and a single reader, which may run in different threads, ISRs
+ * or CPUs: each index is only written by one side, and published with
+ * release semantics.
+ */
+struct ring_buf_spsc {
+	uint32_t head;	/**< Free-running read index, set by the consumer */
+	uint32_t tail;	/**< Free-running write index, set by the producer */
+	uint32_t mask;	/**< Size of buf minus 1, the size is a power of 2 */
+	uint8_t *buf;	/**< Memory region for stored data */
+};
+
+/**
+ * @brief Statically define and initialize a single producer, single
+ * consumer ring buffer.
+ *
+ * @param name  Name of the ring buffer.
+ * @param size8 Size of ring buffer (in bytes), a power of 2.
+ */
+#define RING_BUF_SPSC_DECLARE(name, size8) \
+	BUILD_ASSERT(((size8) & ((size8) - 1)) == 0, \
+		     "Ring buffer size must be a power of 2"); \
+	static uint8_t _ring_buffer_data_##name[size8]; \
+	struct ring_buf_spsc name = { \
+		.mask = (size8) - 1, \
+		.buf = _ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Initialize a single producer, single consumer ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param size Ring buffer size (in bytes), a power of 2.
+ * @param data Ring buffer data area (uint8_t data[size]).
+ */
+static inline void ring_buf_spsc_init(struct ring_buf_spsc *buf,
+				      uint32_t size, uint8_t *data)
+{
+	__ASSERT_NO_MSG(is_power_of_two(size));
+
+	buf->head = 0U;
+	buf->tail = 0U;
+	buf->mask = size - 1U;
+	buf->buf = data;
+}
+
+/**
+ * @brief Get the number of bytes stored in a single producer, single
+ * consumer ring buffer.
+ *
+ * The result is exact when called by the producer or the consumer, the
+ * other side only ever makes it more favourable to the caller.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Number of bytes stored.
+ */
+static inline uint32_t ring_buf_spsc_size_get(struct ring_buf_spsc *buf)
+{
+	uint32_t head = __atomic_load_n(&buf->head, __ATOMIC_ACQUIRE);
+
+	return __atomic_load_n(&buf->tail, __ATOMIC_ACQUIRE) - head;
+}
+
+/**
+ * @brief Determine free space in a single producer, single consumer ring
+ * buffer.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Ring buffer free space (in bytes).
+ */
+static inline uint32_t ring_buf_spsc_space_get(struct ring_buf_spsc *buf)
+{
+	return buf->mask + 1U - ring_buf_spsc_size_get(buf);
+}
+
+/**
+ * @brief Allocate buffer for writing data to a single producer, single
+ * consumer ring buffer.
+ *
+ * Only to be called by the producer. Until @ref ring_buf_spsc_put_finish
+ * is called, the area is not visible to the consumer and a new claim
+ * returns the same area.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *		    ring buffer.
+ * @param[in]  size Requested allocation size (in bytes).
+ *
+ * @return Size of allocated buffer which can be smaller than requested if
+ *	   there is not enough free space or buffer wraps.
+ */
+uint32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Make bytes written to the allocated buffer available to the
+ * consumer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param size Number of valid bytes in the allocated buffer.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds free space in the ring buffer.
+ */
+int ring_buf_spsc_put_finish(struct ring_buf_spsc *buf, uint32_t size);
+
+/**
+ * @brief Write (copy) data to a single producer, single consumer ring
+ * buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+uint32_t ring_buf_spsc_put(struct ring_buf_spsc *buf, const uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Get address of valid data in a single producer, single consumer
+ * ring buffer.
+ *
+ * Only to be called by the consumer. Until @ref ring_buf_spsc_get_finish
+ * is called, the area is not released to the producer and a new claim
+ * returns the same area.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *		    ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of valid bytes in the provided buffer which can be smaller
+ *	   than requested if there is not enough data or buffer wraps.
+ */
+uint32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Release bytes read from a single producer, single consumer ring
+ * buffer to the producer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param size Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds valid bytes in the ring buffer.
+ */
+int ring_buf_spsc_get_finish(struct ring_buf_spsc *buf, uint32_t size);
+
+/**
+ * @brief Read data from a single producer, single consumer ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of the output buffer.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written to the output buffer.
+ */
+uint32_t ring_buf_spsc_get(struct ring_buf_spsc *buf, uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief A lock-free multiple producer, single consumer record ring buffer
+ *
+ * Producers, which may be threads, ISRs or other CPUs, reserve room for a
+ * variable length record, fill it in place and commit it. The consumer
+ * gets committed records in the order they were claimed; a record that is
+ * claimed but not committed yet holds back the ones claimed after it.
+ *
+ * Every record takes a 32-bit header, and its data is padded to 32 bits.
+ * A record never wraps, the space left at the end of the buffer is skipped
+ * instead, so records should be kept well below half the buffer size.
+ */
+struct ring_buf_mpsc {
+	atomic_t tail;	/**< Free-running claim index, in 32-bit words */
+	uint32_t head;	/**< Free-running read index, in 32-bit words */
+	uint32_t mask;	/**< Size of buf minus 1, the size is a power of 2 */
+	uint32_t *buf;	/**< Memory region for stored records */
+};
+
+/**
+ * @brief Statically define and initialize a multiple producer, single
+ * consumer ring buffer.
+ *
+ * @param name   Name of the ring buffer.
+ * @param size32 Size of ring buffer (in 32-bit words), a power of 2.
+ */
+#define RING_BUF_MPSC_DECLARE(name, size32) \
+	BUILD_ASSERT(((size32) & ((size32) - 1)) == 0, \
+		     "Ring buffer size must be a power of 2"); \
+	static uint32_t _ring_buffer_data_##name[size32]; \
+	struct ring_buf_mpsc name = { \
+		.mask = (size32) - 1, \
+		.buf = _ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Initialize a multiple producer, single consumer ring buffer.
+ *
+ * @param buf    Address of ring buffer.
+ * @param size32 Ring buffer size (in 32-bit words), a power of 2.
+ * @param data   Ring buffer data area (uint32_t data[size32]).
+ */
+void ring_buf_mpsc_init(struct ring_buf_mpsc *buf, uint32_t size32,
+			uint32_t *data);
+
+/**
+ * @brief Reserve room for a record in a multiple producer, single consumer
+ * ring buffer.
+ *
+ * The record is passed to the consumer once it is filled in and committed
+ * with @ref ring_buf_mpsc_put_commit.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Set to the 32-bit aligned record data area.
+ * @param[in]  size Record size (in bytes).
+ *
+ * @retval 0 Successful operation.
+ * @retval -ENOMEM Ring buffer has insufficient free space.
+ * @retval -EMSGSIZE Record is larger than half the ring buffer.
+ */
+int ring_buf_mpsc_put_claim(struct ring_buf_mpsc *buf, void **data,
+			    uint32_t size);
+
+/**
+ * @brief Commit a record claimed with @ref ring_buf_mpsc_put_claim.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Record data area, as returned by the claim.
+ */
+void ring_buf_mpsc_put_commit(struct ring_buf_mpsc *buf, void *data);
+
+/**
+ * @brief Get the next record of a multiple producer, single consumer
+ * ring buffer.
+ *
+ * Only to be called by the consumer. The record stays in the ring buffer
+ * until @ref ring_buf_mpsc_get_finish is called.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Set to the record data area.
+ *
+ * @return Record size (in bytes), -EAGAIN if no committed record is
+ *	   available.
+ */
+int ring_buf_mpsc_get_claim(struct ring_buf_mpsc *buf, void **data);
+
+/**
+ * @brief Free the record returned by @ref ring_buf_mpsc_get_claim.
+ *
+ * The space of the record is cleared, so that it never holds stale
+ * headers once it is claimed again.
+ *
+ * @param buf Address of ring buffer.
+ */
+void ring_buf_mpsc_get_finish(struct ring_buf_mpsc *buf);
+
 /**
  * @}
  */
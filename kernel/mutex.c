@@ -37,6 +37,7 @@
 #include <debug/object_tracing_common.h>
 #include <tracing/tracing.h>
 #include <sys/check.h>
+#include <sys/mutex.h>
 #include <logging/log.h>
 LOG_MODULE_DECLARE(os);
 
@@ -116,42 +117,15 @@ static bool adjust_owner_prio(struct k_mutex *mutex, int32_t new_prio)
 	return false;
 }
 
-int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
+/* Wait for a mutex owned by another thread, boosting the owner priority
+ * meanwhile. The lock is released.
+ */
+static int pend_on_mutex(struct k_mutex *mutex, k_spinlock_key_t key,
+			 k_timeout_t timeout)
 {
 	int new_prio;
-	k_spinlock_key_t key;
 	bool resched = false;
 
-	__ASSERT(!arch_is_in_isr(), "mutexes cannot be used inside ISRs");
-
-	sys_trace_mutex_lock(mutex);
-	key = k_spin_lock(&lock);
-
-	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
-
-		mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
-					_current->base.prio :
-					mutex->owner_orig_prio;
-
-		mutex->lock_count++;
-		mutex->owner = _current;
-
-		LOG_DBG("%p took mutex %p, count: %d, orig prio: %d",
-			_current, mutex, mutex->lock_count,
-			mutex->owner_orig_prio);
-
-		k_spin_unlock(&lock, key);
-		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
-
-		return 0;
-	}
-
-	if (unlikely(K_TIMEOUT_EQ(timeout, K_NO_WAIT))) {
-		k_spin_unlock(&lock, key);
-		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
-		return -EBUSY;
-	}
-
 	new_prio = new_prio_for_inheritance(_current->base.prio,
 					    mutex->owner->base.prio);
 
@@ -169,7 +143,6 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 		got_mutex ? 'y' : 'n');
 
 	if (got_mutex == 0) {
-		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
 		return 0;
 	}
 
@@ -179,15 +152,19 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 
 	key = k_spin_lock(&lock);
 
-	struct k_thread *waiter = z_waitq_head(&mutex->wait_q);
+	/* The owner may have released the mutex in the meantime */
+	if (mutex->owner != NULL) {
+		struct k_thread *waiter = z_waitq_head(&mutex->wait_q);
 
-	new_prio = (waiter != NULL) ?
-		new_prio_for_inheritance(waiter->base.prio, mutex->owner_orig_prio) :
-		mutex->owner_orig_prio;
+		new_prio = (waiter != NULL) ?
+			new_prio_for_inheritance(waiter->base.prio,
+						 mutex->owner_orig_prio) :
+			mutex->owner_orig_prio;
 
-	LOG_DBG("adjusting prio down on mutex %p", mutex);
+		LOG_DBG("adjusting prio down on mutex %p", mutex);
 
-	resched = adjust_owner_prio(mutex, new_prio) || resched;
+		resched = adjust_owner_prio(mutex, new_prio) || resched;
+	}
 
 	if (resched) {
 		z_reschedule(&lock, key);
@@ -195,10 +172,50 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 		k_spin_unlock(&lock, key);
 	}
 
-	sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
 	return -EAGAIN;
 }
 
+int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	int ret;
+
+	__ASSERT(!arch_is_in_isr(), "mutexes cannot be used inside ISRs");
+
+	sys_trace_mutex_lock(mutex);
+	key = k_spin_lock(&lock);
+
+	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
+
+		mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
+					_current->base.prio :
+					mutex->owner_orig_prio;
+
+		mutex->lock_count++;
+		mutex->owner = _current;
+
+		LOG_DBG("%p took mutex %p, count: %d, orig prio: %d",
+			_current, mutex, mutex->lock_count,
+			mutex->owner_orig_prio);
+
+		k_spin_unlock(&lock, key);
+		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
+
+		return 0;
+	}
+
+	if (unlikely(K_TIMEOUT_EQ(timeout, K_NO_WAIT))) {
+		k_spin_unlock(&lock, key);
+		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
+		return -EBUSY;
+	}
+
+	ret = pend_on_mutex(mutex, key, timeout);
+
+	sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
+	return ret;
+}
+
 #ifdef CONFIG_USERSPACE
 static inline int z_vrfy_k_mutex_lock(struct k_mutex *mutex,
 				      k_timeout_t timeout)
@@ -290,3 +307,238 @@ static inline int z_vrfy_k_mutex_unlock(struct k_mutex *mutex)
 }
 #include <syscalls/k_mutex_unlock_mrsh.c>
 #endif
+
+#ifdef CONFIG_USERSPACE
+/*
+ * Slow paths of sys_mutex, see include/sys/mutex.h.
+ *
+ * The owner word of a sys_mutex is claimed and released with atomic ops in
+ * user mode as long as nobody waits for it. Once a thread has to wait, the
+ * backing k_mutex is locked on behalf of the owner and Z_SYS_MUTEX_CONTENDED
+ * is set in the word, which sends the owner to the kernel when unlocking.
+ * The word is only changed under the mutex spinlock here, but still with
+ * atomic ops since user mode may change it concurrently.
+ *
+ * The word does not hold a thread pointer, which could be forged, but an
+ * owner id derived from the kernel object id of the thread. The kernel
+ * maps it back to the thread it handed the id to, and checks that the
+ * thread still has that id and is alive, which needs no permission on it.
+ * Threads without a kernel object id have no owner id, the kernel tracks
+ * the mutexes they own with a word of only Z_SYS_MUTEX_CONTENDED.
+ */
+
+#define SYS_MUTEX_OWNERS (CONFIG_MAX_THREAD_BYTES * 8)
+
+/* Threads by kernel object id, owner words hold the id plus 1 */
+static struct k_thread *sys_mutex_owners[SYS_MUTEX_OWNERS];
+
+static int thread_obj_id(struct k_thread *thread)
+{
+	struct z_object *ko = z_object_find(thread);
+
+	if (ko == NULL || ko->type != K_OBJ_THREAD ||
+	    (ko->flags & K_OBJ_FLAG_INITIALIZED) == 0U) {
+		return -1;
+	}
+
+	return ko->data.thread_id;
+}
+
+/* Owner word of the thread, 0 if it has no owner id */
+static atomic_val_t owner_word(struct k_thread *thread)
+{
+	int id = thread_obj_id(thread);
+
+	if (id < 0 || id >= SYS_MUTEX_OWNERS) {
+		return 0;
+	}
+
+	sys_mutex_owners[id] = thread;
+
+	return (atomic_val_t)(id + 1) << 1;
+}
+
+/* Live thread the kernel gave the owner word to, or NULL */
+static struct k_thread *word_owner(atomic_val_t word)
+{
+	uintptr_t id = ((uintptr_t)word >> 1) - 1U;
+	struct k_thread *thread;
+
+	if (id >= SYS_MUTEX_OWNERS) {
+		return NULL;
+	}
+
+	/* The entry may be stale, the thread having exited or its object
+	 * having been freed
+	 */
+	thread = sys_mutex_owners[id];
+	if (thread == NULL || thread_obj_id(thread) != (int)id ||
+	    z_is_thread_state_set(thread, _THREAD_DEAD)) {
+		return NULL;
+	}
+
+	return thread;
+}
+
+/* Take a free mutex, the word being 0 or a stale Z_SYS_MUTEX_CONTENDED */
+static bool take_free(struct k_mutex *kernel_mutex, struct sys_mutex *mutex,
+		      atomic_val_t word)
+{
+	atomic_val_t self = owner_word(_current);
+
+	if (!atomic_cas(&mutex->owner, word,
+			self != 0 ? self : Z_SYS_MUTEX_CONTENDED)) {
+		return false;
+	}
+
+	if (self == 0) {
+		kernel_mutex->owner = _current;
+		kernel_mutex->owner_orig_prio = _current->base.prio;
+		kernel_mutex->lock_count = 1U;
+	}
+
+	mutex->lock_count = 1U;
+
+	return true;
+}
+
+int z_sys_mutex_lock_contended(struct k_mutex *kernel_mutex,
+			       struct sys_mutex *mutex, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	atomic_val_t word;
+	struct k_thread *thread;
+
+	__ASSERT(!arch_is_in_isr(), "mutexes cannot be used inside ISRs");
+
+	key = k_spin_lock(&lock);
+
+	for (;;) {
+		word = atomic_get(&mutex->owner);
+
+		/* The kernel tracks the owner, the word may not be trusted */
+		if ((word & Z_SYS_MUTEX_CONTENDED) != 0 &&
+		    kernel_mutex->owner != NULL) {
+			thread = kernel_mutex->owner;
+		} else if ((word & ~Z_SYS_MUTEX_CONTENDED) == 0) {
+			if (take_free(kernel_mutex, mutex, word)) {
+				break;
+			}
+			continue;
+		} else {
+			thread = word_owner(word);
+			if (thread == NULL) {
+				k_spin_unlock(&lock, key);
+				return -EINVAL;
+			}
+		}
+
+		if (thread == _current) {
+			mutex->lock_count++;
+			break;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&lock, key);
+			return -EBUSY;
+		}
+
+		if (kernel_mutex->owner == thread) {
+			return pend_on_mutex(kernel_mutex, key, timeout);
+		}
+
+		if (atomic_cas(&mutex->owner, word,
+			       word | Z_SYS_MUTEX_CONTENDED)) {
+			kernel_mutex->owner = thread;
+			kernel_mutex->owner_orig_prio = thread->base.prio;
+			kernel_mutex->lock_count = 1U;
+
+			return pend_on_mutex(kernel_mutex, key, timeout);
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+	return 0;
+}
+
+int z_sys_mutex_unlock_contended(struct k_mutex *kernel_mutex,
+				 struct sys_mutex *mutex)
+{
+	k_spinlock_key_t key;
+	atomic_val_t word, new_word;
+	struct k_thread *owner, *new_owner;
+
+	__ASSERT(!arch_is_in_isr(), "mutexes cannot be used inside ISRs");
+
+	key = k_spin_lock(&lock);
+
+	word = atomic_get(&mutex->owner);
+
+	if ((word & Z_SYS_MUTEX_CONTENDED) != 0 &&
+	    kernel_mutex->owner != NULL) {
+		owner = kernel_mutex->owner;
+	} else if ((word & ~Z_SYS_MUTEX_CONTENDED) == 0) {
+		k_spin_unlock(&lock, key);
+		return -EINVAL;
+	} else {
+		owner = word_owner(word);
+	}
+
+	if (owner != _current) {
+		k_spin_unlock(&lock, key);
+		return -EPERM;
+	}
+
+	if (mutex->lock_count > 1U) {
+		mutex->lock_count--;
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	mutex->lock_count = 0U;
+
+	if (kernel_mutex->owner != _current) {
+		atomic_clear(&mutex->owner);
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	adjust_owner_prio(kernel_mutex, kernel_mutex->owner_orig_prio);
+
+	/* Hand the mutex over to the first waiter, keeping the kernel in
+	 * charge only if other threads are still waiting, or the waiter has
+	 * no owner id
+	 */
+	new_owner = z_unpend_first_thread(&kernel_mutex->wait_q);
+
+	LOG_DBG("new owner of sys_mutex %p: %p", mutex, new_owner);
+
+	if (new_owner == NULL) {
+		kernel_mutex->owner = NULL;
+		kernel_mutex->lock_count = 0U;
+		atomic_clear(&mutex->owner);
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	arch_thread_return_value_set(new_owner, 0);
+	z_ready_thread(new_owner);
+
+	mutex->lock_count = 1U;
+	new_word = owner_word(new_owner);
+
+	if (new_word == 0 || z_waitq_head(&kernel_mutex->wait_q) != NULL) {
+		kernel_mutex->owner = new_owner;
+		kernel_mutex->owner_orig_prio = new_owner->base.prio;
+		atomic_set(&mutex->owner, new_word | Z_SYS_MUTEX_CONTENDED);
+	} else {
+		kernel_mutex->owner = NULL;
+		kernel_mutex->lock_count = 0U;
+		atomic_set(&mutex->owner, new_word);
+	}
+
+	z_reschedule(&lock, key);
+
+	return 0;
+}
+#endif /* CONFIG_USERSPACE */
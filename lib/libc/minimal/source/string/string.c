@@ -8,8 +8,41 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <sys/types.h>
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+/* 0x01 and 0x80 repeated in every byte of a word */
+#define MEM_WORD_ONES  ((mem_word_t)-1 / 0xff)
+#define MEM_WORD_HIGHS (MEM_WORD_ONES << 7)
+
+/* Non-zero if any byte of the word is zero */
+static inline mem_word_t mem_word_has_zero(mem_word_t w)
+{
+	return (w - MEM_WORD_ONES) & ~w & MEM_WORD_HIGHS;
+}
+
+/*
+ * Build a word out of the bytes at <shift> bits into <lo>, followed by
+ * the first bytes of <hi>, where <lo> and <hi> are consecutive words in
+ * memory.
+ */
+static inline mem_word_t mem_word_merge(mem_word_t lo, mem_word_t hi,
+					unsigned int shift)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	return (lo >> shift) | (hi << (Z_MEM_WORD_T_WIDTH - shift));
+#else
+	return (lo << shift) | (hi >> (Z_MEM_WORD_T_WIDTH - shift));
+#endif
+}
+
+#if defined(CONFIG_X86_64)
+/* Copies/fills from this size up are left to the microcoded string ops */
+#define REP_STRING_MIN 128
+#endif
+#endif /* !CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE */
+
 /**
  *
  * @brief Copy a string
@@ -106,14 +139,39 @@ char *strrchr(const char *s, int c)
 
 size_t strlen(const char *s)
 {
-	size_t n = 0;
+	const char *p = s;
 
-	while (*s != '\0') {
-		s++;
-		n++;
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	const mem_word_t *p_word;
+
+	/* do byte-sized scanning until word-aligned or finished */
+
+	while (((uintptr_t)p) & (sizeof(mem_word_t) - 1)) {
+		if (*p == '\0') {
+			return p - s;
+		}
+		p++;
 	}
 
-	return n;
+	/*
+	 * do word-sized scanning until a word holds the terminator; an
+	 * aligned word never spans past the end of the string's memory
+	 */
+
+	p_word = (const mem_word_t *)p;
+
+	while (!mem_word_has_zero(*p_word)) {
+		p_word++;
+	}
+
+	p = (const char *)p_word;
+#endif
+
+	while (*p != '\0') {
+		p++;
+	}
+
+	return p - s;
 }
 
 /**
@@ -245,6 +303,41 @@ int memcmp(const void *m1, const void *m2, size_t n)
 		return 0;
 	}
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	const uintptr_t mask = sizeof(mem_word_t) - 1;
+
+	/* attempt word-sized comparison only if identically aligned */
+
+	if ((((uintptr_t)c1 ^ (uintptr_t)c2) & mask) == 0) {
+		while ((n >= sizeof(mem_word_t)) && (((uintptr_t)c1) & mask) &&
+		       (*c1 == *c2)) {
+			c1++;
+			c2++;
+			n--;
+		}
+
+		if ((((uintptr_t)c1) & mask) == 0) {
+			const mem_word_t *w1 = (const mem_word_t *)c1;
+			const mem_word_t *w2 = (const mem_word_t *)c2;
+
+			/* skip equal words, the bytes tell the difference */
+
+			while ((n >= sizeof(mem_word_t)) && (*w1 == *w2)) {
+				w1++;
+				w2++;
+				n -= sizeof(mem_word_t);
+			}
+
+			if (!n) {
+				return 0;
+			}
+
+			c1 = (const char *)w1;
+			c2 = (const char *)w2;
+		}
+	}
+#endif
+
 	while ((--n > 0) && (*c1 == *c2)) {
 		c1++;
 		c2++;
@@ -264,6 +357,11 @@ void *memmove(void *d, const void *s, size_t n)
 {
 	char *dest = d;
 	const char *src  = s;
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	const uintptr_t mask = sizeof(mem_word_t) - 1;
+	/* attempt word-sized copying only if buffers have identical alignment */
+	bool word_copy = (((uintptr_t)dest ^ (uintptr_t)src) & mask) == 0;
+#endif
 
 	if ((size_t) (dest - src) < n) {
 		/*
@@ -271,12 +369,45 @@ void *memmove(void *d, const void *s, size_t n)
 		 * Copy backwards to prevent the premature corruption of <src>.
 		 */
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+		if (word_copy) {
+			while ((n > 0) && (((uintptr_t)(dest + n)) & mask)) {
+				n--;
+				dest[n] = src[n];
+			}
+
+			while (n >= sizeof(mem_word_t)) {
+				n -= sizeof(mem_word_t);
+				*(mem_word_t *)(dest + n) =
+					*(const mem_word_t *)(src + n);
+			}
+		}
+#endif
+
 		while (n > 0) {
 			n--;
 			dest[n] = src[n];
 		}
 	} else {
 		/* It is safe to perform a forward-copy */
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+		if (word_copy) {
+			while ((n > 0) && (((uintptr_t)dest) & mask)) {
+				*dest = *src;
+				dest++;
+				src++;
+				n--;
+			}
+
+			while (n >= sizeof(mem_word_t)) {
+				*(mem_word_t *)dest = *(const mem_word_t *)src;
+				dest += sizeof(mem_word_t);
+				src += sizeof(mem_word_t);
+				n -= sizeof(mem_word_t);
+			}
+		}
+#endif
+
 		while (n > 0) {
 			*dest = *src;
 			dest++;
@@ -303,6 +434,16 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 	const unsigned char *s_byte = (const unsigned char *)s;
 	const uintptr_t mask = sizeof(mem_word_t) - 1;
 
+#if defined(REP_STRING_MIN)
+	if (n >= REP_STRING_MIN) {
+		__asm__ volatile ("rep movsb"
+				  : "+D" (d_byte), "+S" (s_byte), "+c" (n)
+				  :
+				  : "memory");
+		return d;
+	}
+#endif
+
 	if ((((uintptr_t)d ^ (uintptr_t)s_byte) & mask) == 0) {
 
 		/* do byte-sized copying until word-aligned or finished */
@@ -320,6 +461,25 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 		mem_word_t *d_word = (mem_word_t *)d_byte;
 		const mem_word_t *s_word = (const mem_word_t *)s_byte;
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+		/* unrolled, for load/store multiple and fewer branches */
+
+		while (n >= 4 * sizeof(mem_word_t)) {
+			mem_word_t w0 = s_word[0];
+			mem_word_t w1 = s_word[1];
+			mem_word_t w2 = s_word[2];
+			mem_word_t w3 = s_word[3];
+
+			d_word[0] = w0;
+			d_word[1] = w1;
+			d_word[2] = w2;
+			d_word[3] = w3;
+			d_word += 4;
+			s_word += 4;
+			n -= 4 * sizeof(mem_word_t);
+		}
+#endif
+
 		while (n >= sizeof(mem_word_t)) {
 			*(d_word++) = *(s_word++);
 			n -= sizeof(mem_word_t);
@@ -329,6 +489,43 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 		s_byte = (unsigned char *)s_word;
 	}
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	/* otherwise, merge shifted source words if worth it */
+
+	if (((((uintptr_t)d_byte ^ (uintptr_t)s_byte) & mask) != 0) &&
+	    (n >= 2 * sizeof(mem_word_t))) {
+
+		/* do byte-sized copying until destination is word-aligned */
+
+		while (((uintptr_t)d_byte) & mask) {
+			*(d_byte++) = *(s_byte++);
+			n--;
+		}
+
+		/*
+		 * do word-sized copying from aligned source words, each
+		 * destination word merged from two of them
+		 */
+
+		unsigned int shift = ((uintptr_t)s_byte & mask) * 8U;
+		mem_word_t *d_word = (mem_word_t *)d_byte;
+		const mem_word_t *s_word =
+			(const mem_word_t *)((uintptr_t)s_byte & ~mask);
+		mem_word_t lo = *(s_word++);
+
+		while (n >= sizeof(mem_word_t)) {
+			mem_word_t hi = *(s_word++);
+
+			*(d_word++) = mem_word_merge(lo, hi, shift);
+			lo = hi;
+			s_byte += sizeof(mem_word_t);
+			n -= sizeof(mem_word_t);
+		}
+
+		d_byte = (unsigned char *)d_word;
+	}
+#endif
+
 	/* do byte-sized copying until finished */
 
 	while (n > 0) {
@@ -353,6 +550,16 @@ void *memset(void *buf, int c, size_t n)
 	unsigned char *d_byte = (unsigned char *)buf;
 	unsigned char c_byte = (unsigned char)c;
 
+#if defined(REP_STRING_MIN)
+	if (n >= REP_STRING_MIN) {
+		__asm__ volatile ("rep stosb"
+				  : "+D" (d_byte), "+c" (n)
+				  : "a" (c_byte)
+				  : "memory");
+		return buf;
+	}
+#endif
+
 	while (((uintptr_t)d_byte) & (sizeof(mem_word_t) - 1)) {
 		if (n == 0) {
 			return buf;
@@ -398,9 +605,34 @@ void *memset(void *buf, int c, size_t n)
 
 void *memchr(const void *s, int c, size_t n)
 {
-	if (n != 0) {
-		const unsigned char *p = s;
+	const unsigned char *p = s;
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE)
+	/* do byte-sized scanning until word-aligned or finished */
+
+	while ((n != 0) && (((uintptr_t)p) & (sizeof(mem_word_t) - 1))) {
+		if (*p == (unsigned char)c) {
+			return (void *)p;
+		}
+		p++;
+		n--;
+	}
+
+	/* do word-sized scanning until a word holds the byte */
+
+	const mem_word_t *p_word = (const mem_word_t *)p;
+	mem_word_t c_word = MEM_WORD_ONES * (unsigned char)c;
+
+	while ((n >= sizeof(mem_word_t)) &&
+	       !mem_word_has_zero(*p_word ^ c_word)) {
+		p_word++;
+		n -= sizeof(mem_word_t);
+	}
+
+	p = (const unsigned char *)p_word;
+#endif
+
+	if (n != 0) {
 		do {
 			if (*p++ == (unsigned char)c) {
 				return ((void *)(p - 1));
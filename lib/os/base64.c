@@ -23,8 +23,11 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <errno.h>
+#include <toolchain.h>
 #include <sys/base64.h>
+#include <sys/byteorder.h>
 
 static const uint8_t base64_enc_map[64] = {
 	'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J',
@@ -54,6 +57,60 @@ static const uint8_t base64_dec_map[128] = {
 
 #define BASE64_SIZE_T_MAX	((size_t) -1) /* SIZE_T_MAX is not standard */
 
+/*
+ * Encode blocks of 3 bytes, with one 32-bit store per block and, but for
+ * the last block, one 32-bit load.
+ */
+static void encode_blocks(uint8_t *dst, const uint8_t *src, size_t blocks)
+{
+	uint32_t x, w;
+
+	while (blocks--) {
+		if (blocks) {
+			x = UNALIGNED_GET((uint32_t *)src);
+			x = sys_be32_to_cpu(x) >> 8;
+		} else {
+			x = sys_get_be24(src);
+		}
+
+		w = base64_enc_map[x >> 18] |
+		    base64_enc_map[(x >> 12) & 0x3F] << 8 |
+		    base64_enc_map[(x >> 6) & 0x3F] << 16 |
+		    base64_enc_map[x & 0x3F] << 24;
+		UNALIGNED_PUT(sys_cpu_to_le32(w), (uint32_t *)dst);
+
+		src += 3;
+		dst += 4;
+	}
+}
+
+/*
+ * Decode 4 characters of the base64 alphabet, no padding nor white space,
+ * into 24 bits. This is the common case, checked for with a single test.
+ */
+static inline bool decode_quad(const uint8_t *src, uint32_t *x)
+{
+	uint32_t d0, d1, d2, d3;
+
+	if (UNALIGNED_GET((uint32_t *)src) & 0x80808080U) {
+		return false;
+	}
+
+	d0 = base64_dec_map[src[0]];
+	d1 = base64_dec_map[src[1]];
+	d2 = base64_dec_map[src[2]];
+	d3 = base64_dec_map[src[3]];
+
+	/* Padding and invalid characters map to 64 and 127 */
+	if ((d0 | d1 | d2 | d3) & 0x40) {
+		return false;
+	}
+
+	*x = d0 << 18 | d1 << 12 | d2 << 6 | d3;
+
+	return true;
+}
+
 /*
  * Encode a buffer into base64 format
  */
@@ -61,7 +118,7 @@ int base64_encode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 		  size_t slen)
 {
 	size_t i, n;
-	int C1, C2, C3;
+	int C1, C2;
 	uint8_t *p;
 
 	if (slen == 0) {
@@ -83,18 +140,12 @@ int base64_encode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 		return -ENOMEM;
 	}
 
-	n = (slen / 3) * 3;
+	n = slen / 3;
 
-	for (i = 0, p = dst; i < n; i += 3) {
-		C1 = *src++;
-		C2 = *src++;
-		C3 = *src++;
-
-		*p++ = base64_enc_map[(C1 >> 2) & 0x3F];
-		*p++ = base64_enc_map[(((C1 &  3) << 4) + (C2 >> 4)) & 0x3F];
-		*p++ = base64_enc_map[(((C2 & 15) << 2) + (C3 >> 6)) & 0x3F];
-		*p++ = base64_enc_map[C3 & 0x3F];
-	}
+	encode_blocks(dst, src, n);
+	src += n * 3;
+	p = dst + n * 4;
+	i = n * 3;
 
 	if (i < slen) {
 		C1 = *src++;
@@ -130,6 +181,12 @@ int base64_decode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 
 	/* First pass: check for validity and get output length */
 	for (i = n = j = 0U; i < slen; i++) {
+		/* Skip runs of plain characters, leaving one to the checks */
+		while (j == 0U && slen - i > 4 && decode_quad(&src[i], &x)) {
+			i += 4;
+			n += 4;
+		}
+
 		/* Skip spaces before checking for EOL */
 		x = 0U;
 		while (i < slen && src[i] == ' ') {
@@ -188,6 +245,13 @@ int base64_decode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 	}
 
 	for (j = 3U, n = x = 0U, p = dst; i > 0; i--, src++) {
+		/* Decode runs of plain characters, leaving one to the loop */
+		while (n == 0U && i > 4 && decode_quad(src, &x)) {
+			sys_put_be24(x, p);
+			p += 3;
+			src += 4;
+			i -= 4;
+		}
 
 		if (*src == '\r' || *src == '\n' || *src == ' ') {
 			continue;
@@ -214,3 +278,158 @@ int base64_decode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 
 	return 0;
 }
+
+void base64_stream_init(struct base64_stream *stream)
+{
+	stream->acc = 0U;
+	stream->len = 0U;
+	stream->pad = 0U;
+	stream->end = false;
+}
+
+int base64_encode_update(struct base64_stream *stream, uint8_t *dst,
+			 size_t dlen, size_t *olen, const uint8_t *src,
+			 size_t slen)
+{
+	size_t n = (stream->len + slen) / 3;
+	uint8_t *p = dst;
+
+	if (n > BASE64_SIZE_T_MAX / 4) {
+		*olen = BASE64_SIZE_T_MAX;
+		return -ENOMEM;
+	}
+
+	if (n * 4 > dlen || (n && !dst)) {
+		*olen = n * 4;
+		return -ENOMEM;
+	}
+
+	/* Complete the pending block */
+	while (stream->len > 0U && slen > 0U) {
+		stream->acc = (stream->acc << 8) | *src++;
+		slen--;
+
+		if (++stream->len == 3U) {
+			uint8_t block[3];
+
+			sys_put_be24(stream->acc, block);
+			encode_blocks(p, block, 1);
+			p += 4;
+			stream->len = 0U;
+		}
+	}
+
+	n = slen / 3;
+	encode_blocks(p, src, n);
+	p += n * 4;
+	src += n * 3;
+	slen -= n * 3;
+
+	while (slen--) {
+		stream->acc = (stream->acc << 8) | *src++;
+		stream->len++;
+	}
+
+	*olen = p - dst;
+
+	return 0;
+}
+
+int base64_encode_finish(struct base64_stream *stream, uint8_t *dst,
+			 size_t dlen, size_t *olen)
+{
+	uint32_t x;
+
+	if (stream->len == 0U) {
+		*olen = 0;
+		return 0;
+	}
+
+	if (dlen < 4 || !dst) {
+		*olen = 4;
+		return -ENOMEM;
+	}
+
+	x = stream->acc << (8 * (3 - stream->len));
+
+	dst[0] = base64_enc_map[(x >> 18) & 0x3F];
+	dst[1] = base64_enc_map[(x >> 12) & 0x3F];
+	dst[2] = stream->len == 2U ? base64_enc_map[(x >> 6) & 0x3F] : '=';
+	dst[3] = '=';
+
+	base64_stream_init(stream);
+	*olen = 4;
+
+	return 0;
+}
+
+int base64_decode_update(struct base64_stream *stream, uint8_t *dst,
+			 size_t dlen, size_t *olen, const uint8_t *src,
+			 size_t slen)
+{
+	size_t n = (stream->len + slen) / 4;
+	uint8_t *p = dst;
+	uint32_t x;
+
+	if (n * 3 > dlen || (n && !dst)) {
+		*olen = n * 3;
+		return -ENOMEM;
+	}
+
+	for (; slen > 0; slen--, src++) {
+		while (stream->len == 0U && !stream->end && slen > 4 &&
+		       decode_quad(src, &x)) {
+			sys_put_be24(x, p);
+			p += 3;
+			src += 4;
+			slen -= 4;
+		}
+
+		if (*src == '\r' || *src == '\n') {
+			continue;
+		}
+
+		if (stream->end || *src > 127 ||
+		    base64_dec_map[*src] == 127U) {
+			goto invalid;
+		}
+
+		if (*src == '=') {
+			/* At most 2 padding characters, ending a block */
+			if (stream->len < 2U) {
+				goto invalid;
+			}
+			stream->pad++;
+		} else if (stream->pad) {
+			goto invalid;
+		}
+
+		stream->acc = (stream->acc << 6) |
+			      (base64_dec_map[*src] & 0x3F);
+
+		if (++stream->len == 4U) {
+			sys_put_be24(stream->acc, p);
+			p += 3 - stream->pad;
+			stream->end = stream->pad != 0U;
+			stream->len = 0U;
+		}
+	}
+
+	*olen = p - dst;
+
+	return 0;
+
+invalid:
+	*olen = p - dst;
+
+	return -EINVAL;
+}
+
+int base64_decode_finish(struct base64_stream *stream)
+{
+	int err = stream->len ? -EINVAL : 0;
+
+	base64_stream_init(stream);
+
+	return err;
+}
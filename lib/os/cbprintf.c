@@ -0,0 +1,584 @@
+/*
+ * Copyright (c) 2010, 2013-2014 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Formatted output to a callback
+ *
+ * Formatter behind printk() and snprintk(). Literal runs of the format
+ * string, converted values and padding are each handed to the output
+ * callback in one call, so that the cost of the callback is paid per span
+ * rather than per character.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/cbprintf.h>
+#include <sys/types.h>
+#include <sys/util.h>
+
+enum pad_type {
+	PAD_NONE,
+	PAD_ZERO_BEFORE,
+	PAD_SPACE_BEFORE,
+	PAD_SPACE_AFTER,
+};
+
+#ifdef CONFIG_PRINTK64
+typedef uint64_t printk_val_t;
+#else
+typedef uint32_t printk_val_t;
+#endif
+
+/* Maximum number of digits in a printed decimal value (hex is always
+ * less, obviously).  Funny formula produces 10 max digits for 32 bit,
+ * 21 for 64.
+ */
+#define DIGITS_BUFLEN (11U * (sizeof(printk_val_t) / 4U) - 1U)
+
+struct conversion {
+	enum pad_type padding;
+	int min_width;
+	char length_mod;
+	char specifier;
+};
+
+enum arg_type {
+	ARG_NONE,
+	ARG_INT,
+	ARG_LONG,
+	ARG_LLONG,
+	ARG_SIZE,
+	ARG_PTR,
+	ARG_STR,
+};
+
+union arg {
+	int i;
+	long l;
+	long long ll;
+	ssize_t z;
+	void *p;
+	const char *s;
+};
+
+/* Where arguments come from: a va_list, or a package */
+struct args {
+	va_list ap;
+	const uint8_t *pkg;
+	size_t pos;
+};
+
+struct out {
+	cbprintf_cb cb;
+	void *ctx;
+	int count;
+};
+
+/* Header of a package, followed by the arguments in order, unaligned */
+struct package_hdr {
+	const char *fmt;
+	uint32_t len;
+};
+
+static int emit(struct out *out, const char *str, size_t len)
+{
+	int ret;
+
+	if (len == 0U) {
+		return 0;
+	}
+
+	ret = out->cb(str, len, out->ctx);
+	if (ret < 0) {
+		return ret;
+	}
+
+	out->count += len;
+
+	return 0;
+}
+
+static int emit_pad(struct out *out, char pad_char, int n)
+{
+	static const char spaces[] = "                ";
+	static const char zeros[] = "0000000000000000";
+	const char *pad = (pad_char == '0') ? zeros : spaces;
+	int ret = 0;
+
+	while (n > 0 && ret == 0) {
+		int len = MIN(n, (int)sizeof(spaces) - 1);
+
+		ret = emit(out, pad, len);
+		n -= len;
+	}
+
+	return ret;
+}
+
+static int print_digits(struct out *out, printk_val_t num, unsigned int base,
+			bool pad_before, char pad_char, int min_width)
+{
+	char buf[DIGITS_BUFLEN];
+	unsigned int i;
+	int pad;
+	int ret;
+
+	/* Print it backwards into the end of the buffer, low digits first */
+	for (i = DIGITS_BUFLEN - 1U; num != 0U; i--) {
+		buf[i] = "0123456789abcdef"[num % base];
+		num /= base;
+	}
+
+	if (i == DIGITS_BUFLEN - 1U) {
+		buf[i] = '0';
+	} else {
+		i++;
+	}
+
+	pad = MAX(min_width - (int)(DIGITS_BUFLEN - i), 0);
+
+	if (pad_before) {
+		ret = emit_pad(out, pad_char, pad);
+		if (ret < 0) {
+			return ret;
+		}
+		pad = 0;
+	}
+
+	ret = emit(out, &buf[i], DIGITS_BUFLEN - i);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return emit_pad(out, pad_char, pad);
+}
+
+static int print_num(struct out *out, printk_val_t num, unsigned int base,
+		     const struct conversion *conv)
+{
+	return print_digits(out, num, base, conv->padding != PAD_SPACE_AFTER,
+			    conv->padding == PAD_ZERO_BEFORE ? '0' : ' ',
+			    conv->min_width);
+}
+
+static bool negative(printk_val_t val)
+{
+	const printk_val_t hibit = ~(((printk_val_t) ~1) >> 1U);
+
+	return (val & hibit) != 0U;
+}
+
+/*
+ * Parse the conversion following a '%'. An invalid sequence of length
+ * modifiers ends the conversion, with the last modifier as specifier.
+ */
+static const char *parse_conversion(const char *fmt, struct conversion *conv)
+{
+	conv->padding = PAD_NONE;
+	conv->min_width = -1;
+	conv->length_mod = 0;
+
+	for (;; fmt++) {
+		switch (*fmt) {
+		case '\0':
+			conv->specifier = '\0';
+			return fmt;
+		case '-':
+			conv->padding = PAD_SPACE_AFTER;
+			continue;
+		case '0':
+			if (conv->min_width < 0 && conv->padding == PAD_NONE) {
+				conv->padding = PAD_ZERO_BEFORE;
+				continue;
+			}
+			__fallthrough;
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6':
+		case '7':
+		case '8':
+		case '9':
+			if (conv->min_width < 0) {
+				conv->min_width = *fmt - '0';
+			} else {
+				conv->min_width = 10 * conv->min_width +
+						  *fmt - '0';
+			}
+
+			if (conv->padding == PAD_NONE) {
+				conv->padding = PAD_SPACE_BEFORE;
+			}
+			continue;
+		case 'h':
+		case 'l':
+		case 'z':
+			if (*fmt == 'h' && conv->length_mod == 'h') {
+				conv->length_mod = 'H';
+			} else if (*fmt == 'l' && conv->length_mod == 'l') {
+				conv->length_mod = 'L';
+			} else if (conv->length_mod == 0) {
+				conv->length_mod = *fmt;
+			} else {
+				break;
+			}
+			continue;
+		default:
+			break;
+		}
+
+		conv->specifier = *fmt;
+		return fmt + 1;
+	}
+}
+
+static enum arg_type arg_type(const struct conversion *conv)
+{
+	switch (conv->specifier) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'x':
+	case 'X':
+		switch (conv->length_mod) {
+		case 'z':
+			return ARG_SIZE;
+		case 'l':
+			return ARG_LONG;
+		case 'L':
+			return ARG_LLONG;
+		default:
+			return ARG_INT;
+		}
+	case 'c':
+		return ARG_INT;
+	case 'p':
+		return ARG_PTR;
+	case 's':
+		return ARG_STR;
+	default:
+		return ARG_NONE;
+	}
+}
+
+static size_t arg_size(enum arg_type type)
+{
+	switch (type) {
+	case ARG_INT:
+		return sizeof(int);
+	case ARG_LONG:
+		return sizeof(long);
+	case ARG_LLONG:
+		return sizeof(long long);
+	case ARG_SIZE:
+		return sizeof(ssize_t);
+	case ARG_PTR:
+		return sizeof(void *);
+	default:
+		return 0;
+	}
+}
+
+static void arg_get(struct args *args, enum arg_type type, union arg *arg)
+{
+	if (args->pkg) {
+		const uint8_t *pos = &args->pkg[args->pos];
+
+		/* Strings are stored in place, with their terminator */
+		if (type == ARG_STR) {
+			arg->s = (const char *)pos;
+			args->pos += strlen(arg->s) + 1;
+		} else {
+			memcpy(arg, pos, arg_size(type));
+			args->pos += arg_size(type);
+		}
+
+		return;
+	}
+
+	switch (type) {
+	case ARG_INT:
+		arg->i = va_arg(args->ap, int);
+		break;
+	case ARG_LONG:
+		arg->l = va_arg(args->ap, long);
+		break;
+	case ARG_LLONG:
+		arg->ll = va_arg(args->ap, long long);
+		break;
+	case ARG_SIZE:
+		arg->z = va_arg(args->ap, ssize_t);
+		break;
+	case ARG_PTR:
+		arg->p = va_arg(args->ap, void *);
+		break;
+	case ARG_STR:
+		arg->s = va_arg(args->ap, const char *);
+		break;
+	default:
+		break;
+	}
+}
+
+static int print_conversion(struct out *out, struct conversion *conv,
+			    enum arg_type type, const union arg *arg)
+{
+	printk_val_t val;
+	int ret;
+
+	switch (conv->specifier) {
+	case 'd':
+	case 'i':
+	case 'u':
+		if (type == ARG_SIZE) {
+			val = arg->z;
+		} else if (type == ARG_LONG) {
+			val = arg->l;
+		} else if (type == ARG_LLONG) {
+			if (sizeof(printk_val_t) < 8U &&
+			    arg->ll != (long)arg->ll) {
+				return emit(out, "ERR", 3);
+			}
+			val = (printk_val_t)arg->ll;
+		} else if (conv->specifier == 'u') {
+			val = (unsigned int)arg->i;
+		} else {
+			val = arg->i;
+		}
+
+		if (conv->specifier != 'u' && negative(val)) {
+			ret = emit(out, "-", 1);
+			if (ret < 0) {
+				return ret;
+			}
+			val = -val;
+			conv->min_width--;
+		}
+
+		return print_num(out, val, 10U, conv);
+	case 'p':
+		ret = emit(out, "0x", 2);
+		if (ret < 0) {
+			return ret;
+		}
+
+		/* left-pad pointers with zeros */
+		conv->padding = PAD_ZERO_BEFORE;
+		conv->min_width = sizeof(void *) * 2U;
+
+		return print_num(out, (uintptr_t)arg->p, 16U, conv);
+	case 'x':
+	case 'X':
+		if (type == ARG_SIZE) {
+			val = (size_t)arg->z;
+		} else if (type == ARG_LONG) {
+			val = (unsigned long)arg->l;
+		} else if (type == ARG_LLONG) {
+			val = (unsigned long long)arg->ll;
+		} else {
+			val = (unsigned int)arg->i;
+		}
+
+		return print_num(out, val, 16U, conv);
+	case 's': {
+		size_t len = strlen(arg->s);
+
+		ret = emit(out, arg->s, len);
+		if (ret < 0 || conv->padding != PAD_SPACE_AFTER) {
+			return ret;
+		}
+
+		return emit_pad(out, ' ', conv->min_width - (int)len);
+	}
+	case 'c': {
+		char c = arg->i;
+
+		return emit(out, &c, 1);
+	}
+	case '%':
+		return emit(out, "%", 1);
+	default: {
+		char unknown[2] = { '%', conv->specifier };
+
+		return emit(out, unknown, 2);
+	}
+	}
+}
+
+static int format_args(struct out *out, const char *fmt, struct args *args)
+{
+	struct conversion conv;
+	enum arg_type type;
+	union arg arg;
+	int ret;
+
+	while (*fmt) {
+		const char *run = fmt;
+
+		/* Literal run up to the next conversion */
+		while (*fmt && *fmt != '%') {
+			fmt++;
+		}
+
+		ret = emit(out, run, fmt - run);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (*fmt == '\0') {
+			break;
+		}
+
+		fmt = parse_conversion(fmt + 1, &conv);
+		if (conv.specifier == '\0') {
+			break;
+		}
+
+		type = arg_type(&conv);
+		arg_get(args, type, &arg);
+
+		ret = print_conversion(out, &conv, type, &arg);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return out->count;
+}
+
+int cbvprintf(cbprintf_cb out, void *ctx, const char *fmt, va_list ap)
+{
+	struct out o = { .cb = out, .ctx = ctx };
+	struct args args = { .pkg = NULL };
+	int ret;
+
+	va_copy(args.ap, ap);
+	ret = format_args(&o, fmt, &args);
+	va_end(args.ap);
+
+	return ret;
+}
+
+int cbprintf(cbprintf_cb out, void *ctx, const char *fmt, ...)
+{
+	va_list ap;
+	int ret;
+
+	va_start(ap, fmt);
+	ret = cbvprintf(out, ctx, fmt, ap);
+	va_end(ap);
+
+	return ret;
+}
+
+static void package_add(uint8_t *packaged, size_t len, size_t *pos,
+			const void *data, size_t size)
+{
+	if (packaged && *pos + size <= len) {
+		memcpy(&packaged[*pos], data, size);
+	}
+
+	*pos += size;
+}
+
+int cbvprintf_package(void *packaged, size_t len, const char *fmt,
+		      va_list ap)
+{
+	struct package_hdr hdr = { .fmt = fmt };
+	struct conversion conv;
+	size_t pos = sizeof(hdr);
+	enum arg_type type;
+	union arg arg;
+	va_list aq;
+
+	va_copy(aq, ap);
+
+	while (*fmt) {
+		if (*fmt++ != '%') {
+			continue;
+		}
+
+		fmt = parse_conversion(fmt, &conv);
+		type = arg_type(&conv);
+
+		switch (type) {
+		case ARG_NONE:
+			continue;
+		case ARG_STR:
+			arg.s = va_arg(aq, const char *);
+			package_add(packaged, len, &pos, arg.s,
+				    strlen(arg.s) + 1);
+			continue;
+		case ARG_INT:
+			arg.i = va_arg(aq, int);
+			break;
+		case ARG_LONG:
+			arg.l = va_arg(aq, long);
+			break;
+		case ARG_LLONG:
+			arg.ll = va_arg(aq, long long);
+			break;
+		case ARG_SIZE:
+			arg.z = va_arg(aq, ssize_t);
+			break;
+		case ARG_PTR:
+			arg.p = va_arg(aq, void *);
+			break;
+		}
+
+		package_add(packaged, len, &pos, &arg, arg_size(type));
+	}
+
+	va_end(aq);
+
+	if (packaged) {
+		if (pos > len) {
+			return -ENOSPC;
+		}
+
+		hdr.len = pos;
+		memcpy(packaged, &hdr, sizeof(hdr));
+	}
+
+	return pos;
+}
+
+int cbprintf_package(void *packaged, size_t len, const char *fmt, ...)
+{
+	va_list ap;
+	int ret;
+
+	va_start(ap, fmt);
+	ret = cbvprintf_package(packaged, len, fmt, ap);
+	va_end(ap);
+
+	return ret;
+}
+
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged)
+{
+	struct out o = { .cb = out, .ctx = ctx };
+	struct args args = { .pkg = packaged, .pos = sizeof(struct package_hdr) };
+	struct package_hdr hdr;
+
+	memcpy(&hdr, packaged, sizeof(hdr));
+
+	return format_args(&o, hdr.fmt, &args);
+}
+
+size_t cbprintf_package_len(const void *packaged)
+{
+	struct package_hdr hdr;
+
+	memcpy(&hdr, packaged, sizeof(hdr));
+
+	return hdr.len;
+}
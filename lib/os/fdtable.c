@@ -54,11 +54,41 @@ static struct fd_entry fdtable[CONFIG_POSIX_MAX_FDS] = {
 #endif
 };
 
-static K_MUTEX_DEFINE(fdtable_lock);
+/*
+ * Bitmap of allocated entries, so that z_reserve_fd() finds a free one with
+ * a bit scan and claims it with a CAS instead of taking a lock.
+ */
+static atomic_t fd_used[1 + (CONFIG_POSIX_MAX_FDS - 1) / ATOMIC_BITS] = {
+#ifdef CONFIG_POSIX_API
+	/* stdin, stdout and stderr */
+	BIT_MASK(3),
+#endif
+};
+
+/*
+ * Set in the reference count of an entry once it is freed by its owner.
+ * References still held by z_get_fd_ref() callers keep it allocated, but
+ * no new lookup succeeds.
+ */
+#define FD_CLOSED BIT(30)
+
+static inline bool fd_is_open(atomic_val_t rc)
+{
+	return rc != 0 && !(rc & FD_CLOSED);
+}
 
-static int z_fd_ref(int fd)
+static bool z_fd_ref(int fd)
 {
-	return atomic_inc(&fdtable[fd].refcount) + 1;
+	atomic_val_t old_rc;
+
+	do {
+		old_rc = atomic_get(&fdtable[fd].refcount);
+		if (!fd_is_open(old_rc)) {
+			return false;
+		}
+	} while (!atomic_cas(&fdtable[fd].refcount, old_rc, old_rc + 1));
+
+	return true;
 }
 
 static int z_fd_unref(int fd)
@@ -72,28 +102,41 @@ static int z_fd_unref(int fd)
 	 */
 	do {
 		old_rc = atomic_get(&fdtable[fd].refcount);
-		if (!old_rc) {
+		if (!(old_rc & ~FD_CLOSED)) {
 			return 0;
 		}
 	} while (!atomic_cas(&fdtable[fd].refcount, old_rc, old_rc - 1));
 
-	if (old_rc != 1) {
-		return old_rc - 1;
+	if ((old_rc & ~FD_CLOSED) != 1) {
+		return (old_rc & ~FD_CLOSED) - 1;
 	}
 
 	fdtable[fd].obj = NULL;
 	fdtable[fd].vtable = NULL;
+	atomic_set(&fdtable[fd].refcount, 0);
+	atomic_clear_bit(fd_used, fd);
 
 	return 0;
 }
 
 static int _find_fd_entry(void)
 {
-	int fd;
+	for (int i = 0; i < ARRAY_SIZE(fd_used); i++) {
+		atomic_val_t used = atomic_get(&fd_used[i]);
+		int bit;
+
+		while ((bit = find_lsb_set(~(uint32_t)used)) != 0) {
+			int fd = i * ATOMIC_BITS + bit - 1;
+
+			if (fd >= ARRAY_SIZE(fdtable)) {
+				break;
+			}
+
+			if (atomic_cas(&fd_used[i], used, used | BIT(bit - 1))) {
+				return fd;
+			}
 
-	for (fd = 0; fd < ARRAY_SIZE(fdtable); fd++) {
-		if (!atomic_get(&fdtable[fd].refcount)) {
-			return fd;
+			used = atomic_get(&fd_used[i]);
 		}
 	}
 
@@ -110,7 +153,7 @@ static int _check_fd(int fd)
 
 	fd = k_array_index_sanitize(fd, ARRAY_SIZE(fdtable));
 
-	if (!atomic_get(&fdtable[fd].refcount)) {
+	if (!fd_is_open(atomic_get(&fdtable[fd].refcount))) {
 		errno = EBADF;
 		return -1;
 	}
@@ -150,22 +193,52 @@ void *z_get_fd_obj_and_vtable(int fd, const struct fd_op_vtable **vtable)
 	return fd_entry->obj;
 }
 
+int z_get_fd_ref(int fd, void **obj, const struct fd_op_vtable **vtable)
+{
+	if (fd < 0 || fd >= ARRAY_SIZE(fdtable)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	fd = k_array_index_sanitize(fd, ARRAY_SIZE(fdtable));
+
+	if (!z_fd_ref(fd)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	/* Pairs with the release in z_finalize_fd(), obj is set first. */
+	*vtable = __atomic_load_n(&fdtable[fd].vtable, __ATOMIC_ACQUIRE);
+	if (*vtable == NULL) {
+		/* Reserved, but not finalized yet */
+		(void)z_fd_unref(fd);
+		errno = EBADF;
+		return -1;
+	}
+
+	*obj = fdtable[fd].obj;
+
+	return 0;
+}
+
+void z_put_fd_ref(int fd)
+{
+	/* Assumes fd was already bounds-checked. */
+	(void)z_fd_unref(fd);
+}
+
 int z_reserve_fd(void)
 {
 	int fd;
 
-	(void)k_mutex_lock(&fdtable_lock, K_FOREVER);
-
 	fd = _find_fd_entry();
 	if (fd >= 0) {
 		/* Mark entry as used, z_finalize_fd() will fill it in. */
-		(void)z_fd_ref(fd);
 		fdtable[fd].obj = NULL;
 		fdtable[fd].vtable = NULL;
+		atomic_set(&fdtable[fd].refcount, 1);
 	}
 
-	k_mutex_unlock(&fdtable_lock);
-
 	return fd;
 }
 
@@ -183,15 +256,59 @@ void z_finalize_fd(int fd, void *obj, const struct fd_op_vtable *vtable)
 	z_object_recycle(obj);
 #endif
 	fdtable[fd].obj = obj;
-	fdtable[fd].vtable = vtable;
+	__atomic_store_n(&fdtable[fd].vtable, vtable, __ATOMIC_RELEASE);
 }
 
 void z_free_fd(int fd)
 {
-	/* Assumes fd was already bounds-checked. */
+	atomic_val_t old_rc;
+
+	/* Assumes fd was already bounds-checked. Drop the reference of the
+	 * owner, unless the entry is not allocated or freed already.
+	 */
+	do {
+		old_rc = atomic_get(&fdtable[fd].refcount);
+		if (!fd_is_open(old_rc)) {
+			return;
+		}
+	} while (!atomic_cas(&fdtable[fd].refcount, old_rc,
+			     old_rc | FD_CLOSED));
+
 	(void)z_fd_unref(fd);
 }
 
+int z_close_fd(int fd)
+{
+	const struct fd_op_vtable *vtable = fdtable[fd].vtable;
+	void *obj = fdtable[fd].obj;
+	atomic_val_t old_rc;
+	int res;
+
+	/* Assumes the caller holds a reference taken by z_get_fd_ref().
+	 * Drop the reference of the owner along with marking the entry
+	 * closed, so that only one caller closes the object.
+	 */
+	do {
+		old_rc = atomic_get(&fdtable[fd].refcount);
+		if (old_rc & FD_CLOSED) {
+			/* Closed concurrently */
+			(void)z_fd_unref(fd);
+			errno = EBADF;
+			return -1;
+		}
+	} while (!atomic_cas(&fdtable[fd].refcount, old_rc,
+			     (old_rc | FD_CLOSED) - 1));
+
+	/* Close the object right away, this wakes up calls blocked on it in
+	 * other threads. Their references only keep the descriptor from
+	 * being reused until they return.
+	 */
+	res = vtable->close(obj);
+	(void)z_fd_unref(fd);
+
+	return res;
+}
+
 int z_alloc_fd(void *obj, const struct fd_op_vtable *vtable)
 {
 	int fd;
@@ -208,82 +325,113 @@ int z_alloc_fd(void *obj, const struct fd_op_vtable *vtable)
 
 ssize_t read(int fd, void *buf, size_t sz)
 {
-	if (_check_fd(fd) < 0) {
+	const struct fd_op_vtable *vtable;
+	ssize_t res;
+	void *obj;
+
+	if (z_get_fd_ref(fd, &obj, &vtable) < 0) {
 		return -1;
 	}
 
-	return fdtable[fd].vtable->read(fdtable[fd].obj, buf, sz);
+	res = vtable->read(obj, buf, sz);
+	z_put_fd_ref(fd);
+
+	return res;
 }
 FUNC_ALIAS(read, _read, ssize_t);
 
 ssize_t write(int fd, const void *buf, size_t sz)
 {
-	if (_check_fd(fd) < 0) {
+	const struct fd_op_vtable *vtable;
+	ssize_t res;
+	void *obj;
+
+	if (z_get_fd_ref(fd, &obj, &vtable) < 0) {
 		return -1;
 	}
 
-	return fdtable[fd].vtable->write(fdtable[fd].obj, buf, sz);
+	res = vtable->write(obj, buf, sz);
+	z_put_fd_ref(fd);
+
+	return res;
 }
 FUNC_ALIAS(write, _write, ssize_t);
 
 int close(int fd)
 {
-	int res;
+	const struct fd_op_vtable *vtable;
+	void *obj;
 
-	if (_check_fd(fd) < 0) {
+	if (z_get_fd_ref(fd, &obj, &vtable) < 0) {
 		return -1;
 	}
 
-	res = fdtable[fd].vtable->close(fdtable[fd].obj);
-
-	z_free_fd(fd);
-
-	return res;
+	return z_close_fd(fd);
 }
 FUNC_ALIAS(close, _close, int);
 
 int fsync(int fd)
 {
-	if (_check_fd(fd) < 0) {
+	const struct fd_op_vtable *vtable;
+	void *obj;
+	int res;
+
+	if (z_get_fd_ref(fd, &obj, &vtable) < 0) {
 		return -1;
 	}
 
-	return z_fdtable_call_ioctl(fdtable[fd].vtable, fdtable[fd].obj, ZFD_IOCTL_FSYNC);
+	res = z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_FSYNC);
+	z_put_fd_ref(fd);
+
+	return res;
 }
 
 off_t lseek(int fd, off_t offset, int whence)
 {
-	if (_check_fd(fd) < 0) {
+	const struct fd_op_vtable *vtable;
+	void *obj;
+	off_t res;
+
+	if (z_get_fd_ref(fd, &obj, &vtable) < 0) {
 		return -1;
 	}
 
-	return z_fdtable_call_ioctl(fdtable[fd].vtable, fdtable[fd].obj, ZFD_IOCTL_LSEEK,
-			  offset, whence);
+	res = z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_LSEEK,
+				   offset, whence);
+	z_put_fd_ref(fd);
+
+	return res;
 }
 FUNC_ALIAS(lseek, _lseek, off_t);
 
 int ioctl(int fd, unsigned long request, ...)
 {
+	const struct fd_op_vtable *vtable;
 	va_list args;
+	void *obj;
 	int res;
 
-	if (_check_fd(fd) < 0) {
+	if (z_get_fd_ref(fd, &obj, &vtable) < 0) {
 		return -1;
 	}
 
 	va_start(args, request);
-	res = fdtable[fd].vtable->ioctl(fdtable[fd].obj, request, args);
+	res = vtable->ioctl(obj, request, args);
 	va_end(args);
 
+	z_put_fd_ref(fd);
+
 	return res;
 }
 
 int fcntl(int fd, int cmd, ...)
 {
+	const struct fd_op_vtable *vtable;
 	va_list args;
+	void *obj;
 	int res;
 
-	if (_check_fd(fd) < 0) {
+	if (z_get_fd_ref(fd, &obj, &vtable) < 0) {
 		return -1;
 	}
 
@@ -291,15 +439,18 @@ int fcntl(int fd, int cmd, ...)
 	switch (cmd) {
 	case F_DUPFD:
 		/* Not implemented so far. */
+		z_put_fd_ref(fd);
 		errno = EINVAL;
 		return -1;
 	}
 
 	/* The rest of commands are per-fd, handled by ioctl vmethod. */
 	va_start(args, cmd);
-	res = fdtable[fd].vtable->ioctl(fdtable[fd].obj, cmd, args);
+	res = vtable->ioctl(obj, cmd, args);
 	va_end(args);
 
+	z_put_fd_ref(fd);
+
 	return res;
 }
 
@@ -0,0 +1,239 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/hashtable.h>
+#include <sys/sys_heap.h>
+#include <sys/util.h>
+#include <sys/__assert.h>
+#include <errno.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 8
+
+/* Maximum number of nodes, at a load factor of 7/8 */
+static inline uint32_t max_count(uint32_t capacity)
+{
+	return capacity - capacity / 8U;
+}
+
+/* Distance of a slot from the ideal one of the hash it holds */
+static inline uint32_t probe_dist(const struct sys_hashtable *ht,
+				  uint32_t pos, uint32_t hash)
+{
+	return (pos - hash) & (ht->capacity - 1U);
+}
+
+static void place(struct sys_hashtable *ht, struct sys_hashtable_slot entry)
+{
+	uint32_t mask = ht->capacity - 1U;
+	uint32_t pos = entry.hash & mask;
+	uint32_t dist = 0U;
+
+	while (ht->slots[pos].node != NULL) {
+		struct sys_hashtable_slot *slot = &ht->slots[pos];
+		uint32_t slot_dist = probe_dist(ht, pos, slot->hash);
+
+		/* Robin Hood: take the slot of an entry closer to home */
+		if (slot_dist < dist) {
+			struct sys_hashtable_slot tmp = *slot;
+
+			*slot = entry;
+			entry = tmp;
+			dist = slot_dist;
+		}
+
+		pos = (pos + 1U) & mask;
+		dist++;
+	}
+
+	ht->slots[pos] = entry;
+}
+
+static int grow(struct sys_hashtable *ht)
+{
+	struct sys_hashtable_slot *old = ht->slots;
+	uint32_t old_capacity = ht->capacity;
+	uint32_t capacity = old_capacity ? old_capacity * 2U : INITIAL_CAPACITY;
+	struct sys_hashtable_slot *slots;
+
+	if (ht->heap == NULL || capacity < old_capacity) {
+		return -ENOMEM;
+	}
+
+	slots = sys_heap_alloc(ht->heap, capacity * sizeof(*slots));
+	if (slots == NULL) {
+		return -ENOMEM;
+	}
+
+	(void)memset(slots, 0, capacity * sizeof(*slots));
+	ht->slots = slots;
+	ht->capacity = capacity;
+
+	for (uint32_t i = 0U; i < old_capacity; i++) {
+		if (old[i].node != NULL) {
+			place(ht, old[i]);
+		}
+	}
+
+	if (old != NULL) {
+		sys_heap_free(ht->heap, old);
+	}
+
+	return 0;
+}
+
+/* Shift the entries following a removed one back, down to their ideal
+ * slot or an empty one, so that no probe sequence is broken.
+ */
+static void remove_at(struct sys_hashtable *ht, uint32_t pos)
+{
+	uint32_t mask = ht->capacity - 1U;
+	uint32_t next = (pos + 1U) & mask;
+
+	while (ht->slots[next].node != NULL &&
+	       probe_dist(ht, next, ht->slots[next].hash) != 0U) {
+		ht->slots[pos] = ht->slots[next];
+		pos = next;
+		next = (next + 1U) & mask;
+	}
+
+	ht->slots[pos].node = NULL;
+	ht->count--;
+}
+
+/* Find the slot of @a node, or of the first node holding @a key if NULL */
+static int lookup(const struct sys_hashtable *ht, uint32_t hash,
+		  const void *key, const struct sys_hashnode *node)
+{
+	uint32_t mask = ht->capacity - 1U;
+	uint32_t pos = hash & mask;
+
+	for (uint32_t dist = 0U; dist < ht->capacity; dist++) {
+		const struct sys_hashtable_slot *slot = &ht->slots[pos];
+
+		/* Past the point the hash would have displaced this entry */
+		if (slot->node == NULL ||
+		    probe_dist(ht, pos, slot->hash) < dist) {
+			break;
+		}
+
+		if (slot->hash == hash &&
+		    (node ? slot->node == node : ht->eq(slot->node, key))) {
+			return pos;
+		}
+
+		pos = (pos + 1U) & mask;
+	}
+
+	return -ENOENT;
+}
+
+void sys_hashtable_init(struct sys_hashtable *ht,
+			struct sys_hashtable_slot *slots, uint32_t capacity,
+			sys_hashtable_eq_t eq)
+{
+	__ASSERT(is_power_of_two(capacity), "capacity not a power of 2");
+
+	(void)memset(slots, 0, capacity * sizeof(*slots));
+	ht->slots = slots;
+	ht->capacity = capacity;
+	ht->count = 0U;
+	ht->heap = NULL;
+	ht->eq = eq;
+}
+
+void sys_hashtable_init_heap(struct sys_hashtable *ht, struct sys_heap *heap,
+			     sys_hashtable_eq_t eq)
+{
+	ht->slots = NULL;
+	ht->capacity = 0U;
+	ht->count = 0U;
+	ht->heap = heap;
+	ht->eq = eq;
+}
+
+void sys_hashtable_free(struct sys_hashtable *ht)
+{
+	__ASSERT_NO_MSG(ht->heap != NULL);
+
+	if (ht->slots != NULL) {
+		sys_heap_free(ht->heap, ht->slots);
+	}
+
+	ht->slots = NULL;
+	ht->capacity = 0U;
+	ht->count = 0U;
+}
+
+int sys_hashtable_insert(struct sys_hashtable *ht, struct sys_hashnode *node,
+			 uint32_t hash)
+{
+	if (ht->count + 1U > max_count(ht->capacity)) {
+		int err = grow(ht);
+
+		if (err) {
+			return err;
+		}
+	}
+
+	node->hash = hash;
+	place(ht, (struct sys_hashtable_slot){ .hash = hash, .node = node });
+	ht->count++;
+
+	return 0;
+}
+
+struct sys_hashnode *sys_hashtable_find(const struct sys_hashtable *ht,
+					uint32_t hash, const void *key)
+{
+	int pos;
+
+	if (ht->count == 0U) {
+		return NULL;
+	}
+
+	pos = lookup(ht, hash, key, NULL);
+
+	return pos < 0 ? NULL : ht->slots[pos].node;
+}
+
+struct sys_hashnode *sys_hashtable_remove(struct sys_hashtable *ht,
+					  uint32_t hash, const void *key)
+{
+	struct sys_hashnode *node;
+	int pos;
+
+	if (ht->count == 0U) {
+		return NULL;
+	}
+
+	pos = lookup(ht, hash, key, NULL);
+	if (pos < 0) {
+		return NULL;
+	}
+
+	node = ht->slots[pos].node;
+	remove_at(ht, pos);
+
+	return node;
+}
+
+bool sys_hashtable_remove_node(struct sys_hashtable *ht,
+			       struct sys_hashnode *node)
+{
+	int pos;
+
+	if (ht->count == 0U) {
+		return false;
+	}
+
+	pos = lookup(ht, node->hash, NULL, node);
+	if (pos < 0) {
+		return false;
+	}
+
+	remove_at(ht, pos);
+
+	return true;
+}
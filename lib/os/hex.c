@@ -7,7 +7,11 @@
 #include <stddef.h>
 #include <zephyr/types.h>
 #include <errno.h>
+#include <toolchain.h>
 #include <sys/util.h>
+#include <sys/byteorder.h>
+
+#define ONES 0x0101010101010101ULL
 
 int char2hex(char c, uint8_t *x)
 {
@@ -37,19 +41,79 @@ int hex2char(uint8_t x, char *c)
 	return 0;
 }
 
+/* Spread the 4 bytes of x over the even bytes of a 64-bit word */
+static inline uint64_t spread_bytes(uint64_t x)
+{
+	x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+	x = (x | (x << 8)) & 0x00ff00ff00ff00ffULL;
+
+	return x;
+}
+
+/* Convert 8 nibbles, one per byte, into lowercase hex characters */
+static inline uint64_t nibbles_to_hex(uint64_t v)
+{
+	uint64_t alpha = ((v + ONES * 6U) >> 4) & ONES;
+
+	return v + ONES * '0' + alpha * ('a' - '0' - 10);
+}
+
+/*
+ * Convert 8 hex characters, the first one in the least significant byte,
+ * into 4 bytes. Each byte is checked to be in either of '0'-'9' or, case
+ * folded, 'a'-'f' with the carry of an addition into its top bit, which
+ * is clear for ASCII characters.
+ */
+static inline bool hex_to_bytes(uint64_t w, uint32_t *x)
+{
+	const uint64_t high = ONES * 0x80U;
+	uint64_t lw = w | (ONES * 0x20U);
+	uint64_t digit, alpha, v;
+
+	if (w & high) {
+		return false;
+	}
+
+	digit = (w + ONES * (0x80 - '0')) & ~(w + ONES * (0x7f - '9'));
+	alpha = (lw + ONES * (0x80 - 'a')) & ~(lw + ONES * (0x7f - 'f'));
+	if (((digit | alpha) & high) != high) {
+		return false;
+	}
+
+	/* Letters have bit 6 set, and 1 to 6 in their low nibble */
+	v = (w & (ONES * 0xfU)) + ((w >> 6) & ONES) * 9U;
+
+	v = ((v << 4) | (v >> 8)) & 0x00ff00ff00ff00ffULL;
+	v = (v | (v >> 8)) & 0x0000ffff0000ffffULL;
+	*x = (uint32_t)(v | (v >> 16));
+
+	return true;
+}
+
 size_t bin2hex(const uint8_t *buf, size_t buflen, char *hex, size_t hexlen)
 {
+	size_t i = 0;
+
 	if ((hexlen + 1) < buflen * 2) {
 		return 0;
 	}
 
-	for (size_t i = 0; i < buflen; i++) {
-		if (hex2char(buf[i] >> 4, &hex[2 * i]) < 0) {
-			return 0;
-		}
-		if (hex2char(buf[i] & 0xf, &hex[2 * i + 1]) < 0) {
-			return 0;
-		}
+	/* 4 bytes at a time, the first one in the least significant byte */
+	for (; buflen - i >= 4; i += 4) {
+		uint32_t x = UNALIGNED_GET((uint32_t *)&buf[i]);
+		uint64_t v;
+
+		x = sys_le32_to_cpu(x);
+		v = spread_bytes((x >> 4) & 0x0f0f0f0fU) |
+		    spread_bytes(x & 0x0f0f0f0fU) << 8;
+
+		UNALIGNED_PUT(sys_cpu_to_le64(nibbles_to_hex(v)),
+			      (uint64_t *)&hex[2 * i]);
+	}
+
+	for (; i < buflen; i++) {
+		(void)hex2char(buf[i] >> 4, &hex[2 * i]);
+		(void)hex2char(buf[i] & 0xf, &hex[2 * i + 1]);
 	}
 
 	hex[2 * buflen] = '\0';
@@ -59,6 +123,7 @@ size_t bin2hex(const uint8_t *buf, size_t buflen, char *hex, size_t hexlen)
 size_t hex2bin(const char *hex, size_t hexlen, uint8_t *buf, size_t buflen)
 {
 	uint8_t dec;
+	size_t i = 0;
 
 	if (buflen < hexlen / 2 + hexlen % 2) {
 		return 0;
@@ -74,8 +139,22 @@ size_t hex2bin(const char *hex, size_t hexlen, uint8_t *buf, size_t buflen)
 		buf++;
 	}
 
+	/* 8 characters at a time */
+	for (; hexlen / 2 - i >= 4; i += 4) {
+		uint64_t w = UNALIGNED_GET((uint64_t *)&hex[2 * i]);
+		uint32_t x;
+
+		w = sys_le64_to_cpu(w);
+
+		if (!hex_to_bytes(w, &x)) {
+			return 0;
+		}
+
+		UNALIGNED_PUT(sys_cpu_to_le32(x), (uint32_t *)&buf[i]);
+	}
+
 	/* regular hex conversion */
-	for (size_t i = 0; i < hexlen / 2; i++) {
+	for (; i < hexlen / 2; i++) {
 		if (char2hex(hex[2 * i], &dec) < 0) {
 			return 0;
 		}
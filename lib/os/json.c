@@ -107,12 +107,58 @@ static int peek(struct lexer *lexer)
 	return chr;
 }
 
+/* 0x01 and 0x80 repeated in every byte of a word */
+#define WORD_ONES  ((unsigned long)-1 / 0xff)
+#define WORD_HIGHS (WORD_ONES << 7)
+
+/* Non-zero if any byte of the word is <chr> */
+static inline unsigned long word_has_byte(unsigned long w, char chr)
+{
+	w ^= WORD_ONES * (unsigned char)chr;
+
+	return (w - WORD_ONES) & ~w & WORD_HIGHS;
+}
+
+/*
+ * Returns the first '"', '\\' or NUL in [pos, end), or end. Runs of plain
+ * characters make up most of a string, so they are scanned a word at a
+ * time.
+ */
+static const char *string_run_end(const char *pos, const char *end)
+{
+	while (pos < end && ((uintptr_t)pos & (sizeof(unsigned long) - 1))) {
+		if (*pos == '"' || *pos == '\\' || *pos == '\0') {
+			return pos;
+		}
+		pos++;
+	}
+
+	while ((size_t)(end - pos) >= sizeof(unsigned long)) {
+		unsigned long w = *(const unsigned long *)pos;
+
+		if (word_has_byte(w, '"') || word_has_byte(w, '\\') ||
+		    word_has_byte(w, '\0')) {
+			break;
+		}
+		pos += sizeof(unsigned long);
+	}
+
+	while (pos < end && *pos != '"' && *pos != '\\' && *pos != '\0') {
+		pos++;
+	}
+
+	return pos;
+}
+
 static void *lexer_string(struct lexer *lexer)
 {
 	ignore(lexer);
 
 	while (true) {
-		int chr = next(lexer);
+		int chr;
+
+		lexer->pos = (char *)string_run_end(lexer->pos, lexer->end);
+		chr = next(lexer);
 
 		if (chr == '\0') {
 			emit(lexer, JSON_TOK_ERROR);
@@ -442,6 +488,11 @@ static int decode_value(struct json_obj *obj,
 
 	switch (descr->type) {
 	case JSON_TOK_OBJECT_START:
+		/* The decoded fields are returned as a bitmap */
+		if (descr->object.sub_descr_len > sizeof(int) * CHAR_BIT - 1) {
+			return -EINVAL;
+		}
+
 		return obj_parse(obj, descr->object.sub_descr,
 				 descr->object.sub_descr_len,
 				 field);
@@ -599,6 +650,564 @@ int json_obj_parse(char *payload, size_t len,
 	return obj_parse(&obj, descr, descr_len, val);
 }
 
+enum stream_state {
+	STREAM_START,
+	STREAM_MEMBER,		/* key, ',' or '}' */
+	STREAM_KEY_START,	/* key */
+	STREAM_KEY,
+	STREAM_COLON,
+	STREAM_ELEMENT,		/* value, ',' or ']' */
+	STREAM_VALUE,
+	STREAM_STRING,
+	STREAM_LITERAL,
+	STREAM_NUMBER,
+	STREAM_SKIP,		/* inside an ignored object or array */
+	STREAM_SKIP_STRING,
+	STREAM_DONE,
+};
+
+/* Escape sequence progress: after '\\', then each hex digit of "\u" */
+#define STREAM_ESC_NONE     0
+#define STREAM_ESC_CHAR     1
+#define STREAM_ESC_HEX      2
+#define STREAM_ESC_HEX_LAST (STREAM_ESC_HEX + 3)
+
+static struct json_obj_stream_frame *stream_top(struct json_obj_stream *stream)
+{
+	return &stream->stack[stream->depth - 1];
+}
+
+static int stream_value_end(struct json_obj_stream *stream)
+{
+	struct json_obj_stream_frame *frame = stream_top(stream);
+	size_t *elements;
+
+	if (frame->type == JSON_TOK_OBJECT_START) {
+		if (frame->key >= 0) {
+			frame->decoded |= 1 << frame->key;
+		}
+
+		stream->state = STREAM_MEMBER;
+		return 0;
+	}
+
+	elements = (size_t *)((char *)frame->val + frame->descr->offset);
+	(*elements)++;
+	frame->field += frame->decoded;
+	frame->len--;
+
+	stream->state = STREAM_ELEMENT;
+	return 0;
+}
+
+static int stream_pop(struct json_obj_stream *stream)
+{
+	stream->depth--;
+
+	if (stream->depth == 0U) {
+		stream->ret = stream->stack[0].decoded;
+		stream->state = STREAM_DONE;
+		return 0;
+	}
+
+	return stream_value_end(stream);
+}
+
+static int stream_push(struct json_obj_stream *stream,
+		       const struct json_obj_descr *descr, void *field)
+{
+	struct json_obj_stream_frame *parent = stream_top(stream);
+	struct json_obj_stream_frame *frame;
+
+	if (stream->depth == JSON_OBJ_STREAM_MAX_DEPTH) {
+		return -ENOMEM;
+	}
+
+	if (descr->type == JSON_TOK_OBJECT_START) {
+		/* The decoded fields are kept as a bitmap */
+		if (descr->object.sub_descr_len >
+		    sizeof(frame->decoded) * CHAR_BIT - 1) {
+			return -EINVAL;
+		}
+	}
+
+	frame = &stream->stack[stream->depth++];
+	frame->type = descr->type;
+	frame->key = -1;
+
+	if (descr->type == JSON_TOK_OBJECT_START) {
+		frame->descr = descr->object.sub_descr;
+		frame->len = descr->object.sub_descr_len;
+		frame->val = field;
+		frame->decoded = 0;
+
+		stream->state = STREAM_MEMBER;
+	} else {
+		frame->descr = descr->array.element_descr;
+		frame->len = descr->array.n_elements;
+		frame->val = parent->val;
+		frame->field = field;
+		frame->decoded = get_elem_size(frame->descr);
+
+		__ASSERT_NO_MSG(frame->decoded > 0);
+
+		*(size_t *)((char *)frame->val + frame->descr->offset) = 0;
+
+		stream->state = STREAM_ELEMENT;
+	}
+
+	return 0;
+}
+
+static int stream_value(struct json_obj_stream *stream, int chr)
+{
+	struct json_obj_stream_frame *frame = stream_top(stream);
+	const struct json_obj_descr *descr = NULL;
+	enum json_tokens type;
+	void *field = NULL;
+
+	switch (chr) {
+	case '{':
+	case '[':
+	case '"':
+		type = (enum json_tokens)chr;
+		break;
+	case 't':
+		type = JSON_TOK_TRUE;
+		stream->literal = "rue";
+		break;
+	case 'f':
+		type = JSON_TOK_FALSE;
+		stream->literal = "alse";
+		break;
+	default:
+		/* Like json_obj_parse(), refuse null even if it is ignored */
+		if (chr != '-' && !isdigit(chr)) {
+			return -EINVAL;
+		}
+
+		type = JSON_TOK_NUMBER;
+		break;
+	}
+
+	if (frame->type == JSON_TOK_LIST_START) {
+		if (frame->len == 0U) {
+			return -ENOSPC;
+		}
+
+		descr = frame->descr;
+		field = frame->field;
+	} else if (frame->key >= 0) {
+		descr = &frame->descr[frame->key];
+		field = (char *)frame->val + descr->offset;
+	}
+
+	if (descr && !equivalent_types(type, descr->type)) {
+		return -EINVAL;
+	}
+
+	stream->field = field;
+
+	switch (type) {
+	case JSON_TOK_OBJECT_START:
+	case JSON_TOK_LIST_START:
+		if (!descr) {
+			stream->skip = 1U;
+			stream->state = STREAM_SKIP;
+			return 0;
+		}
+
+		return stream_push(stream, descr, field);
+	case JSON_TOK_STRING:
+		if (field) {
+			/* Leave room for the terminator */
+			if (stream->buf_len >= stream->buf_size) {
+				return -ENOMEM;
+			}
+
+			*(char **)field = stream->buf + stream->buf_len;
+		}
+
+		stream->state = STREAM_STRING;
+		return 0;
+	case JSON_TOK_TRUE:
+	case JSON_TOK_FALSE:
+		if (field) {
+			*(bool *)field = type == JSON_TOK_TRUE;
+		}
+
+		stream->state = STREAM_LITERAL;
+		return 0;
+	default:
+		stream->num[0] = chr;
+		stream->num_len = 1U;
+
+		stream->state = STREAM_NUMBER;
+		return 0;
+	}
+}
+
+static int stream_number_end(struct json_obj_stream *stream)
+{
+	struct token token = {
+		.start = stream->num,
+		.end = stream->num + stream->num_len,
+	};
+	int ret;
+
+	if (stream->field) {
+		if (stream->num_len == sizeof(stream->num)) {
+			return -ERANGE;
+		}
+
+		ret = decode_num(&token, stream->field);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return stream_value_end(stream);
+}
+
+static int stream_append(struct json_obj_stream *stream, const char *str,
+			 size_t len)
+{
+	if (stream->state == STREAM_KEY) {
+		const struct json_obj_descr *descr = stream_top(stream)->descr;
+		size_t i;
+
+		/* Drop the fields whose name does not go on with str */
+		for (i = 0; (stream->keys >> i) != 0U; i++) {
+			if (!(stream->keys & BIT(i))) {
+				continue;
+			}
+
+			if (stream->key_len + len > descr[i].field_name_len ||
+			    memcmp(descr[i].field_name + stream->key_len, str,
+				   len)) {
+				stream->keys &= ~BIT(i);
+			}
+		}
+
+		stream->key_len += len;
+		return 0;
+	}
+
+	if (stream->state == STREAM_STRING && stream->field) {
+		if (len >= stream->buf_size - stream->buf_len) {
+			return -ENOMEM;
+		}
+
+		memcpy(stream->buf + stream->buf_len, str, len);
+		stream->buf_len += len;
+	}
+
+	return 0;
+}
+
+/*
+ * Lexes the string at *pos, which is either a key, a value or inside an
+ * ignored value, depending on the state. Returns 1 once the closing
+ * quote is consumed, 0 if the string goes on in the next chunk.
+ */
+static int stream_string(struct json_obj_stream *stream, const char **pos,
+			 const char *end)
+{
+	const char *p = *pos;
+	const char *run;
+	int ret = 0;
+
+	while (p < end) {
+		if (stream->esc == STREAM_ESC_CHAR) {
+			switch (*p) {
+			case '"':
+			case '\\':
+			case '/':
+			case 'b':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't':
+				stream->esc = STREAM_ESC_NONE;
+				break;
+			case 'u':
+				stream->esc = STREAM_ESC_HEX;
+				break;
+			default:
+				return -EINVAL;
+			}
+		} else if (stream->esc != STREAM_ESC_NONE) {
+			if (!isxdigit((unsigned char)*p)) {
+				return -EINVAL;
+			}
+
+			if (stream->esc == STREAM_ESC_HEX_LAST) {
+				stream->esc = STREAM_ESC_NONE;
+			} else {
+				stream->esc++;
+			}
+		} else {
+			run = string_run_end(p, end);
+			ret = stream_append(stream, p, run - p);
+			p = run;
+
+			if (ret < 0 || p == end) {
+				break;
+			}
+
+			if (*p == '"') {
+				p++;
+				ret = 1;
+				break;
+			}
+
+			stream->esc = STREAM_ESC_CHAR;
+		}
+
+		/* Escape sequences are kept as they are */
+		ret = stream_append(stream, p, 1);
+		if (ret < 0) {
+			break;
+		}
+
+		p++;
+	}
+
+	*pos = p;
+	return ret;
+}
+
+static int stream_string_end(struct json_obj_stream *stream)
+{
+	struct json_obj_stream_frame *frame = stream_top(stream);
+	size_t i;
+
+	switch (stream->state) {
+	case STREAM_KEY:
+		frame->key = -1;
+
+		for (i = 0; (stream->keys >> i) != 0U; i++) {
+			if ((stream->keys & BIT(i)) &&
+			    frame->descr[i].field_name_len == stream->key_len) {
+				frame->key = i;
+				break;
+			}
+		}
+
+		stream->state = STREAM_COLON;
+		return 0;
+	case STREAM_SKIP_STRING:
+		stream->state = STREAM_SKIP;
+		return 0;
+	default:
+		if (stream->field) {
+			stream->buf[stream->buf_len++] = '\0';
+		}
+
+		return stream_value_end(stream);
+	}
+}
+
+static int stream_skip(struct json_obj_stream *stream, int chr)
+{
+	switch (chr) {
+	case '"':
+		stream->state = STREAM_SKIP_STRING;
+		return 0;
+	case '{':
+	case '[':
+		if (stream->skip == UINT16_MAX) {
+			return -ENOMEM;
+		}
+
+		stream->skip++;
+		return 0;
+	case '}':
+	case ']':
+		if (--stream->skip == 0U) {
+			return stream_value_end(stream);
+		}
+
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+static int stream_token(struct json_obj_stream *stream, int chr)
+{
+	struct json_obj_stream_frame *frame;
+
+	switch (stream->state) {
+	case STREAM_START:
+		if (chr != '{') {
+			return -EINVAL;
+		}
+
+		stream->depth = 1U;
+		stream->state = STREAM_MEMBER;
+		return 0;
+	case STREAM_MEMBER:
+		if (chr == '}') {
+			return stream_pop(stream);
+		}
+
+		if (chr == ',') {
+			stream->state = STREAM_KEY_START;
+			return 0;
+		}
+
+		__fallthrough;
+	case STREAM_KEY_START:
+		if (chr != '"') {
+			return -EINVAL;
+		}
+
+		/* Fields decoded already are not matched again */
+		frame = stream_top(stream);
+		stream->keys = BIT_MASK(frame->len) & ~frame->decoded;
+		stream->key_len = 0;
+
+		stream->state = STREAM_KEY;
+		return 0;
+	case STREAM_COLON:
+		if (chr != ':') {
+			return -EINVAL;
+		}
+
+		stream->state = STREAM_VALUE;
+		return 0;
+	case STREAM_ELEMENT:
+		if (chr == ']') {
+			return stream_pop(stream);
+		}
+
+		if (chr == ',') {
+			stream->state = STREAM_VALUE;
+			return 0;
+		}
+
+		__fallthrough;
+	case STREAM_VALUE:
+		return stream_value(stream, chr);
+	default:
+		return -EINVAL;
+	}
+}
+
+static int stream_lex(struct json_obj_stream *stream, const char *pos,
+		      const char *end)
+{
+	int ret = 0;
+	int chr;
+
+	while (pos < end && stream->state != STREAM_DONE) {
+		switch (stream->state) {
+		case STREAM_KEY:
+		case STREAM_STRING:
+		case STREAM_SKIP_STRING:
+			ret = stream_string(stream, &pos, end);
+			if (ret > 0) {
+				ret = stream_string_end(stream);
+			}
+			break;
+		case STREAM_LITERAL:
+			if (*pos++ != *stream->literal++) {
+				return -EINVAL;
+			}
+
+			if (*stream->literal == '\0') {
+				ret = stream_value_end(stream);
+			}
+			break;
+		case STREAM_NUMBER:
+			chr = (unsigned char)*pos;
+
+			/* A lone '-' is not a number */
+			if (stream->num_len == 1U && stream->num[0] == '-' &&
+			    !isdigit(chr)) {
+				return -EINVAL;
+			}
+
+			if (!isdigit(chr) && chr != '.') {
+				ret = stream_number_end(stream);
+				break;
+			}
+
+			/* Too long numbers are flagged as out of range */
+			if (stream->num_len < sizeof(stream->num) - 1) {
+				stream->num[stream->num_len++] = chr;
+			} else {
+				stream->num_len = sizeof(stream->num);
+			}
+
+			pos++;
+			break;
+		case STREAM_SKIP:
+			ret = stream_skip(stream, (unsigned char)*pos++);
+			break;
+		default:
+			chr = (unsigned char)*pos++;
+
+			if (isspace(chr)) {
+				while (pos < end && isspace((unsigned char)*pos)) {
+					pos++;
+				}
+				break;
+			}
+
+			ret = stream_token(stream, chr);
+			break;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+void json_obj_stream_init(struct json_obj_stream *stream,
+			  const struct json_obj_descr *descr, size_t descr_len,
+			  void *val, char *buf, size_t buf_size)
+{
+	__ASSERT_NO_MSG(descr_len < (sizeof(stream->ret) * CHAR_BIT - 1));
+
+	stream->stack[0].descr = descr;
+	stream->stack[0].val = val;
+	stream->stack[0].len = descr_len;
+	stream->stack[0].decoded = 0;
+	stream->stack[0].type = JSON_TOK_OBJECT_START;
+	stream->stack[0].key = -1;
+
+	stream->buf = buf;
+	stream->buf_size = buf_size;
+	stream->buf_len = 0;
+	stream->state = STREAM_START;
+	stream->esc = STREAM_ESC_NONE;
+	stream->depth = 0U;
+	stream->skip = 0U;
+	stream->ret = -EAGAIN;
+}
+
+int json_obj_stream_feed(struct json_obj_stream *stream, const char *data,
+			 size_t len)
+{
+	int ret;
+
+	if (stream->ret != -EAGAIN) {
+		return stream->ret;
+	}
+
+	ret = stream_lex(stream, data, data + len);
+	if (ret < 0) {
+		stream->ret = ret;
+	}
+
+	return stream->ret;
+}
+
 static char escape_as(char chr)
 {
 	switch (chr) {
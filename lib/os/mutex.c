@@ -9,6 +9,11 @@
 #include <syscall_handler.h>
 #include <kernel_structs.h>
 
+#ifdef CONFIG_THREAD_LOCAL_STORAGE
+__thread atomic_val_t z_sys_mutex_self;
+__thread struct sys_mutex *z_sys_mutex_checked[Z_SYS_MUTEX_CHECKED];
+#endif
+
 static struct k_mutex *get_k_mutex(struct sys_mutex *mutex)
 {
 	struct z_object *obj;
@@ -23,9 +28,9 @@ static struct k_mutex *get_k_mutex(struct sys_mutex *mutex)
 
 static bool check_sys_mutex_addr(struct sys_mutex *addr)
 {
-	/* sys_mutex memory is never touched, just used to lookup the
-	 * underlying k_mutex, but we don't want threads using mutexes
-	 * that are outside their memory domain
+	/* Besides being used to lookup the underlying k_mutex, the
+	 * sys_mutex is updated by the kernel, and we don't want threads
+	 * using mutexes that are outside their memory domain
 	 */
 	return Z_SYSCALL_MEMORY_WRITE(addr, sizeof(struct sys_mutex));
 }
@@ -38,7 +43,7 @@ int z_impl_z_sys_mutex_kernel_lock(struct sys_mutex *mutex, k_timeout_t timeout)
 		return -EINVAL;
 	}
 
-	return k_mutex_lock(kernel_mutex, timeout);
+	return z_sys_mutex_lock_contended(kernel_mutex, mutex, timeout);
 }
 
 static inline int z_vrfy_z_sys_mutex_kernel_lock(struct sys_mutex *mutex,
@@ -56,16 +61,11 @@ int z_impl_z_sys_mutex_kernel_unlock(struct sys_mutex *mutex)
 {
 	struct k_mutex *kernel_mutex = get_k_mutex(mutex);
 
-	if (kernel_mutex == NULL || kernel_mutex->lock_count == 0) {
+	if (kernel_mutex == NULL) {
 		return -EINVAL;
 	}
 
-	if (kernel_mutex->owner != _current) {
-		return -EPERM;
-	}
-
-	k_mutex_unlock(kernel_mutex);
-	return 0;
+	return z_sys_mutex_unlock_contended(kernel_mutex, mutex);
 }
 
 static inline int z_vrfy_z_sys_mutex_kernel_unlock(struct sys_mutex *mutex)
@@ -14,7 +14,9 @@
 
 #include <kernel.h>
 #include <sys/printk.h>
+#include <sys/cbprintf.h>
 #include <stdarg.h>
+#include <string.h>
 #include <toolchain.h>
 #include <linker/sections.h>
 #include <syscall_handler.h>
@@ -23,25 +25,6 @@
 
 typedef int (*out_func_t)(int c, void *ctx);
 
-enum pad_type {
-	PAD_NONE,
-	PAD_ZERO_BEFORE,
-	PAD_SPACE_BEFORE,
-	PAD_SPACE_AFTER,
-};
-
-#ifdef CONFIG_PRINTK64
-typedef uint64_t printk_val_t;
-#else
-typedef uint32_t printk_val_t;
-#endif
-
-/* Maximum number of digits in a printed decimal value (hex is always
- * less, obviously).  Funny formula produces 10 max digits for 32 bit,
- * 21 for 64.
- */
-#define DIGITS_BUFLEN (11U * (sizeof(printk_val_t) / 4U) - 1U)
-
 #ifdef CONFIG_PRINTK_SYNC
 static struct k_spinlock lock;
 #endif
@@ -68,11 +51,14 @@ __attribute__((weak)) int arch_printk_char_out(int c)
 
 int (*_char_out)(int) = arch_printk_char_out;
 
+static int (*_str_out)(const char *str, size_t len);
+
 /**
  * @brief Install the character output routine for printk
  *
  * To be called by the platform's console driver at init time. Installs a
- * routine that outputs one ASCII character at a time.
+ * routine that outputs one ASCII character at a time. Any string output
+ * routine installed before is removed.
  * @param fn putc routine to install
  *
  * @return N/A
@@ -80,6 +66,23 @@ int (*_char_out)(int) = arch_printk_char_out;
 void __printk_hook_install(int (*fn)(int))
 {
 	_char_out = fn;
+	_str_out = NULL;
+}
+
+/**
+ * @brief Install a string output routine for printk
+ *
+ * Optionally called by a console driver after __printk_hook_install(),
+ * if it can output several characters at once. printk() and k_str_out()
+ * then hand their output over in spans rather than one character at a
+ * time.
+ * @param fn routine outputting @a len characters from @a str
+ *
+ * @return N/A
+ */
+void __printk_str_hook_install(int (*fn)(const char *str, size_t len))
+{
+	_str_out = fn;
 }
 
 /**
@@ -96,73 +99,29 @@ void *__printk_get_hook(void)
 }
 #endif /* CONFIG_PRINTK */
 
-static void print_digits(out_func_t out, void *ctx, printk_val_t num, unsigned int base,
-			 bool pad_before, char pad_char, int min_width)
-{
-	char buf[DIGITS_BUFLEN];
-	unsigned int i;
-
-	/* Print it backwards into the end of the buffer, low digits first */
-	for (i = DIGITS_BUFLEN - 1U; num != 0U; i--) {
-		buf[i] = "0123456789abcdef"[num % base];
-		num /= base;
-	}
-
-	if (i == DIGITS_BUFLEN - 1U) {
-		buf[i] = '0';
-	} else {
-		i++;
-	}
-
-	int pad = MAX(min_width - (int)(DIGITS_BUFLEN - i), 0);
-
-	for (/**/; pad > 0 && pad_before; pad--) {
-		out(pad_char, ctx);
-	}
-	for (/**/; i < DIGITS_BUFLEN; i++) {
-		out(buf[i], ctx);
-	}
-	for (/**/; pad > 0; pad--) {
-		out(pad_char, ctx);
-	}
-}
-
-static void print_hex(out_func_t out, void *ctx, printk_val_t num,
-		      enum pad_type padding, int min_width)
-{
-	print_digits(out, ctx, num, 16U, padding != PAD_SPACE_AFTER,
-		     padding == PAD_ZERO_BEFORE ? '0' : ' ', min_width);
-}
+struct char_out_context {
+	out_func_t out;
+	void *ctx;
+};
 
-static void print_dec(out_func_t out, void *ctx, printk_val_t num,
-		      enum pad_type padding, int min_width)
+static int char_out_span(const char *str, size_t len, void *ctx_p)
 {
-	print_digits(out, ctx, num, 10U, padding != PAD_SPACE_AFTER,
-		     padding == PAD_ZERO_BEFORE ? '0' : ' ', min_width);
-}
+	struct char_out_context *ctx = ctx_p;
 
-static bool ok64(out_func_t out, void *ctx, long long val)
-{
-	if (sizeof(printk_val_t) < 8U && val != (long) val) {
-		out('E', ctx);
-		out('R', ctx);
-		out('R', ctx);
-		return false;
+	for (size_t i = 0; i < len; i++) {
+		ctx->out((int)str[i], ctx->ctx);
 	}
-	return true;
-}
-
-static bool negative(printk_val_t val)
-{
-	const printk_val_t hibit = ~(((printk_val_t) ~1) >> 1U);
 
-	return (val & hibit) != 0U;
+	return 0;
 }
 
 /**
  * @brief Printk internals
  *
- * See printk() for description.
+ * See printk() for description. Prefer cbvprintf(), which hands the
+ * output over in spans rather than one character at a time.
+ * @param out Character output routine
+ * @param ctx Context passed to @a out
  * @param fmt Format string
  * @param ap Variable parameters
  *
@@ -170,163 +129,14 @@ static bool negative(printk_val_t val)
  */
 void z_vprintk(out_func_t out, void *ctx, const char *fmt, va_list ap)
 {
-	int might_format = 0; /* 1 if encountered a '%' */
-	enum pad_type padding = PAD_NONE;
-	int min_width = -1;
-	char length_mod = 0;
-
-	/* fmt has already been adjusted if needed */
-
-	while (*fmt) {
-		if (!might_format) {
-			if (*fmt != '%') {
-				out((int)*fmt, ctx);
-			} else {
-				might_format = 1;
-				min_width = -1;
-				padding = PAD_NONE;
-				length_mod = 0;
-			}
-		} else {
-			switch (*fmt) {
-			case '-':
-				padding = PAD_SPACE_AFTER;
-				goto still_might_format;
-			case '0':
-				if (min_width < 0 && padding == PAD_NONE) {
-					padding = PAD_ZERO_BEFORE;
-					goto still_might_format;
-				}
-				__fallthrough;
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-				if (min_width < 0) {
-					min_width = *fmt - '0';
-				} else {
-					min_width = 10 * min_width + *fmt - '0';
-				}
-
-				if (padding == PAD_NONE) {
-					padding = PAD_SPACE_BEFORE;
-				}
-				goto still_might_format;
-			case 'h':
-			case 'l':
-			case 'z':
-				if (*fmt == 'h' && length_mod == 'h') {
-					length_mod = 'H';
-				} else if (*fmt == 'l' && length_mod == 'l') {
-					length_mod = 'L';
-				} else if (length_mod == 0) {
-					length_mod = *fmt;
-				} else {
-					out((int)'%', ctx);
-					out((int)*fmt, ctx);
-					break;
-				}
-				goto still_might_format;
-			case 'd':
-			case 'i':
-			case 'u': {
-				printk_val_t d;
-
-				if (length_mod == 'z') {
-					d = va_arg(ap, ssize_t);
-				} else if (length_mod == 'l') {
-					d = va_arg(ap, long);
-				} else if (length_mod == 'L') {
-					long long lld = va_arg(ap, long long);
-					if (!ok64(out, ctx, lld)) {
-						break;
-					}
-					d = (printk_val_t) lld;
-				} else if (*fmt == 'u') {
-					d = va_arg(ap, unsigned int);
-				} else {
-					d = va_arg(ap, int);
-				}
-
-				if (*fmt != 'u' && negative(d)) {
-					out((int)'-', ctx);
-					d = -d;
-					min_width--;
-				}
-				print_dec(out, ctx, d, padding, min_width);
-				break;
-			}
-			case 'p':
-				out('0', ctx);
-				out('x', ctx);
-				/* left-pad pointers with zeros */
-				padding = PAD_ZERO_BEFORE;
-				min_width = sizeof(void *) * 2U;
-				__fallthrough;
-			case 'x':
-			case 'X': {
-				printk_val_t x;
-
-				if (*fmt == 'p') {
-					x = (uintptr_t)va_arg(ap, void *);
-				} else if (length_mod == 'l') {
-					x = va_arg(ap, unsigned long);
-				} else if (length_mod == 'L') {
-					x = va_arg(ap, unsigned long long);
-				} else {
-					x = va_arg(ap, unsigned int);
-				}
-
-				print_hex(out, ctx, x, padding, min_width);
-				break;
-			}
-			case 's': {
-				char *s = va_arg(ap, char *);
-				char *start = s;
-
-				while (*s) {
-					out((int)(*s++), ctx);
-				}
-
-				if (padding == PAD_SPACE_AFTER) {
-					int remaining = min_width - (s - start);
-					while (remaining-- > 0) {
-						out(' ', ctx);
-					}
-				}
-				break;
-			}
-			case 'c': {
-				int c = va_arg(ap, int);
-
-				out(c, ctx);
-				break;
-			}
-			case '%': {
-				out((int)'%', ctx);
-				break;
-			}
-			default:
-				out((int)'%', ctx);
-				out((int)*fmt, ctx);
-				break;
-			}
-			might_format = 0;
-		}
-still_might_format:
-		++fmt;
-	}
+	struct char_out_context char_ctx = { out, ctx };
+
+	(void)cbvprintf(char_out_span, &char_ctx, fmt, ap);
 }
 
 #ifdef CONFIG_PRINTK
 #ifdef CONFIG_USERSPACE
 struct buf_out_context {
-	int count;
 	unsigned int buf_count;
 	char buf[CONFIG_PRINTK_BUFFER_SIZE];
 };
@@ -337,30 +147,41 @@ static void buf_flush(struct buf_out_context *ctx)
 	ctx->buf_count = 0U;
 }
 
-static int buf_char_out(int c, void *ctx_p)
+static int buf_out(const char *str, size_t len, void *ctx_p)
 {
 	struct buf_out_context *ctx = ctx_p;
 
-	ctx->count++;
-	ctx->buf[ctx->buf_count++] = c;
-	if (ctx->buf_count == CONFIG_PRINTK_BUFFER_SIZE) {
-		buf_flush(ctx);
+	while (len > 0) {
+		size_t n = MIN(len, CONFIG_PRINTK_BUFFER_SIZE - ctx->buf_count);
+
+		memcpy(&ctx->buf[ctx->buf_count], str, n);
+		ctx->buf_count += n;
+		str += n;
+		len -= n;
+
+		if (ctx->buf_count == CONFIG_PRINTK_BUFFER_SIZE) {
+			buf_flush(ctx);
+		}
 	}
 
-	return c;
+	return 0;
 }
 #endif /* CONFIG_USERSPACE */
 
-struct out_context {
-	int count;
-};
-
-static int char_out(int c, void *ctx_p)
+static int char_out(const char *str, size_t len, void *ctx)
 {
-	struct out_context *ctx = ctx_p;
+	ARG_UNUSED(ctx);
+
+	if (_str_out) {
+		(void)_str_out(str, len);
+		return 0;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		_char_out(str[i]);
+	}
 
-	ctx->count++;
-	return _char_out(c);
+	return 0;
 }
 
 #ifdef CONFIG_USERSPACE
@@ -369,18 +190,17 @@ void vprintk(const char *fmt, va_list ap)
 	if (_is_user_context()) {
 		struct buf_out_context ctx = { 0 };
 
-		z_vprintk(buf_char_out, &ctx, fmt, ap);
+		(void)cbvprintf(buf_out, &ctx, fmt, ap);
 
 		if (ctx.buf_count) {
 			buf_flush(&ctx);
 		}
 	} else {
-		struct out_context ctx = { 0 };
 #ifdef CONFIG_PRINTK_SYNC
 		k_spinlock_key_t key = k_spin_lock(&lock);
 #endif
 
-		z_vprintk(char_out, &ctx, fmt, ap);
+		(void)cbvprintf(char_out, NULL, fmt, ap);
 
 #ifdef CONFIG_PRINTK_SYNC
 		k_spin_unlock(&lock, key);
@@ -390,12 +210,11 @@ void vprintk(const char *fmt, va_list ap)
 #else
 void vprintk(const char *fmt, va_list ap)
 {
-	struct out_context ctx = { 0 };
 #ifdef CONFIG_PRINTK_SYNC
 	k_spinlock_key_t key = k_spin_lock(&lock);
 #endif
 
-	z_vprintk(char_out, &ctx, fmt, ap);
+	(void)cbvprintf(char_out, NULL, fmt, ap);
 
 #ifdef CONFIG_PRINTK_SYNC
 	k_spin_unlock(&lock, key);
@@ -405,14 +224,11 @@ void vprintk(const char *fmt, va_list ap)
 
 void z_impl_k_str_out(char *c, size_t n)
 {
-	size_t i;
 #ifdef CONFIG_PRINTK_SYNC
 	k_spinlock_key_t key = k_spin_lock(&lock);
 #endif
 
-	for (i = 0; i < n; i++) {
-		_char_out(c[i]);
-	}
+	(void)char_out(c, n, NULL);
 
 #ifdef CONFIG_PRINTK_SYNC
 	k_spin_unlock(&lock, key);
@@ -467,24 +283,23 @@ void printk(const char *fmt, ...)
 
 struct str_context {
 	char *str;
-	int max;
-	int count;
+	size_t max;
+	size_t count;
 };
 
-static int str_out(int c, struct str_context *ctx)
+static int str_out(const char *str, size_t len, void *ctx_p)
 {
-	if (ctx->str == NULL || ctx->count >= ctx->max) {
-		ctx->count++;
-		return c;
-	}
+	struct str_context *ctx = ctx_p;
 
-	if (ctx->count == ctx->max - 1) {
-		ctx->str[ctx->count++] = '\0';
-	} else {
-		ctx->str[ctx->count++] = c;
+	/* Keep the last byte for the terminator */
+	if (ctx->str != NULL && ctx->count + 1 < ctx->max) {
+		memcpy(&ctx->str[ctx->count], str,
+		       MIN(len, ctx->max - 1 - ctx->count));
 	}
 
-	return c;
+	ctx->count += len;
+
+	return 0;
 }
 
 int snprintk(char *str, size_t size, const char *fmt, ...)
@@ -503,10 +318,10 @@ int vsnprintk(char *str, size_t size, const char *fmt, va_list ap)
 {
 	struct str_context ctx = { str, size, 0 };
 
-	z_vprintk((out_func_t)str_out, &ctx, fmt, ap);
+	(void)cbvprintf(str_out, &ctx, fmt, ap);
 
-	if (ctx.count < ctx.max) {
-		str[ctx.count] = '\0';
+	if (str != NULL && size > 0) {
+		str[MIN(ctx.count, size - 1)] = '\0';
 	}
 
 	return ctx.count;
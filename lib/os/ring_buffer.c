@@ -217,3 +217,236 @@ uint32_t ring_buf_get(struct ring_buf *buf, uint8_t *data, uint32_t size)
 
 	return total_size;
 }
+
+/*
+ * Single producer, single consumer ring buffer. The indexes run freely and
+ * are masked on access, so the whole buffer can be used and the fill level
+ * is their difference. The producer only writes tail and the consumer only
+ * writes head; a release store of either publishes the data written, or
+ * the space freed, before it, to the acquire load on the other side.
+ */
+
+static inline uint32_t load_acquire(const uint32_t *p)
+{
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_release(uint32_t *p, uint32_t val)
+{
+	__atomic_store_n(p, val, __ATOMIC_RELEASE);
+}
+
+uint32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t tail = buf->tail;
+	uint32_t offset = tail & buf->mask;
+	uint32_t space = buf->mask + 1 - (tail - load_acquire(&buf->head));
+
+	/* Limit requested size to free space and to trail size. */
+	size = MIN(size, space);
+	size = MIN(size, buf->mask + 1 - offset);
+
+	*data = &buf->buf[offset];
+
+	return size;
+}
+
+int ring_buf_spsc_put_finish(struct ring_buf_spsc *buf, uint32_t size)
+{
+	uint32_t tail = buf->tail;
+
+	if (size > buf->mask + 1 - (tail - load_acquire(&buf->head))) {
+		return -EINVAL;
+	}
+
+	store_release(&buf->tail, tail + size);
+
+	return 0;
+}
+
+uint32_t ring_buf_spsc_put(struct ring_buf_spsc *buf, const uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *dst;
+	uint32_t partial_size;
+	uint32_t total_size = 0U;
+	int err;
+
+	/* Publish each part, so that a claim returns the next one. */
+	do {
+		partial_size = ring_buf_spsc_put_claim(buf, &dst, size);
+		memcpy(dst, data, partial_size);
+		err = ring_buf_spsc_put_finish(buf, partial_size);
+		__ASSERT_NO_MSG(err == 0);
+		total_size += partial_size;
+		size -= partial_size;
+		data += partial_size;
+	} while (size && partial_size);
+
+	return total_size;
+}
+
+uint32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t head = buf->head;
+	uint32_t offset = head & buf->mask;
+	uint32_t available = load_acquire(&buf->tail) - head;
+
+	/* Limit requested size to available size and to trail size. */
+	size = MIN(size, available);
+	size = MIN(size, buf->mask + 1 - offset);
+
+	*data = &buf->buf[offset];
+
+	return size;
+}
+
+int ring_buf_spsc_get_finish(struct ring_buf_spsc *buf, uint32_t size)
+{
+	uint32_t head = buf->head;
+
+	if (size > load_acquire(&buf->tail) - head) {
+		return -EINVAL;
+	}
+
+	store_release(&buf->head, head + size);
+
+	return 0;
+}
+
+uint32_t ring_buf_spsc_get(struct ring_buf_spsc *buf, uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *src;
+	uint32_t partial_size;
+	uint32_t total_size = 0U;
+	int err;
+
+	do {
+		partial_size = ring_buf_spsc_get_claim(buf, &src, size);
+		memcpy(data, src, partial_size);
+		err = ring_buf_spsc_get_finish(buf, partial_size);
+		__ASSERT_NO_MSG(err == 0);
+		total_size += partial_size;
+		size -= partial_size;
+		data += partial_size;
+	} while (size && partial_size);
+
+	return total_size;
+}
+
+/*
+ * Multiple producer, single consumer record ring buffer. Producers claim
+ * space by moving tail with a CAS, and write the record header with the
+ * length first, then with MPSC_COMMITTED once the data is filled in. The
+ * consumer zeroes every word it frees, so a header is non-committed until
+ * its producer says otherwise. A record which would cross the end of the
+ * buffer is preceded by a committed skip record covering the trail.
+ */
+
+#define MPSC_COMMITTED BIT(31)
+#define MPSC_SKIP BIT(30)
+#define MPSC_LEN_MASK BIT_MASK(30)
+
+static inline uint32_t mpsc_words(uint32_t size)
+{
+	/* Header and data padded to 32 bits. */
+	return 1 + ceiling_fraction(size, sizeof(uint32_t));
+}
+
+void ring_buf_mpsc_init(struct ring_buf_mpsc *buf, uint32_t size32,
+			uint32_t *data)
+{
+	__ASSERT_NO_MSG(is_power_of_two(size32));
+
+	memset(data, 0, size32 * sizeof(uint32_t));
+	atomic_set(&buf->tail, 0);
+	buf->head = 0U;
+	buf->mask = size32 - 1;
+	buf->buf = data;
+}
+
+int ring_buf_mpsc_put_claim(struct ring_buf_mpsc *buf, void **data,
+			    uint32_t size)
+{
+	uint32_t words = mpsc_words(size);
+	uint32_t capacity = buf->mask + 1;
+	uint32_t tail, offset, pad;
+
+	/* Then padding and record always fit in an empty buffer. */
+	if (size > MPSC_LEN_MASK || words > capacity / 2) {
+		return -EMSGSIZE;
+	}
+
+	do {
+		tail = (uint32_t)atomic_get(&buf->tail);
+		offset = tail & buf->mask;
+		pad = (offset + words > capacity) ? capacity - offset : 0;
+
+		if (tail + pad + words - load_acquire(&buf->head) > capacity) {
+			return -ENOMEM;
+		}
+	} while (!atomic_cas(&buf->tail, (atomic_val_t)tail,
+			     (atomic_val_t)(tail + pad + words)));
+
+	if (pad) {
+		store_release(&buf->buf[offset],
+			      MPSC_COMMITTED | MPSC_SKIP | pad);
+		offset = 0U;
+	}
+
+	__atomic_store_n(&buf->buf[offset], size, __ATOMIC_RELAXED);
+	*data = &buf->buf[offset + 1];
+
+	return 0;
+}
+
+void ring_buf_mpsc_put_commit(struct ring_buf_mpsc *buf, void *data)
+{
+	uint32_t *hdr = (uint32_t *)data - 1;
+
+	ARG_UNUSED(buf);
+
+	store_release(hdr, *hdr | MPSC_COMMITTED);
+}
+
+int ring_buf_mpsc_get_claim(struct ring_buf_mpsc *buf, void **data)
+{
+	uint32_t head = buf->head;
+	uint32_t hdr;
+
+	while (true) {
+		hdr = load_acquire(&buf->buf[head & buf->mask]);
+		if (!(hdr & MPSC_COMMITTED)) {
+			return -EAGAIN;
+		}
+
+		if (!(hdr & MPSC_SKIP)) {
+			break;
+		}
+
+		/* The padding words were zeroed when they were freed. */
+		buf->buf[head & buf->mask] = 0U;
+		head += hdr & MPSC_LEN_MASK;
+		store_release(&buf->head, head);
+	}
+
+	*data = &buf->buf[(head & buf->mask) + 1];
+
+	return hdr & MPSC_LEN_MASK;
+}
+
+void ring_buf_mpsc_get_finish(struct ring_buf_mpsc *buf)
+{
+	uint32_t head = buf->head;
+	uint32_t *hdr = &buf->buf[head & buf->mask];
+	uint32_t words = mpsc_words(*hdr & MPSC_LEN_MASK);
+
+	__ASSERT_NO_MSG((*hdr & (MPSC_COMMITTED | MPSC_SKIP)) ==
+			MPSC_COMMITTED);
+
+	memset(hdr, 0, words * sizeof(uint32_t));
+	store_release(&buf->head, head + words);
+}
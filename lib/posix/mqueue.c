@@ -4,14 +4,17 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <kernel.h>
+#include <init.h>
 #include <errno.h>
 #include <string.h>
 #include <sys/atomic.h>
+#include <sys/hashtable.h>
+#include <sys/sys_heap.h>
 #include <posix/time.h>
 #include <posix/mqueue.h>
 
 typedef struct mqueue_object {
-	sys_snode_t snode;
+	struct sys_hashnode hnode;
 	char *mem_buffer;
 	char *mem_obj;
 	struct k_msgq queue;
@@ -27,11 +30,17 @@ typedef struct mqueue_desc {
 
 K_SEM_DEFINE(mq_sem, 1, 1);
 
-/* Initialize the list */
-sys_slist_t mq_list = SYS_SLIST_STATIC_INIT(&mq_list);
+static bool mq_name_eq(const struct sys_hashnode *node, const void *key);
+
+/* Named message queues, protected by mq_sem. The slot array grows in a heap
+ * of its own.
+ */
+static char __aligned(8) mq_registry_mem[CONFIG_MQUEUE_REGISTRY_HEAP_SIZE];
+static struct sys_heap mq_registry_heap;
+static struct sys_hashtable mq_registry;
 
 int64_t timespec_to_timeoutms(const struct timespec *abstime);
-static mqueue_object *find_in_list(const char *name);
+static mqueue_object *find_mq(const char *name);
 static int32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
 			  k_timeout_t timeout);
 static int receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
@@ -41,8 +50,10 @@ static void remove_mq(mqueue_object *msg_queue);
 /**
  * @brief Open a message queue.
  *
- * Number of message queue and descriptor to message queue are limited by
- * heap size. increase the size through CONFIG_HEAP_MEM_POOL_SIZE.
+ * Message queues and their descriptors are allocated from the heap, whose
+ * size is set through CONFIG_HEAP_MEM_POOL_SIZE, and the name registry
+ * grows as needed in CONFIG_MQUEUE_REGISTRY_HEAP_SIZE bytes. Opening a
+ * message queue fails with ENOSPC once either is exhausted.
  *
  * See IEEE 1003.1
  */
@@ -79,19 +90,22 @@ mqd_t mq_open(const char *name, int oflags, ...)
 		return (mqd_t)mqd;
 	}
 
-	/* Check if queue already exists */
+	/* Check if queue already exists, the lock is held until the queue
+	 * is either referenced or created and registered.
+	 */
 	k_sem_take(&mq_sem, K_FOREVER);
-	msg_queue = find_in_list(name);
-	k_sem_give(&mq_sem);
+	msg_queue = find_mq(name);
 
 	if ((msg_queue != NULL) && (oflags & O_CREAT) != 0 &&
 	    (oflags & O_EXCL) != 0) {
 		/* Message queue has alreadey been opened and O_EXCL is set */
+		k_sem_give(&mq_sem);
 		errno = EEXIST;
 		return (mqd_t)mqd;
 	}
 
 	if ((msg_queue == NULL) && (oflags & O_CREAT) == 0) {
+		k_sem_give(&mq_sem);
 		errno = ENOENT;
 		return (mqd_t)mqd;
 	}
@@ -145,22 +159,27 @@ mqd_t mq_open(const char *name, int oflags, ...)
 			goto free_mq_buffer;
 		}
 
+		if (sys_hashtable_insert(&mq_registry, &msg_queue->hnode,
+					 sys_hash32(name, strlen(name))) != 0) {
+			goto free_mq_registry;
+		}
+
 		(void)atomic_set(&msg_queue->ref_count, 1);
 		/* initialize zephyr message queue */
 		k_msgq_init(&msg_queue->queue, msg_queue->mem_buffer, msg_size,
 			    max_msgs);
-		k_sem_take(&mq_sem, K_FOREVER);
-		sys_slist_append(&mq_list, (sys_snode_t *)&(msg_queue->snode));
-		k_sem_give(&mq_sem);
-
 	} else {
 		atomic_inc(&msg_queue->ref_count);
 	}
 
+	k_sem_give(&mq_sem);
+
 	msg_queue_desc->mqueue = msg_queue;
 	msg_queue_desc->flags = (oflags & O_NONBLOCK) != 0 ? O_NONBLOCK : 0;
 	return (mqd_t)msg_queue_desc;
 
+free_mq_registry:
+	k_free(mq_buf_ptr);
 free_mq_buffer:
 	k_free(mq_name_ptr);
 free_mq_name:
@@ -168,6 +187,7 @@ free_mq_name:
 free_mq_object:
 	k_free(mq_desc_ptr);
 free_mq_desc:
+	k_sem_give(&mq_sem);
 	errno = ENOSPC;
 	return (mqd_t)mqd;
 }
@@ -186,12 +206,14 @@ int mq_close(mqd_t mqdes)
 		return -1;
 	}
 
+	k_sem_take(&mq_sem, K_FOREVER);
 	atomic_dec(&mqd->mqueue->ref_count);
 
 	/* remove mq if marked for unlink */
 	if (mqd->mqueue->name == NULL) {
 		remove_mq(mqd->mqueue);
 	}
+	k_sem_give(&mq_sem);
 
 	k_free(mqd->mem_desc);
 	return 0;
@@ -207,7 +229,7 @@ int mq_unlink(const char *name)
 	mqueue_object *msg_queue;
 
 	k_sem_take(&mq_sem, K_FOREVER);
-	msg_queue = find_in_list(name);
+	msg_queue = find_mq(name);
 
 	if (msg_queue == NULL) {
 		k_sem_give(&mq_sem);
@@ -215,10 +237,12 @@ int mq_unlink(const char *name)
 		return -1;
 	}
 
+	/* The name is released at once, the queue once it is closed */
+	(void)sys_hashtable_remove_node(&mq_registry, &msg_queue->hnode);
 	k_free(msg_queue->name);
 	msg_queue->name = NULL;
-	k_sem_give(&mq_sem);
 	remove_mq(msg_queue);
+	k_sem_give(&mq_sem);
 	return 0;
 }
 
@@ -341,23 +365,25 @@ int mq_setattr(mqd_t mqdes, const struct mq_attr *mqstat,
 }
 
 /* Internal functions */
-static mqueue_object *find_in_list(const char *name)
+static bool mq_name_eq(const struct sys_hashnode *node, const void *key)
 {
-	sys_snode_t *mq;
-	mqueue_object *msg_queue;
+	const mqueue_object *msg_queue =
+		CONTAINER_OF(node, mqueue_object, hnode);
 
-	mq = mq_list.head;
+	return strcmp(msg_queue->name, key) == 0;
+}
 
-	while (mq != NULL) {
-		msg_queue = (mqueue_object *)mq;
-		if (strcmp(msg_queue->name, name) == 0) {
-			return msg_queue;
-		}
+static mqueue_object *find_mq(const char *name)
+{
+	struct sys_hashnode *node;
 
-		mq = mq->next;
+	node = sys_hashtable_find(&mq_registry, sys_hash32(name, strlen(name)),
+				  name);
+	if (node == NULL) {
+		return NULL;
 	}
 
-	return NULL;
+	return CONTAINER_OF(node, mqueue_object, hnode);
 }
 
 static int32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
@@ -415,15 +441,25 @@ static int32_t receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
 	return ret;
 }
 
+/* Called with mq_sem held, once the queue is unlinked */
 static void remove_mq(mqueue_object *msg_queue)
 {
 	if (atomic_cas(&msg_queue->ref_count, 0, 0)) {
-		k_sem_take(&mq_sem, K_FOREVER);
-		sys_slist_find_and_remove(&mq_list, (sys_snode_t *) msg_queue);
-		k_sem_give(&mq_sem);
-
 		/* Free mq buffer and pbject */
 		k_free(msg_queue->mem_buffer);
 		k_free(msg_queue->mem_obj);
 	}
 }
+
+static int mq_registry_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	sys_heap_init(&mq_registry_heap, mq_registry_mem,
+		      sizeof(mq_registry_mem));
+	sys_hashtable_init_heap(&mq_registry, &mq_registry_heap, mq_name_eq);
+
+	return 0;
+}
+
+SYS_INIT(mq_registry_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
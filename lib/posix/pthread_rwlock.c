@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <kernel.h>
+#include <ksched.h>
+#include <wait_q.h>
 #include <errno.h>
 #include <posix/time.h>
 #include <posix/posix_types.h>
@@ -11,11 +13,26 @@
 #define INITIALIZED 1
 #define NOT_INITIALIZED 0
 
-#define CONCURRENT_READER_LIMIT  (CONFIG_MAX_PTHREAD_COUNT + 1)
+/*
+ * The lock state is a single atomic word: the number of readers holding
+ * the lock, a bit set while a writer holds it, and a bit per wait queue
+ * set while threads may be pending on it. Uncontended lock and unlock
+ * are a single compare-and-swap, like a futex; the wait queues are only
+ * touched, with interrupts locked, when one of these bits is set.
+ *
+ * Readers do not take the lock while a writer waits for it, so that
+ * writers are not starved. A thread woken from a wait queue is handed
+ * the lock by the thread that released it.
+ */
+#define RW_WRITER	0x40000000
+#define RW_WR_WAIT	0x20000000
+#define RW_RD_WAIT	0x10000000
+#define RW_READERS	0x0fffffff
 
 int64_t timespec_to_timeoutms(const struct timespec *abstime);
 static uint32_t read_lock_acquire(pthread_rwlock_t *rwlock, int32_t timeout);
 static uint32_t write_lock_acquire(pthread_rwlock_t *rwlock, int32_t timeout);
+static void wake_waiters(pthread_rwlock_t *rwlock);
 
 /**
  * @brief Initialize read-write lock object.
@@ -25,10 +42,9 @@ static uint32_t write_lock_acquire(pthread_rwlock_t *rwlock, int32_t timeout);
 int pthread_rwlock_init(pthread_rwlock_t *rwlock,
 			const pthread_rwlockattr_t *attr)
 {
-	k_sem_init(&rwlock->rd_sem, CONCURRENT_READER_LIMIT,
-		   CONCURRENT_READER_LIMIT);
-	k_sem_init(&rwlock->wr_sem, 1, 1);
-	k_sem_init(&rwlock->reader_active, 1, 1);
+	(void)atomic_set(&rwlock->state, 0);
+	z_waitq_init(&rwlock->rd_wait_q);
+	z_waitq_init(&rwlock->wr_wait_q);
 	rwlock->wr_owner = NULL;
 	rwlock->status = INITIALIZED;
 	return 0;
@@ -45,7 +61,7 @@ int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
 		return EINVAL;
 	}
 
-	if (rwlock->wr_owner != NULL) {
+	if (atomic_get(&rwlock->state) != 0) {
 		return EBUSY;
 	}
 
@@ -60,8 +76,7 @@ int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for reading.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
+ * Readers wait while a writer holds or waits for the lock.
  *
  * See IEEE 1003.1
  */
@@ -77,8 +92,7 @@ int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for reading within specific time.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
+ * Readers wait while a writer holds or waits for the lock.
  *
  * See IEEE 1003.1
  */
@@ -105,8 +119,7 @@ int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock,
 /**
  * @brief Lock a read-write lock object for reading immedately.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
+ * Readers fail to get the lock while a writer holds or waits for it.
  *
  * See IEEE 1003.1
  */
@@ -122,8 +135,8 @@ int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for writing.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
+ * Write lock has priority over reader lock, new readers wait
+ * while a writer waits for the lock.
  *
  * See IEEE 1003.1
  */
@@ -139,8 +152,8 @@ int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for writing within specific time.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
+ * Write lock has priority over reader lock, new readers wait
+ * while a writer waits for the lock.
  *
  * See IEEE 1003.1
  */
@@ -167,8 +180,8 @@ int pthread_rwlock_timedwrlock(pthread_rwlock_t *rwlock,
 /**
  * @brief Lock a read-write lock object for writing immedately.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
+ * Write lock has priority over reader lock, new readers wait
+ * while a writer waits for the lock.
  *
  * See IEEE 1003.1
  */
@@ -189,6 +202,9 @@ int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock)
  */
 int pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
 {
+	atomic_val_t state;
+	unsigned int key;
+
 	if (rwlock->status == NOT_INITIALIZED) {
 		return EINVAL;
 	}
@@ -196,66 +212,186 @@ int pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
 	if (k_current_get() == rwlock->wr_owner) {
 		/* Write unlock */
 		rwlock->wr_owner = NULL;
-		k_sem_give(&rwlock->reader_active);
-		k_sem_give(&rwlock->wr_sem);
+		if (atomic_cas(&rwlock->state, RW_WRITER, 0)) {
+			return 0;
+		}
+
+		key = irq_lock();
+		(void)atomic_and(&rwlock->state, ~RW_WRITER);
 	} else {
 		/* Read unlock */
-		if (k_sem_count_get(&rwlock->rd_sem) ==
-				    (CONCURRENT_READER_LIMIT - 1)) {
-			/* Last read lock, unlock writer */
-			k_sem_give(&rwlock->reader_active);
+		do {
+			state = atomic_get(&rwlock->state);
+			if ((state & RW_READERS) == 0) {
+				return EPERM;
+			}
+		} while (!atomic_cas(&rwlock->state, state, state - 1));
+
+		/* Only the last reader hands the lock to a waiting writer */
+		if ((state & RW_READERS) != 1 || (state & RW_WR_WAIT) == 0) {
+			return 0;
 		}
 
-		k_sem_give(&rwlock->rd_sem);
+		key = irq_lock();
 	}
+
+	wake_waiters(rwlock);
+	z_reschedule_irqlock(key);
 	return 0;
 }
 
+/* Called with interrupts locked, when the lock may have been released */
+static void wake_waiters(pthread_rwlock_t *rwlock)
+{
+	struct k_thread *thread;
+	atomic_val_t state = atomic_get(&rwlock->state);
+	int readers = 0;
+
+	if ((state & RW_WRITER) != 0) {
+		/* Taken by another writer, which wakes them in turn */
+		return;
+	}
+
+	if ((state & RW_WR_WAIT) != 0) {
+		if ((state & RW_READERS) != 0) {
+			return;
+		}
+
+		/* Neither fast path can change the state while a writer
+		 * waits and no reader holds the lock, so it can be updated
+		 * in two steps.
+		 */
+		thread = z_unpend_first_thread(&rwlock->wr_wait_q);
+		if (thread != NULL) {
+			(void)atomic_or(&rwlock->state, RW_WRITER);
+			if (z_waitq_head(&rwlock->wr_wait_q) == NULL) {
+				(void)atomic_and(&rwlock->state, ~RW_WR_WAIT);
+			}
+
+			rwlock->wr_owner = thread;
+			z_ready_thread(thread);
+			arch_thread_return_value_set(thread, 0);
+			return;
+		}
+
+		(void)atomic_and(&rwlock->state, ~RW_WR_WAIT);
+	}
+
+	if ((state & RW_RD_WAIT) != 0) {
+		while ((thread = z_unpend_first_thread(&rwlock->rd_wait_q)) !=
+		       NULL) {
+			z_ready_thread(thread);
+			arch_thread_return_value_set(thread, 0);
+			readers++;
+		}
+
+		/* Count the woken readers before clearing the bit */
+		(void)atomic_add(&rwlock->state, readers - RW_RD_WAIT);
+	}
+}
 
 static uint32_t read_lock_acquire(pthread_rwlock_t *rwlock, int32_t timeout)
 {
-	uint32_t ret = 0U;
+	atomic_val_t state;
+	unsigned int key;
+	int rc;
+
+	while (true) {
+		state = atomic_get(&rwlock->state);
+		if ((state & (RW_WRITER | RW_WR_WAIT)) != 0 ||
+		    (state & RW_READERS) == RW_READERS) {
+			break;
+		}
 
-	if (k_sem_take(&rwlock->wr_sem, SYS_TIMEOUT_MS(timeout)) == 0) {
-		k_sem_take(&rwlock->reader_active, K_NO_WAIT);
-		k_sem_take(&rwlock->rd_sem, K_NO_WAIT);
-		k_sem_give(&rwlock->wr_sem);
-	} else {
-		ret = EBUSY;
+		if (atomic_cas(&rwlock->state, state, state + 1)) {
+			return 0;
+		}
 	}
 
-	return ret;
+	if (timeout == 0) {
+		return EBUSY;
+	}
+
+	key = irq_lock();
+	while (true) {
+		state = atomic_get(&rwlock->state);
+		if ((state & (RW_WRITER | RW_WR_WAIT)) == 0) {
+			if ((state & RW_READERS) == RW_READERS) {
+				irq_unlock(key);
+				return EAGAIN;
+			}
+
+			if (atomic_cas(&rwlock->state, state, state + 1)) {
+				irq_unlock(key);
+				return 0;
+			}
+		} else if (atomic_cas(&rwlock->state, state,
+				      state | RW_RD_WAIT)) {
+			break;
+		}
+	}
+
+	rc = z_pend_curr_irqlock(key, &rwlock->rd_wait_q,
+				 SYS_TIMEOUT_MS(timeout));
+	if (rc == 0) {
+		return 0;
+	}
+
+	key = irq_lock();
+	if (z_waitq_head(&rwlock->rd_wait_q) == NULL) {
+		(void)atomic_and(&rwlock->state, ~RW_RD_WAIT);
+	}
+	irq_unlock(key);
+
+	return EBUSY;
 }
 
 static uint32_t write_lock_acquire(pthread_rwlock_t *rwlock, int32_t timeout)
 {
-	uint32_t ret = 0U;
-	int64_t elapsed_time, st_time = k_uptime_get();
-	k_timeout_t k_timeout;
-
-	k_timeout = SYS_TIMEOUT_MS(timeout);
-
-	/* waiting for release of write lock */
-	if (k_sem_take(&rwlock->wr_sem, k_timeout) == 0) {
-		/* update remaining timeout time for 2nd sem */
-		if (timeout != SYS_FOREVER_MS) {
-			elapsed_time = k_uptime_get() - st_time;
-			timeout = timeout <= elapsed_time ? 0 :
-				  timeout - elapsed_time;
-		}
+	atomic_val_t state;
+	unsigned int key;
+	int rc;
 
-		k_timeout = SYS_TIMEOUT_MS(timeout);
+	if (atomic_cas(&rwlock->state, 0, RW_WRITER)) {
+		rwlock->wr_owner = k_current_get();
+		return 0;
+	}
+
+	if (timeout == 0) {
+		return EBUSY;
+	}
 
-		/* waiting for reader to complete operation */
-		if (k_sem_take(&rwlock->reader_active, k_timeout) == 0) {
-			rwlock->wr_owner = k_current_get();
-		} else {
-			k_sem_give(&rwlock->wr_sem);
-			ret = EBUSY;
+	key = irq_lock();
+	while (true) {
+		state = atomic_get(&rwlock->state);
+		if ((state & (RW_WRITER | RW_READERS)) == 0) {
+			/* Released meanwhile */
+			if (atomic_cas(&rwlock->state, state,
+				       state | RW_WRITER)) {
+				rwlock->wr_owner = k_current_get();
+				irq_unlock(key);
+				return 0;
+			}
+		} else if (atomic_cas(&rwlock->state, state,
+				      state | RW_WR_WAIT)) {
+			break;
 		}
+	}
 
-	} else {
-		ret = EBUSY;
+	/* wr_owner is set by the thread handing over the lock */
+	rc = z_pend_curr_irqlock(key, &rwlock->wr_wait_q,
+				 SYS_TIMEOUT_MS(timeout));
+	if (rc == 0) {
+		return 0;
 	}
-	return ret;
+
+	/* Readers held back by this writer may go on */
+	key = irq_lock();
+	if (z_waitq_head(&rwlock->wr_wait_q) == NULL) {
+		(void)atomic_and(&rwlock->state, ~RW_WR_WAIT);
+		wake_waiters(rwlock);
+	}
+	z_reschedule_irqlock(key);
+
+	return EBUSY;
 }
@@ -91,6 +91,15 @@ static struct net_buf *process_prio_evt(struct node_rx_pdu *node_rx,
 	return NULL;
 }
 
+static void recv_batch_flush(sys_slist_t *batch, uint8_t *batch_len)
+{
+	if (*batch_len) {
+		/* Wakes up recv_thread() once for all nodes in the batch */
+		k_fifo_put_slist(&recv_fifo, batch);
+		*batch_len = 0U;
+	}
+}
+
 /**
  * @brief Handover from Controller thread to Host thread
  * @details Execution context: Controller thread
@@ -101,6 +110,13 @@ static struct net_buf *process_prio_evt(struct node_rx_pdu *node_rx,
  */
 static void prio_recv_thread(void *p1, void *p2, void *p3)
 {
+	/* Rx nodes not yet handed over to recv_thread() */
+	sys_slist_t batch;
+	uint8_t batch_len;
+
+	sys_slist_init(&batch);
+	batch_len = 0U;
+
 	while (1) {
 		struct node_rx_pdu *node_rx;
 		struct net_buf *buf;
@@ -134,6 +150,12 @@ static void prio_recv_thread(void *p1, void *p2, void *p3)
 			buf = process_prio_evt(node_rx, &evt_flags);
 			if (buf) {
 				BT_DBG("Priority event");
+
+				/* Keep the order of nodes handed over before
+				 * this event
+				 */
+				recv_batch_flush(&batch, &batch_len);
+
 				if (!(evt_flags & BT_HCI_EVT_FLAG_RECV)) {
 					node_rx->hdr.next = NULL;
 					ll_rx_mem_release((void **)&node_rx);
@@ -153,7 +175,11 @@ static void prio_recv_thread(void *p1, void *p2, void *p3)
 				 * recv_thread()
 				 */
 				BT_DBG("RX node enqueue");
-				k_fifo_put(&recv_fifo, node_rx);
+				sys_slist_append(&batch, (void *)node_rx);
+				batch_len++;
+				if (batch_len >= CONFIG_BT_RX_BATCH_SIZE) {
+					recv_batch_flush(&batch, &batch_len);
+				}
 			}
 
 			/* There may still be completed nodes, continue
@@ -164,6 +190,9 @@ static void prio_recv_thread(void *p1, void *p2, void *p3)
 
 		}
 
+		/* Hand over what has been collected before waiting */
+		recv_batch_flush(&batch, &batch_len);
+
 		BT_DBG("sem take...");
 		/* Wait until ULL mayfly has something to give us.
 		 * Blocking-take of the semaphore; we take it once ULL mayfly
@@ -343,6 +372,19 @@ static inline struct net_buf *process_hbuf(struct node_rx_pdu *n)
 }
 #endif
 
+static inline void recv_buf(struct net_buf *buf)
+{
+	if (buf) {
+		if (buf->len) {
+			BT_DBG("Packet in: type:%u len:%u",
+				bt_buf_get_type(buf), buf->len);
+			bt_recv(buf);
+		} else {
+			net_buf_unref(buf);
+		}
+	}
+}
+
 /**
  * @brief Blockingly pull from Controller thread's recv_fifo
  * @details Execution context: Host thread
@@ -394,14 +436,24 @@ static void recv_thread(void *p1, void *p2, void *p3)
 			buf = process_node(node_rx);
 		}
 
-		if (buf) {
-			if (buf->len) {
-				BT_DBG("Packet in: type:%u len:%u",
-					bt_buf_get_type(buf), buf->len);
-				bt_recv(buf);
-			} else {
-				net_buf_unref(buf);
+		recv_buf(buf);
+
+		/* Process further nodes handed over in the same batch before
+		 * yielding
+		 */
+		for (uint8_t i = 1U; i < CONFIG_BT_RX_BATCH_SIZE; i++) {
+			node_rx = k_fifo_get(&recv_fifo, K_NO_WAIT);
+			if (!node_rx) {
+				break;
 			}
+
+#if defined(CONFIG_BT_HCI_ACL_FLOW_CONTROL)
+			/* Only updates host buffers and signals pending nodes
+			 * when given a node
+			 */
+			(void)process_hbuf(node_rx);
+#endif
+			recv_buf(process_node(node_rx));
 		}
 
 		k_yield();
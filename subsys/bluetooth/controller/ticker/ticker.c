@@ -228,6 +228,14 @@ struct ticker_instance {
 	uint8_t  ticker_id_head;      /* Index of first ticker node (next to
 				    * expire)
 				    */
+#if !defined(CONFIG_BT_TICKER_COMPATIBILITY_MODE)
+	uint8_t  ticker_id_hint;      /* Index of last enqueued ticker node,
+				    * valid while ticker_job inserts nodes
+				    */
+	uint32_t ticks_hint;	   /* Total ticks until expiration of the
+				    * hint node
+				    */
+#endif /* !CONFIG_BT_TICKER_COMPATIBILITY_MODE */
 	uint8_t  job_guard;	   /* Flag preventing ticker_worker from
 				    * running if ticker_job is active
 				    */
@@ -388,7 +396,11 @@ static void ticker_by_next_slot_get(struct ticker_instance *instance,
  * @brief Enqueue ticker node
  *
  * @details Finds insertion point for new ticker node and inserts the
- * node in the linked node list.
+ * node in the linked node list. If the previously enqueued node is still
+ * a valid hint and expires before the new node, the search starts after
+ * it instead of at the head of the list. This only shortens the walks of
+ * the nodes ticker_job re-inserts in expiry order, the search remains
+ * linear in the number of nodes.
  *
  * @param instance Pointer to ticker instance
  * @param id       Ticker node id to enqueue
@@ -405,17 +417,31 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance, uint8_t id)
 	uint32_t ticks_to_expire;
 	uint8_t previous;
 	uint8_t current;
+	uint8_t hint;
 
 	node = &instance->nodes[0];
 	ticker_new = &node[id];
 	ticks_to_expire = ticker_new->ticks_to_expire;
 	current = instance->ticker_id_head;
+	previous = TICKER_NULL;
+
+	/* Nodes expiring strictly before the new node are always passed by the
+	 * search below, so resume it after the hint node when possible.
+	 */
+	hint = instance->ticker_id_hint;
+	if ((hint != TICKER_NULL) && (ticks_to_expire > instance->ticks_hint)) {
+		ticks_to_expire -= instance->ticks_hint;
+		previous = hint;
+		current = node[hint].next;
+	}
+
+	/* Hint the next enqueue with the total ticks of this node */
+	instance->ticker_id_hint = id;
+	instance->ticks_hint = ticker_new->ticks_to_expire;
 
 	/* Find insertion point for new ticker node and adjust ticks_to_expire
 	 * relative to insertion point
 	 */
-	previous = TICKER_NULL;
-
 	while ((current != TICKER_NULL) && (ticks_to_expire >=
 		(ticks_to_expire_current =
 		(ticker_current = &node[current])->ticks_to_expire))) {
@@ -1973,6 +1999,13 @@ static inline void ticker_job_list_insert(struct ticker_instance *instance,
 	users = &instance->users[0];
 	count_user = instance->count_user;
 
+#if !defined(CONFIG_BT_TICKER_COMPATIBILITY_MODE)
+	/* Nodes are only enqueued below, which keeps the total ticks of the
+	 * nodes already in the list unchanged and a hint valid.
+	 */
+	instance->ticker_id_hint = TICKER_NULL;
+#endif /* !CONFIG_BT_TICKER_COMPATIBILITY_MODE */
+
 	/* Iterate through all user ids */
 	while (count_user--) {
 		struct ticker_user_op *user_ops;
@@ -2052,6 +2085,11 @@ static inline void ticker_job_list_insert(struct ticker_instance *instance,
 			}
 		}
 	}
+
+#if !defined(CONFIG_BT_TICKER_COMPATIBILITY_MODE)
+	/* Other list operations invalidate the hint */
+	instance->ticker_id_hint = TICKER_NULL;
+#endif /* !CONFIG_BT_TICKER_COMPATIBILITY_MODE */
 }
 
 /**
@@ -2413,6 +2451,9 @@ uint32_t ticker_init(uint8_t instance_index, uint8_t count_node, void *node,
 
 	instance->ticker_id_head = TICKER_NULL;
 	instance->ticker_id_slot_previous = TICKER_NULL;
+#if !defined(CONFIG_BT_TICKER_COMPATIBILITY_MODE)
+	instance->ticker_id_hint = TICKER_NULL;
+#endif /* !CONFIG_BT_TICKER_COMPATIBILITY_MODE */
 	instance->ticks_slot_previous = 0U;
 	instance->ticks_current = 0U;
 	instance->ticks_elapsed_first = 0U;
@@ -11,10 +11,73 @@
 #include <sys/byteorder.h>
 #include <bluetooth/crypto.h>
 
+#if defined(CONFIG_BT_HOST_CRYPTO)
+#include <tinycrypt/constants.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/utils.h>
+#endif
+
 #define BT_DBG_ENABLED IS_ENABLED(CONFIG_BT_DEBUG_HCI_CORE)
 #define LOG_MODULE_NAME bt_aes_ccm
 #include "common/log.h"
 
+/* Every block of a message is encrypted with the same key.  When the AES
+ * implementation is local, expand the key schedule once per message
+ * instead of once per block.
+ */
+#if defined(CONFIG_BT_HOST_CRYPTO)
+struct ccm_key {
+	struct tc_aes_key_sched_struct sched;
+};
+
+static int ccm_key_init(struct ccm_key *ck, const uint8_t key[16])
+{
+	if (tc_aes128_set_encrypt_key(&ck->sched, key) == TC_CRYPTO_FAIL) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int ccm_encrypt(const struct ccm_key *ck, const uint8_t in[16],
+		       uint8_t out[16])
+{
+	if (tc_aes_encrypt(out, in, &ck->sched) == TC_CRYPTO_FAIL) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* The expanded key schedule is as sensitive as the key itself */
+static void ccm_key_clear(struct ccm_key *ck)
+{
+	_set(&ck->sched, 0, sizeof(ck->sched));
+}
+#else
+struct ccm_key {
+	const uint8_t *key;
+};
+
+static int ccm_key_init(struct ccm_key *ck, const uint8_t key[16])
+{
+	ck->key = key;
+
+	return 0;
+}
+
+static int ccm_encrypt(const struct ccm_key *ck, const uint8_t in[16],
+		       uint8_t out[16])
+{
+	return bt_encrypt_be(ck->key, in, out);
+}
+
+static void ccm_key_clear(struct ccm_key *ck)
+{
+	ck->key = NULL;
+}
+#endif /* CONFIG_BT_HOST_CRYPTO */
+
 static inline void xor16(uint8_t *dst, const uint8_t *a, const uint8_t *b)
 {
 	dst[0] = a[0] ^ b[0];
@@ -36,9 +99,9 @@ static inline void xor16(uint8_t *dst, const uint8_t *a, const uint8_t *b)
 }
 
 /* pmsg is assumed to have the nonce already present in bytes 1-13 */
-static int ccm_calculate_X0(const uint8_t key[16], const uint8_t *aad, uint8_t aad_len,
-			    size_t mic_size, uint8_t msg_len, uint8_t b[16],
-			    uint8_t X0[16])
+static int ccm_calculate_X0(const struct ccm_key *key, const uint8_t *aad,
+			    uint8_t aad_len, size_t mic_size, uint8_t msg_len,
+			    uint8_t b[16], uint8_t X0[16])
 {
 	int i, j, err;
 
@@ -47,7 +110,7 @@ static int ccm_calculate_X0(const uint8_t key[16], const uint8_t *aad, uint8_t a
 
 	sys_put_be16(msg_len, b + 14);
 
-	err = bt_encrypt_be(key, b, X0);
+	err = ccm_encrypt(key, b, X0);
 	if (err) {
 		return err;
 	}
@@ -71,7 +134,7 @@ static int ccm_calculate_X0(const uint8_t key[16], const uint8_t *aad, uint8_t a
 			aad_len -= 16;
 			i = 0;
 
-			err = bt_encrypt_be(key, b, X0);
+			err = ccm_encrypt(key, b, X0);
 			if (err) {
 				return err;
 			}
@@ -85,7 +148,7 @@ static int ccm_calculate_X0(const uint8_t key[16], const uint8_t *aad, uint8_t a
 			b[i] = X0[i];
 		}
 
-		err = bt_encrypt_be(key, b, X0);
+		err = ccm_encrypt(key, b, X0);
 		if (err) {
 			return err;
 		}
@@ -94,7 +157,7 @@ static int ccm_calculate_X0(const uint8_t key[16], const uint8_t *aad, uint8_t a
 	return 0;
 }
 
-static int ccm_auth(const uint8_t key[16], uint8_t nonce[13],
+static int ccm_auth(const struct ccm_key *key, uint8_t nonce[13],
 		    const uint8_t *cleartext_msg, size_t msg_len, const uint8_t *aad,
 		    size_t aad_len, uint8_t *mic, size_t mic_size)
 {
@@ -114,7 +177,7 @@ static int ccm_auth(const uint8_t key[16], uint8_t nonce[13],
 	/* S[0] = e(AppKey, 0x01 || nonce || 0x0000) */
 	sys_put_be16(0x0000, &b[14]);
 
-	err = bt_encrypt_be(key, b, s0);
+	err = ccm_encrypt(key, b, s0);
 	if (err) {
 		return err;
 	}
@@ -133,7 +196,7 @@ static int ccm_auth(const uint8_t key[16], uint8_t nonce[13],
 			xor16(b, Xn, &cleartext_msg[j * 16]);
 		}
 
-		err = bt_encrypt_be(key, b, Xn);
+		err = ccm_encrypt(key, b, Xn);
 		if (err) {
 			return err;
 		}
@@ -147,7 +210,7 @@ static int ccm_auth(const uint8_t key[16], uint8_t nonce[13],
 	return 0;
 }
 
-static int ccm_crypt(const uint8_t key[16], const uint8_t nonce[13],
+static int ccm_crypt(const struct ccm_key *key, const uint8_t nonce[13],
 		     const uint8_t *in_msg, uint8_t *out_msg, size_t msg_len)
 {
 	uint8_t a_i[16], s_i[16];
@@ -168,7 +231,7 @@ static int ccm_crypt(const uint8_t key[16], const uint8_t nonce[13],
 		/* S_1 = e(AppKey, 0x01 || nonce || 0x0001) */
 		sys_put_be16(j + 1, &a_i[14]);
 
-		err = bt_encrypt_be(key, a_i, s_i);
+		err = ccm_encrypt(key, a_i, s_i);
 		if (err) {
 			return err;
 		}
@@ -190,15 +253,22 @@ int bt_ccm_decrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *enc_
 		   size_t msg_len, const uint8_t *aad, size_t aad_len,
 		   uint8_t *out_msg, size_t mic_size)
 {
+	struct ccm_key ck;
 	uint8_t mic[16];
 
 	if (aad_len >= 0xff00 || mic_size > sizeof(mic)) {
 		return -EINVAL;
 	}
 
-	ccm_crypt(key, nonce, enc_msg, out_msg, msg_len);
+	if (ccm_key_init(&ck, key)) {
+		return -EINVAL;
+	}
+
+	ccm_crypt(&ck, nonce, enc_msg, out_msg, msg_len);
+
+	ccm_auth(&ck, nonce, out_msg, msg_len, aad, aad_len, mic, mic_size);
 
-	ccm_auth(key, nonce, out_msg, msg_len, aad, aad_len, mic, mic_size);
+	ccm_key_clear(&ck);
 
 	if (memcmp(mic, enc_msg + msg_len, mic_size)) {
 		return -EBADMSG;
@@ -212,6 +282,7 @@ int bt_ccm_encrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *msg,
 		   uint8_t *out_msg, size_t mic_size)
 {
 	uint8_t *mic = out_msg + msg_len;
+	struct ccm_key ck;
 
 	BT_DBG("key %s", bt_hex(key, 16));
 	BT_DBG("nonce %s", bt_hex(nonce, 13));
@@ -223,9 +294,15 @@ int bt_ccm_encrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *msg,
 		return -EINVAL;
 	}
 
-	ccm_auth(key, nonce, out_msg, msg_len, aad, aad_len, mic, mic_size);
+	if (ccm_key_init(&ck, key)) {
+		return -EINVAL;
+	}
+
+	ccm_auth(&ck, nonce, msg, msg_len, aad, aad_len, mic, mic_size);
+
+	ccm_crypt(&ck, nonce, msg, out_msg, msg_len);
 
-	ccm_crypt(key, nonce, msg, out_msg, msg_len);
+	ccm_key_clear(&ck);
 
 	return 0;
 }
@@ -69,6 +69,56 @@ NET_BUF_POOL_FIXED_DEFINE(frag_pool, CONFIG_BT_L2CAP_TX_FRAG_COUNT, FRAG_SIZE,
 
 #endif /* CONFIG_BT_L2CAP_TX_FRAG_COUNT > 0 */
 
+#if defined(CONFIG_BT_L2CAP_TX_FRAG_REF)
+/* Room needed in front of a fragment for the ACL header and the driver */
+#define FRAG_REF_HEADROOM (BT_BUF_RESERVE + sizeof(struct bt_hci_acl_hdr))
+
+/* A fragment sent by reference points into its parent buffer, with the
+ * headers written over the tail of the fragment before it. The bytes it
+ * overwrites are restored when the driver releases it. A slot is in use
+ * while its fragment is with the driver.
+ */
+static struct frag_ref {
+	struct net_buf *parent;
+	struct net_buf *frag;
+	uint8_t *head;
+	uint8_t *end;
+	uint8_t saved[FRAG_REF_HEADROOM];
+} frag_refs[CONFIG_BT_MAX_CONN];
+
+static void frag_ref_destroy(struct net_buf *buf)
+{
+	struct frag_ref *ref = NULL;
+	struct net_buf *parent;
+	unsigned int key;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(frag_refs); i++) {
+		if (frag_refs[i].frag == buf) {
+			ref = &frag_refs[i];
+			break;
+		}
+	}
+
+	__ASSERT_NO_MSG(ref);
+
+	memcpy(ref->head, ref->saved, FRAG_REF_HEADROOM);
+	parent = ref->parent;
+
+	net_buf_destroy(buf);
+
+	key = irq_lock();
+	ref->frag = NULL;
+	ref->parent = NULL;
+	irq_unlock(key);
+
+	net_buf_unref(parent);
+}
+
+NET_BUF_POOL_FIXED_DEFINE(frag_ref_pool, CONFIG_BT_MAX_CONN, 0,
+			  frag_ref_destroy);
+#endif /* CONFIG_BT_L2CAP_TX_FRAG_REF */
+
 #if defined(CONFIG_BT_SMP) || defined(CONFIG_BT_BREDR)
 const struct bt_conn_auth_cb *bt_auth;
 #endif /* CONFIG_BT_SMP || CONFIG_BT_BREDR */
@@ -1193,11 +1243,112 @@ static inline uint16_t conn_mtu(struct bt_conn *conn)
 	return bt_dev.le.acl_mtu;
 }
 
+#if defined(CONFIG_BT_L2CAP_TX_FRAG_REF)
+/* Check whether the fragment ending where the remaining data of buf
+ * starts is still with the driver. Writing headers in front of the
+ * remaining data would then corrupt it. Must be called with IRQs locked.
+ */
+static bool frag_ref_busy(struct net_buf *buf)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(frag_refs); i++) {
+		if (frag_refs[i].parent == buf &&
+		    frag_refs[i].end == buf->data) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool frag_ref_pending(struct net_buf *buf)
+{
+	unsigned int key;
+	bool busy;
+
+	key = irq_lock();
+	busy = frag_ref_busy(buf);
+	irq_unlock(key);
+
+	return busy;
+}
+
+/* Returns NULL if the fragment has to be copied instead */
+static struct net_buf *create_frag_ref(struct bt_conn *conn,
+				       struct net_buf *buf)
+{
+	struct frag_ref *ref = NULL;
+	struct net_buf *frag;
+	uint16_t frag_len;
+	unsigned int key;
+	int i;
+
+	if (IS_ENABLED(CONFIG_BT_ISO) && conn->type == BT_CONN_TYPE_ISO) {
+		return NULL;
+	}
+
+	if (net_buf_headroom(buf) < FRAG_REF_HEADROOM) {
+		return NULL;
+	}
+
+	key = irq_lock();
+
+	if (frag_ref_busy(buf)) {
+		irq_unlock(key);
+		return NULL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(frag_refs); i++) {
+		if (!frag_refs[i].parent) {
+			ref = &frag_refs[i];
+			ref->parent = net_buf_ref(buf);
+			break;
+		}
+	}
+
+	irq_unlock(key);
+
+	if (!ref) {
+		return NULL;
+	}
+
+	frag_len = conn_mtu(conn);
+
+	ref->head = buf->data - FRAG_REF_HEADROOM;
+	ref->end = buf->data + frag_len;
+	memcpy(ref->saved, ref->head, FRAG_REF_HEADROOM);
+
+	/* The pool has a buffer for every slot */
+	frag = net_buf_alloc_with_data(&frag_ref_pool, ref->head,
+				       FRAG_REF_HEADROOM + frag_len,
+				       K_NO_WAIT);
+	__ASSERT_NO_MSG(frag);
+
+	ref->frag = frag;
+
+	net_buf_pull(frag, FRAG_REF_HEADROOM);
+	net_buf_pull(buf, frag_len);
+
+	/* Fragments never have a TX completion callback */
+	tx_data(frag)->tx = NULL;
+
+	return frag;
+}
+#endif /* CONFIG_BT_L2CAP_TX_FRAG_REF */
+
 static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 {
 	struct net_buf *frag;
 	uint16_t frag_len;
 
+#if defined(CONFIG_BT_L2CAP_TX_FRAG_REF)
+	frag = create_frag_ref(conn, buf);
+	if (frag) {
+		return frag;
+	}
+#endif
+
 	switch (conn->type) {
 #if defined(CONFIG_BT_ISO)
 	case BT_CONN_TYPE_ISO:
@@ -1217,6 +1368,7 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 	tx_data(frag)->tx = NULL;
 
 	frag_len = MIN(conn_mtu(conn), net_buf_tailroom(frag));
+	frag_len = MIN(frag_len, buf->len);
 
 	net_buf_add_mem(frag, buf->data, frag_len);
 	net_buf_pull(buf, frag_len);
@@ -1260,6 +1412,35 @@ static bool send_buf(struct bt_conn *conn, struct net_buf *buf)
 		}
 	}
 
+#if defined(CONFIG_BT_L2CAP_TX_FRAG_REF)
+	/* The headers of the final part go over the tail of the previous
+	 * fragment. If that is still with the driver, send a copy of the
+	 * final part instead, which takes over the completion callback.
+	 */
+	if (frag_ref_pending(buf)) {
+		frag = create_frag(conn, buf);
+		if (!frag) {
+			return false;
+		}
+
+		if (!buf->len) {
+			tx_data(frag)->tx = tx_data(buf)->tx;
+			tx_data(buf)->tx = NULL;
+
+			if (!send_frag(conn, frag, FRAG_END, true)) {
+				return false;
+			}
+
+			net_buf_unref(buf);
+			return true;
+		}
+
+		if (!send_frag(conn, frag, FRAG_CONT, true)) {
+			return false;
+		}
+	}
+#endif
+
 	return send_frag(conn, buf, FRAG_END, false);
 }
 
@@ -1330,11 +1330,8 @@ uint16_t bt_gatt_attr_get_handle(const struct bt_gatt_attr *attr)
 			continue;
 		}
 
-		for (size_t i = 0; i < static_svc->attr_count; i++, handle++) {
-			if (attr == &static_svc->attrs[i]) {
-				return handle;
-			}
-		}
+		/* Static service handles are consecutive */
+		return handle + (attr - static_svc->attrs);
 	}
 
 	return 0;
@@ -1467,6 +1464,31 @@ static uint8_t gatt_foreach_iter(const struct bt_gatt_attr *attr,
 	return result;
 }
 
+#if defined(CONFIG_BT_GATT_DYNAMIC_DB)
+/* Index of the first attribute of a service with a handle not below the
+ * given one.  Handles are assigned in ascending order on registration, so
+ * they can be bisected.
+ */
+static size_t find_attr_index(const struct bt_gatt_service *svc,
+			      uint16_t handle)
+{
+	size_t lo = 0;
+	size_t hi = svc->attr_count;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (svc->attrs[mid].handle < handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+#endif /* CONFIG_BT_GATT_DYNAMIC_DB */
+
 static void foreach_attr_type_dyndb(uint16_t start_handle, uint16_t end_handle,
 				    const struct bt_uuid *uuid,
 				    const void *attr_data, uint16_t num_matches,
@@ -1487,7 +1509,8 @@ static void foreach_attr_type_dyndb(uint16_t start_handle, uint16_t end_handle,
 			}
 		}
 
-		for (i = 0; i < svc->attr_count; i++) {
+		for (i = find_attr_index(svc, start_handle);
+		     i < svc->attr_count; i++) {
 			struct bt_gatt_attr *attr = &svc->attrs[i];
 
 			if (gatt_foreach_iter(attr, attr->handle,
@@ -1520,12 +1543,21 @@ void bt_gatt_foreach_attr_type(uint16_t start_handle, uint16_t end_handle,
 
 		Z_STRUCT_SECTION_FOREACH(bt_gatt_service_static, static_svc) {
 			/* Skip ahead if start is not within service handles */
-			if (handle + static_svc->attr_count < start_handle) {
+			if (handle + static_svc->attr_count <= start_handle) {
 				handle += static_svc->attr_count;
 				continue;
 			}
 
-			for (i = 0; i < static_svc->attr_count; i++, handle++) {
+			/* Static service handles are consecutive, so jump
+			 * straight to the first attribute in range.
+			 */
+			i = 0;
+			if (start_handle > handle) {
+				i = start_handle - handle;
+				handle = start_handle;
+			}
+
+			for (; i < static_svc->attr_count; i++, handle++) {
 				if (gatt_foreach_iter(&static_svc->attrs[i],
 						      handle, start_handle,
 						      end_handle, uuid,
@@ -2101,45 +2133,57 @@ static bool gatt_find_by_uuid(struct notify_data *found,
 	return found->attr ? true : false;
 }
 
-int bt_gatt_notify_cb(struct bt_conn *conn,
-		      struct bt_gatt_notify_params *params)
+static int notify_handle_get(struct notify_data *data,
+			     struct bt_gatt_notify_params *params)
 {
-	struct notify_data data;
-
-	__ASSERT(params, "invalid parameters\n");
-	__ASSERT(params->attr, "invalid parameters\n");
+	data->attr = params->attr;
 
-	if (!atomic_test_bit(bt_dev.flags, BT_DEV_READY)) {
-		return -EAGAIN;
-	}
-
-	data.attr = params->attr;
-
-	if (conn && conn->state != BT_CONN_CONNECTED) {
-		return -ENOTCONN;
-	}
-
-	data.handle = bt_gatt_attr_get_handle(data.attr);
-	if (!data.handle) {
+	data->handle = bt_gatt_attr_get_handle(data->attr);
+	if (!data->handle) {
 		return -ENOENT;
 	}
 
 	/* Lookup UUID if it was given */
 	if (params->uuid) {
-		if (!gatt_find_by_uuid(&data, params->uuid)) {
+		if (!gatt_find_by_uuid(data, params->uuid)) {
 			return -ENOENT;
 		}
 	}
 
 	/* Check if attribute is a characteristic then adjust the handle */
-	if (!bt_uuid_cmp(data.attr->uuid, BT_UUID_GATT_CHRC)) {
-		struct bt_gatt_chrc *chrc = data.attr->user_data;
+	if (!bt_uuid_cmp(data->attr->uuid, BT_UUID_GATT_CHRC)) {
+		struct bt_gatt_chrc *chrc = data->attr->user_data;
 
 		if (!(chrc->properties & BT_GATT_CHRC_NOTIFY)) {
 			return -EINVAL;
 		}
 
-		data.handle = bt_gatt_attr_value_handle(data.attr);
+		data->handle = bt_gatt_attr_value_handle(data->attr);
+	}
+
+	return 0;
+}
+
+int bt_gatt_notify_cb(struct bt_conn *conn,
+		      struct bt_gatt_notify_params *params)
+{
+	struct notify_data data;
+	int err;
+
+	__ASSERT(params, "invalid parameters\n");
+	__ASSERT(params->attr, "invalid parameters\n");
+
+	if (!atomic_test_bit(bt_dev.flags, BT_DEV_READY)) {
+		return -EAGAIN;
+	}
+
+	if (conn && conn->state != BT_CONN_CONNECTED) {
+		return -ENOTCONN;
+	}
+
+	err = notify_handle_get(&data, params);
+	if (err) {
+		return err;
 	}
 
 	if (conn) {
@@ -2156,6 +2200,82 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
 	return data.err;
 }
 
+static uint8_t find_ccc(const struct bt_gatt_attr *attr, uint16_t handle,
+			void *user_data)
+{
+	const struct bt_gatt_attr **ccc_attr = user_data;
+
+	/* Only CCC descriptors managed by the GATT server are considered */
+	if (attr->write == bt_gatt_attr_write_ccc) {
+		*ccc_attr = attr;
+	}
+
+	return BT_GATT_ITER_STOP;
+}
+
+int bt_gatt_notify_multicast(struct bt_conn **conns, uint16_t num_conns,
+			     struct bt_gatt_notify_params *params)
+{
+	const struct bt_gatt_attr *ccc_attr = NULL;
+	struct notify_data data;
+	struct _bt_gatt_ccc *ccc;
+	int count = 0;
+	int err;
+
+	__ASSERT(conns || !num_conns, "invalid parameters\n");
+	__ASSERT(params, "invalid parameters\n");
+	__ASSERT(params->attr, "invalid parameters\n");
+
+	if (!atomic_test_bit(bt_dev.flags, BT_DEV_READY)) {
+		return -EAGAIN;
+	}
+
+	/* Resolve the value handle and its CCC descriptor only once */
+	err = notify_handle_get(&data, params);
+	if (err) {
+		return err;
+	}
+
+	bt_gatt_foreach_attr_type(data.handle, 0xffff, BT_UUID_GATT_CCC, NULL,
+				  1, find_ccc, &ccc_attr);
+	if (!ccc_attr) {
+		return -ENOENT;
+	}
+
+	ccc = ccc_attr->user_data;
+
+	for (uint16_t i = 0; i < num_conns; i++) {
+		struct bt_conn *conn = conns[i];
+		struct bt_gatt_ccc_cfg *cfg;
+
+		if (!conn || conn->state != BT_CONN_CONNECTED) {
+			continue;
+		}
+
+		/* Check the value as notify_cb() does, so that both notify
+		 * the same peers.
+		 */
+		cfg = find_ccc_cfg(conn, ccc);
+		if (!cfg || cfg->value != BT_GATT_CCC_NOTIFY) {
+			continue;
+		}
+
+		/* Confirm match if cfg is managed by application */
+		if (ccc->cfg_match && !ccc->cfg_match(conn, ccc_attr)) {
+			continue;
+		}
+
+		/* Each connection queues its own ATT PDU, a failure to
+		 * allocate or send one does not affect the others.
+		 */
+		if (!gatt_notify(conn, data.handle, params)) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
 #if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
 int bt_gatt_notify_multiple(struct bt_conn *conn, uint16_t num_params,
 			    struct bt_gatt_notify_params *params)
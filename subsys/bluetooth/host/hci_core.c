@@ -6505,6 +6505,32 @@ static void init_work(struct k_work *work)
 }
 
 #if !defined(CONFIG_BT_RECV_IS_RX_THREAD)
+static void hci_rx_buf(struct net_buf *buf)
+{
+	BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf),
+	       buf->len);
+
+	switch (bt_buf_get_type(buf)) {
+#if defined(CONFIG_BT_CONN)
+	case BT_BUF_ACL_IN:
+		hci_acl(buf);
+		break;
+#endif /* CONFIG_BT_CONN */
+#if defined(CONFIG_BT_ISO)
+	case BT_BUF_ISO_IN:
+		hci_iso(buf);
+		break;
+#endif /* CONFIG_BT_ISO */
+	case BT_BUF_EVT:
+		hci_event(buf);
+		break;
+	default:
+		BT_ERR("Unknown buf type %u", bt_buf_get_type(buf));
+		net_buf_unref(buf);
+		break;
+	}
+}
+
 static void hci_rx_thread(void)
 {
 	struct net_buf *buf;
@@ -6514,28 +6540,16 @@ static void hci_rx_thread(void)
 	while (1) {
 		BT_DBG("calling fifo_get_wait");
 		buf = net_buf_get(&bt_dev.rx_queue, K_FOREVER);
+		hci_rx_buf(buf);
 
-		BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf),
-		       buf->len);
+		/* Process buffers queued meanwhile in the same pass */
+		for (uint8_t i = 1U; i < CONFIG_BT_RX_BATCH_SIZE; i++) {
+			buf = net_buf_get(&bt_dev.rx_queue, K_NO_WAIT);
+			if (!buf) {
+				break;
+			}
 
-		switch (bt_buf_get_type(buf)) {
-#if defined(CONFIG_BT_CONN)
-		case BT_BUF_ACL_IN:
-			hci_acl(buf);
-			break;
-#endif /* CONFIG_BT_CONN */
-#if defined(CONFIG_BT_ISO)
-		case BT_BUF_ISO_IN:
-			hci_iso(buf);
-			break;
-#endif /* CONFIG_BT_ISO */
-		case BT_BUF_EVT:
-			hci_event(buf);
-			break;
-		default:
-			BT_ERR("Unknown buf type %u", bt_buf_get_type(buf));
-			net_buf_unref(buf);
-			break;
+			hci_rx_buf(buf);
 		}
 
 		/* Make sure we don't hog the CPU if the rx_queue never
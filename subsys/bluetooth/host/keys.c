@@ -38,6 +38,69 @@ static uint32_t aging_counter_val;
 static struct bt_keys *last_keys_updated;
 #endif /* CONFIG_BT_KEYS_OVERWRITE_OLDEST */
 
+#if defined(CONFIG_BT_KEYS_RPA_CACHE)
+struct rpa_cache_entry {
+	bt_addr_t rpa;
+	uint8_t id;
+	bool valid;
+	/* Keys the RPA resolved to, NULL if it did not resolve */
+	struct bt_keys *keys;
+	uint32_t stamp;
+};
+
+static struct rpa_cache_entry rpa_cache[CONFIG_BT_KEYS_RPA_CACHE_SIZE];
+static uint32_t rpa_cache_stamp;
+
+static struct rpa_cache_entry *rpa_cache_find(uint8_t id, const bt_addr_t *rpa)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(rpa_cache); i++) {
+		struct rpa_cache_entry *entry = &rpa_cache[i];
+
+		if (entry->valid && entry->id == id &&
+		    !bt_addr_cmp(&entry->rpa, rpa)) {
+			entry->stamp = ++rpa_cache_stamp;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void rpa_cache_add(uint8_t id, const bt_addr_t *rpa,
+			  struct bt_keys *keys)
+{
+	struct rpa_cache_entry *entry = &rpa_cache[0];
+
+	for (size_t i = 0; i < ARRAY_SIZE(rpa_cache); i++) {
+		if (!rpa_cache[i].valid) {
+			entry = &rpa_cache[i];
+			break;
+		}
+
+		if (rpa_cache[i].stamp < entry->stamp) {
+			entry = &rpa_cache[i];
+		}
+	}
+
+	bt_addr_copy(&entry->rpa, rpa);
+	entry->id = id;
+	entry->keys = keys;
+	entry->stamp = ++rpa_cache_stamp;
+	entry->valid = true;
+}
+
+/* Any change to the set of IRKs may turn cached results stale. */
+static void rpa_cache_flush(void)
+{
+	(void)memset(rpa_cache, 0, sizeof(rpa_cache));
+	rpa_cache_stamp = 0U;
+}
+#else
+static inline void rpa_cache_flush(void)
+{
+}
+#endif /* CONFIG_BT_KEYS_RPA_CACHE */
+
 struct bt_keys *bt_keys_get_addr(uint8_t id, const bt_addr_le_t *addr)
 {
 	struct bt_keys *keys;
@@ -150,6 +213,11 @@ struct bt_keys *bt_keys_get_type(int type, uint8_t id, const bt_addr_le_t *addr)
 
 	BT_DBG("type %d %s", type, bt_addr_le_str(addr));
 
+	/* The caller is about to store a new IRK */
+	if (type & BT_KEYS_IRK) {
+		rpa_cache_flush();
+	}
+
 	keys = bt_keys_find(type, id, addr);
 	if (keys) {
 		return keys;
@@ -189,6 +257,17 @@ struct bt_keys *bt_keys_find_irk(uint8_t id, const bt_addr_le_t *addr)
 		}
 	}
 
+#if defined(CONFIG_BT_KEYS_RPA_CACHE)
+	{
+		struct rpa_cache_entry *entry = rpa_cache_find(id, &addr->a);
+
+		if (entry) {
+			BT_DBG("cached result for RPA %s", bt_addr_str(&addr->a));
+			return entry->keys;
+		}
+	}
+#endif
+
 	for (i = 0; i < ARRAY_SIZE(key_pool); i++) {
 		if (!(key_pool[i].keys & BT_KEYS_IRK)) {
 			continue;
@@ -205,12 +284,18 @@ struct bt_keys *bt_keys_find_irk(uint8_t id, const bt_addr_le_t *addr)
 
 			bt_addr_copy(&key_pool[i].irk.rpa, &addr->a);
 
+#if defined(CONFIG_BT_KEYS_RPA_CACHE)
+			rpa_cache_add(id, &addr->a, &key_pool[i]);
+#endif
 			return &key_pool[i];
 		}
 	}
 
 	BT_DBG("No IRK for %s", bt_addr_le_str(addr));
 
+#if defined(CONFIG_BT_KEYS_RPA_CACHE)
+	rpa_cache_add(id, &addr->a, NULL);
+#endif
 	return NULL;
 }
 
@@ -232,6 +317,10 @@ struct bt_keys *bt_keys_find_addr(uint8_t id, const bt_addr_le_t *addr)
 
 void bt_keys_add_type(struct bt_keys *keys, int type)
 {
+	if (type & BT_KEYS_IRK) {
+		rpa_cache_flush();
+	}
+
 	keys->keys |= type;
 }
 
@@ -263,6 +352,7 @@ void bt_keys_clear(struct bt_keys *keys)
 	}
 
 	(void)memset(keys, 0, sizeof(*keys));
+	rpa_cache_flush();
 }
 
 #if defined(CONFIG_BT_SETTINGS)
@@ -337,6 +427,7 @@ static int keys_set(const char *name, size_t len_rd, settings_read_cb read_cb,
 		keys = bt_keys_find(BT_KEYS_ALL, id, &addr);
 		if (keys) {
 			(void)memset(keys, 0, sizeof(*keys));
+			rpa_cache_flush();
 			BT_DBG("Cleared keys for %s", bt_addr_le_str(&addr));
 		} else {
 			BT_WARN("Unable to find deleted keys for %s",
@@ -374,6 +465,8 @@ static int keys_set(const char *name, size_t len_rd, settings_read_cb read_cb,
 		memcpy(keys->storage_start, val, len);
 	}
 
+	rpa_cache_flush();
+
 	BT_DBG("Successfully restored keys for %s", bt_addr_le_str(&addr));
 #if IS_ENABLED(CONFIG_BT_KEYS_OVERWRITE_OLDEST)
 	if (aging_counter_val < keys->aging_counter) {
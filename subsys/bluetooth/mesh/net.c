@@ -68,6 +68,86 @@ static struct {
 } msg_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
 static uint16_t msg_cache_next;
 
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+#define MSG_CACHE_HASH_SIZE  (2 * CONFIG_BT_MESH_MSG_CACHE_SIZE)
+
+/* Open addressing index into msg_cache, keyed by source and sequence
+ * number. Slots hold the msg_cache index plus one, zero marks an empty
+ * slot. The table is never more than half full, so probing always
+ * terminates at an empty slot.
+ */
+static uint16_t msg_cache_hash[MSG_CACHE_HASH_SIZE];
+
+static uint32_t msg_cache_home(uint16_t src, uint32_t seq)
+{
+	uint32_t key = ((uint32_t)src << 17) | seq;
+
+	return (key * 2654435761U) % MSG_CACHE_HASH_SIZE;
+}
+
+static void msg_cache_hash_add(uint16_t idx)
+{
+	uint32_t i = msg_cache_home(msg_cache[idx].src, msg_cache[idx].seq);
+
+	while (msg_cache_hash[i]) {
+		i = (i + 1) % MSG_CACHE_HASH_SIZE;
+	}
+
+	msg_cache_hash[i] = idx + 1;
+}
+
+static void msg_cache_hash_del(uint16_t idx)
+{
+	uint32_t i = msg_cache_home(msg_cache[idx].src, msg_cache[idx].seq);
+	uint32_t j;
+
+	while (msg_cache_hash[i] != idx + 1) {
+		if (!msg_cache_hash[i]) {
+			return;
+		}
+
+		i = (i + 1) % MSG_CACHE_HASH_SIZE;
+	}
+
+	/* Move back any following entry that would no longer be reachable
+	 * from its home slot once slot i is emptied.
+	 */
+	for (j = (i + 1) % MSG_CACHE_HASH_SIZE; msg_cache_hash[j];
+	     j = (j + 1) % MSG_CACHE_HASH_SIZE) {
+		uint16_t entry = msg_cache_hash[j] - 1;
+		uint32_t home = msg_cache_home(msg_cache[entry].src,
+					       msg_cache[entry].seq);
+
+		if ((i < j) ? (home > i && home <= j) :
+			      (home > i || home <= j)) {
+			continue;
+		}
+
+		msg_cache_hash[i] = entry + 1;
+		i = j;
+	}
+
+	msg_cache_hash[i] = 0U;
+}
+
+static void msg_cache_hash_clear(void)
+{
+	(void)memset(msg_cache_hash, 0, sizeof(msg_cache_hash));
+}
+#else
+static inline void msg_cache_hash_add(uint16_t idx)
+{
+}
+
+static inline void msg_cache_hash_del(uint16_t idx)
+{
+}
+
+static inline void msg_cache_hash_clear(void)
+{
+}
+#endif /* CONFIG_BT_MESH_MSG_CACHE_HASH */
+
 /* Singleton network context (the implementation only supports one) */
 struct bt_mesh_net bt_mesh = {
 	.local_queue = SYS_SLIST_STATIC_INIT(&bt_mesh.local_queue),
@@ -101,6 +181,20 @@ static bool check_dup(struct net_buf_simple *data)
 
 static bool msg_cache_match(struct net_buf_simple *pdu)
 {
+#if defined(CONFIG_BT_MESH_MSG_CACHE_HASH)
+	uint16_t src = SRC(pdu->data);
+	uint32_t seq = SEQ(pdu->data) & BIT_MASK(17);
+	uint32_t i;
+
+	for (i = msg_cache_home(src, seq); msg_cache_hash[i];
+	     i = (i + 1) % MSG_CACHE_HASH_SIZE) {
+		uint16_t idx = msg_cache_hash[i] - 1;
+
+		if (msg_cache[idx].src == src && msg_cache[idx].seq == seq) {
+			return true;
+		}
+	}
+#else
 	uint16_t i;
 
 	for (i = 0U; i < ARRAY_SIZE(msg_cache); i++) {
@@ -109,6 +203,7 @@ static bool msg_cache_match(struct net_buf_simple *pdu)
 			return true;
 		}
 	}
+#endif
 
 	return false;
 }
@@ -116,8 +211,10 @@ static bool msg_cache_match(struct net_buf_simple *pdu)
 static void msg_cache_add(struct bt_mesh_net_rx *rx)
 {
 	rx->msg_cache_idx = msg_cache_next++;
+	msg_cache_hash_del(rx->msg_cache_idx);
 	msg_cache[rx->msg_cache_idx].src = rx->ctx.addr;
 	msg_cache[rx->msg_cache_idx].seq = rx->seq;
+	msg_cache_hash_add(rx->msg_cache_idx);
 	msg_cache_next %= ARRAY_SIZE(msg_cache);
 }
 
@@ -142,6 +239,7 @@ int bt_mesh_net_create(uint16_t idx, uint8_t flags, const uint8_t key[16],
 	}
 
 	(void)memset(msg_cache, 0, sizeof(msg_cache));
+	msg_cache_hash_clear();
 	msg_cache_next = 0U;
 
 	bt_mesh.iv_index = iv_index;
@@ -790,6 +888,7 @@ void bt_mesh_net_recv(struct net_buf_simple *data, int8_t rssi,
 	 */
 	if (bt_mesh_trans_recv(&buf, &rx) == -EAGAIN) {
 		BT_WARN("Removing rejected message from Network Message Cache");
+		msg_cache_hash_del(rx.msg_cache_idx);
 		msg_cache[rx.msg_cache_idx].src = BT_MESH_ADDR_UNASSIGNED;
 		/* Rewind the next index now that we're not using this entry */
 		msg_cache_next = rx.msg_cache_idx;
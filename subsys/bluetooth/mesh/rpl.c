@@ -30,8 +30,80 @@
 #include "rpl.h"
 #include "settings.h"
 
+/* The list is an open addressing hash table keyed by source address,
+ * using linear probing. An unused slot terminates a probe sequence, so
+ * removing single entries requires the table to be rehashed.
+ */
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
+static uint16_t rpl_home(uint16_t src)
+{
+	return ((uint32_t)src * 2654435761U) % ARRAY_SIZE(replay_list);
+}
+
+/* Look up the entry for the given source. If there is none, the slot a
+ * new entry for the source goes to is returned through free, or NULL if
+ * the list is full.
+ */
+static struct bt_mesh_rpl *rpl_lookup(uint16_t src, struct bt_mesh_rpl **free)
+{
+	uint16_t i = rpl_home(src);
+
+	if (free) {
+		*free = NULL;
+	}
+
+	for (size_t n = 0; n < ARRAY_SIZE(replay_list); n++) {
+		struct bt_mesh_rpl *rpl = &replay_list[i];
+
+		if (rpl->src == src) {
+			return rpl;
+		}
+
+		if (!rpl->src) {
+			break;
+		}
+
+		i = (i + 1) % ARRAY_SIZE(replay_list);
+	}
+
+	if (free && !replay_list[i].src) {
+		*free = &replay_list[i];
+	}
+
+	return NULL;
+}
+
+/* Move entries back to the first free slot of their probe sequence after
+ * entries were removed. Moving an entry may open up a slot on the probe
+ * sequence of an entry already visited, so repeat until nothing moves.
+ */
+static void rpl_rehash(void)
+{
+	bool moved;
+
+	do {
+		moved = false;
+
+		for (size_t i = 0; i < ARRAY_SIZE(replay_list); i++) {
+			struct bt_mesh_rpl entry = replay_list[i];
+			struct bt_mesh_rpl *free;
+
+			if (!entry.src) {
+				continue;
+			}
+
+			(void)memset(&replay_list[i], 0, sizeof(entry));
+			(void)rpl_lookup(entry.src, &free);
+			*free = entry;
+
+			if (free != &replay_list[i]) {
+				moved = true;
+			}
+		}
+	} while (moved);
+}
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
@@ -52,7 +124,8 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
+	struct bt_mesh_rpl *free;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -64,11 +137,27 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
+	rpl = rpl_lookup(rx->ctx.addr, &free);
 
-		/* Empty slot */
-		if (!rpl->src) {
+	/* Empty slot */
+	if (!rpl && free) {
+		if (match) {
+			*match = free;
+		} else {
+			bt_mesh_rpl_update(free, rx);
+		}
+
+		return false;
+	}
+
+	/* Existing slot for given address */
+	if (rpl) {
+		if (rx->old_iv && !rpl->old_iv) {
+			return true;
+		}
+
+		if ((!rx->old_iv && rpl->old_iv) ||
+		    rpl->seq < rx->seq) {
 			if (match) {
 				*match = rpl;
 			} else {
@@ -76,26 +165,8 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 			}
 
 			return false;
-		}
-
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
-
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
-
-				return false;
-			} else {
-				return true;
-			}
+		} else {
+			return true;
 		}
 	}
 
@@ -116,29 +187,26 @@ void bt_mesh_rpl_clear(void)
 
 struct bt_mesh_rpl *bt_mesh_rpl_find(uint16_t src)
 {
-	int i;
-
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (replay_list[i].src == src) {
-			return &replay_list[i];
-		}
-	}
-
-	return NULL;
+	return rpl_lookup(src, NULL);
 }
 
 struct bt_mesh_rpl *bt_mesh_rpl_alloc(uint16_t src)
 {
-	int i;
+	struct bt_mesh_rpl *free;
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (!replay_list[i].src) {
-			replay_list[i].src = src;
-			return &replay_list[i];
-		}
+	if (rpl_lookup(src, &free) || !free) {
+		return NULL;
 	}
 
-	return NULL;
+	free->src = src;
+
+	return free;
+}
+
+void bt_mesh_rpl_remove(struct bt_mesh_rpl *rpl)
+{
+	(void)memset(rpl, 0, sizeof(*rpl));
+	rpl_rehash();
 }
 
 void bt_mesh_rpl_foreach(bt_mesh_rpl_func_t func, void *user_data)
@@ -152,6 +220,7 @@ void bt_mesh_rpl_foreach(bt_mesh_rpl_func_t func, void *user_data)
 
 void bt_mesh_rpl_reset(void)
 {
+	bool removed = false;
 	int i;
 
 	/* Discard "old old" IV Index entries from RPL and flag
@@ -163,6 +232,7 @@ void bt_mesh_rpl_reset(void)
 		if (rpl->src) {
 			if (rpl->old_iv) {
 				(void)memset(rpl, 0, sizeof(*rpl));
+				removed = true;
 			} else {
 				rpl->old_iv = true;
 			}
@@ -172,4 +242,8 @@ void bt_mesh_rpl_reset(void)
 			}
 		}
 	}
+
+	if (removed) {
+		rpl_rehash();
+	}
 }
@@ -296,7 +296,7 @@ static int rpl_set(const char *name, size_t len_rd,
 	if (len_rd == 0) {
 		BT_DBG("val (null)");
 		if (entry) {
-			(void)memset(entry, 0, sizeof(*entry));
+			bt_mesh_rpl_remove(entry);
 		} else {
 			BT_WARN("Unable to find RPL entry for 0x%04x", src);
 		}
@@ -289,20 +289,31 @@ static void schedule_retransmit(struct seg_tx *tx)
 		return;
 	}
 
-	if (--tx->seg_pending || tx->sending) {
+	tx->seg_pending--;
+
+	if (tx->sending) {
 		return;
 	}
 
-	BT_DBG("");
-
 	/* If we haven't gone through all the segments for this attempt yet,
-	 * (likely because of a buffer allocation failure or because we
-	 * called this from inside bt_mesh_net_send), we should continue the
-	 * retransmit immediately, as we just freed up a tx buffer.
+	 * (because of the sending window, a buffer allocation failure or
+	 * because we called this from inside bt_mesh_net_send), we should
+	 * continue the retransmit immediately, as we just freed up a tx
+	 * buffer.
 	 */
+	if (tx->seg_o) {
+		k_delayed_work_submit(&tx->retransmit, K_NO_WAIT);
+		return;
+	}
+
+	if (tx->seg_pending) {
+		return;
+	}
+
+	BT_DBG("");
+
 	k_delayed_work_submit(&tx->retransmit,
-			      tx->seg_o ? K_NO_WAIT :
-					  K_MSEC(SEG_RETRANSMIT_TIMEOUT(tx)));
+			      K_MSEC(SEG_RETRANSMIT_TIMEOUT(tx)));
 }
 
 static void seg_send_start(uint16_t duration, int err, void *user_data)
@@ -398,6 +409,11 @@ static void seg_tx_send_unacked(struct seg_tx *tx)
 			continue;
 		}
 
+		if (tx->seg_pending >= CONFIG_BT_MESH_TX_SEG_WINDOW) {
+			BT_DBG("Sending window full");
+			goto end;
+		}
+
 		seg = bt_mesh_adv_create(BT_MESH_ADV_DATA, tx->xmit,
 					 BUF_TIMEOUT);
 		if (!seg) {
@@ -846,12 +862,16 @@ static int trans_ack(struct bt_mesh_net_rx *rx, uint8_t hdr,
 		ack &= ~BIT(bit - 1);
 	}
 
-	if (tx->nack_count) {
-		seg_tx_send_unacked(tx);
-	} else {
+	if (!tx->nack_count) {
 		BT_DBG("SDU TX complete");
 		seg_tx_complete(tx, 0);
+	} else if (!tx->seg_pending) {
+		seg_tx_send_unacked(tx);
 	}
+	/* Otherwise segments of this attempt are still queued for sending.
+	 * The acked ones get skipped, and the rest of the attempt (or the
+	 * retransmit timer) is kicked off once the queued ones have been sent.
+	 */
 
 	return 0;
 }
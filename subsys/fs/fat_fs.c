@@ -201,6 +201,72 @@ static ssize_t fatfs_write(struct fs_file_t *zfp, const void *ptr, size_t size)
 	return res;
 }
 
+static ssize_t fatfs_readv(struct fs_file_t *zfp, const struct fs_iovec *iov,
+			   int iovcnt)
+{
+	FRESULT res = FR_OK;
+	unsigned int br;
+	ssize_t total = 0;
+
+	for (int i = 0; i < iovcnt; i++) {
+		res = f_read(zfp->filep, iov[i].iov_base, iov[i].iov_len, &br);
+		if (res != FR_OK) {
+			break;
+		}
+
+		total += br;
+		if (br < iov[i].iov_len) {
+			break;
+		}
+	}
+
+	if ((res != FR_OK) && (total == 0)) {
+		return translate_error(res);
+	}
+
+	return total;
+}
+
+static ssize_t fatfs_writev(struct fs_file_t *zfp, const struct fs_iovec *iov,
+			    int iovcnt)
+{
+	ssize_t res = -ENOTSUP;
+
+#if !defined(CONFIG_FS_FATFS_READ_ONLY)
+	unsigned int bw;
+	ssize_t total = 0;
+	res = FR_OK;
+
+	/* Seek to the end only once for the whole vector when the file
+	 * has been opened for append, see fatfs_write().
+	 */
+	if (zfp->flags & FS_O_APPEND) {
+		res = f_lseek(zfp->filep, f_size((FIL *)zfp->filep));
+	}
+
+	for (int i = 0; (res == FR_OK) && (i < iovcnt); i++) {
+		res = f_write(zfp->filep, iov[i].iov_base, iov[i].iov_len,
+			      &bw);
+		if (res != FR_OK) {
+			break;
+		}
+
+		total += bw;
+		if (bw < iov[i].iov_len) {
+			break;
+		}
+	}
+
+	if ((res != FR_OK) && (total == 0)) {
+		res = translate_error(res);
+	} else {
+		res = total;
+	}
+#endif
+
+	return res;
+}
+
 static int fatfs_seek(struct fs_file_t *zfp, off_t offset, int whence)
 {
 	FRESULT res = FR_OK;
@@ -446,6 +512,8 @@ static const struct fs_file_system_t fatfs_fs = {
 	.close = fatfs_close,
 	.read = fatfs_read,
 	.write = fatfs_write,
+	.readv = fatfs_readv,
+	.writev = fatfs_writev,
 	.lseek = fatfs_seek,
 	.tell = fatfs_tell,
 	.truncate = fatfs_truncate,
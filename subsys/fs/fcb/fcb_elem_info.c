@@ -18,6 +18,7 @@ int
 fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *c8p)
 {
 	uint8_t tmp_str[FCB_TMP_BUF_SZ];
+	const uint8_t *mapped;
 	int cnt;
 	int blk_sz;
 	uint8_t crc8;
@@ -46,6 +47,15 @@ fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *c8p)
 
 	off = loc->fe_data_off;
 	end = loc->fe_data_off + len;
+
+	/* crc memory mapped flash in place */
+	if (fcb->fap != NULL && end <= loc->fe_sector->fs_size &&
+	    !flash_area_mmap(fcb->fap, loc->fe_sector->fs_off + off, len,
+			     (const void **)&mapped)) {
+		*c8p = crc8_ccitt(crc8, mapped, len);
+		return 0;
+	}
+
 	for (; off < end; off += blk_sz) {
 		blk_sz = end - off;
 		if (blk_sz > sizeof(tmp_str)) {
@@ -128,6 +128,216 @@ static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 	return 0;
 }
 
+#if defined(CONFIG_FILE_SYSTEM_DENTRY_CACHE)
+static uint32_t dcache_hash(const char *path)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*path != '\0') {
+		hash = (hash ^ (uint8_t)*path++) * 16777619U;
+	}
+
+	return hash;
+}
+
+/* Look up abs_path in the cache of mp.  On a miss, *gen receives the
+ * generation that must still be current for a result obtained from the
+ * file system to be inserted.
+ */
+static bool dcache_lookup(struct fs_mount_t *mp, const char *abs_path,
+			  struct fs_dirent *entry, uint32_t *gen)
+{
+	struct fs_dcache *dc = mp->dcache;
+	uint32_t hash;
+	bool found = false;
+
+	if (dc == NULL) {
+		return false;
+	}
+
+	hash = dcache_hash(abs_path);
+
+	k_mutex_lock(&dc->lock, K_FOREVER);
+	for (size_t i = 0; i < dc->size; i++) {
+		struct fs_dentry *de = &dc->entries[i];
+
+		if ((de->stamp == 0U) || (de->hash != hash) ||
+		    (strcmp(de->path, abs_path) != 0)) {
+			continue;
+		}
+
+		entry->type = de->type;
+		entry->size = de->size;
+		strcpy(entry->name, de->name);
+		if (++dc->stamp == 0U) {
+			dc->stamp = 1U;
+		}
+		de->stamp = dc->stamp;
+		found = true;
+		break;
+	}
+	*gen = dc->gen;
+	k_mutex_unlock(&dc->lock);
+
+	return found;
+}
+
+static void dcache_insert(struct fs_mount_t *mp, const char *abs_path,
+			  const struct fs_dirent *entry, uint32_t gen)
+{
+	struct fs_dcache *dc = mp->dcache;
+	struct fs_dentry *de;
+
+	if ((dc == NULL) || (dc->size == 0U) ||
+	    (strlen(abs_path) > CONFIG_FILE_SYSTEM_DENTRY_CACHE_PATH_MAX)) {
+		return;
+	}
+
+	k_mutex_lock(&dc->lock, K_FOREVER);
+	if (gen != dc->gen) {
+		/* Invalidated while the file system was queried */
+		goto out;
+	}
+
+	/* Replace a free slot or the least recently used entry */
+	de = &dc->entries[0];
+	for (size_t i = 1; (i < dc->size) && (de->stamp != 0U); i++) {
+		if ((dc->entries[i].stamp == 0U) ||
+		    ((int32_t)(dc->entries[i].stamp - de->stamp) < 0)) {
+			de = &dc->entries[i];
+		}
+	}
+
+	strcpy(de->path, abs_path);
+	de->hash = dcache_hash(abs_path);
+	de->type = entry->type;
+	de->size = entry->size;
+	strcpy(de->name, entry->name);
+	if (++dc->stamp == 0U) {
+		dc->stamp = 1U;
+	}
+	de->stamp = dc->stamp;
+
+out:
+	k_mutex_unlock(&dc->lock);
+}
+
+/* Drop cached abs_path and everything below it */
+static void dcache_invalidate(struct fs_mount_t *mp, const char *abs_path)
+{
+	struct fs_dcache *dc = mp->dcache;
+	size_t len = strlen(abs_path);
+
+	if (dc == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&dc->lock, K_FOREVER);
+	dc->gen++;
+	for (size_t i = 0; i < dc->size; i++) {
+		struct fs_dentry *de = &dc->entries[i];
+
+		if ((strncmp(de->path, abs_path, len) == 0) &&
+		    ((de->path[len] == '\0') || (de->path[len] == '/'))) {
+			de->stamp = 0U;
+		}
+	}
+	k_mutex_unlock(&dc->lock);
+}
+
+/* Entries of files are matched on the hash of their path, a collision only
+ * drops an unrelated entry.
+ */
+static bool dcache_has_file(const struct fs_file_t *zfp)
+{
+	struct fs_dcache *dc = zfp->mp->dcache;
+	bool found = false;
+
+	if (dc == NULL) {
+		return false;
+	}
+
+	k_mutex_lock(&dc->lock, K_FOREVER);
+	for (size_t i = 0; (i < dc->size) && !found; i++) {
+		found = (dc->entries[i].stamp != 0U) &&
+			(dc->entries[i].hash == zfp->dcache_hash);
+	}
+	k_mutex_unlock(&dc->lock);
+
+	return found;
+}
+
+/* Drop the cached entry of the file open as zfp when the file is now size
+ * long, or at least size long when grown is set, and that changes its size.
+ * A negative size drops the entry.
+ */
+static void dcache_resize(const struct fs_file_t *zfp, off_t size,
+			  bool grown)
+{
+	struct fs_dcache *dc = zfp->mp->dcache;
+
+	if (dc == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&dc->lock, K_FOREVER);
+	for (size_t i = 0; i < dc->size; i++) {
+		struct fs_dentry *de = &dc->entries[i];
+
+		if ((de->stamp == 0U) || (de->hash != zfp->dcache_hash)) {
+			continue;
+		}
+
+		if ((size < 0) ||
+		    (grown ? ((size_t)size > de->size) :
+			     ((size_t)size != de->size))) {
+			de->stamp = 0U;
+			dc->gen++;
+		}
+	}
+	k_mutex_unlock(&dc->lock);
+}
+
+/* Called after data was written to the file open as zfp */
+static void dcache_written(struct fs_file_t *zfp)
+{
+	off_t pos;
+
+	/* Only query the position of files that are cached */
+	if (!dcache_has_file(zfp)) {
+		return;
+	}
+
+	pos = (zfp->mp->fs->tell != NULL) ? zfp->mp->fs->tell(zfp) : -1;
+	dcache_resize(zfp, pos, true);
+}
+#else
+static inline bool dcache_lookup(struct fs_mount_t *mp, const char *abs_path,
+				 struct fs_dirent *entry, uint32_t *gen)
+{
+	return false;
+}
+
+static inline void dcache_insert(struct fs_mount_t *mp, const char *abs_path,
+				 const struct fs_dirent *entry, uint32_t gen)
+{
+}
+
+static inline void dcache_invalidate(struct fs_mount_t *mp,
+				     const char *abs_path)
+{
+}
+
+static inline void dcache_resize(const struct fs_file_t *zfp, off_t size,
+				 bool grown)
+{
+}
+
+static inline void dcache_written(struct fs_file_t *zfp)
+{
+}
+#endif /* CONFIG_FILE_SYSTEM_DENTRY_CACHE */
+
 /* File operations */
 int fs_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
 {
@@ -150,6 +360,11 @@ int fs_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
 	}
 
 	zfp->mp = mp;
+#if defined(CONFIG_FILE_SYSTEM_DENTRY_CACHE)
+	if (mp->dcache != NULL) {
+		zfp->dcache_hash = dcache_hash(file_name);
+	}
+#endif
 	if (((mp->flags & FS_MOUNT_FLAG_READ_ONLY) != 0) &&
 	    (flags & FS_O_CREATE || flags & FS_O_WRITE)) {
 		return -EROFS;
@@ -226,11 +441,168 @@ ssize_t fs_write(struct fs_file_t *zfp, const void *ptr, size_t size)
 	rc = zfp->mp->fs->write(zfp, ptr, size);
 	if (rc < 0) {
 		LOG_ERR("file write error (%d)", rc);
+	} else if (rc > 0) {
+		dcache_written(zfp);
 	}
 
 	return rc;
 }
 
+/* Vectored I/O through the single buffer read or write operation, stops at
+ * the first short transfer.
+ */
+static ssize_t fs_rwv(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		      int iovcnt, bool write)
+{
+	ssize_t total = 0;
+	ssize_t rc;
+
+	for (int i = 0; i < iovcnt; i++) {
+		if (write) {
+			rc = zfp->mp->fs->write(zfp, iov[i].iov_base,
+						iov[i].iov_len);
+		} else {
+			rc = zfp->mp->fs->read(zfp, iov[i].iov_base,
+					       iov[i].iov_len);
+		}
+
+		if (rc < 0) {
+			return (total > 0) ? total : rc;
+		}
+
+		total += rc;
+		if ((size_t)rc < iov[i].iov_len) {
+			break;
+		}
+	}
+
+	return total;
+}
+
+ssize_t fs_readv(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		 int iovcnt)
+{
+	ssize_t rc = -EINVAL;
+
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	CHECKIF((iov == NULL && iovcnt > 0) || iovcnt < 0) {
+		return -EINVAL;
+	}
+
+	if (zfp->mp->fs->readv != NULL) {
+		rc = zfp->mp->fs->readv(zfp, iov, iovcnt);
+	} else {
+		CHECKIF(zfp->mp->fs->read == NULL) {
+			return -ENOTSUP;
+		}
+		rc = fs_rwv(zfp, iov, iovcnt, false);
+	}
+
+	if (rc < 0) {
+		LOG_ERR("file read error (%d)", (int)rc);
+	}
+
+	return rc;
+}
+
+ssize_t fs_writev(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		  int iovcnt)
+{
+	ssize_t rc = -EINVAL;
+
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	CHECKIF((iov == NULL && iovcnt > 0) || iovcnt < 0) {
+		return -EINVAL;
+	}
+
+	if (zfp->mp->fs->writev != NULL) {
+		rc = zfp->mp->fs->writev(zfp, iov, iovcnt);
+	} else {
+		CHECKIF(zfp->mp->fs->write == NULL) {
+			return -ENOTSUP;
+		}
+		rc = fs_rwv(zfp, iov, iovcnt, true);
+	}
+
+	if (rc < 0) {
+		LOG_ERR("file write error (%d)", (int)rc);
+	} else if (rc > 0) {
+		dcache_written(zfp);
+	}
+
+	return rc;
+}
+
+#if defined(CONFIG_FILE_SYSTEM_ASYNC)
+K_KERNEL_STACK_DEFINE(fs_work_q_stack, CONFIG_FILE_SYSTEM_ASYNC_STACK_SIZE);
+
+static struct k_work_q fs_work_q;
+
+static void fs_async_handler(struct k_work *work)
+{
+	struct fs_async_req *req = CONTAINER_OF(work, struct fs_async_req,
+						work);
+	ssize_t rc;
+
+	switch (req->op) {
+	case FS_ASYNC_READV:
+		rc = fs_readv(req->zfp, req->iov, req->iovcnt);
+		break;
+	case FS_ASYNC_WRITEV:
+		rc = fs_writev(req->zfp, req->iov, req->iovcnt);
+		break;
+	case FS_ASYNC_SYNC:
+		rc = fs_sync(req->zfp);
+		break;
+	default:
+		rc = -EINVAL;
+		break;
+	}
+
+	if (req->cb != NULL) {
+		req->cb(req, rc);
+	}
+}
+
+void fs_async_req_init(struct fs_async_req *req)
+{
+	k_work_init(&req->work, fs_async_handler);
+}
+
+int fs_async_submit(struct fs_async_req *req)
+{
+	struct k_work_q *work_q;
+
+	CHECKIF(req == NULL || req->zfp == NULL ||
+		req->op > FS_ASYNC_SYNC) {
+		return -EINVAL;
+	}
+
+	if (req->zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	if (k_work_pending(&req->work)) {
+		return -EBUSY;
+	}
+
+	work_q = req->zfp->mp->work_q;
+	if (work_q == NULL) {
+		work_q = &fs_work_q;
+	}
+
+	k_work_submit_to_queue(work_q, &req->work);
+
+	return 0;
+}
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
+
 int fs_seek(struct fs_file_t *zfp, off_t offset, int whence)
 {
 	int rc = -ENOTSUP;
@@ -286,6 +658,8 @@ int fs_truncate(struct fs_file_t *zfp, off_t length)
 	rc = zfp->mp->fs->truncate(zfp, length);
 	if (rc < 0) {
 		LOG_ERR("file truncate error (%d)", rc);
+	} else {
+		dcache_resize(zfp, length, false);
 	}
 
 	return rc;
@@ -488,6 +862,8 @@ int fs_mkdir(const char *abs_path)
 	rc = mp->fs->mkdir(mp, abs_path);
 	if (rc < 0) {
 		LOG_ERR("failed to create directory (%d)", rc);
+	} else {
+		dcache_invalidate(mp, abs_path);
 	}
 
 	return rc;
@@ -521,6 +897,8 @@ int fs_unlink(const char *abs_path)
 	rc = mp->fs->unlink(mp, abs_path);
 	if (rc < 0) {
 		LOG_ERR("failed to unlink path (%d)", rc);
+	} else {
+		dcache_invalidate(mp, abs_path);
 	}
 
 	return rc;
@@ -561,6 +939,9 @@ int fs_rename(const char *from, const char *to)
 	rc = mp->fs->rename(mp, from, to);
 	if (rc < 0) {
 		LOG_ERR("failed to rename file or dir (%d)", rc);
+	} else {
+		dcache_invalidate(mp, from);
+		dcache_invalidate(mp, to);
 	}
 
 	return rc;
@@ -569,6 +950,7 @@ int fs_rename(const char *from, const char *to)
 int fs_stat(const char *abs_path, struct fs_dirent *entry)
 {
 	struct fs_mount_t *mp;
+	uint32_t gen = 0U;
 	int rc = -EINVAL;
 
 	if ((abs_path == NULL) ||
@@ -587,9 +969,15 @@ int fs_stat(const char *abs_path, struct fs_dirent *entry)
 		return -ENOTSUP;
 	}
 
+	if ((entry != NULL) && dcache_lookup(mp, abs_path, entry, &gen)) {
+		return 0;
+	}
+
 	rc = mp->fs->stat(mp, abs_path, entry);
 	if (rc < 0) {
 		LOG_ERR("failed get file or dir stat (%d)", rc);
+	} else {
+		dcache_insert(mp, abs_path, entry, gen);
 	}
 	return rc;
 }
@@ -689,6 +1077,13 @@ int fs_mount(struct fs_mount_t *mp)
 	/* Update mount point data and append it to the list */
 	mp->mountp_len = len;
 	mp->fs = fs;
+#if defined(CONFIG_FILE_SYSTEM_DENTRY_CACHE)
+	if (mp->dcache != NULL) {
+		k_mutex_init(&mp->dcache->lock);
+		memset(mp->dcache->entries, 0,
+		       mp->dcache->size * sizeof(mp->dcache->entries[0]));
+	}
+#endif
 
 	sys_dlist_append(&fs_mnt_list, &mp->node);
 	LOG_DBG("fs mounted at %s", log_strdup(mp->mnt_point));
@@ -815,6 +1210,13 @@ static int fs_init(const struct device *dev)
 {
 	k_mutex_init(&mutex);
 	sys_dlist_init(&fs_mnt_list);
+
+#if defined(CONFIG_FILE_SYSTEM_ASYNC)
+	k_work_q_start(&fs_work_q, fs_work_q_stack,
+		       K_KERNEL_STACK_SIZEOF(fs_work_q_stack),
+		       CONFIG_FILE_SYSTEM_ASYNC_PRIORITY);
+	k_thread_name_set(&fs_work_q.thread, "fs_workq");
+#endif
 	return 0;
 }
 
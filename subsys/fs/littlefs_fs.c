@@ -306,6 +306,56 @@ static ssize_t littlefs_write(struct fs_file_t *fp, const void *ptr, size_t len)
 	return lfs_to_errno(ret);
 }
 
+/* Vectored transfers hold the file system lock across all buffers */
+static ssize_t littlefs_rwv(struct fs_file_t *fp, const struct fs_iovec *iov,
+			    int iovcnt, bool write)
+{
+	struct fs_littlefs *fs = fp->mp->fs_data;
+	ssize_t total = 0;
+	lfs_ssize_t ret = 0;
+
+	fs_lock(fs);
+
+	for (int i = 0; i < iovcnt; i++) {
+		if (write) {
+			ret = lfs_file_write(&fs->lfs, LFS_FILEP(fp),
+					     iov[i].iov_base, iov[i].iov_len);
+		} else {
+			ret = lfs_file_read(&fs->lfs, LFS_FILEP(fp),
+					    iov[i].iov_base, iov[i].iov_len);
+		}
+
+		if (ret < 0) {
+			break;
+		}
+
+		total += ret;
+		if ((size_t)ret < iov[i].iov_len) {
+			break;
+		}
+	}
+
+	fs_unlock(fs);
+
+	if ((ret < 0) && (total == 0)) {
+		return lfs_to_errno(ret);
+	}
+
+	return total;
+}
+
+static ssize_t littlefs_readv(struct fs_file_t *fp, const struct fs_iovec *iov,
+			      int iovcnt)
+{
+	return littlefs_rwv(fp, iov, iovcnt, false);
+}
+
+static ssize_t littlefs_writev(struct fs_file_t *fp,
+			       const struct fs_iovec *iov, int iovcnt)
+{
+	return littlefs_rwv(fp, iov, iovcnt, true);
+}
+
 BUILD_ASSERT((FS_SEEK_SET == LFS_SEEK_SET)
 	     && (FS_SEEK_CUR == LFS_SEEK_CUR)
 	     && (FS_SEEK_END == LFS_SEEK_END));
@@ -736,6 +786,8 @@ static const struct fs_file_system_t littlefs_fs = {
 	.close = littlefs_close,
 	.read = littlefs_read,
 	.write = littlefs_write,
+	.readv = littlefs_readv,
+	.writev = littlefs_writev,
 	.lseek = littlefs_seek,
 	.tell = littlefs_tell,
 	.truncate = littlefs_truncate,
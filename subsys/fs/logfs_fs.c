@@ -0,0 +1,1475 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <kernel.h>
+#include <errno.h>
+#include <init.h>
+#include <fs/fs.h>
+#include <fs/fs_sys.h>
+#include <fs/logfs.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <sys/byteorder.h>
+#include <sys/crc.h>
+
+#include "fs_impl.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(logfs, CONFIG_FS_LOG_LEVEL);
+
+/* Each sector starts with a header naming the file it belongs to,
+ * followed by the file data in whole flash write blocks.  Length records
+ * are written from the end of the sector towards the data each time the
+ * file is synced; the last valid record gives the number of data bytes
+ * in the sector and carries the bytes of a trailing partial write block.
+ * A record with LOGFS_SEALED set closes the sector for further appends.
+ *
+ * One record is always left free in a sector that is appended to, so
+ * that the sector can be shortened by a truncate later on.  A sector
+ * without room for a record is shortened by a LOGFS_REC_TRIM record in
+ * the first slot of a new sector following it: the record gives the
+ * length of the previous sector, and its bytes past the last whole write
+ * block start the new sector.
+ */
+#define LOGFS_MAGIC 0x4c4f4731 /* "LOG1" */
+#define LOGFS_SEALED BIT(31)
+#define LOGFS_REC_MARK BIT(30)	/* Keeps records apart from erased flash */
+#define LOGFS_REC_TRIM BIT(29)
+#define LOGFS_REC_LEN_MASK (BIT(29) - 1)
+#define LOGFS_REC_MAX (2 * FS_LOGFS_WBUF_SIZE)
+#define LOGFS_NONE UINT16_MAX
+
+/* Sector flags kept in RAM */
+#define LOGFS_SECT_SEALED BIT(0)	/* No further appends */
+#define LOGFS_SECT_DIRTY BIT(1)		/* Free, needs erase before use */
+#define LOGFS_SECT_UNCOMMITTED BIT(2)	/* Data written since last record */
+#define LOGFS_SECT_TRIM BIT(3)		/* Shortens the previous sector */
+
+struct logfs_hdr {
+	uint32_t magic;
+	uint32_t seq;
+	char name[FS_LOGFS_NAME_MAX + 1];
+	uint32_t crc;
+};
+
+struct logfs_file_data {
+	uint8_t file;
+	uint32_t pos;
+	/* Last sector read and the file offset of its first byte */
+	uint16_t sector;
+	uint32_t sector_seq;
+	uint32_t sector_base;
+};
+
+struct logfs_dir_data {
+	uint8_t next;
+};
+
+K_MEM_SLAB_DEFINE(logfs_file_pool, sizeof(struct logfs_file_data),
+		  CONFIG_FS_LOGFS_NUM_FILES, 4);
+K_MEM_SLAB_DEFINE(logfs_dir_pool, sizeof(struct logfs_dir_data),
+		  CONFIG_FS_LOGFS_NUM_DIRS, 4);
+
+BUILD_ASSERT(CONFIG_FS_LOGFS_MAX_SECTORS < LOGFS_NONE);
+BUILD_ASSERT(CONFIG_FS_LOGFS_MAX_FILES <= UINT8_MAX);
+
+static inline void fs_lock(struct fs_logfs *fs)
+{
+	k_mutex_lock(&fs->mutex, K_FOREVER);
+}
+
+static inline void fs_unlock(struct fs_logfs *fs)
+{
+	k_mutex_unlock(&fs->mutex);
+}
+
+/* A record holds the length, up to one partial write block and a crc8 */
+static inline size_t rec_size(const struct fs_logfs *fs)
+{
+	return ROUND_UP(sizeof(uint32_t) + fs->write_size, fs->write_size);
+}
+
+static inline size_t hdr_size(const struct fs_logfs *fs)
+{
+	return ROUND_UP(sizeof(struct logfs_hdr), fs->write_size);
+}
+
+static inline off_t sector_off(const struct fs_logfs *fs, uint16_t idx)
+{
+	return (off_t)idx * fs->sector_size;
+}
+
+/* Offset of record slot i of a sector, relative to the sector */
+static inline off_t rec_off(const struct fs_logfs *fs, uint16_t i)
+{
+	return fs->sector_size - (off_t)(i + 1) * rec_size(fs);
+}
+
+/* Bytes left between the programmed data and the records of a sector */
+static inline uint32_t sector_room(const struct fs_logfs *fs, uint16_t idx)
+{
+	const struct fs_logfs_sector *s = &fs->sectors[idx];
+
+	return rec_off(fs, s->slots) + rec_size(fs) - fs->data_off - s->end;
+}
+
+/* Room for whole data blocks, keeping a record for the commit of the
+ * data and one for a truncate.
+ */
+static inline uint32_t sector_data_room(const struct fs_logfs *fs,
+					uint16_t idx)
+{
+	uint32_t room = sector_room(fs, idx);
+
+	if (room < 2 * rec_size(fs)) {
+		return 0;
+	}
+
+	return ROUND_DOWN(room - 2 * rec_size(fs), fs->write_size);
+}
+
+static const char *file_name(const char *path, const struct fs_mount_t *mp)
+{
+	path = fs_impl_strip_prefix(path, mp);
+
+	return (*path == '/') ? path + 1 : path;
+}
+
+static int file_find(struct fs_logfs *fs, const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(fs->files); i++) {
+		if (fs->files[i].used &&
+		    (strcmp(fs->files[i].name, name) == 0)) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static int file_add(struct fs_logfs *fs, const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(fs->files); i++) {
+		struct fs_logfs_file *f = &fs->files[i];
+
+		if (!f->used) {
+			memset(f, 0, sizeof(*f));
+			strcpy(f->name, name);
+			f->first = LOGFS_NONE;
+			f->last = LOGFS_NONE;
+			f->used = true;
+			return i;
+		}
+	}
+
+	return -ENOSPC;
+}
+
+static int sector_erase(struct fs_logfs *fs, uint16_t idx)
+{
+	struct fs_logfs_sector *s = &fs->sectors[idx];
+	int rc;
+
+	rc = flash_area_erase(fs->area, sector_off(fs, idx), fs->sector_size);
+	if (rc == 0) {
+		memset(s, 0, sizeof(*s));
+		s->next = LOGFS_NONE;
+	} else {
+		s->seq = 0;
+		s->flags = LOGFS_SECT_DIRTY;
+	}
+
+	return rc;
+}
+
+/* Read up to n data bytes at offset off of a sector, returns the number
+ * of bytes read.  Bytes past the whole write blocks of a sector that is
+ * no longer appended to are held by its last record.
+ */
+static ssize_t sector_read(struct fs_logfs *fs, uint16_t idx, uint32_t off,
+			   void *dst, size_t n)
+{
+	const struct fs_logfs_sector *s = &fs->sectors[idx];
+	uint32_t full = ROUND_DOWN(s->len, fs->write_size);
+	off_t addr = sector_off(fs, idx);
+	const void *src;
+	int rc;
+
+	if (off >= full) {
+		addr += rec_off(fs, s->rec) + sizeof(uint32_t) + (off - full);
+	} else {
+		addr += fs->data_off + off;
+		n = MIN(n, full - off);
+		if (flash_area_mmap(fs->area, addr, n, &src) == 0) {
+			memcpy(dst, src, n);
+			return n;
+		}
+	}
+
+	rc = flash_area_read(fs->area, addr, dst, n);
+
+	return (rc < 0) ? rc : n;
+}
+
+/* Write the next record of a sector.  The bytes of value's length past
+ * the last whole write block are taken from tail.
+ */
+static int rec_write(struct fs_logfs *fs, uint16_t idx, uint32_t value,
+		     const uint8_t *tail)
+{
+	const uint32_t len = value & LOGFS_REC_LEN_MASK;
+	struct fs_logfs_sector *s = &fs->sectors[idx];
+	const size_t size = rec_size(fs);
+	uint8_t buf[LOGFS_REC_MAX];
+	int rc;
+
+	if (sector_room(fs, idx) < size) {
+		return -ENOSPC;
+	}
+
+	memset(buf, fs->erased_val, size);
+	sys_put_le32(value | LOGFS_REC_MARK, buf);
+	if ((len % fs->write_size) != 0) {
+		memcpy(&buf[sizeof(uint32_t)], tail, len % fs->write_size);
+	}
+	buf[size - 1] = crc8_ccitt(0xff, buf, size - 1);
+
+	rc = flash_area_write(fs->area, sector_off(fs, idx) +
+			      rec_off(fs, s->slots), buf, size);
+	/* A failed write may have programmed part of the slot, the next
+	 * record goes to the following one.
+	 */
+	s->slots++;
+	if (rc < 0) {
+		return rc;
+	}
+
+	s->rec = s->slots - 1;
+	s->flags &= ~LOGFS_SECT_UNCOMMITTED;
+	if (value & LOGFS_SEALED) {
+		s->flags |= LOGFS_SECT_SEALED;
+	}
+
+	return 0;
+}
+
+static int sector_seal(struct fs_logfs *fs, uint16_t idx)
+{
+	struct fs_logfs_sector *s = &fs->sectors[idx];
+
+	if ((s->flags & LOGFS_SECT_SEALED) &&
+	    !(s->flags & LOGFS_SECT_UNCOMMITTED)) {
+		return 0;
+	}
+
+	/* Sectors appended to only hold whole write blocks */
+	return rec_write(fs, idx, s->len | LOGFS_SEALED, NULL);
+}
+
+/* Take the next free sector in ring order and append it to the file */
+static int sector_alloc(struct fs_logfs *fs, uint8_t fi)
+{
+	struct fs_logfs_file *f = &fs->files[fi];
+	struct logfs_hdr hdr;
+	uint8_t buf[FS_LOGFS_WBUF_SIZE];
+	uint16_t idx = LOGFS_NONE;
+	size_t len;
+	int rc;
+
+	for (uint32_t i = 0; i < fs->sector_count; i++) {
+		uint16_t n = (fs->alloc + i) % fs->sector_count;
+
+		if (fs->sectors[n].seq == 0) {
+			idx = n;
+			break;
+		}
+	}
+
+	if (idx == LOGFS_NONE) {
+		return -ENOSPC;
+	}
+
+	if (fs->sectors[idx].flags & LOGFS_SECT_DIRTY) {
+		rc = sector_erase(fs, idx);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = sys_cpu_to_le32(LOGFS_MAGIC);
+	hdr.seq = sys_cpu_to_le32(fs->seq + 1);
+	strcpy(hdr.name, f->name);
+	hdr.crc = sys_cpu_to_le32(crc32_ieee((const uint8_t *)&hdr,
+					     offsetof(struct logfs_hdr, crc)));
+
+	/* The unaligned tail of the header shares a write block with
+	 * padding.
+	 */
+	len = ROUND_DOWN(sizeof(hdr), fs->write_size);
+	rc = flash_area_write(fs->area, sector_off(fs, idx), &hdr, len);
+	if ((rc == 0) && (len < sizeof(hdr))) {
+		memset(buf, fs->erased_val, fs->write_size);
+		memcpy(buf, (uint8_t *)&hdr + len, sizeof(hdr) - len);
+		rc = flash_area_write(fs->area, sector_off(fs, idx) + len,
+				      buf, fs->write_size);
+	}
+
+	if (rc < 0) {
+		fs->sectors[idx].flags = LOGFS_SECT_DIRTY;
+		return rc;
+	}
+
+	fs->seq++;
+	fs->sectors[idx] = (struct fs_logfs_sector) {
+		.seq = fs->seq,
+		.next = LOGFS_NONE,
+		.file = fi,
+	};
+
+	if (f->last == LOGFS_NONE) {
+		f->first = idx;
+	} else {
+		fs->sectors[f->last].next = idx;
+	}
+	f->last = idx;
+	fs->alloc = (idx + 1) % fs->sector_count;
+
+	return 0;
+}
+
+/* Continue the file in a new sector.  The current tail sector is sealed
+ * first, so that its length is known before data follows elsewhere.
+ */
+static int file_extend(struct fs_logfs *fs, uint8_t fi)
+{
+	struct fs_logfs_file *f = &fs->files[fi];
+	int rc;
+
+	rc = sector_seal(fs, f->last);
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = sector_alloc(fs, fi);
+	if ((rc == 0) && (f->pending > 0)) {
+		fs->sectors[f->last].flags |= LOGFS_SECT_UNCOMMITTED;
+	}
+
+	return rc;
+}
+
+/* Record the length of the tail sector of a file, together with the
+ * bytes of a trailing partial write block.
+ */
+static int file_commit(struct fs_logfs *fs, uint8_t fi)
+{
+	struct fs_logfs_file *f = &fs->files[fi];
+	struct fs_logfs_sector *s = &fs->sectors[f->last];
+	int rc;
+
+	if (!(s->flags & LOGFS_SECT_UNCOMMITTED)) {
+		return 0;
+	}
+
+	if (!(s->flags & LOGFS_SECT_SEALED) &&
+	    (sector_room(fs, f->last) >= 2 * rec_size(fs))) {
+		return rec_write(fs, f->last, s->len + f->pending, f->wbuf);
+	}
+
+	/* No record left to spare, move the pending bytes on */
+	if (f->pending == 0) {
+		return sector_seal(fs, f->last);
+	}
+
+	rc = file_extend(fs, fi);
+	if (rc < 0) {
+		return rc;
+	}
+
+	return rec_write(fs, f->last, f->pending, f->wbuf);
+}
+
+static ssize_t file_append(struct fs_logfs *fs, uint8_t fi,
+			   const uint8_t *data, size_t size)
+{
+	struct fs_logfs_file *f = &fs->files[fi];
+	const uint16_t wsize = fs->write_size;
+	size_t written = 0;
+	int rc = 0;
+
+	while (size > 0) {
+		struct fs_logfs_sector *s = &fs->sectors[f->last];
+		off_t off;
+		size_t n;
+
+		if ((s->flags & LOGFS_SECT_SEALED) ||
+		    (sector_data_room(fs, f->last) == 0)) {
+			rc = file_extend(fs, fi);
+			if (rc < 0) {
+				break;
+			}
+			continue;
+		}
+
+		off = sector_off(fs, f->last) + fs->data_off + s->len;
+
+		if ((f->pending > 0) || (size < wsize)) {
+			/* Gather a partial write block */
+			n = MIN(size, wsize - f->pending);
+			memcpy(&f->wbuf[f->pending], data, n);
+			f->pending += n;
+			f->size += n;
+			data += n;
+			size -= n;
+			written += n;
+			s->flags |= LOGFS_SECT_UNCOMMITTED;
+
+			if (f->pending == wsize) {
+				rc = flash_area_write(fs->area, off, f->wbuf,
+						      wsize);
+				if (rc < 0) {
+					s->flags |= LOGFS_SECT_SEALED |
+						    LOGFS_SECT_UNCOMMITTED;
+					break;
+				}
+				s->len += wsize;
+				s->end = s->len;
+				f->pending = 0;
+			}
+			continue;
+		}
+
+		/* Program whole write blocks straight from the caller */
+		n = MIN(size, sector_data_room(fs, f->last));
+		n = ROUND_DOWN(n, wsize);
+		rc = flash_area_write(fs->area, off, data, n);
+		if (rc < 0) {
+			/* The blocks may be partially programmed */
+			s->flags |= LOGFS_SECT_SEALED | LOGFS_SECT_UNCOMMITTED;
+			break;
+		}
+		s->len += n;
+		s->end = s->len;
+		s->flags |= LOGFS_SECT_UNCOMMITTED;
+		f->size += n;
+		data += n;
+		size -= n;
+		written += n;
+	}
+
+	return (written > 0) ? written : rc;
+}
+
+/* Erase the sectors of a file past sector keep, or all of them when keep
+ * is LOGFS_NONE.  The newest sector goes first, so the file only ever
+ * loses data from its end should power fail meanwhile.
+ */
+static int file_drop_sectors(struct fs_logfs *fs, struct fs_logfs_file *f,
+			     uint16_t keep)
+{
+	int err = 0;
+
+	while (f->last != keep) {
+		uint16_t prev = (keep == LOGFS_NONE) ? f->first : keep;
+		int rc;
+
+		if (prev == f->last) {
+			prev = LOGFS_NONE;
+		} else {
+			while (fs->sectors[prev].next != f->last) {
+				prev = fs->sectors[prev].next;
+			}
+		}
+
+		/* A sector that fails to erase is left dirty */
+		rc = sector_erase(fs, f->last);
+		if ((rc < 0) && (err == 0)) {
+			err = rc;
+		}
+
+		if (prev == LOGFS_NONE) {
+			f->first = LOGFS_NONE;
+		} else {
+			fs->sectors[prev].next = LOGFS_NONE;
+		}
+		f->last = prev;
+	}
+
+	return err;
+}
+
+/* Find the sector holding file offset pos, starting from the sector
+ * last used by the handle when possible.
+ */
+static uint16_t file_locate(struct fs_logfs *fs, struct logfs_file_data *fdp,
+			    uint32_t pos, uint32_t *base)
+{
+	struct fs_logfs_file *f = &fs->files[fdp->file];
+	uint16_t idx = f->first;
+
+	*base = 0;
+	if ((fdp->sector != LOGFS_NONE) &&
+	    (fs->sectors[fdp->sector].seq == fdp->sector_seq) &&
+	    (fdp->sector_base <= pos)) {
+		idx = fdp->sector;
+		*base = fdp->sector_base;
+	}
+
+	while (idx != LOGFS_NONE) {
+		struct fs_logfs_sector *s = &fs->sectors[idx];
+
+		if ((pos < (*base + s->len)) || (s->next == LOGFS_NONE)) {
+			break;
+		}
+		*base += s->len;
+		idx = s->next;
+	}
+
+	if (idx != LOGFS_NONE) {
+		fdp->sector = idx;
+		fdp->sector_seq = fs->sectors[idx].seq;
+		fdp->sector_base = *base;
+	}
+
+	return idx;
+}
+
+static int logfs_open(struct fs_file_t *fp, const char *path,
+		      fs_mode_t zflags)
+{
+	struct fs_logfs *fs = fp->mp->fs_data;
+	const char *name = file_name(path, fp->mp);
+	struct logfs_file_data *fdp;
+	struct fs_logfs_file *f;
+	int fi;
+	int rc;
+
+	if ((*name == '\0') || (strchr(name, '/') != NULL)) {
+		return -EINVAL;
+	}
+
+	rc = k_mem_slab_alloc(&logfs_file_pool, &fp->filep, K_NO_WAIT);
+	if (rc != 0) {
+		return rc;
+	}
+	fdp = fp->filep;
+
+	fs_lock(fs);
+
+	fi = file_find(fs, name);
+	if ((fi < 0) && (zflags & FS_O_CREATE)) {
+		if (strlen(name) > MIN(FS_LOGFS_NAME_MAX, MAX_FILE_NAME)) {
+			fi = -ENAMETOOLONG;
+		} else {
+			fi = file_add(fs, name);
+		}
+
+		/* Persist the name in the first sector of the file */
+		if (fi >= 0) {
+			rc = sector_alloc(fs, fi);
+			if (rc < 0) {
+				fs->files[fi].used = false;
+				fi = rc;
+			}
+		}
+	}
+
+	if (fi < 0) {
+		rc = fi;
+		goto out;
+	}
+
+	f = &fs->files[fi];
+	if (zflags & FS_O_WRITE) {
+		if (f->writer) {
+			rc = -EBUSY;
+			goto out;
+		}
+		f->writer = true;
+	}
+	f->open_cnt++;
+
+	*fdp = (struct logfs_file_data) {
+		.file = fi,
+		.pos = (zflags & FS_O_APPEND) ? f->size : 0,
+		.sector = LOGFS_NONE,
+	};
+	rc = 0;
+
+out:
+	fs_unlock(fs);
+
+	if (rc < 0) {
+		k_mem_slab_free(&logfs_file_pool, &fp->filep);
+		fp->filep = NULL;
+	}
+
+	return rc;
+}
+
+static int logfs_close(struct fs_file_t *fp)
+{
+	struct fs_logfs *fs = fp->mp->fs_data;
+	struct logfs_file_data *fdp = fp->filep;
+	struct fs_logfs_file *f = &fs->files[fdp->file];
+	int rc = 0;
+
+	fs_lock(fs);
+
+	if (fp->flags & FS_O_WRITE) {
+		rc = file_commit(fs, fdp->file);
+		f->writer = false;
+	}
+	f->open_cnt--;
+
+	fs_unlock(fs);
+
+	k_mem_slab_free(&logfs_file_pool, &fp->filep);
+	fp->filep = NULL;
+
+	return rc;
+}
+
+static ssize_t logfs_read(struct fs_file_t *fp, void *ptr, size_t len)
+{
+	struct fs_logfs *fs = fp->mp->fs_data;
+	struct logfs_file_data *fdp = fp->filep;
+	struct fs_logfs_file *f = &fs->files[fdp->file];
+	uint8_t *dst = ptr;
+	size_t done = 0;
+	int rc = 0;
+
+	fs_lock(fs);
+
+	len = MIN(len, (fdp->pos < f->size) ? (f->size - fdp->pos) : 0);
+	while (done < len) {
+		uint32_t base;
+		uint16_t idx = file_locate(fs, fdp, fdp->pos, &base);
+		struct fs_logfs_sector *s;
+		uint32_t in_sector;
+		size_t n;
+
+		__ASSERT_NO_MSG(idx != LOGFS_NONE);
+		s = &fs->sectors[idx];
+		in_sector = fdp->pos - base;
+
+		if (in_sector >= s->len) {
+			/* Bytes not yet programmed to flash */
+			n = MIN(len - done, f->pending - (in_sector - s->len));
+			memcpy(dst, &f->wbuf[in_sector - s->len], n);
+		} else {
+			rc = sector_read(fs, idx, in_sector, dst,
+					 MIN(len - done, s->len - in_sector));
+			if (rc < 0) {
+				break;
+			}
+			n = rc;
+		}
+
+		dst += n;
+		done += n;
+		fdp->pos += n;
+	}
+
+	fs_unlock(fs);
+
+	return (done > 0) ? done : rc;
+}
+
+static ssize_t logfs_write(struct fs_file_t *fp, const void *ptr, size_t len)
+{
+	struct fs_logfs *fs = fp->mp->fs_data;
+	struct logfs_file_data *fdp = fp->filep;
+	ssize_t rc;
+
+	fs_lock(fs);
+
+	rc = file_append(fs, fdp->file, ptr, len);
+	fdp->pos = fs->files[fdp->file].size;
+
+	fs_unlock(fs);
+
+	return rc;
+}
+
+static int logfs_seek(struct fs_file_t *fp, off_t off, int whence)
+{
+	struct fs_logfs *fs = fp->mp->fs_data;
+	struct logfs_file_data *fdp = fp->filep;
+	off_t pos;
+	int rc = 0;
+
+	fs_lock(fs);
+
+	switch (whence) {
+	case FS_SEEK_SET:
+		pos = off;
+		break;
+	case FS_SEEK_CUR:
+		pos = fdp->pos + off;
+		break;
+	case FS_SEEK_END:
+		pos = fs->files[fdp->file].size + off;
+		break;
+	default:
+		rc = -EINVAL;
+		goto out;
+	}
+
+	if ((pos < 0) || (pos > fs->files[fdp->file].size)) {
+		rc = -EINVAL;
+		goto out;
+	}
+	fdp->pos = pos;
+
+out:
+	fs_unlock(fs);
+
+	return rc;
+}
+
+static off_t logfs_tell(struct fs_file_t *fp)
+{
+	struct logfs_file_data *fdp = fp->filep;
+
+	return fdp->pos;
+}
+
+/* Shorten the full tail sector of a file to len bytes from a new sector */
+static int file_trim(struct fs_logfs *fs, uint8_t fi, uint32_t len,
+		     const uint8_t *tail)
+{
+	struct fs_logfs_file *f = &fs->files[fi];
+	uint16_t prev = f->last;
+	int rc;
+
+	rc = sector_alloc(fs, fi);
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = rec_write(fs, f->last, len | LOGFS_REC_TRIM, tail);
+	if (rc < 0) {
+		return rc;
+	}
+
+	fs->sectors[prev].len = ROUND_DOWN(len, fs->write_size);
+	fs->sectors[prev].flags |= LOGFS_SECT_SEALED;
+	fs->sectors[f->last].flags |= LOGFS_SECT_TRIM;
+	f->pending = len % fs->write_size;
+	memcpy(f->wbuf, tail, f->pending);
+
+	return 0;
+}
+
+static int logfs_truncate(struct fs_file_t *fp, off_t length)
+{
+	struct fs_logfs *fs = fp->mp->fs_data;
+	struct logfs_file_data *fdp = fp->filep;
+	struct fs_logfs_file *f = &fs->files[fdp->file];
+	uint32_t flushed;
+	struct fs_logfs_sector *s;
+	uint8_t tail[FS_LOGFS_WBUF_SIZE];
+	uint32_t base = 0;
+	uint32_t len;
+	uint16_t idx;
+	int rc = 0;
+
+	if (length < 0) {
+		return -EINVAL;
+	}
+
+	fs_lock(fs);
+
+	if (length > f->size) {
+		rc = -ENOTSUP;
+		goto out;
+	}
+
+	flushed = f->size - f->pending;
+	if (length >= flushed) {
+		if (length != f->size) {
+			fs->sectors[f->last].flags |= LOGFS_SECT_UNCOMMITTED;
+		}
+		f->pending = length - flushed;
+		f->size = length;
+		goto out;
+	}
+
+	/* Find the sector holding the new end */
+	idx = f->first;
+	while ((fs->sectors[idx].next != LOGFS_NONE) &&
+	       ((base + fs->sectors[idx].len) < length)) {
+		base += fs->sectors[idx].len;
+		idx = fs->sectors[idx].next;
+	}
+	s = &fs->sectors[idx];
+	len = length - base;
+
+	/* Drop the sectors past it before the new length is recorded */
+	f->pending = 0;
+	rc = file_drop_sectors(fs, f, idx);
+	if ((rc == 0) && (len < s->len) && ((len % fs->write_size) != 0)) {
+		/* The bytes past the last whole write block move to the
+		 * record giving the new length.
+		 */
+		rc = sector_read(fs, idx, ROUND_DOWN(len, fs->write_size),
+				 tail, len % fs->write_size);
+	}
+
+	if ((rc >= 0) && (len < s->len)) {
+		if (sector_room(fs, idx) >= rec_size(fs)) {
+			rc = rec_write(fs, idx, len | LOGFS_SEALED, tail);
+			if (rc == 0) {
+				s->len = len;
+			}
+		} else {
+			rc = file_trim(fs, fdp->file, len, tail);
+		}
+	}
+
+	f->size = f->pending;
+	for (idx = f->first; idx != LOGFS_NONE; idx = fs->sectors[idx].next) {
+		f->size += fs->sectors[idx].len;
+	}
+
+out:
+	fs_unlock(fs);
+
+	return rc;
+}
+
+static int logfs_sync(struct fs_file_t *fp)
+{
+	struct fs_logfs *fs = fp->mp->fs_data;
+	struct logfs_file_data *fdp = fp->filep;
+	int rc;
+
+	fs_lock(fs);
+
+	rc = file_commit(fs, fdp->file);
+
+	fs_unlock(fs);
+
+	return rc;
+}
+
+static bool is_root(const char *path, const struct fs_mount_t *mp)
+{
+	return *file_name(path, mp) == '\0';
+}
+
+static int logfs_opendir(struct fs_dir_t *dp, const char *path)
+{
+	int rc;
+
+	if (!is_root(path, dp->mp)) {
+		return -ENOENT;
+	}
+
+	rc = k_mem_slab_alloc(&logfs_dir_pool, &dp->dirp, K_NO_WAIT);
+	if (rc == 0) {
+		((struct logfs_dir_data *)dp->dirp)->next = 0;
+	}
+
+	return rc;
+}
+
+static int logfs_readdir(struct fs_dir_t *dp, struct fs_dirent *entry)
+{
+	struct fs_logfs *fs = dp->mp->fs_data;
+	struct logfs_dir_data *ddp = dp->dirp;
+
+	fs_lock(fs);
+
+	entry->name[0] = '\0';
+	while (ddp->next < ARRAY_SIZE(fs->files)) {
+		struct fs_logfs_file *f = &fs->files[ddp->next++];
+
+		if (f->used) {
+			entry->type = FS_DIR_ENTRY_FILE;
+			entry->size = f->size;
+			strncpy(entry->name, f->name, sizeof(entry->name) - 1);
+			entry->name[sizeof(entry->name) - 1] = '\0';
+			break;
+		}
+	}
+
+	fs_unlock(fs);
+
+	return 0;
+}
+
+static int logfs_closedir(struct fs_dir_t *dp)
+{
+	k_mem_slab_free(&logfs_dir_pool, &dp->dirp);
+
+	return 0;
+}
+
+static int logfs_unlink(struct fs_mount_t *mountp, const char *path)
+{
+	struct fs_logfs *fs = mountp->fs_data;
+	struct fs_logfs_file *f;
+	int fi;
+	int rc = 0;
+
+	fs_lock(fs);
+
+	fi = file_find(fs, file_name(path, mountp));
+	if (fi < 0) {
+		rc = fi;
+		goto out;
+	}
+
+	f = &fs->files[fi];
+	if (f->open_cnt > 0) {
+		rc = -EBUSY;
+		goto out;
+	}
+
+	(void)file_drop_sectors(fs, f, LOGFS_NONE);
+	f->used = false;
+
+out:
+	fs_unlock(fs);
+
+	return rc;
+}
+
+static int logfs_stat(struct fs_mount_t *mountp,
+		      const char *path, struct fs_dirent *entry)
+{
+	struct fs_logfs *fs = mountp->fs_data;
+	int fi;
+
+	if (is_root(path, mountp)) {
+		entry->type = FS_DIR_ENTRY_DIR;
+		entry->name[0] = '\0';
+		entry->size = 0;
+		return 0;
+	}
+
+	fs_lock(fs);
+
+	fi = file_find(fs, file_name(path, mountp));
+	if (fi >= 0) {
+		entry->type = FS_DIR_ENTRY_FILE;
+		entry->size = fs->files[fi].size;
+		strncpy(entry->name, fs->files[fi].name,
+			sizeof(entry->name) - 1);
+		entry->name[sizeof(entry->name) - 1] = '\0';
+	}
+
+	fs_unlock(fs);
+
+	return (fi < 0) ? fi : 0;
+}
+
+static int logfs_statvfs(struct fs_mount_t *mountp,
+			 const char *path, struct fs_statvfs *stat)
+{
+	struct fs_logfs *fs = mountp->fs_data;
+
+	fs_lock(fs);
+
+	stat->f_bsize = fs->write_size;
+	stat->f_frsize = fs->sector_size;
+	stat->f_blocks = fs->sector_count;
+	stat->f_bfree = 0;
+	for (uint32_t i = 0; i < fs->sector_count; i++) {
+		if (fs->sectors[i].seq == 0) {
+			stat->f_bfree++;
+		}
+	}
+
+	fs_unlock(fs);
+
+	return 0;
+}
+
+int fs_logfs_mmap(struct fs_file_t *zfp, const void **ptr, size_t *len)
+{
+	struct fs_logfs *fs;
+	struct logfs_file_data *fdp = zfp->filep;
+	struct fs_logfs_sector *s;
+	uint32_t base;
+	uint16_t idx;
+	int rc;
+
+	if ((zfp->mp == NULL) || (fdp == NULL)) {
+		return -EBADF;
+	}
+
+	fs = zfp->mp->fs_data;
+	fs_lock(fs);
+
+	if (fdp->pos >= fs->files[fdp->file].size) {
+		*ptr = NULL;
+		*len = 0;
+		rc = 0;
+		goto out;
+	}
+
+	idx = file_locate(fs, fdp, fdp->pos, &base);
+	s = &fs->sectors[idx];
+	if ((fdp->pos - base) >= ROUND_DOWN(s->len, fs->write_size)) {
+		rc = -ENOTSUP;
+		goto out;
+	}
+
+	*len = ROUND_DOWN(s->len, fs->write_size) - (fdp->pos - base);
+	rc = flash_area_mmap(fs->area, sector_off(fs, idx) + fs->data_off +
+			     (fdp->pos - base), *len, ptr);
+
+out:
+	fs_unlock(fs);
+
+	return rc;
+}
+
+struct sector_size_ctx {
+	const struct flash_area *area;
+	size_t min_size;
+	size_t max_size;
+};
+
+static bool sector_size_cb(const struct flash_pages_info *info, void *data)
+{
+	struct sector_size_ctx *ctx = data;
+	size_t info_start = (size_t)info->start_offset;
+	size_t area_start = ctx->area->fa_off;
+
+	if ((info_start + info->size) <= area_start) {
+		return true;
+	}
+	if (info_start >= (area_start + ctx->area->fa_size)) {
+		return false;
+	}
+
+	ctx->min_size = MIN(ctx->min_size, info->size);
+	ctx->max_size = MAX(ctx->max_size, info->size);
+
+	return true;
+}
+
+/* Check whether len bytes at offset off of a sector are erased */
+static int sector_erased(struct fs_logfs *fs, uint16_t idx, off_t off,
+			 size_t len)
+{
+	uint8_t buf[32];
+
+	while (len > 0) {
+		size_t n = MIN(sizeof(buf), len);
+		int rc;
+
+		rc = flash_area_read(fs->area, sector_off(fs, idx) + off, buf,
+				     n);
+		if (rc < 0) {
+			return rc;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			if (buf[i] != fs->erased_val) {
+				return 0;
+			}
+		}
+		off += n;
+		len -= n;
+	}
+
+	return 1;
+}
+
+/* Find the end of the programmed data below the records of a sector */
+static int sector_data_end(struct fs_logfs *fs, uint16_t idx, uint32_t *end)
+{
+	off_t off = rec_off(fs, fs->sectors[idx].slots) + rec_size(fs);
+	uint8_t buf[32];
+
+	while (off > fs->data_off) {
+		size_t n = MIN(sizeof(buf), off - fs->data_off);
+		int rc;
+
+		off -= n;
+		rc = flash_area_read(fs->area, sector_off(fs, idx) + off, buf,
+				     n);
+		if (rc < 0) {
+			return rc;
+		}
+
+		for (size_t i = n; i > 0; i--) {
+			if (buf[i - 1] != fs->erased_val) {
+				*end = ROUND_UP(off + i - fs->data_off,
+						fs->write_size);
+				return 0;
+			}
+		}
+	}
+
+	*end = 0;
+
+	return 0;
+}
+
+/* Read the records of a sector up to the first erased or invalid slot.
+ * Provides the value of the last valid record, 0 if there is none, and
+ * whether an invalid slot was found.
+ */
+static int sector_scan_recs(struct fs_logfs *fs, uint16_t idx,
+			    uint32_t *value, bool *torn)
+{
+	struct fs_logfs_sector *s = &fs->sectors[idx];
+	const size_t size = rec_size(fs);
+	uint8_t buf[LOGFS_REC_MAX];
+
+	*value = 0;
+	*torn = false;
+	for (uint16_t i = 0; rec_off(fs, i) >= fs->data_off; i++) {
+		size_t n = 0;
+		uint32_t v;
+		int rc;
+
+		rc = flash_area_read(fs->area, sector_off(fs, idx) +
+				     rec_off(fs, i), buf, size);
+		if (rc < 0) {
+			return rc;
+		}
+
+		while ((n < size) && (buf[n] == fs->erased_val)) {
+			n++;
+		}
+		if (n == size) {
+			break;
+		}
+
+		/* An interrupted record write, or data of a full sector */
+		v = sys_get_le32(buf);
+		if ((buf[size - 1] != crc8_ccitt(0xff, buf, size - 1)) ||
+		    !(v & LOGFS_REC_MARK)) {
+			*torn = true;
+			break;
+		}
+
+		if (v & LOGFS_REC_TRIM) {
+			if (i == 0) {
+				s->flags |= LOGFS_SECT_TRIM;
+			}
+			/* Only the bytes past the trimmed length are ours */
+			v = (v & LOGFS_SEALED) |
+			    ((v & LOGFS_REC_LEN_MASK) % fs->write_size);
+		}
+
+		*value = v;
+		s->rec = i;
+		s->slots = i + 1;
+	}
+
+	return 0;
+}
+
+static int sector_scan(struct fs_logfs *fs, uint16_t idx)
+{
+	struct fs_logfs_sector *s = &fs->sectors[idx];
+	struct logfs_hdr hdr;
+	uint32_t value;
+	uint32_t cap;
+	bool torn;
+	int fi;
+	int rc;
+
+	memset(s, 0, sizeof(*s));
+	s->next = LOGFS_NONE;
+
+	rc = flash_area_read(fs->area, sector_off(fs, idx), &hdr, sizeof(hdr));
+	if (rc < 0) {
+		return rc;
+	}
+
+	if ((sys_le32_to_cpu(hdr.magic) != LOGFS_MAGIC) ||
+	    (sys_le32_to_cpu(hdr.crc) !=
+	     crc32_ieee((const uint8_t *)&hdr,
+			offsetof(struct logfs_hdr, crc))) ||
+	    (hdr.name[FS_LOGFS_NAME_MAX] != '\0') ||
+	    (sys_le32_to_cpu(hdr.seq) == 0)) {
+		/* Only erase on reuse what is not erased already */
+		rc = sector_erased(fs, idx, 0, fs->sector_size);
+		if (rc == 0) {
+			s->flags = LOGFS_SECT_DIRTY;
+		}
+		return MIN(rc, 0);
+	}
+
+	fi = file_find(fs, hdr.name);
+	if (fi < 0) {
+		fi = file_add(fs, hdr.name);
+		if (fi < 0) {
+			LOG_ERR("too many files");
+			return fi;
+		}
+	}
+
+	rc = sector_scan_recs(fs, idx, &value, &torn);
+	if (rc == 0) {
+		rc = sector_data_end(fs, idx, &s->end);
+	}
+	if (rc < 0) {
+		return rc;
+	}
+
+	cap = rec_off(fs, s->slots) + rec_size(fs) - fs->data_off;
+	s->seq = sys_le32_to_cpu(hdr.seq);
+	s->file = fi;
+	s->len = MIN(value & LOGFS_REC_LEN_MASK,
+		     ROUND_DOWN(cap, fs->write_size));
+	if ((value & LOGFS_SEALED) ||
+	    (s->end > ROUND_DOWN(s->len, fs->write_size))) {
+		/* Appends would overlap data that is not committed */
+		s->flags |= LOGFS_SECT_SEALED;
+	}
+	s->end = MAX(s->end, ROUND_DOWN(s->len, fs->write_size));
+	if (torn) {
+		/* Nothing more is written to the sector */
+		s->flags |= LOGFS_SECT_SEALED;
+		s->end = cap;
+	}
+
+	fs->seq = MAX(fs->seq, s->seq);
+
+	return 0;
+}
+
+static void file_link(struct fs_logfs *fs, uint16_t idx)
+{
+	struct fs_logfs_sector *s = &fs->sectors[idx];
+	struct fs_logfs_file *f = &fs->files[s->file];
+	uint16_t *link = &f->first;
+
+	/* Keep the sectors of a file ordered by sequence number */
+	while ((*link != LOGFS_NONE) && (fs->sectors[*link].seq < s->seq)) {
+		link = &fs->sectors[*link].next;
+	}
+	s->next = *link;
+	*link = idx;
+	if (s->next == LOGFS_NONE) {
+		f->last = idx;
+	}
+}
+
+/* Apply the length given by a LOGFS_REC_TRIM record to the sector
+ * before the one holding it.
+ */
+static int sector_trim(struct fs_logfs *fs, uint16_t prev, uint16_t idx)
+{
+	uint32_t v;
+	int rc;
+
+	rc = flash_area_read(fs->area, sector_off(fs, idx) + rec_off(fs, 0),
+			     &v, sizeof(v));
+	if (rc < 0) {
+		return rc;
+	}
+
+	v = sys_le32_to_cpu(v) & LOGFS_REC_LEN_MASK;
+	fs->sectors[prev].len = MIN(fs->sectors[prev].len,
+				    ROUND_DOWN(v, fs->write_size));
+
+	return 0;
+}
+
+/* Only the tail sector of a file is appended to.  Its trailing partial
+ * write block is taken back from the last record, to be completed by
+ * the next write.
+ */
+static int file_resume(struct fs_logfs *fs, struct fs_logfs_file *f)
+{
+	struct fs_logfs_sector *s;
+	int rc;
+
+	if (!f->used) {
+		return 0;
+	}
+
+	for (uint16_t idx = f->first; idx != f->last;
+	     idx = fs->sectors[idx].next) {
+		uint16_t next = fs->sectors[idx].next;
+
+		if (fs->sectors[next].flags & LOGFS_SECT_TRIM) {
+			rc = sector_trim(fs, idx, next);
+			if (rc < 0) {
+				return rc;
+			}
+		}
+		fs->sectors[idx].flags |= LOGFS_SECT_SEALED;
+		f->size += fs->sectors[idx].len;
+	}
+	f->size += fs->sectors[f->last].len;
+
+	s = &fs->sectors[f->last];
+	f->pending = s->len % fs->write_size;
+	if ((s->flags & LOGFS_SECT_SEALED) || (f->pending == 0)) {
+		f->pending = 0;
+		return 0;
+	}
+
+	rc = sector_read(fs, f->last, s->len - f->pending, f->wbuf,
+			 f->pending);
+	if (rc < 0) {
+		return rc;
+	}
+	s->len -= f->pending;
+
+	return 0;
+}
+
+static int logfs_mount(struct fs_mount_t *mountp)
+{
+	struct fs_logfs *fs = mountp->fs_data;
+	unsigned int area_id = (uintptr_t)mountp->storage_dev;
+	struct sector_size_ctx ctx = {
+		.min_size = SIZE_MAX,
+	};
+	const struct device *dev;
+	uint32_t seq = 0;
+	int rc;
+
+	if (fs->area) {
+		return -EBUSY;
+	}
+
+	k_mutex_init(&fs->mutex);
+	fs_lock(fs);
+
+	rc = flash_area_open(area_id, &fs->area);
+	if ((rc < 0) || (fs->area == NULL)) {
+		LOG_ERR("can't open flash area %d", area_id);
+		rc = -ENODEV;
+		goto out;
+	}
+
+	dev = flash_area_get_device(fs->area);
+	if (dev == NULL) {
+		LOG_ERR("can't get flash device: %s", fs->area->fa_dev_name);
+		rc = -ENODEV;
+		goto out;
+	}
+
+	ctx.area = fs->area;
+	flash_page_foreach(dev, sector_size_cb, &ctx);
+	if ((ctx.max_size == 0) || (ctx.min_size != ctx.max_size)) {
+		LOG_ERR("sectors must be of uniform size");
+		rc = -EINVAL;
+		goto out;
+	}
+
+	fs->sector_size = ctx.max_size;
+	fs->sector_count = fs->area->fa_size / fs->sector_size;
+	fs->write_size = flash_area_align(fs->area);
+	fs->erased_val = flash_area_erased_val(fs->area);
+	if ((fs->sector_count > ARRAY_SIZE(fs->sectors)) ||
+	    (fs->write_size > FS_LOGFS_WBUF_SIZE)) {
+		LOG_ERR("unsupported geometry: %u sectors, %u write size",
+			fs->sector_count, fs->write_size);
+		rc = -EINVAL;
+		goto out;
+	}
+
+	fs->data_off = hdr_size(fs);
+	if ((fs->data_off + 3 * rec_size(fs)) > fs->sector_size) {
+		rc = -EINVAL;
+		goto out;
+	}
+
+	fs->seq = 0;
+	fs->alloc = 0;
+	memset(fs->files, 0, sizeof(fs->files));
+	for (uint16_t i = 0; i < fs->sector_count; i++) {
+		rc = sector_scan(fs, i);
+		if (rc < 0) {
+			goto out;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(fs->files); i++) {
+		fs->files[i].first = LOGFS_NONE;
+		fs->files[i].last = LOGFS_NONE;
+	}
+
+	for (uint16_t i = 0; i < fs->sector_count; i++) {
+		if (fs->sectors[i].seq == 0) {
+			continue;
+		}
+
+		file_link(fs, i);
+		if (fs->sectors[i].seq > seq) {
+			/* Continue allocating after the newest sector */
+			seq = fs->sectors[i].seq;
+			fs->alloc = (i + 1) % fs->sector_count;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(fs->files); i++) {
+		rc = file_resume(fs, &fs->files[i]);
+		if (rc < 0) {
+			goto out;
+		}
+	}
+
+	LOG_INF("%s: %u 0x%x-byte sectors", log_strdup(mountp->mnt_point),
+		fs->sector_count, fs->sector_size);
+
+out:
+	if ((rc < 0) && (fs->area != NULL)) {
+		flash_area_close(fs->area);
+		fs->area = NULL;
+	}
+
+	fs_unlock(fs);
+
+	return rc;
+}
+
+static int logfs_unmount(struct fs_mount_t *mountp)
+{
+	struct fs_logfs *fs = mountp->fs_data;
+
+	fs_lock(fs);
+
+	flash_area_close(fs->area);
+	fs->area = NULL;
+
+	fs_unlock(fs);
+
+	return 0;
+}
+
+/* File system interface */
+static const struct fs_file_system_t logfs_fs = {
+	.open = logfs_open,
+	.close = logfs_close,
+	.read = logfs_read,
+	.write = logfs_write,
+	.lseek = logfs_seek,
+	.tell = logfs_tell,
+	.truncate = logfs_truncate,
+	.sync = logfs_sync,
+	.opendir = logfs_opendir,
+	.readdir = logfs_readdir,
+	.closedir = logfs_closedir,
+	.mount = logfs_mount,
+	.unmount = logfs_unmount,
+	.unlink = logfs_unlink,
+	.stat = logfs_stat,
+	.statvfs = logfs_statvfs,
+};
+
+static int logfs_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+	return fs_register(FS_LOGFS, &logfs_fs);
+}
+
+SYS_INIT(logfs_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -11,6 +11,7 @@
 #include <inttypes.h>
 #include <fs/nvs.h>
 #include <sys/crc.h>
+#include <init.h>
 #include "nvs_priv.h"
 
 #include <logging/log.h>
@@ -99,6 +100,22 @@ static int nvs_flash_rd(struct nvs_fs *fs, uint32_t addr, void *data,
 
 }
 
+/* direct pointer to memory mapped flash at nvs address, returns -ENOTSUP
+ * when the flash is not mapped.
+ */
+static int nvs_flash_ptr(struct nvs_fs *fs, uint32_t addr, size_t len,
+			 const uint8_t **ptr)
+{
+	off_t offset;
+
+	offset = fs->offset;
+	offset += fs->sector_size * (addr >> ADDR_SECT_SHIFT);
+	offset += addr & ADDR_OFFS_MASK;
+
+	return flash_mmap(fs->flash_device, offset, len,
+			  (const void **)ptr);
+}
+
 /* allocation entry write */
 static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 {
@@ -141,10 +158,15 @@ static int nvs_flash_block_cmp(struct nvs_fs *fs, uint32_t addr, const void *dat
 				size_t len)
 {
 	const uint8_t *data8 = (const uint8_t *)data;
+	const uint8_t *mapped;
 	int rc;
 	size_t bytes_to_cmp, block_size;
 	uint8_t buf[NVS_BLOCK_SIZE];
 
+	if (!nvs_flash_ptr(fs, addr, len, &mapped)) {
+		return memcmp(data8, mapped, len) ? 1 : 0;
+	}
+
 	block_size =
 		NVS_BLOCK_SIZE & ~(fs->flash_parameters->write_block_size - 1U);
 
@@ -172,10 +194,20 @@ static int nvs_flash_block_cmp(struct nvs_fs *fs, uint32_t addr, const void *dat
 static int nvs_flash_cmp_const(struct nvs_fs *fs, uint32_t addr, uint8_t value,
 				size_t len)
 {
+	const uint8_t *mapped;
 	int rc;
 	size_t bytes_to_cmp, block_size;
 	uint8_t cmp[NVS_BLOCK_SIZE];
 
+	if (!nvs_flash_ptr(fs, addr, len, &mapped)) {
+		while (len--) {
+			if (*mapped++ != value) {
+				return 1;
+			}
+		}
+		return 0;
+	}
+
 	block_size =
 		NVS_BLOCK_SIZE & ~(fs->flash_parameters->write_block_size - 1U);
 
@@ -197,10 +229,16 @@ static int nvs_flash_cmp_const(struct nvs_fs *fs, uint32_t addr, uint8_t value,
  */
 static int nvs_flash_block_move(struct nvs_fs *fs, uint32_t addr, size_t len)
 {
+	const uint8_t *mapped;
 	int rc;
 	size_t bytes_to_copy, block_size;
 	uint8_t buf[NVS_BLOCK_SIZE];
 
+	/* memory mapped flash can be written from in place */
+	if (!nvs_flash_ptr(fs, addr, len, &mapped)) {
+		return nvs_flash_data_wrt(fs, mapped, len);
+	}
+
 	block_size =
 		NVS_BLOCK_SIZE & ~(fs->flash_parameters->write_block_size - 1U);
 
@@ -466,22 +504,21 @@ static int nvs_sector_close(struct nvs_fs *fs)
 }
 
 
-/* garbage collection: the address ate_wra has been updated to the new sector
- * that has just been started. The data to gc is in the sector after this new
- * sector.
+/* garbage collection of the sector at sec_addr: its valid entries are moved
+ * to the sector at ate_wra and it is erased. When move_size is not NULL,
+ * nothing is written and the space the entries to move need is added to it.
  */
-static int nvs_gc(struct nvs_fs *fs)
+static int nvs_gc_sector(struct nvs_fs *fs, uint32_t sec_addr,
+			 size_t *move_size)
 {
 	int rc;
 	struct nvs_ate close_ate, gc_ate, wlk_ate;
-	uint32_t sec_addr, gc_addr, gc_prev_addr, wlk_addr, wlk_prev_addr,
+	uint32_t gc_addr, gc_prev_addr, wlk_addr, wlk_prev_addr,
 	      data_addr, stop_addr;
 	size_t ate_size;
 
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
-	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
-	nvs_sector_advance(fs, &sec_addr);
 	gc_addr = sec_addr + fs->sector_size - ate_size;
 
 	/* if the sector is not closed don't do gc */
@@ -493,6 +530,18 @@ static int nvs_gc(struct nvs_fs *fs)
 
 	rc = nvs_ate_cmp_const(&close_ate, fs->flash_parameters->erase_value);
 	if (!rc) {
+		if (move_size) {
+			return 0;
+		}
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+		/* sectors gc'ed in the background are erased already */
+		rc = nvs_flash_cmp_const(fs, sec_addr,
+					 fs->flash_parameters->erase_value,
+					 fs->sector_size);
+		if (rc <= 0) {
+			return rc;
+		}
+#endif
 		rc = nvs_flash_erase_sector(fs, sec_addr);
 		if (rc) {
 			return rc;
@@ -546,6 +595,12 @@ static int nvs_gc(struct nvs_fs *fs)
 		 */
 		if ((wlk_prev_addr == gc_prev_addr) && gc_ate.len) {
 			/* copy needed */
+			if (move_size) {
+				*move_size += nvs_al_size(fs, gc_ate.len) +
+					      ate_size;
+				continue;
+			}
+
 			LOG_DBG("Moving %d, len %d", gc_ate.id, gc_ate.len);
 
 			data_addr = (gc_prev_addr & ADDR_SECT_MASK);
@@ -566,6 +621,10 @@ static int nvs_gc(struct nvs_fs *fs)
 		}
 	} while (gc_prev_addr != stop_addr);
 
+	if (move_size) {
+		return 0;
+	}
+
 	rc = nvs_flash_erase_sector(fs, sec_addr);
 	if (rc) {
 		return rc;
@@ -573,6 +632,171 @@ static int nvs_gc(struct nvs_fs *fs)
 	return 0;
 }
 
+/* garbage collection: the address ate_wra has been updated to the new sector
+ * that has just been started. The data to gc is in the sector after this new
+ * sector.
+ */
+static int nvs_gc(struct nvs_fs *fs)
+{
+	uint32_t sec_addr;
+
+	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
+	nvs_sector_advance(fs, &sec_addr);
+
+	return nvs_gc_sector(fs, sec_addr, NULL);
+}
+
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+K_KERNEL_STACK_DEFINE(nvs_gc_stack, CONFIG_NVS_BACKGROUND_GC_STACK_SIZE);
+
+static struct k_work_q nvs_gc_work_q;
+static bool nvs_gc_work_q_started;
+
+/* count the erased sectors following the write sector, and return the
+ * address of the first one that is not, the oldest sector holding data.
+ * Apart from the write sector, a sector that is not closed is erased.
+ */
+static int nvs_count_free_sectors(struct nvs_fs *fs, uint32_t *oldest)
+{
+	int rc;
+	uint32_t addr;
+	size_t ate_size;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	fs->free_sectors = 0U;
+	addr = fs->ate_wra & ADDR_SECT_MASK;
+	while (1) {
+		nvs_sector_advance(fs, &addr);
+		if (addr == (fs->ate_wra & ADDR_SECT_MASK)) {
+			break;
+		}
+
+		rc = nvs_flash_cmp_const(fs, addr + fs->sector_size - ate_size,
+					 fs->flash_parameters->erase_value,
+					 sizeof(struct nvs_ate));
+		if (rc < 0) {
+			return rc;
+		}
+		if (rc) {
+			/* closed sector */
+			break;
+		}
+
+		fs->free_sectors++;
+	}
+
+	*oldest = addr;
+	return 0;
+}
+
+/* background gc is needed when fewer sectors than the configured reserve are
+ * erased. It is not retried in a write sector where it found no room to move
+ * the data of the oldest sector, that only changes once the write sector is
+ * closed.
+ */
+static bool nvs_bg_gc_needed(struct nvs_fs *fs)
+{
+	return (fs->free_sectors < CONFIG_NVS_BACKGROUND_GC_FREE_SECTORS) &&
+	       ((fs->ate_wra >> ADDR_SECT_SHIFT) != fs->bg_gc_sector);
+}
+
+static void nvs_bg_gc_submit(struct nvs_fs *fs)
+{
+	if (nvs_gc_work_q_started && nvs_bg_gc_needed(fs)) {
+		atomic_set(&fs->gc_pending, 1);
+		k_work_submit_to_queue(&nvs_gc_work_q, &fs->gc_work);
+	}
+}
+
+/* background gc: move the valid entries of the oldest sector to the write
+ * sector and erase it, until the reserve of erased sectors is restored. When
+ * the write sector fills up, nvs_write() then closes it and its gc finds the
+ * next sector erased already. The entries are moved as nvs_gc() moves them
+ * and the sector is only erased once they are all written, so a power loss
+ * leaves at worst duplicate entries, the newest being used.
+ */
+static void nvs_gc_work_handler(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, gc_work);
+	uint32_t sec_addr;
+	size_t ate_size, move_size;
+	int rc = 0;
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	while (fs->ready && nvs_bg_gc_needed(fs)) {
+		rc = nvs_count_free_sectors(fs, &sec_addr);
+		if (rc) {
+			break;
+		}
+
+		if ((sec_addr == (fs->ate_wra & ADDR_SECT_MASK)) ||
+		    !nvs_bg_gc_needed(fs)) {
+			/* nothing left to gc */
+			break;
+		}
+
+		move_size = 0;
+		rc = nvs_gc_sector(fs, sec_addr, &move_size);
+		if (rc) {
+			break;
+		}
+
+		/* leave space for a delete ate, as nvs_write() does */
+		if (fs->ate_wra < fs->data_wra + move_size + ate_size) {
+			fs->bg_gc_sector = fs->ate_wra >> ADDR_SECT_SHIFT;
+			break;
+		}
+
+		LOG_DBG("Background gc of sector %d",
+			(sec_addr >> ADDR_SECT_SHIFT));
+
+		rc = nvs_gc_sector(fs, sec_addr, NULL);
+		if (rc) {
+			break;
+		}
+
+		fs->free_sectors++;
+	}
+
+	if (rc) {
+		LOG_ERR("Background gc failed (%d)", rc);
+	}
+
+	/* cleared under the lock: a write submitting the work again after
+	 * this sets it again
+	 */
+	atomic_clear(&fs->gc_pending);
+	k_mutex_unlock(&fs->nvs_lock);
+	k_sem_give(&fs->gc_done);
+}
+
+void nvs_gc_flush(struct nvs_fs *fs)
+{
+	while (atomic_get(&fs->gc_pending)) {
+		k_sem_take(&fs->gc_done, K_FOREVER);
+	}
+}
+
+static int nvs_gc_work_q_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_q_start(&nvs_gc_work_q, nvs_gc_stack,
+		       K_KERNEL_STACK_SIZEOF(nvs_gc_stack),
+		       CONFIG_NVS_BACKGROUND_GC_PRIORITY);
+	k_thread_name_set(&nvs_gc_work_q.thread, "nvs_gc");
+	nvs_gc_work_q_started = true;
+
+	return 0;
+}
+
+SYS_INIT(nvs_gc_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+
 static int nvs_startup(struct nvs_fs *fs)
 {
 	int rc;
@@ -723,14 +947,19 @@ int nvs_clear(struct nvs_fs *fs)
 		return -EACCES;
 	}
 
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
 	for (uint16_t i = 0; i < fs->sector_count; i++) {
 		addr = i << ADDR_SECT_SHIFT;
 		rc = nvs_flash_erase_sector(fs, addr);
 		if (rc) {
-			return rc;
+			goto end;
 		}
 	}
-	return 0;
+	rc = 0;
+end:
+	k_mutex_unlock(&fs->nvs_lock);
+	return rc;
 }
 
 int nvs_init(struct nvs_fs *fs, const char *dev_name)
@@ -739,7 +968,16 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 	int rc;
 	struct flash_pages_info info;
 	size_t write_block_size;
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	uint32_t oldest_addr;
 
+	/* a gc of a previous mount must not find the work item reinitialized
+	 */
+	nvs_gc_flush(fs);
+	k_work_init(&fs->gc_work, nvs_gc_work_handler);
+	k_sem_init(&fs->gc_done, 0, 1);
+	fs->bg_gc_sector = UINT32_MAX;
+#endif
 	k_mutex_init(&fs->nvs_lock);
 
 	fs->flash_device = device_get_binding(dev_name);
@@ -787,6 +1025,18 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 	/* nvs is ready for use */
 	fs->ready = true;
 
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	rc = nvs_count_free_sectors(fs, &oldest_addr);
+	if (!rc) {
+		nvs_bg_gc_submit(fs);
+	}
+	k_mutex_unlock(&fs->nvs_lock);
+	if (rc) {
+		return rc;
+	}
+#endif
+
 	LOG_INF("%d Sectors of %d bytes", fs->sector_count, fs->sector_size);
 	LOG_INF("alloc wra: %d, %x",
 		(fs->ate_wra >> ADDR_SECT_SHIFT),
@@ -824,6 +1074,9 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		return -EINVAL;
 	}
 
+	/* the lookup of the previous entry must not race with a gc */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
 	/* find latest entry with same id */
 	wlk_addr = fs->ate_wra;
 	rd_addr = wlk_addr;
@@ -832,7 +1085,7 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 		if (rc) {
-			return rc;
+			goto end;
 		}
 		if ((wlk_ate.id == id) && (!nvs_ate_crc8_check(&wlk_ate))) {
 			prev_found = true;
@@ -854,20 +1107,22 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 				/* skip delete entry as it is already the
 				 * last one
 				 */
-				return 0;
+				rc = 0;
+				goto end;
 			}
 		} else if (len == wlk_ate.len) {
 			/* do not try to compare if lengths are not equal */
 			/* compare the data and if equal return 0 */
 			rc = nvs_flash_block_cmp(fs, rd_addr, data, len);
 			if (rc <= 0) {
-				return rc;
+				goto end;
 			}
 		}
 	} else {
 		/* skip delete entry for non-existing entry */
 		if (len == 0) {
-			return 0;
+			rc = 0;
+			goto end;
 		}
 	}
 
@@ -877,8 +1132,6 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		required_space = data_size + ate_size;
 	}
 
-	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
-
 	gc_count = 0;
 	while (1) {
 		if (gc_count == fs->sector_count) {
@@ -911,6 +1164,17 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		gc_count++;
 	}
 	rc = len;
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	if (gc_count) {
+		/* the write sector has changed, recount the reserve */
+		fs->bg_gc_sector = UINT32_MAX;
+		if (nvs_count_free_sectors(fs, &wlk_addr)) {
+			/* only the background gc is missed */
+			fs->free_sectors = 0U;
+		}
+	}
+	nvs_bg_gc_submit(fs);
+#endif
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
@@ -943,6 +1207,9 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
+	/* a background gc may move and erase entries meanwhile */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
 	wlk_addr = fs->ate_wra;
 	rd_addr = wlk_addr;
 
@@ -962,7 +1229,8 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	if (((wlk_addr == fs->ate_wra) && (wlk_ate.id != id)) ||
 	    (wlk_ate.len == 0U) || (cnt_his < cnt)) {
-		return -ENOENT;
+		rc = -ENOENT;
+		goto err;
 	}
 
 	rd_addr &= ADDR_SECT_MASK;
@@ -972,9 +1240,11 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 		goto err;
 	}
 
+	k_mutex_unlock(&fs->nvs_lock);
 	return wlk_ate.len;
 
 err:
+	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
 }
 
@@ -989,7 +1259,7 @@ ssize_t nvs_read(struct nvs_fs *fs, uint16_t id, void *data, size_t len)
 ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 {
 
-	int rc;
+	ssize_t rc;
 	struct nvs_ate step_ate, wlk_ate;
 	uint32_t step_addr, wlk_addr;
 	size_t ate_size, free_space;
@@ -1006,12 +1276,14 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		free_space += (fs->sector_size - ate_size);
 	}
 
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
 	step_addr = fs->ate_wra;
 
 	while (1) {
 		rc = nvs_prev_ate(fs, &step_addr, &step_ate);
 		if (rc) {
-			return rc;
+			goto end;
 		}
 
 		wlk_addr = fs->ate_wra;
@@ -1019,7 +1291,7 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		while (1) {
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 			if (rc) {
-				return rc;
+				goto end;
 			}
 			if ((wlk_ate.id == step_ate.id) ||
 			    (wlk_addr == fs->ate_wra)) {
@@ -1039,5 +1311,8 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		}
 
 	}
-	return free_space;
+	rc = free_space;
+end:
+	k_mutex_unlock(&fs->nvs_lock);
+	return rc;
 }
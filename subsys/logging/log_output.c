@@ -8,6 +8,7 @@
 #include <logging/log_ctrl.h>
 #include <logging/log.h>
 #include <sys/__assert.h>
+#include <sys/cbprintf.h>
 #include <ctype.h>
 #include <time.h>
 #include <stdio.h>
@@ -47,8 +48,6 @@ static uint32_t timestamp_div;
 typedef int (*out_func_t)(int c, void *ctx);
 
 extern int z_prf(int (*func)(), void *dest, char *format, va_list vargs);
-extern void z_vprintk(out_func_t out, void *log_output,
-		     const char *fmt, va_list ap);
 extern void log_output_msg_syst_process(const struct log_output *log_output,
 				struct log_msg *msg, uint32_t flag);
 extern void log_output_string_syst_process(const struct log_output *log_output,
@@ -98,6 +97,20 @@ static int level_to_rfc5424_severity(uint32_t level)
 	return ret;
 }
 
+static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
+			 void *ctx)
+{
+	int processed;
+
+	do {
+		processed = outf(buf, len, ctx);
+		len -= processed;
+		buf += processed;
+	} while (len != 0);
+}
+
+#if !defined(CONFIG_NEWLIB_LIBC) && !defined(CONFIG_ARCH_POSIX) && \
+    defined(CONFIG_LOG_ENABLE_FANCY_OUTPUT_FORMATTING)
 static int out_func(int c, void *ctx)
 {
 	const struct log_output *out_ctx =
@@ -121,6 +134,40 @@ static int out_func(int c, void *ctx)
 
 	return 0;
 }
+#else
+static int out_span(const char *str, size_t len, void *ctx)
+{
+	const struct log_output *out_ctx =
+					(const struct log_output *)ctx;
+	size_t n;
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
+		/* Backend must be thread safe in synchronous operation. */
+		buffer_write(out_ctx->func, (uint8_t *)str, len,
+			     out_ctx->control_block->ctx);
+		return 0;
+	}
+
+	while (len > 0) {
+		if (out_ctx->control_block->offset == out_ctx->size) {
+			log_output_flush(out_ctx);
+		}
+
+		n = MIN(len, out_ctx->size - out_ctx->control_block->offset);
+		memcpy(&out_ctx->buf[out_ctx->control_block->offset], str, n);
+		atomic_add(&out_ctx->control_block->offset, n);
+
+		str += n;
+		len -= n;
+	}
+
+	return 0;
+}
+#endif
 
 static int print_formatted(const struct log_output *log_output,
 			   const char *fmt, ...)
@@ -133,25 +180,13 @@ static int print_formatted(const struct log_output *log_output,
     defined(CONFIG_LOG_ENABLE_FANCY_OUTPUT_FORMATTING)
 	length = z_prf(out_func, (void *)log_output, (char *)fmt, args);
 #else
-	z_vprintk(out_func, (void *)log_output, fmt, args);
+	(void)cbvprintf(out_span, (void *)log_output, fmt, args);
 #endif
 	va_end(args);
 
 	return length;
 }
 
-static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
-			 void *ctx)
-{
-	int processed;
-
-	do {
-		processed = outf(buf, len, ctx);
-		len -= processed;
-		buf += processed;
-	} while (len != 0);
-}
-
 
 void log_output_flush(const struct log_output *log_output)
 {
@@ -595,7 +630,7 @@ void log_output_string(const struct log_output *log_output,
     defined(CONFIG_LOG_ENABLE_FANCY_OUTPUT_FORMATTING)
 	length = z_prf(out_func, (void *)log_output, (char *)fmt, ap);
 #else
-	z_vprintk(out_func, (void *)log_output, fmt, ap);
+	(void)cbvprintf(out_span, (void *)log_output, fmt, ap);
 #endif
 
 	(void)length;
@@ -49,7 +49,7 @@ enum {
  * - each endpoint may be blocking or non-blocking
  */
 __net_socket struct spair {
-	int remote; /**< the remote endpoint file descriptor */
+	struct spair *remote; /**< the remote endpoint */
 	uint32_t flags; /**< status and option bits */
 	struct k_sem sem; /**< semaphore for exclusive structure access */
 	struct k_pipe recv_q; /**< receive queue of local endpoint */
@@ -74,14 +74,7 @@ static inline bool sock_is_nonblock(const struct spair *spair)
 /** Determine if a @ref spair is connected */
 static inline bool sock_is_connected(const struct spair *spair)
 {
-	const struct spair *remote = z_get_fd_obj(spair->remote,
-		(const struct fd_op_vtable *)&spair_fd_op_vtable, 0);
-
-	if (remote == NULL) {
-		return false;
-	}
-
-	return true;
+	return spair->remote != NULL;
 }
 
 #undef sock_is_eof
@@ -99,8 +92,7 @@ static inline bool sock_is_eof(const struct spair *spair)
  */
 static inline size_t spair_write_avail(struct spair *spair)
 {
-	struct spair *const remote = z_get_fd_obj(spair->remote,
-		(const struct fd_op_vtable *)&spair_fd_op_vtable, 0);
+	struct spair *const remote = spair->remote;
 
 	if (remote == NULL) {
 		return 0;
@@ -120,16 +112,6 @@ static inline size_t spair_read_avail(struct spair *spair)
 	return k_pipe_read_avail(&spair->recv_q);
 }
 
-/** Swap two 32-bit integers */
-static inline void swap32(uint32_t *a, uint32_t *b)
-{
-	uint32_t c;
-
-	c = *b;
-	*b = *a;
-	*a = c;
-}
-
 /**
  * Delete @param spair
  *
@@ -151,8 +133,8 @@ static inline void swap32(uint32_t *a, uint32_t *b)
  *    @ref spair.read_signal.
  *
  * If the remote endpoint is already closed, the former operation does not
- * take place. Otherwise, the @ref spair.remote of the local endpoint is
- * set to -1.
+ * take place. Otherwise, the @ref spair.remote of the remote endpoint is
+ * set to NULL.
  *
  * If no threads are blocking on A, then the signals have no effect.
  *
@@ -168,25 +150,21 @@ static void spair_delete(struct spair *spair)
 		return;
 	}
 
-	if (spair->remote != -1) {
-		remote = z_get_fd_obj(spair->remote,
-			(const struct fd_op_vtable *)&spair_fd_op_vtable, 0);
+	remote = spair->remote;
 
-		if (remote != NULL) {
-			res = k_sem_take(&remote->sem, K_FOREVER);
-			if (res == 0) {
-				have_remote_sem = true;
-				remote->remote = -1;
-				res = k_poll_signal_raise(&remote->write_signal,
-					SPAIR_SIG_CANCEL);
-				__ASSERT(res == 0,
-					"k_poll_signal_raise() failed: %d",
-					res);
-			}
+	if (remote != NULL) {
+		res = k_sem_take(&remote->sem, K_FOREVER);
+		if (res == 0) {
+			have_remote_sem = true;
+			remote->remote = NULL;
+			res = k_poll_signal_raise(&remote->write_signal,
+				SPAIR_SIG_CANCEL);
+			__ASSERT(res == 0, "k_poll_signal_raise() failed: %d",
+				res);
 		}
 	}
 
-	spair->remote = -1;
+	spair->remote = NULL;
 
 	res = k_poll_signal_raise(&spair->read_signal, SPAIR_SIG_CANCEL);
 	__ASSERT(res == 0, "k_poll_signal_raise() failed: %d", res);
@@ -207,13 +185,13 @@ static void spair_delete(struct spair *spair)
 /**
  * Create a @ref spair (1/2 of a socketpair)
  *
- * The idea is to call this twice, but store the "local" side in the
- * @ref spair.remote field initially.
+ * The idea is to call this twice, and if both allocations are successful,
+ * point the @ref spair.remote fields of the two @ref spair instances at
+ * each other.
  *
- * If both allocations are successful, then swap the @ref spair.remote
- * fields in the two @ref spair instances.
+ * @param fd the file descriptor of the new @ref spair
  */
-static struct spair *spair_new(void)
+static struct spair *spair_new(int *fd)
 {
 	struct spair *spair;
 
@@ -236,7 +214,6 @@ static struct spair *spair_new(void)
 	memset(spair, 0, sizeof(*spair));
 
 	/* initialize any non-zero default values */
-	spair->remote = -1;
 	spair->flags = SPAIR_FLAGS_DEFAULT;
 
 	k_sem_init(&spair->sem, 1, 1);
@@ -244,13 +221,13 @@ static struct spair *spair_new(void)
 	k_poll_signal_init(&spair->write_signal);
 	k_poll_signal_init(&spair->read_signal);
 
-	spair->remote = z_reserve_fd();
-	if (spair->remote == -1) {
+	*fd = z_reserve_fd();
+	if (*fd == -1) {
 		errno = ENFILE;
 		goto cleanup;
 	}
 
-	z_finalize_fd(spair->remote, spair,
+	z_finalize_fd(*fd, spair,
 		      (const struct fd_op_vtable *)&spair_fd_op_vtable);
 
 	goto out;
@@ -268,6 +245,7 @@ int z_impl_zsock_socketpair(int family, int type, int proto, int *sv)
 	int res;
 	size_t i;
 	struct spair *obj[2] = {};
+	int fd[2] = {-1, -1};
 
 	if (family != AF_UNIX) {
 		errno = EAFNOSUPPORT;
@@ -295,7 +273,7 @@ int z_impl_zsock_socketpair(int family, int type, int proto, int *sv)
 	}
 
 	for (i = 0; i < 2; ++i) {
-		obj[i] = spair_new();
+		obj[i] = spair_new(&fd[i]);
 		if (!obj[i]) {
 			res = -1;
 			goto cleanup;
@@ -303,10 +281,11 @@ int z_impl_zsock_socketpair(int family, int type, int proto, int *sv)
 	}
 
 	/* connect the two endpoints */
-	swap32(&obj[0]->remote, &obj[1]->remote);
+	obj[0]->remote = obj[1];
+	obj[1]->remote = obj[0];
 
 	for (i = 0; i < 2; ++i) {
-		sv[i] = obj[i]->remote;
+		sv[i] = fd[i];
 		k_sem_give(&obj[0]->sem);
 	}
 
@@ -314,6 +293,9 @@ int z_impl_zsock_socketpair(int family, int type, int proto, int *sv)
 
 cleanup:
 	for (i = 0; i < 2; ++i) {
+		if (fd[i] != -1) {
+			z_free_fd(fd[i]);
+		}
 		spair_delete(obj[i]);
 	}
 
@@ -420,8 +402,7 @@ static ssize_t spair_write(void *obj, const void *buffer, size_t count)
 
 	have_local_sem = true;
 
-	remote = z_get_fd_obj(spair->remote,
-		(const struct fd_op_vtable *)&spair_fd_op_vtable, 0);
+	remote = spair->remote;
 
 	if (remote == NULL) {
 		errno = EPIPE;
@@ -479,9 +460,7 @@ static ssize_t spair_write(void *obj, const void *buffer, size_t count)
 				goto out;
 			}
 
-			remote = z_get_fd_obj(spair->remote,
-				(const struct fd_op_vtable *)
-				&spair_fd_op_vtable, 0);
+			remote = spair->remote;
 
 			if (remote == NULL) {
 				errno = EPIPE;
@@ -756,9 +735,7 @@ static int zsock_poll_prepare_ctx(struct spair *const spair,
 			goto out;
 		}
 
-		remote = z_get_fd_obj(spair->remote,
-			(const struct fd_op_vtable *)
-			&spair_fd_op_vtable, 0);
+		remote = spair->remote;
 
 		__ASSERT(remote != NULL, "remote is NULL");
 
@@ -807,8 +784,7 @@ static int zsock_poll_update_ctx(struct spair *const spair,
 			goto pollout_done;
 		}
 
-		remote = z_get_fd_obj(spair->remote,
-			(const struct fd_op_vtable *) &spair_fd_op_vtable, 0);
+		remote = spair->remote;
 
 		__ASSERT(remote != NULL, "remote is NULL");
 
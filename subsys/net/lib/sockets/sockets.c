@@ -30,27 +30,32 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #define SET_ERRNO(x) \
 	{ int _err = x; if (_err < 0) { errno = -_err; return -1; } }
 
+/* The socket is referenced during the call, so that its descriptor cannot
+ * be reused by a concurrent close before it returns.
+ */
 #define VTABLE_CALL(fn, sock, ...) \
 	do { \
 		const struct socket_op_vtable *vtable; \
-		void *ctx = get_sock_vtable(sock, &vtable); \
-		if (ctx == NULL || vtable->fn == NULL) { \
+		void *ctx = get_sock_vtable_ref(sock, &vtable); \
+		ssize_t ret; \
+		if (ctx == NULL) { \
 			errno = EBADF; \
 			return -1; \
 		} \
-		return vtable->fn(ctx, __VA_ARGS__); \
+		if (vtable->fn == NULL) { \
+			z_put_fd_ref(sock); \
+			errno = EBADF; \
+			return -1; \
+		} \
+		ret = vtable->fn(ctx, __VA_ARGS__); \
+		z_put_fd_ref(sock); \
+		return ret; \
 	} while (0)
 
 const struct socket_op_vtable sock_fd_op_vtable;
 
-static inline void *get_sock_vtable(
-			int sock, const struct socket_op_vtable **vtable)
+static inline void *check_sock_ctx(int sock, void *ctx)
 {
-	void *ctx;
-
-	ctx = z_get_fd_obj_and_vtable(sock,
-				      (const struct fd_op_vtable **)vtable);
-
 #ifdef CONFIG_USERSPACE
 	if (ctx != NULL && z_is_in_user_syscall()) {
 		struct z_object *zo;
@@ -78,6 +83,35 @@ static inline void *get_sock_vtable(
 	return ctx;
 }
 
+static inline void *get_sock_vtable(
+			int sock, const struct socket_op_vtable **vtable)
+{
+	void *ctx;
+
+	ctx = z_get_fd_obj_and_vtable(sock,
+				      (const struct fd_op_vtable **)vtable);
+
+	return check_sock_ctx(sock, ctx);
+}
+
+static inline void *get_sock_vtable_ref(
+			int sock, const struct socket_op_vtable **vtable)
+{
+	void *ctx;
+
+	if (z_get_fd_ref(sock, &ctx,
+			 (const struct fd_op_vtable **)vtable) < 0) {
+		return check_sock_ctx(sock, NULL);
+	}
+
+	if (check_sock_ctx(sock, ctx) == NULL) {
+		z_put_fd_ref(sock);
+		return NULL;
+	}
+
+	return ctx;
+}
+
 void *z_impl_zsock_get_context_object(int sock)
 {
 	const struct socket_op_vtable *ignored;
@@ -246,8 +280,7 @@ int zsock_close_ctx(struct net_context *ctx)
 int z_impl_zsock_close(int sock)
 {
 	const struct socket_op_vtable *vtable;
-	void *ctx = get_sock_vtable(sock, &vtable);
-	int ret;
+	void *ctx = get_sock_vtable_ref(sock, &vtable);
 
 	if (ctx == NULL) {
 		errno = EBADF;
@@ -256,11 +289,10 @@ int z_impl_zsock_close(int sock)
 
 	NET_DBG("close: ctx=%p, fd=%d", ctx, sock);
 
-	ret = vtable->fd_vtable.close(ctx);
-
-	z_free_fd(sock);
-
-	return ret;
+	/* Calls blocked on the socket in other threads are woken up by the
+	 * close, its descriptor is reused once the last of them returns.
+	 */
+	return z_close_fd(sock);
 }
 
 #ifdef CONFIG_USERSPACE
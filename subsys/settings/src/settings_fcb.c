@@ -9,6 +9,7 @@
 #include <stdbool.h>
 #include <fs/fcb.h>
 #include <string.h>
+#include <init.h>
 
 #include "settings/settings.h"
 #include "settings/settings_fcb.h"
@@ -32,6 +33,10 @@ static const struct settings_store_itf settings_fcb_itf = {
 	.csi_save = settings_fcb_save,
 };
 
+#if defined(CONFIG_SETTINGS_FCB_BACKGROUND_COMPRESS)
+static struct settings_fcb *settings_fcb_compress_dst;
+#endif
+
 int settings_fcb_src(struct settings_fcb *cf)
 {
 	int rc;
@@ -72,6 +77,12 @@ int settings_fcb_src(struct settings_fcb *cf)
 
 int settings_fcb_dst(struct settings_fcb *cf)
 {
+#if defined(CONFIG_SETTINGS_FCB_BACKGROUND_COMPRESS)
+	/* the work item only compresses the destination, see
+	 * settings_fcb_compress_work()
+	 */
+	settings_fcb_compress_dst = cf;
+#endif
 	cf->cf_store.cs_itf = &settings_fcb_itf;
 	settings_dst_register(&cf->cf_store);
 
@@ -282,6 +293,70 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 	}
 }
 
+#if defined(CONFIG_SETTINGS_FCB_BACKGROUND_COMPRESS)
+extern struct k_mutex settings_lock;
+
+K_KERNEL_STACK_DEFINE(settings_fcb_compress_stack,
+		      CONFIG_SETTINGS_FCB_BACKGROUND_COMPRESS_STACK_SIZE);
+
+static struct k_work_q settings_fcb_compress_work_q;
+
+/*
+ * Compression is due when only the scratch sectors are left free and the
+ * active sector is about to overflow, the next save would have to compress
+ * synchronously otherwise.
+ */
+static bool settings_fcb_compress_needed(struct settings_fcb *cf)
+{
+	struct fcb_entry *active = &cf->cf_fcb.f_active;
+
+	if (fcb_free_sector_cnt(&cf->cf_fcb) > cf->cf_fcb.f_scratch_cnt) {
+		return false;
+	}
+
+	return (active->fe_sector->fs_size - active->fe_elem_off) <
+	       CONFIG_SETTINGS_FCB_BACKGROUND_COMPRESS_THRESHOLD;
+}
+
+/*
+ * The work item is defined statically, so it is never reinitialized while
+ * it is queued or running, and it acts on the destination registered last.
+ * settings_lock serializes it with saves to that destination.
+ */
+static void settings_fcb_compress_work(struct k_work *work)
+{
+	struct settings_fcb *cf;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	cf = settings_fcb_compress_dst;
+	if (cf && settings_fcb_compress_needed(cf)) {
+		LOG_DBG("Background compression");
+		settings_fcb_compress(cf);
+	}
+	k_mutex_unlock(&settings_lock);
+}
+
+static K_WORK_DEFINE(settings_fcb_compress_work_item,
+		     settings_fcb_compress_work);
+
+static int settings_fcb_compress_work_q_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_q_start(&settings_fcb_compress_work_q,
+		       settings_fcb_compress_stack,
+		       K_KERNEL_STACK_SIZEOF(settings_fcb_compress_stack),
+		       CONFIG_SETTINGS_FCB_BACKGROUND_COMPRESS_PRIORITY);
+	k_thread_name_set(&settings_fcb_compress_work_q.thread,
+			  "settings_fcb");
+
+	return 0;
+}
+
+SYS_INIT(settings_fcb_compress_work_q_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_SETTINGS_FCB_BACKGROUND_COMPRESS */
+
 static size_t get_len_cb(void *ctx)
 {
 	struct fcb_entry_ctx *entry_ctx = ctx;
@@ -341,6 +416,13 @@ static int settings_fcb_save_priv(struct settings_store *cs, const char *name,
 			rc = i;
 		}
 	}
+
+#if defined(CONFIG_SETTINGS_FCB_BACKGROUND_COMPRESS)
+	if (!rc && settings_fcb_compress_needed(cf)) {
+		k_work_submit_to_queue(&settings_fcb_compress_work_q,
+				       &settings_fcb_compress_work_item);
+	}
+#endif
 	return rc;
 }
 
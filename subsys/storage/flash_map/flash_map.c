@@ -198,6 +198,20 @@ int flash_area_read(const struct flash_area *fa, off_t off, void *dst,
 	return flash_read(dev, fa->fa_off + off, dst, len);
 }
 
+int flash_area_mmap(const struct flash_area *fa, off_t off, size_t len,
+		    const void **ptr)
+{
+	const struct device *dev;
+
+	if (!is_in_flash_area_bounds(fa, off, len)) {
+		return -EINVAL;
+	}
+
+	dev = device_get_binding(fa->fa_dev_name);
+
+	return flash_mmap(dev, fa->fa_off + off, len, ptr);
+}
+
 int flash_area_write(const struct flash_area *fa, off_t off, const void *src,
 		     size_t len)
 {
@@ -286,6 +300,7 @@ int flash_area_check_int_sha256(const struct flash_area *fa,
 	unsigned char hash[TC_SHA256_DIGEST_SIZE];
 	struct tc_sha256_state_struct sha;
 	const struct device *dev;
+	const uint8_t *mapped;
 	int to_read;
 	int pos;
 	int rc;
@@ -304,24 +319,34 @@ int flash_area_check_int_sha256(const struct flash_area *fa,
 	}
 
 	dev = device_get_binding(fa->fa_dev_name);
-	to_read = fac->rblen;
-
-	for (pos = 0; pos < fac->clen; pos += to_read) {
-		if (pos + to_read > fac->clen) {
-			to_read = fac->clen - pos;
-		}
-
-		rc = flash_read(dev, (fa->fa_off + fac->off + pos),
-				fac->rbuf, to_read);
-		if (rc != 0) {
-			return rc;
-		}
 
-		if (tc_sha256_update(&sha,
-				     fac->rbuf,
-				     to_read) != TC_CRYPTO_SUCCESS) {
+	/* Hash memory mapped flash in place */
+	if (flash_mmap(dev, fa->fa_off + fac->off, fac->clen,
+		       (const void **)&mapped) == 0) {
+		if (tc_sha256_update(&sha, mapped,
+				     fac->clen) != TC_CRYPTO_SUCCESS) {
 			return -ESRCH;
 		}
+	} else {
+		to_read = fac->rblen;
+
+		for (pos = 0; pos < fac->clen; pos += to_read) {
+			if (pos + to_read > fac->clen) {
+				to_read = fac->clen - pos;
+			}
+
+			rc = flash_read(dev, (fa->fa_off + fac->off + pos),
+					fac->rbuf, to_read);
+			if (rc != 0) {
+				return rc;
+			}
+
+			if (tc_sha256_update(&sha,
+					     fac->rbuf,
+					     to_read) != TC_CRYPTO_SUCCESS) {
+				return -ESRCH;
+			}
+		}
 	}
 
 	if (tc_sha256_final(hash, &sha) != TC_CRYPTO_SUCCESS) {
@@ -5,9 +5,11 @@
  */
 
 #include <string.h>
+#include <sys/cbprintf.h>
 #include <tracing_buffer.h>
 #include <tracing_format_common.h>
 
+#if !defined(CONFIG_NEWLIB_LIBC) && !defined(CONFIG_ARCH_POSIX)
 static int str_put(int c, void *ctx)
 {
 	tracing_ctx_t *str_ctx = (tracing_ctx_t *)ctx;
@@ -27,6 +29,28 @@ static int str_put(int c, void *ctx)
 
 	return 0;
 }
+#else
+static int str_put_span(const char *str, size_t len, void *ctx)
+{
+	tracing_ctx_t *str_ctx = (tracing_ctx_t *)ctx;
+	uint32_t claimed_size;
+	uint8_t *buf;
+
+	while (len > 0 && str_ctx->status == 0) {
+		claimed_size = tracing_buffer_put_claim(&buf, len);
+		if (claimed_size) {
+			memcpy(buf, str, claimed_size);
+			str_ctx->length += claimed_size;
+			str += claimed_size;
+			len -= claimed_size;
+		} else {
+			str_ctx->status = -1;
+		}
+	}
+
+	return 0;
+}
+#endif
 
 bool tracing_format_string_put(const char *str, va_list args)
 {
@@ -35,7 +59,7 @@ bool tracing_format_string_put(const char *str, va_list args)
 #if !defined(CONFIG_NEWLIB_LIBC) && !defined(CONFIG_ARCH_POSIX)
 	(void)z_prf(str_put, (void *)&str_ctx, (char *)str, args);
 #else
-	z_vprintk(str_put, (void *)&str_ctx, str, args);
+	(void)cbvprintf(str_put_span, (void *)&str_ctx, str, args);
 #endif
 
 	if (str_ctx.status == 0) {
@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <bluetooth/crypto.h>
+
+#define ITERATIONS 1000
+#define MSG_MAX 376
+
+struct msg_type {
+	const char *layer;
+	size_t len;
+	size_t mic_size;
+};
+
+static const struct msg_type msg_types[] = {
+	{ "network", 18, 4 },
+	{ "network", 10, 8 },
+	{ "transport", 11, 4 },
+	{ "transport", 96, 4 },
+	{ "transport", MSG_MAX, 4 },
+};
+
+static const uint8_t key[16] = {
+	0x7d, 0xd7, 0x36, 0x4c, 0xd8, 0x42, 0xad, 0x18,
+	0xc1, 0x7c, 0x2b, 0x82, 0x0c, 0x84, 0xc3, 0xd6,
+};
+
+static uint8_t nonce[13] = {
+	0x00, 0x80, 0x00, 0x00, 0x01, 0x12, 0x34, 0x00,
+	0x00, 0x12, 0x34, 0x56, 0x78,
+};
+
+static uint8_t msg[MSG_MAX];
+static uint8_t enc[MSG_MAX + 8];
+static uint8_t dec[MSG_MAX];
+
+static uint32_t elapsed_us(uint32_t start)
+{
+	return (uint32_t)k_cyc_to_us_floor64(k_cycle_get_32() - start);
+}
+
+static void bench(const struct msg_type *type)
+{
+	uint32_t enc_us;
+	uint32_t dec_us;
+	uint32_t start;
+	int err = 0;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < ITERATIONS && !err; i++) {
+		err = bt_ccm_encrypt(key, nonce, msg, type->len, NULL, 0,
+				     enc, type->mic_size);
+	}
+	enc_us = elapsed_us(start);
+
+	if (err) {
+		printk("%s: encrypt failed: %d\n", type->layer, err);
+		return;
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < ITERATIONS && !err; i++) {
+		err = bt_ccm_decrypt(key, nonce, enc, type->len, NULL, 0,
+				     dec, type->mic_size);
+	}
+	dec_us = elapsed_us(start);
+
+	if (err || memcmp(dec, msg, type->len)) {
+		printk("%s: decrypt failed: %d\n", type->layer, err);
+		return;
+	}
+
+	printk("%s: %zu B: %u.%03u us/encrypt, %u.%03u us/decrypt\n",
+	       type->layer, type->len,
+	       enc_us / ITERATIONS, enc_us % ITERATIONS,
+	       dec_us / ITERATIONS, dec_us % ITERATIONS);
+}
+
+void main(void)
+{
+	for (size_t i = 0; i < sizeof(msg); i++) {
+		msg[i] = i;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(msg_types); i++) {
+		bench(&msg_types[i]);
+	}
+
+	printk("fin\n");
+}
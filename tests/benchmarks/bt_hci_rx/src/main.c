@@ -0,0 +1,207 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <sys/byteorder.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/hci.h>
+#include <bluetooth/buf.h>
+#include <drivers/bluetooth/hci_driver.h>
+
+#define REPORTS 20000
+#define ADV_DATA_LEN 31
+
+static K_SEM_DEFINE(done_sem, 0, 1);
+static K_THREAD_STACK_DEFINE(rx_stack, 1024);
+static struct k_thread rx_thread;
+static uint32_t reports;
+
+static void *cmd_complete(struct net_buf **buf, uint8_t plen, uint16_t opcode)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+	struct bt_hci_evt_hdr *hdr;
+
+	*buf = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+
+	hdr = net_buf_add(*buf, sizeof(*hdr));
+	hdr->evt = BT_HCI_EVT_CMD_COMPLETE;
+	hdr->len = sizeof(*cc) + plen;
+
+	cc = net_buf_add(*buf, sizeof(*cc));
+	cc->ncmd = 1U;
+	cc->opcode = sys_cpu_to_le16(opcode);
+
+	return memset(net_buf_add(*buf, plen), 0, plen);
+}
+
+static int driver_open(void)
+{
+	return 0;
+}
+
+/* Answer every command with success, and claim support for everything */
+static int driver_send(struct net_buf *buf)
+{
+	struct bt_hci_cmd_hdr *chdr;
+	struct net_buf *evt;
+	uint16_t opcode;
+	uint8_t *rp;
+
+	chdr = net_buf_pull_mem(buf, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	switch (opcode) {
+	case BT_HCI_OP_READ_SUPPORTED_COMMANDS:
+		rp = cmd_complete(&evt,
+				  sizeof(struct
+					 bt_hci_rp_read_supported_commands),
+				  opcode);
+		memset(rp + 1, 0xff, sizeof(struct
+					    bt_hci_rp_read_supported_commands) -
+		       1);
+		break;
+	case BT_HCI_OP_READ_LOCAL_FEATURES:
+		rp = cmd_complete(&evt,
+				  sizeof(struct bt_hci_rp_read_local_features),
+				  opcode);
+		memset(rp + 1, 0xff,
+		       sizeof(struct bt_hci_rp_read_local_features) - 1);
+		break;
+	case BT_HCI_OP_LE_READ_LOCAL_FEATURES:
+		/* No optional LE features, legacy scanning only */
+		cmd_complete(&evt,
+			     sizeof(struct bt_hci_rp_le_read_local_features),
+			     opcode);
+		break;
+	case BT_HCI_OP_READ_LOCAL_VERSION_INFO:
+		cmd_complete(&evt,
+			     sizeof(struct bt_hci_rp_read_local_version_info),
+			     opcode);
+		break;
+	case BT_HCI_OP_READ_BD_ADDR:
+		rp = cmd_complete(&evt, sizeof(struct bt_hci_rp_read_bd_addr),
+				  opcode);
+		memset(rp + 1, 0x12, sizeof(bt_addr_t));
+		break;
+	case BT_HCI_OP_LE_READ_SUPP_STATES:
+		rp = cmd_complete(&evt,
+				  sizeof(struct bt_hci_rp_le_read_supp_states),
+				  opcode);
+		memset(rp + 1, 0xff, sizeof(uint64_t));
+		break;
+	case BT_HCI_OP_LE_RAND:
+		cmd_complete(&evt, sizeof(struct bt_hci_rp_le_rand), opcode);
+		break;
+	default:
+		cmd_complete(&evt, sizeof(struct bt_hci_evt_cc_status),
+			     opcode);
+		break;
+	}
+
+	net_buf_unref(buf);
+	bt_recv(evt);
+
+	return 0;
+}
+
+static const struct bt_hci_driver drv = {
+	.name = "bench",
+	.bus = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open = driver_open,
+	.send = driver_send,
+	.quirks = BT_QUIRK_NO_RESET,
+};
+
+static struct net_buf *adv_report(uint32_t i)
+{
+	struct bt_hci_evt_le_advertising_report *rep;
+	struct bt_hci_evt_le_advertising_info *info;
+	struct bt_hci_evt_le_meta_event *meta;
+	struct bt_hci_evt_hdr *hdr;
+	struct net_buf *buf;
+	uint8_t *data;
+
+	buf = bt_buf_get_rx(BT_BUF_EVT, K_FOREVER);
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->evt = BT_HCI_EVT_LE_META_EVENT;
+	hdr->len = sizeof(*meta) + sizeof(*rep) + sizeof(*info) +
+		   ADV_DATA_LEN + 1;
+
+	meta = net_buf_add(buf, sizeof(*meta));
+	meta->subevent = BT_HCI_EVT_LE_ADVERTISING_REPORT;
+
+	rep = net_buf_add(buf, sizeof(*rep));
+	rep->num_reports = 1U;
+
+	info = net_buf_add(buf, sizeof(*info));
+	info->evt_type = BT_HCI_ADV_NONCONN_IND;
+	info->addr.type = BT_ADDR_LE_RANDOM;
+	memset(info->addr.a.val, 0, sizeof(info->addr.a.val));
+	sys_put_le32(i, info->addr.a.val);
+	info->length = ADV_DATA_LEN;
+
+	data = net_buf_add(buf, ADV_DATA_LEN + 1);
+	memset(data, i, ADV_DATA_LEN);
+	/* RSSI */
+	data[ADV_DATA_LEN] = -40;
+
+	return buf;
+}
+
+/* Feeds reports like an HCI driver RX thread would */
+static void rx(void *p1, void *p2, void *p3)
+{
+	for (uint32_t i = 0U; i < REPORTS; i++) {
+		bt_recv(adv_report(i));
+	}
+}
+
+static void scan_cb(const bt_addr_le_t *addr, int8_t rssi, uint8_t adv_type,
+		    struct net_buf_simple *ad)
+{
+	if (++reports == REPORTS) {
+		k_sem_give(&done_sem);
+	}
+}
+
+void main(void)
+{
+	struct bt_le_scan_param param = {
+		.type = BT_LE_SCAN_TYPE_PASSIVE,
+		.options = BT_LE_SCAN_OPT_NONE,
+		.interval = BT_GAP_SCAN_FAST_INTERVAL,
+		.window = BT_GAP_SCAN_FAST_WINDOW,
+	};
+	uint32_t cycles;
+	uint64_t us;
+	int err;
+
+	bt_hci_driver_register(&drv);
+
+	err = bt_enable(NULL);
+	if (!err) {
+		err = bt_le_scan_start(&param, scan_cb);
+	}
+	if (err) {
+		printk("Bluetooth setup failed: %d\n", err);
+		return;
+	}
+
+	cycles = k_cycle_get_32();
+	k_thread_create(&rx_thread, rx_stack, K_THREAD_STACK_SIZEOF(rx_stack),
+			rx, NULL, NULL, NULL,
+			K_PRIO_COOP(CONFIG_BT_DRIVER_RX_HIGH_PRIO), 0,
+			K_NO_WAIT);
+	k_sem_take(&done_sem, K_FOREVER);
+	cycles = k_cycle_get_32() - cycles;
+
+	us = k_cyc_to_us_floor64(cycles);
+	printk("%u reports in %u us, %u ns/report\n", reports, (uint32_t)us,
+	       (uint32_t)(us * 1000U / reports));
+
+	printk("fin\n");
+}
@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/cbprintf.h>
+
+#define RUNS 1000
+
+typedef int (*out_func_t)(int c, void *ctx);
+
+extern int z_prf(int (*func)(), void *dest, char *format, va_list vargs);
+extern void z_vprintk(out_func_t out, void *ctx, const char *fmt,
+		      va_list ap);
+
+static char buf[128];
+static size_t len;
+static uint8_t packaged[64];
+
+enum formatter {
+	PRF,
+	VPRINTK,
+	CBPRINTF,
+	PACKAGE,
+};
+
+static const char *const names[] = {
+	[PRF] = "z_prf",
+	[VPRINTK] = "z_vprintk",
+	[CBPRINTF] = "cbvprintf",
+	[PACKAGE] = "cbpprintf",
+};
+
+static int char_out(int c, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	buf[len++ % sizeof(buf)] = c;
+
+	return c;
+}
+
+static int span_out(const char *str, size_t n, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	for (size_t i = 0; i < n; i++) {
+		buf[len++ % sizeof(buf)] = str[i];
+	}
+
+	return 0;
+}
+
+static void format(enum formatter formatter, const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+
+	switch (formatter) {
+	case PRF:
+		(void)z_prf(char_out, NULL, (char *)fmt, ap);
+		break;
+	case VPRINTK:
+		z_vprintk(char_out, NULL, fmt, ap);
+		break;
+	case CBPRINTF:
+		(void)cbvprintf(span_out, NULL, fmt, ap);
+		break;
+	case PACKAGE:
+		(void)cbvprintf_package(packaged, sizeof(packaged), fmt, ap);
+		(void)cbpprintf(span_out, NULL, packaged);
+		break;
+	}
+
+	va_end(ap);
+}
+
+static void report(const char *name, enum formatter formatter,
+		   uint32_t cycles)
+{
+	uint64_t us = k_cyc_to_us_floor64(cycles);
+
+	printk("%s %s: %u calls in %u us, %u cycles per call\n", name,
+	       names[formatter], RUNS, (uint32_t)us, cycles / RUNS);
+}
+
+void main(void)
+{
+	uint32_t cycles;
+
+	for (enum formatter f = PRF; f <= PACKAGE; f++) {
+		cycles = k_cycle_get_32();
+		for (int i = 0; i < RUNS; i++) {
+			format(f, "Connection established, waiting for data\n");
+		}
+		report("literal", f, k_cycle_get_32() - cycles);
+
+		cycles = k_cycle_get_32();
+		for (int i = 0; i < RUNS; i++) {
+			format(f, "%d", -i);
+		}
+		report("%d", f, k_cycle_get_32() - cycles);
+
+		cycles = k_cycle_get_32();
+		for (int i = 0; i < RUNS; i++) {
+			format(f, "%08x", i);
+		}
+		report("%08x", f, k_cycle_get_32() - cycles);
+
+		cycles = k_cycle_get_32();
+		for (int i = 0; i < RUNS; i++) {
+			format(f, "%s", "connection established");
+		}
+		report("%s", f, k_cycle_get_32() - cycles);
+
+		cycles = k_cycle_get_32();
+		for (int i = 0; i < RUNS; i++) {
+			format(f, "[%08u] <%s> %s: conn %p len %u\n", i, "inf",
+			       "bt_conn", &cycles, 27U);
+		}
+		report("log line", f, k_cycle_get_32() - cycles);
+	}
+
+	printk("fin\n");
+}
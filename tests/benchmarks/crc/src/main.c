@@ -0,0 +1,61 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/crc.h>
+
+#define BUF_SIZE 4096
+#define RUNS 16
+
+static uint8_t buf[BUF_SIZE];
+
+static void report(const char *name, uint32_t cycles)
+{
+	uint32_t bytes = BUF_SIZE * RUNS;
+	uint64_t us = k_cyc_to_us_floor64(cycles);
+
+	if (us == 0U) {
+		us = 1U;
+	}
+
+	printk("%s: %u bytes in %u us, %u KiB/s\n", name, bytes, (uint32_t)us,
+	       (uint32_t)(bytes * 1000000ULL / us / 1024U));
+}
+
+void main(void)
+{
+	volatile uint32_t crc = 0U;
+	uint32_t cycles;
+
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		buf[i] = i * 7 + (i >> 8);
+	}
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < RUNS; i++) {
+		crc = crc32_ieee_update(crc, buf, sizeof(buf));
+	}
+	report("crc32_ieee", k_cycle_get_32() - cycles);
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < RUNS; i++) {
+		crc = crc16_ccitt(crc, buf, sizeof(buf));
+	}
+	report("crc16_ccitt", k_cycle_get_32() - cycles);
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < RUNS; i++) {
+		crc = crc16_itu_t(crc, buf, sizeof(buf));
+	}
+	report("crc16_itu_t", k_cycle_get_32() - cycles);
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < RUNS; i++) {
+		crc = crc8_ccitt(crc, buf, sizeof(buf));
+	}
+	report("crc8_ccitt", k_cycle_get_32() - cycles);
+
+	printk("fin\n");
+}
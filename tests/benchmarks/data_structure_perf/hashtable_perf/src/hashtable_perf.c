@@ -0,0 +1,212 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/hashtable.h>
+#include <sys/sys_heap.h>
+#include <sys/dlist.h>
+#include <sys/rb.h>
+
+/*
+ * Lookup of N keys in each of the data structures which can hold them,
+ * to show where a linear scan or a tree walk should be replaced.
+ */
+
+#define NODES 512
+#define LOOKUPS (4 * NODES)
+
+struct item {
+	struct sys_hashnode hnode;
+	struct rbnode rbnode;
+	sys_dnode_t dnode;
+	uint32_t key;
+};
+
+static struct item items[NODES];
+static struct sys_hashtable_slot slots[NODES * 2];
+/* Room for the largest slot array, the previous one and fragmentation */
+static uint8_t heap_mem[NODES * 2 * sizeof(struct sys_hashtable_slot) * 4];
+static struct sys_heap heap;
+
+static bool item_eq(const struct sys_hashnode *node, const void *key)
+{
+	return CONTAINER_OF(node, struct item, hnode)->key ==
+	       *(const uint32_t *)key;
+}
+
+static bool item_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return CONTAINER_OF(a, struct item, rbnode)->key <
+	       CONTAINER_OF(b, struct item, rbnode)->key;
+}
+
+/* Keys looked up in a different order than inserted, half of them absent */
+static uint32_t lookup_key(int i)
+{
+	return ((i * 7919U) % (2U * NODES)) * 3U;
+}
+
+static void report(const char *name, uint32_t cycles)
+{
+	printk("%s: %u lookups of %u nodes in %u cycles, %u cycles/lookup\n",
+	       name, LOOKUPS, NODES, cycles, cycles / LOOKUPS);
+}
+
+static void lookup_hashtable(const char *name, struct sys_hashtable *ht)
+{
+	uint32_t found = 0U;
+	uint32_t cycles;
+	uint32_t key;
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < LOOKUPS; i++) {
+		key = lookup_key(i);
+		found += sys_hashtable_find(ht, sys_hash32_u32(key),
+					    &key) != NULL;
+	}
+	cycles = k_cycle_get_32() - cycles;
+
+	zassert_equal(found, LOOKUPS / 2, "lookups failed");
+	report(name, cycles);
+}
+
+static void fill_hashtable(struct sys_hashtable *ht)
+{
+	for (int i = 0; i < NODES; i++) {
+		zassert_equal(sys_hashtable_insert(ht, &items[i].hnode,
+						   sys_hash32_u32(items[i].key)),
+			      0, "insert failed");
+	}
+}
+
+static void setup(void)
+{
+	for (int i = 0; i < NODES; i++) {
+		items[i].key = i * 6U;
+	}
+}
+
+/**
+ * @brief Measure lookups in a hash table of fixed capacity
+ *
+ * @see sys_hashtable_find()
+ */
+void test_hashtable_fixed_perf(void)
+{
+	struct sys_hashtable ht;
+	uint32_t cycles;
+
+	setup();
+	sys_hashtable_init(&ht, slots, ARRAY_SIZE(slots), item_eq);
+
+	cycles = k_cycle_get_32();
+	fill_hashtable(&ht);
+	cycles = k_cycle_get_32() - cycles;
+	printk("hashtable: %u inserts in %u cycles\n", NODES, cycles);
+
+	lookup_hashtable("hashtable", &ht);
+}
+
+/**
+ * @brief Measure lookups in a hash table grown from a heap
+ *
+ * @see sys_hashtable_init_heap()
+ */
+void test_hashtable_heap_perf(void)
+{
+	struct sys_hashtable ht;
+	uint32_t cycles;
+
+	setup();
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_hashtable_init_heap(&ht, &heap, item_eq);
+
+	cycles = k_cycle_get_32();
+	fill_hashtable(&ht);
+	cycles = k_cycle_get_32() - cycles;
+	printk("hashtable heap: %u inserts in %u cycles\n", NODES, cycles);
+
+	lookup_hashtable("hashtable heap", &ht);
+	sys_hashtable_free(&ht);
+}
+
+/**
+ * @brief Measure lookups in a red/black tree, for comparison
+ *
+ * @see rb_contains()
+ */
+void test_rbtree_lookup_perf(void)
+{
+	struct rbtree tree = { .lessthan_fn = item_lessthan };
+	struct item probe;
+	uint32_t found = 0U;
+	uint32_t cycles;
+
+	setup();
+	for (int i = 0; i < NODES; i++) {
+		rb_insert(&tree, &items[i].rbnode);
+	}
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < LOOKUPS; i++) {
+		struct rbnode *n = tree.root;
+
+		probe.key = lookup_key(i);
+		while (n != NULL &&
+		       CONTAINER_OF(n, struct item, rbnode)->key != probe.key) {
+			n = z_rb_child(n, item_lessthan(n, &probe.rbnode));
+		}
+		found += n != NULL;
+	}
+	cycles = k_cycle_get_32() - cycles;
+
+	zassert_equal(found, LOOKUPS / 2, "lookups failed");
+	report("rbtree", cycles);
+}
+
+/**
+ * @brief Measure lookups by linear scan of a list, for comparison
+ *
+ * @see SYS_DLIST_FOR_EACH_CONTAINER()
+ */
+void test_dlist_lookup_perf(void)
+{
+	sys_dlist_t list;
+	struct item *item;
+	uint32_t found = 0U;
+	uint32_t cycles;
+
+	setup();
+	sys_dlist_init(&list);
+	for (int i = 0; i < NODES; i++) {
+		sys_dlist_append(&list, &items[i].dnode);
+	}
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < LOOKUPS; i++) {
+		uint32_t key = lookup_key(i);
+
+		SYS_DLIST_FOR_EACH_CONTAINER(&list, item, dnode) {
+			if (item->key == key) {
+				found++;
+				break;
+			}
+		}
+	}
+	cycles = k_cycle_get_32() - cycles;
+
+	zassert_equal(found, LOOKUPS / 2, "lookups failed");
+	report("dlist", cycles);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_hashtable_perf,
+			 ztest_unit_test(test_hashtable_fixed_perf),
+			 ztest_unit_test(test_hashtable_heap_perf),
+			 ztest_unit_test(test_rbtree_lookup_perf),
+			 ztest_unit_test(test_dlist_lookup_perf)
+			 );
+	ztest_run_test_suite(test_hashtable_perf);
+}
@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <fs/fs.h>
+#include <storage/flash_map.h>
+
+#if defined(CONFIG_FILE_SYSTEM_LOGFS)
+#include <fs/logfs.h>
+#endif
+#if defined(CONFIG_FILE_SYSTEM_LITTLEFS)
+#include <fs/littlefs.h>
+#endif
+#if defined(CONFIG_FAT_FILESYSTEM_ELM)
+#include <ff.h>
+#endif
+
+#define TOTAL_SIZE (64 * 1024)
+#define RECORDS_PER_SYNC 16
+
+static const size_t record_sizes[] = { 16, 64, 256 };
+static uint8_t record[256];
+
+#if defined(CONFIG_FILE_SYSTEM_LOGFS)
+static struct fs_logfs logfs_data;
+static struct fs_mount_t logfs_mnt = {
+	.type = FS_LOGFS,
+	.fs_data = &logfs_data,
+	.storage_dev = (void *)FLASH_AREA_ID(image_scratch),
+	.mnt_point = "/log",
+};
+#endif
+
+#if defined(CONFIG_FILE_SYSTEM_LITTLEFS)
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(lfs_data);
+static struct fs_mount_t lfs_mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &lfs_data,
+	.storage_dev = (void *)FLASH_AREA_ID(image_scratch),
+	.mnt_point = "/lfs",
+};
+#endif
+
+#if defined(CONFIG_FAT_FILESYSTEM_ELM)
+static FATFS fat_data;
+static struct fs_mount_t fat_mnt = {
+	.type = FS_FATFS,
+	.fs_data = &fat_data,
+	.mnt_point = "/NAND:",
+};
+#endif
+
+static int erase_scratch(void)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(image_scratch), &fa);
+	if (rc == 0) {
+		rc = flash_area_erase(fa, 0, fa->fa_size);
+		flash_area_close(fa);
+	}
+
+	return rc;
+}
+
+static int write_records(const char *path, size_t record_size)
+{
+	struct fs_file_t file = { 0 };
+	size_t count = TOTAL_SIZE / record_size;
+	int rc;
+
+	rc = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE);
+	if (rc < 0) {
+		return rc;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		rc = fs_write(&file, record, record_size);
+		if (rc != record_size) {
+			rc = (rc < 0) ? rc : -ENOSPC;
+			break;
+		}
+
+		if (((i + 1) % RECORDS_PER_SYNC) == 0) {
+			rc = fs_sync(&file);
+			if (rc < 0) {
+				break;
+			}
+		}
+		rc = 0;
+	}
+
+	(void)fs_close(&file);
+
+	return rc;
+}
+
+static void bench(const char *name, struct fs_mount_t *mp)
+{
+	char path[32];
+
+	for (size_t i = 0; i < ARRAY_SIZE(record_sizes); i++) {
+		uint32_t t0;
+		uint32_t t1;
+		int rc;
+
+		rc = erase_scratch();
+		if (rc == 0) {
+			rc = fs_mount(mp);
+		}
+		if (rc < 0) {
+			printk("%s: setup failed: %d\n", name, rc);
+			return;
+		}
+
+		snprintk(path, sizeof(path), "%s/data", mp->mnt_point);
+
+		t0 = k_uptime_get_32();
+		rc = write_records(path, record_sizes[i]);
+		t1 = k_uptime_get_32();
+
+		(void)fs_unmount(mp);
+
+		if (rc < 0) {
+			printk("%s: write failed: %d\n", name, rc);
+			return;
+		}
+
+		if (t1 == t0) {
+			t1++;
+		}
+
+		printk("%s: %zu B records: %u bytes in %u ms, %u KiB/s\n",
+		       name, record_sizes[i], TOTAL_SIZE, t1 - t0,
+		       TOTAL_SIZE * 1000U / (t1 - t0) / 1024U);
+	}
+}
+
+void main(void)
+{
+	for (size_t i = 0; i < sizeof(record); i++) {
+		record[i] = i;
+	}
+
+#if defined(CONFIG_FILE_SYSTEM_LOGFS)
+	bench("logfs", &logfs_mnt);
+#endif
+#if defined(CONFIG_FILE_SYSTEM_LITTLEFS)
+	bench("littlefs", &lfs_mnt);
+#endif
+#if defined(CONFIG_FAT_FILESYSTEM_ELM)
+	bench("fatfs", &fat_mnt);
+#endif
+
+	printk("fin\n");
+}
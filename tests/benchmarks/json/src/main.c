@@ -0,0 +1,136 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <data/json.h>
+
+#define ITEMS 16
+#define CHUNK_SIZE 64
+#define RUNS 64
+
+struct item {
+	const char *name;
+	const char *description;
+	int id;
+};
+
+struct doc {
+	const char *device;
+	struct item items[ITEMS];
+	size_t items_len;
+	int version;
+};
+
+static const struct json_obj_descr item_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct item, name, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct item, description, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct item, id, JSON_TOK_NUMBER),
+};
+
+static const struct json_obj_descr doc_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct doc, device, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct doc, items, ITEMS, items_len,
+				 item_descr, ARRAY_SIZE(item_descr)),
+	JSON_OBJ_DESCR_PRIM(struct doc, version, JSON_TOK_NUMBER),
+};
+
+static char encoded[2560];
+static char copy[sizeof(encoded)];
+static char strings[1536];
+static size_t encoded_len;
+static struct doc doc;
+
+static void build(void)
+{
+	size_t len;
+
+	len = snprintk(encoded, sizeof(encoded),
+		       "{\"device\": \"sensor-node-0123456789abcdef\",\n"
+		       " \"items\": [\n");
+
+	for (int i = 0; i < ITEMS; i++) {
+		len += snprintk(&encoded[len], sizeof(encoded) - len,
+				"  {\"name\": \"channel %02d\", "
+				"\"description\": \"Temperature of the "
+				"enclosure, \\\"degrees\\\" Celsius\", "
+				"\"id\": %d}%s\n",
+				i, 1000 + i, (i < ITEMS - 1) ? "," : "");
+	}
+
+	len += snprintk(&encoded[len], sizeof(encoded) - len,
+			" ],\n \"version\": 3}\n");
+
+	encoded_len = len;
+}
+
+static void report(const char *name, uint32_t cycles)
+{
+	uint32_t bytes = encoded_len * RUNS;
+	uint64_t us = k_cyc_to_us_floor64(cycles);
+
+	if (us == 0U) {
+		us = 1U;
+	}
+
+	printk("%s: %u bytes in %u us, %u KiB/s\n", name, bytes, (uint32_t)us,
+	       (uint32_t)(bytes * 1000000ULL / us / 1024U));
+}
+
+static int parse(void)
+{
+	memcpy(copy, encoded, encoded_len);
+
+	return json_obj_parse(copy, encoded_len, doc_descr,
+			      ARRAY_SIZE(doc_descr), &doc);
+}
+
+static int stream(size_t chunk)
+{
+	struct json_obj_stream stream;
+	int ret = -EAGAIN;
+
+	json_obj_stream_init(&stream, doc_descr, ARRAY_SIZE(doc_descr), &doc,
+			     strings, sizeof(strings));
+
+	for (size_t i = 0; i < encoded_len; i += chunk) {
+		ret = json_obj_stream_feed(&stream, &encoded[i],
+					   MIN(chunk, encoded_len - i));
+	}
+
+	return ret;
+}
+
+void main(void)
+{
+	uint32_t cycles;
+	int ret = 0;
+
+	build();
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < RUNS; i++) {
+		ret |= parse();
+	}
+	report("json_obj_parse", k_cycle_get_32() - cycles);
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < RUNS; i++) {
+		ret |= stream(encoded_len);
+	}
+	report("json_obj_stream", k_cycle_get_32() - cycles);
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < RUNS; i++) {
+		ret |= stream(CHUNK_SIZE);
+	}
+	report("json_obj_stream (64 B chunks)", k_cycle_get_32() - cycles);
+
+	if (ret != BIT_MASK(ARRAY_SIZE(doc_descr)) || doc.items_len != ITEMS) {
+		printk("Decoding failed: %d\n", ret);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+
+#define RUNS 64
+#define BUF_SIZE 1024
+
+static const size_t sizes[] = { 16, 64, 256, BUF_SIZE };
+
+/* Offsets of source and destination from word alignment */
+static const struct {
+	uint8_t src;
+	uint8_t dst;
+} offsets[] = {
+	{ 0, 0 },
+	{ 1, 1 },
+	{ 1, 0 },
+	{ 3, 2 },
+};
+
+static uint8_t __aligned(sizeof(void *)) src_buf[BUF_SIZE + 8];
+static uint8_t __aligned(sizeof(void *)) dst_buf[BUF_SIZE + 8];
+
+/* Called through pointers, so that the compiler can't inline them */
+static void *(*volatile memcpy_fn)(void *, const void *, size_t) = memcpy;
+static void *(*volatile memmove_fn)(void *, const void *, size_t) = memmove;
+static void *(*volatile memset_fn)(void *, int, size_t) = memset;
+static int (*volatile memcmp_fn)(const void *, const void *, size_t) = memcmp;
+static void *(*volatile memchr_fn)(const void *, int, size_t) = memchr;
+static size_t (*volatile strlen_fn)(const char *) = strlen;
+
+enum op {
+	OP_MEMCPY,
+	OP_MEMMOVE,
+	OP_MEMSET,
+	OP_MEMCMP,
+	OP_MEMCHR,
+	OP_STRLEN,
+};
+
+static const char *const op_names[] = {
+	"memcpy", "memmove", "memset", "memcmp", "memchr", "strlen",
+};
+
+static bool run(enum op op, uint8_t *src, uint8_t *dst, size_t size)
+{
+	switch (op) {
+	case OP_MEMCPY:
+		memcpy_fn(dst, src, size);
+		return dst[size - 1] == src[size - 1];
+	case OP_MEMMOVE:
+		/* Overlapping, as when shifting data within a buffer */
+		memmove_fn(dst_buf + 8, dst, size - 8);
+		return true;
+	case OP_MEMSET:
+		memset_fn(dst, 0x55, size);
+		return dst[size - 1] == 0x55;
+	case OP_MEMCMP:
+		return memcmp_fn(src, dst, size) == 0;
+	case OP_MEMCHR:
+		return memchr_fn(src, 0xff, size) == &src[size - 1];
+	case OP_STRLEN:
+		return strlen_fn((const char *)src) == size - 1;
+	default:
+		return false;
+	}
+}
+
+static void bench(enum op op, size_t size, uint8_t src_off, uint8_t dst_off)
+{
+	uint8_t *src = src_buf + src_off;
+	uint8_t *dst = dst_buf + dst_off;
+	uint32_t cycles;
+	bool ok = true;
+
+	for (size_t i = 0; i < size; i++) {
+		src[i] = 1 + (i % 0x7f);
+	}
+	src[size - 1] = (op == OP_STRLEN) ? '\0' : 0xff;
+	memcpy(dst, src, size);
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < RUNS; i++) {
+		ok &= run(op, src, dst, size);
+	}
+	cycles = k_cycle_get_32() - cycles;
+
+	printk("%s %zu %u/%u: %u cycles%s\n", op_names[op], size, src_off,
+	       dst_off, cycles / RUNS, ok ? "" : " (FAILED)");
+}
+
+void main(void)
+{
+	for (enum op op = OP_MEMCPY; op <= OP_STRLEN; op++) {
+		for (size_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+			for (size_t j = 0; j < ARRAY_SIZE(offsets); j++) {
+				bench(op, sizes[i], offsets[j].src,
+				      offsets[j].dst);
+			}
+		}
+	}
+
+	printk("fin\n");
+}
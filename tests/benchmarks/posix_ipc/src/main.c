@@ -0,0 +1,252 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/slist.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <mqueue.h>
+
+#define PAIRS 10000
+#define READERS 2
+#define READ_LOCKS 5000
+#define WRITE_LOCKS 1000
+#define MQUEUES 12
+#define OPENS 1000
+#define STACK_SIZE 1024
+
+/* Read-write lock made of semaphores, as pthread_rwlock_t used to be */
+struct sem_rwlock {
+	struct k_sem rd_sem;
+	struct k_sem wr_sem;
+	struct k_sem reader_active;
+	k_tid_t wr_owner;
+};
+
+#define SEM_READER_LIMIT (CONFIG_MAX_PTHREAD_COUNT + 1)
+
+static void sem_rwlock_init(struct sem_rwlock *l)
+{
+	k_sem_init(&l->rd_sem, SEM_READER_LIMIT, SEM_READER_LIMIT);
+	k_sem_init(&l->wr_sem, 1, 1);
+	k_sem_init(&l->reader_active, 1, 1);
+	l->wr_owner = NULL;
+}
+
+static void sem_rwlock_rdlock(struct sem_rwlock *l)
+{
+	k_sem_take(&l->wr_sem, K_FOREVER);
+	k_sem_take(&l->reader_active, K_NO_WAIT);
+	k_sem_take(&l->rd_sem, K_NO_WAIT);
+	k_sem_give(&l->wr_sem);
+}
+
+static void sem_rwlock_wrlock(struct sem_rwlock *l)
+{
+	k_sem_take(&l->wr_sem, K_FOREVER);
+	k_sem_take(&l->reader_active, K_FOREVER);
+	l->wr_owner = k_current_get();
+}
+
+static void sem_rwlock_unlock(struct sem_rwlock *l)
+{
+	if (k_current_get() == l->wr_owner) {
+		l->wr_owner = NULL;
+		k_sem_give(&l->reader_active);
+		k_sem_give(&l->wr_sem);
+	} else {
+		if (k_sem_count_get(&l->rd_sem) == SEM_READER_LIMIT - 1) {
+			k_sem_give(&l->reader_active);
+		}
+		k_sem_give(&l->rd_sem);
+	}
+}
+
+static pthread_rwlock_t rwlock;
+static struct sem_rwlock sem_lock;
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, READERS + 1, STACK_SIZE);
+static struct k_thread threads[READERS + 1];
+static volatile uint32_t shared[4];
+
+static void bench_uncontended(void)
+{
+	uint32_t rw_rd, rw_wr, sem_rd, sem_wr;
+
+	pthread_rwlock_init(&rwlock, NULL);
+	sem_rwlock_init(&sem_lock);
+
+	rw_rd = k_cycle_get_32();
+	for (int i = 0; i < PAIRS; i++) {
+		pthread_rwlock_rdlock(&rwlock);
+		pthread_rwlock_unlock(&rwlock);
+	}
+	rw_rd = k_cycle_get_32() - rw_rd;
+
+	rw_wr = k_cycle_get_32();
+	for (int i = 0; i < PAIRS; i++) {
+		pthread_rwlock_wrlock(&rwlock);
+		pthread_rwlock_unlock(&rwlock);
+	}
+	rw_wr = k_cycle_get_32() - rw_wr;
+
+	sem_rd = k_cycle_get_32();
+	for (int i = 0; i < PAIRS; i++) {
+		sem_rwlock_rdlock(&sem_lock);
+		sem_rwlock_unlock(&sem_lock);
+	}
+	sem_rd = k_cycle_get_32() - sem_rd;
+
+	sem_wr = k_cycle_get_32();
+	for (int i = 0; i < PAIRS; i++) {
+		sem_rwlock_wrlock(&sem_lock);
+		sem_rwlock_unlock(&sem_lock);
+	}
+	sem_wr = k_cycle_get_32() - sem_wr;
+
+	printk("rdlock: %u cycles/pair, semaphores: %u cycles/pair\n",
+	       rw_rd / PAIRS, sem_rd / PAIRS);
+	printk("wrlock: %u cycles/pair, semaphores: %u cycles/pair\n",
+	       rw_wr / PAIRS, sem_wr / PAIRS);
+}
+
+static void reader_thread(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < READ_LOCKS; i++) {
+		pthread_rwlock_rdlock(&rwlock);
+		if (shared[0] != shared[ARRAY_SIZE(shared) - 1]) {
+			printk("torn read\n");
+		}
+		pthread_rwlock_unlock(&rwlock);
+
+		if ((i % 64) == 63) {
+			k_yield();
+		}
+	}
+}
+
+static void writer_thread(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < WRITE_LOCKS; i++) {
+		pthread_rwlock_wrlock(&rwlock);
+		for (int j = 0; j < ARRAY_SIZE(shared); j++) {
+			shared[j] = i;
+		}
+		pthread_rwlock_unlock(&rwlock);
+
+		if ((i % 16) == 15) {
+			k_yield();
+		}
+	}
+}
+
+static void bench_contended(void)
+{
+	uint32_t cycles;
+	uint64_t us;
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i <= READERS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				i < READERS ? reader_thread : writer_thread,
+				NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0,
+				K_NO_WAIT);
+	}
+	for (int i = 0; i <= READERS; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+	cycles = k_cycle_get_32() - cycles;
+
+	us = k_cyc_to_us_floor64(cycles);
+	printk("contended: %u read and %u write locks by %u threads "
+	       "in %u us\n", READERS * READ_LOCKS, WRITE_LOCKS, READERS + 1,
+	       (uint32_t)us);
+}
+
+struct named {
+	sys_snode_t node;
+	char name[CONFIG_MQUEUE_NAMELEN_MAX];
+};
+
+static struct named names[MQUEUES];
+static sys_slist_t name_list;
+
+static struct named *list_find(const char *name)
+{
+	struct named *n;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&name_list, n, node) {
+		if (strcmp(n->name, name) == 0) {
+			return n;
+		}
+	}
+
+	return NULL;
+}
+
+static void bench_mq_open(void)
+{
+	struct mq_attr attrs = { .mq_maxmsg = 1, .mq_msgsize = 8 };
+	mqd_t mqd[MQUEUES], other;
+	uint32_t open_cycles, list_cycles;
+	const char *last;
+	int created = 0;
+
+	sys_slist_init(&name_list);
+	for (int i = 0; i < MQUEUES; i++) {
+		snprintk(names[i].name, sizeof(names[i].name), "queue%d", i);
+		sys_slist_append(&name_list, &names[i].node);
+
+		mqd[i] = mq_open(names[i].name, O_RDWR | O_CREAT, 0777,
+				 &attrs);
+		if (mqd[i] == (mqd_t)-1) {
+			printk("mq_open failed: %d\n", errno);
+			break;
+		}
+		created++;
+	}
+
+	if (created == 0) {
+		return;
+	}
+
+	/* The queue the furthest away in a list */
+	last = names[created - 1].name;
+
+	open_cycles = k_cycle_get_32();
+	for (int i = 0; i < OPENS; i++) {
+		other = mq_open(last, O_RDWR);
+		mq_close(other);
+	}
+	open_cycles = k_cycle_get_32() - open_cycles;
+
+	list_cycles = k_cycle_get_32();
+	for (int i = 0; i < OPENS; i++) {
+		if (list_find(last) == NULL) {
+			printk("not found\n");
+		}
+	}
+	list_cycles = k_cycle_get_32() - list_cycles;
+
+	printk("mq_open: %u cycles/open+close with %u queues, "
+	       "list walk: %u cycles\n", open_cycles / OPENS, created,
+	       list_cycles / OPENS);
+
+	for (int i = 0; i < created; i++) {
+		mq_close(mqd[i]);
+		mq_unlink(names[i].name);
+	}
+}
+
+void main(void)
+{
+	bench_uncontended();
+	bench_contended();
+	bench_mq_open();
+
+	printk("fin\n");
+}
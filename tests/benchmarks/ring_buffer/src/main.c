@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+
+#define BUF_SIZE 1024
+#define BYTES (256 * 1024)
+#define CHUNK 61
+#define PRODUCERS 2
+#define RECORDS 20000
+#define STACK_SIZE 1024
+
+struct record {
+	uint32_t stamp;
+	uint32_t seq;
+	uint8_t payload[8];
+};
+
+RING_BUF_DECLARE(locked_rb, BUF_SIZE);
+RING_BUF_SPSC_DECLARE(spsc_rb, BUF_SIZE);
+RING_BUF_MPSC_DECLARE(mpsc_rb, BUF_SIZE / sizeof(uint32_t));
+
+static struct k_spinlock lock;
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, PRODUCERS, STACK_SIZE);
+static struct k_thread threads[PRODUCERS];
+
+typedef uint32_t (*xfer_t)(uint8_t *data, uint32_t size);
+
+static uint32_t locked_put(uint8_t *data, uint32_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	size = ring_buf_put(&locked_rb, data, size);
+	k_spin_unlock(&lock, key);
+
+	return size;
+}
+
+static uint32_t locked_get(uint8_t *data, uint32_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	size = ring_buf_get(&locked_rb, data, size);
+	k_spin_unlock(&lock, key);
+
+	return size;
+}
+
+static uint32_t spsc_put(uint8_t *data, uint32_t size)
+{
+	return ring_buf_spsc_put(&spsc_rb, data, size);
+}
+
+static uint32_t spsc_get(uint8_t *data, uint32_t size)
+{
+	return ring_buf_spsc_get(&spsc_rb, data, size);
+}
+
+/* Moves BYTES through the buffer, in chunks that keep it wrapping */
+static void transfer(xfer_t xfer)
+{
+	uint8_t chunk[CHUNK];
+	uint32_t total = 0U;
+	uint32_t len;
+
+	while (total < BYTES) {
+		len = xfer(chunk, MIN(sizeof(chunk), BYTES - total));
+		if (len == 0U) {
+			k_yield();
+		}
+		total += len;
+	}
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	transfer(p1);
+}
+
+static void run_stream(const char *name, xfer_t put, xfer_t get)
+{
+	uint32_t cycles;
+	uint64_t us;
+
+	cycles = k_cycle_get_32();
+	k_thread_create(&threads[0], stacks[0], STACK_SIZE, producer, put,
+			NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	transfer(get);
+	k_thread_join(&threads[0], K_FOREVER);
+	cycles = k_cycle_get_32() - cycles;
+
+	us = MAX(k_cyc_to_us_floor64(cycles), 1U);
+	printk("%s: %u bytes in %u us, %u KiB/s\n", name, BYTES,
+	       (uint32_t)us, (uint32_t)(BYTES * 1000000ULL / us / 1024U));
+}
+
+static void mpsc_producer(void *p1, void *p2, void *p3)
+{
+	struct record *rec;
+	uint32_t seq = 0U;
+
+	while (seq < RECORDS / PRODUCERS) {
+		if (ring_buf_mpsc_put_claim(&mpsc_rb, (void **)&rec,
+					    sizeof(*rec))) {
+			k_yield();
+			continue;
+		}
+
+		rec->seq = seq++;
+		rec->stamp = k_cycle_get_32();
+		ring_buf_mpsc_put_commit(&mpsc_rb, rec);
+	}
+}
+
+static void run_mpsc(void)
+{
+	uint64_t latency = 0U;
+	uint32_t latency_max = 0U;
+	uint32_t received = 0U;
+	struct record *rec;
+	uint32_t cycles;
+	uint64_t us;
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < PRODUCERS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				mpsc_producer, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	}
+
+	while (received < RECORDS) {
+		uint32_t delta;
+
+		if (ring_buf_mpsc_get_claim(&mpsc_rb, (void **)&rec) < 0) {
+			k_yield();
+			continue;
+		}
+
+		delta = k_cycle_get_32() - rec->stamp;
+		latency += delta;
+		latency_max = MAX(latency_max, delta);
+		ring_buf_mpsc_get_finish(&mpsc_rb);
+		received++;
+	}
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+	cycles = k_cycle_get_32() - cycles;
+
+	us = k_cyc_to_us_floor64(cycles);
+	printk("mpsc: %u records in %u us, latency avg %u ns max %u ns\n",
+	       RECORDS, (uint32_t)us,
+	       (uint32_t)k_cyc_to_ns_floor64(latency / RECORDS),
+	       (uint32_t)k_cyc_to_ns_floor64(latency_max));
+}
+
+void main(void)
+{
+	run_stream("locked", locked_put, locked_get);
+	run_stream("spsc", spsc_put, spsc_get);
+	run_mpsc();
+
+	printk("fin\n");
+}
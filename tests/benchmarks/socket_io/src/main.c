@@ -0,0 +1,131 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/fdtable.h>
+#include <net/socket.h>
+
+#define IO_THREADS 3
+#define MESSAGES 2000
+#define MSG_SIZE 16
+#define ALLOCS 10000
+#define FDS_IN_USE (CONFIG_POSIX_MAX_FDS - 4)
+#define STACK_SIZE 2048
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, IO_THREADS + 1, STACK_SIZE);
+static struct k_thread threads[IO_THREADS + 1];
+static volatile bool io_done;
+static uint32_t churned;
+
+static void io_thread(void *p1, void *p2, void *p3)
+{
+	uint8_t msg[MSG_SIZE] = { 0 };
+	int sv[2];
+
+	if (zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+		printk("socketpair failed: %d\n", errno);
+		return;
+	}
+
+	for (int i = 0; i < MESSAGES; i++) {
+		msg[0] = i;
+		if (zsock_send(sv[0], msg, sizeof(msg), 0) != sizeof(msg) ||
+		    zsock_recv(sv[1], msg, sizeof(msg), 0) != sizeof(msg) ||
+		    msg[0] != (uint8_t)i) {
+			printk("I/O failed: %d\n", errno);
+			break;
+		}
+
+		/* Let the other threads in, without time slicing too */
+		if ((i % 64) == 63) {
+			k_yield();
+		}
+	}
+
+	zsock_close(sv[0]);
+	zsock_close(sv[1]);
+}
+
+/* Allocates and frees descriptors next to the I/O threads */
+static void churn_thread(void *p1, void *p2, void *p3)
+{
+	int sv[2];
+
+	while (!io_done) {
+		if (zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0) {
+			zsock_close(sv[0]);
+			zsock_close(sv[1]);
+			churned++;
+		}
+		k_yield();
+	}
+}
+
+static void bench_io(void)
+{
+	uint32_t cycles;
+	uint64_t us;
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i <= IO_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				i < IO_THREADS ? io_thread : churn_thread,
+				NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0,
+				K_NO_WAIT);
+	}
+
+	for (int i = 0; i < IO_THREADS; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+	cycles = k_cycle_get_32() - cycles;
+
+	io_done = true;
+	k_thread_join(&threads[IO_THREADS], K_FOREVER);
+
+	us = k_cyc_to_us_floor64(cycles);
+	printk("io: %u send/recv pairs by %u threads in %u us, "
+	       "%u cycles/pair\n", IO_THREADS * MESSAGES, IO_THREADS,
+	       (uint32_t)us, cycles / (IO_THREADS * MESSAGES));
+	printk("churn: %u socket pairs created and closed\n", churned);
+}
+
+static void bench_alloc(void)
+{
+	int fds[FDS_IN_USE];
+	uint32_t cycles;
+	int used = 0;
+	int fd;
+
+	/* Fill most of the table, so that a free entry is hard to find */
+	while (used < ARRAY_SIZE(fds) && (fd = z_reserve_fd()) >= 0) {
+		fds[used++] = fd;
+	}
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < ALLOCS; i++) {
+		fd = z_reserve_fd();
+		if (fd < 0) {
+			printk("reserve failed: %d\n", errno);
+			break;
+		}
+		z_free_fd(fd);
+	}
+	cycles = k_cycle_get_32() - cycles;
+
+	printk("alloc: %u fd reserve/free with %u in use in %u cycles, "
+	       "%u cycles/op\n", ALLOCS, used, cycles, cycles / ALLOCS);
+
+	while (used > 0) {
+		z_free_fd(fds[--used]);
+	}
+}
+
+void main(void)
+{
+	bench_io();
+	bench_alloc();
+
+	printk("fin\n");
+}
@@ -0,0 +1,128 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/mutex.h>
+#include <app_memory/app_memdomain.h>
+
+#define PAIRS 10000
+#define HANDOFFS 1000
+#define STACK_SIZE 1024
+
+#ifdef CONFIG_USERSPACE
+K_APPMEM_PARTITION_DEFINE(bench_part);
+#define BENCH_BMEM K_APP_BMEM(bench_part)
+static struct k_mem_domain bench_domain;
+#define THREAD_OPTIONS K_USER
+#else
+#define BENCH_BMEM
+#define THREAD_OPTIONS 0
+#endif
+
+BENCH_BMEM static SYS_MUTEX_DEFINE(sys_lock);
+static K_MUTEX_DEFINE(k_lock);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, 2, STACK_SIZE);
+static struct k_thread threads[2];
+
+static void sys_mutex_pairs(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < PAIRS; i++) {
+		sys_mutex_lock(&sys_lock, K_FOREVER);
+		sys_mutex_unlock(&sys_lock);
+	}
+}
+
+static void k_mutex_pairs(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < PAIRS; i++) {
+		k_mutex_lock(&k_lock, K_FOREVER);
+		k_mutex_unlock(&k_lock);
+	}
+}
+
+/* The owner yields with the mutex locked, so that the other thread blocks
+ * on it and has it handed over on unlock
+ */
+static void sys_mutex_handoff(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < HANDOFFS; i++) {
+		sys_mutex_lock(&sys_lock, K_FOREVER);
+		k_yield();
+		sys_mutex_unlock(&sys_lock);
+	}
+}
+
+static void k_mutex_handoff(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < HANDOFFS; i++) {
+		k_mutex_lock(&k_lock, K_FOREVER);
+		k_yield();
+		k_mutex_unlock(&k_lock);
+	}
+}
+
+/* The cycle counter is not necessarily readable from user mode, threads are
+ * timed from main() instead
+ */
+static uint32_t run(k_thread_entry_t entry, int count, uint32_t options)
+{
+	uint32_t cycles;
+
+	for (int i = 0; i < count; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, entry,
+				NULL, NULL, NULL,
+				K_PRIO_PREEMPT(1), options, K_FOREVER);
+#ifdef CONFIG_USERSPACE
+		if ((options & K_USER) != 0U) {
+			k_mem_domain_add_thread(&bench_domain, &threads[i]);
+			k_object_access_grant(&k_lock, &threads[i]);
+		}
+#endif
+	}
+
+	cycles = k_cycle_get_32();
+	for (int i = 0; i < count; i++) {
+		k_thread_start(&threads[i]);
+	}
+	for (int i = 0; i < count; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	return k_cycle_get_32() - cycles;
+}
+
+void main(void)
+{
+	uint32_t sys_cycles, k_cycles;
+
+#ifdef CONFIG_USERSPACE
+	struct k_mem_partition *parts[] = { &bench_part };
+
+	k_mem_domain_init(&bench_domain, ARRAY_SIZE(parts), parts);
+#endif
+
+	sys_mutex_init(&sys_lock);
+
+	sys_cycles = run(sys_mutex_pairs, 1, 0);
+	k_cycles = run(k_mutex_pairs, 1, 0);
+	printk("supervisor: sys_mutex %u cycles/pair, k_mutex %u cycles/pair\n",
+	       sys_cycles / PAIRS, k_cycles / PAIRS);
+
+	if (IS_ENABLED(CONFIG_USERSPACE)) {
+		sys_cycles = run(sys_mutex_pairs, 1, THREAD_OPTIONS);
+		k_cycles = run(k_mutex_pairs, 1, THREAD_OPTIONS);
+		printk("user: sys_mutex %u cycles/pair, "
+		       "k_mutex %u cycles/pair\n",
+		       sys_cycles / PAIRS, k_cycles / PAIRS);
+	}
+
+	sys_cycles = run(sys_mutex_handoff, 2, THREAD_OPTIONS);
+	k_cycles = run(k_mutex_handoff, 2, THREAD_OPTIONS);
+	printk("handoff: sys_mutex %u cycles, k_mutex %u cycles\n",
+	       sys_cycles / (2 * HANDOFFS), k_cycles / (2 * HANDOFFS));
+
+	printk("fin\n");
+}
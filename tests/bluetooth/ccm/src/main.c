@@ -0,0 +1,97 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <ztest.h>
+
+#include <bluetooth/crypto.h>
+
+/* RFC 3610, Packet Vector #1: 8 bytes of AAD, 23 byte payload, 8 byte MIC */
+static const uint8_t key[16] = {
+	0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+	0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf,
+};
+
+static const uint8_t nonce[13] = {
+	0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0,
+	0xa1, 0xa2, 0xa3, 0xa4, 0xa5,
+};
+
+static const uint8_t aad[8] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+};
+
+static const uint8_t payload[23] = {
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+	0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e,
+};
+
+static const uint8_t expected[23 + 8] = {
+	0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2,
+	0xf0, 0x66, 0xd0, 0xc2, 0xc0, 0xf9, 0x89, 0x80,
+	0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84,
+	/* MIC */
+	0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0,
+};
+
+#define MIC_LEN (sizeof(expected) - sizeof(payload))
+
+static void test_ccm_encrypt_out_of_place(void)
+{
+	uint8_t n[13], msg[sizeof(payload)], out[sizeof(expected)];
+
+	memcpy(n, nonce, sizeof(n));
+	memcpy(msg, payload, sizeof(msg));
+	(void)memset(out, 0, sizeof(out));
+
+	zassert_ok(bt_ccm_encrypt(key, n, msg, sizeof(msg), aad, sizeof(aad),
+				  out, MIC_LEN), "encrypt failed");
+
+	zassert_mem_equal(out, expected, sizeof(expected), "wrong output");
+	zassert_mem_equal(msg, payload, sizeof(msg), "input modified");
+}
+
+static void test_ccm_encrypt_in_place(void)
+{
+	uint8_t n[13], buf[sizeof(expected)];
+
+	memcpy(n, nonce, sizeof(n));
+	memcpy(buf, payload, sizeof(payload));
+
+	zassert_ok(bt_ccm_encrypt(key, n, buf, sizeof(payload), aad,
+				  sizeof(aad), buf, MIC_LEN), "encrypt failed");
+
+	zassert_mem_equal(buf, expected, sizeof(expected), "wrong output");
+}
+
+static void test_ccm_decrypt_out_of_place(void)
+{
+	uint8_t n[13], enc[sizeof(expected)], out[sizeof(payload)];
+
+	memcpy(n, nonce, sizeof(n));
+	memcpy(enc, expected, sizeof(enc));
+	(void)memset(out, 0, sizeof(out));
+
+	zassert_ok(bt_ccm_decrypt(key, n, enc, sizeof(payload), aad,
+				  sizeof(aad), out, MIC_LEN), "decrypt failed");
+
+	zassert_mem_equal(out, payload, sizeof(payload), "wrong output");
+	zassert_mem_equal(enc, expected, sizeof(enc), "input modified");
+
+	enc[sizeof(enc) - 1] ^= 0x01;
+	zassert_equal(bt_ccm_decrypt(key, n, enc, sizeof(payload), aad,
+				     sizeof(aad), out, MIC_LEN), -EBADMSG,
+		      "bad MIC accepted");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_bluetooth_ccm,
+			 ztest_unit_test(test_ccm_encrypt_out_of_place),
+			 ztest_unit_test(test_ccm_encrypt_in_place),
+			 ztest_unit_test(test_ccm_decrypt_out_of_place));
+	ztest_run_test_suite(test_bluetooth_ccm);
+}
@@ -0,0 +1,396 @@
+/* main.c - ACL fragmentation by reference test */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+
+#include <errno.h>
+#include <ztest.h>
+
+#include <bluetooth/hci.h>
+#include <bluetooth/buf.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/l2cap.h>
+#include <drivers/bluetooth/hci_driver.h>
+#include <sys/byteorder.h>
+
+#include "host/conn_internal.h"
+
+#define ACL_MTU     27
+#define ACL_HANDLE  0x0001
+/* Three full fragments and a short final one */
+#define PDU_LEN     (3 * ACL_MTU + 10)
+#define FRAG_MAX    4
+
+static const bt_addr_le_t peer = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a = { { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc6 } },
+};
+
+static struct bt_conn *conn;
+
+/* Buffer being sent and a copy of its contents taken before sending */
+static struct net_buf *parent;
+static uint8_t parent_copy[BT_L2CAP_BUF_SIZE(CONFIG_BT_L2CAP_TX_MTU)];
+
+/* Fragments as seen by the driver */
+static struct {
+	struct net_buf *buf;
+	uint8_t data[sizeof(struct bt_hci_acl_hdr) + ACL_MTU];
+	uint16_t len;
+	bool by_ref;
+} frags[FRAG_MAX];
+
+static int frag_count;
+static size_t rx_len;
+static bool hold_frags;
+static K_SEM_DEFINE(pdu_sent, 0, 1);
+
+/* Command handler structure for cmd_handle(). */
+struct cmd_handler {
+	uint16_t opcode; /* HCI command opcode */
+	uint8_t len;     /* HCI command response length */
+	void (*handler)(struct net_buf *buf, struct net_buf **evt,
+			uint8_t len, uint16_t opcode);
+};
+
+/* Add event to net_buf. */
+static void evt_create(struct net_buf *buf, uint8_t evt, uint8_t len)
+{
+	struct bt_hci_evt_hdr *hdr;
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->evt = evt;
+	hdr->len = len;
+}
+
+/* Create a command complete event. */
+static void *cmd_complete(struct net_buf **buf, uint8_t plen, uint16_t opcode)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+
+	*buf = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+	evt_create(*buf, BT_HCI_EVT_CMD_COMPLETE, sizeof(*cc) + plen);
+	cc = net_buf_add(*buf, sizeof(*cc));
+	cc->ncmd = 1U;
+	cc->opcode = sys_cpu_to_le16(opcode);
+	return net_buf_add(*buf, plen);
+}
+
+/* Generic command complete with success status. */
+static void generic_success(struct net_buf *buf, struct net_buf **evt,
+			    uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+
+	/* Fill any event parameters with zero */
+	(void)memset(ccst, 0, len);
+
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Bogus handler for BT_HCI_OP_READ_LOCAL_FEATURES. */
+static void read_local_features(struct net_buf *buf, struct net_buf **evt,
+				uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_rp_read_local_features *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	(void)memset(&rp->features[0], 0xFF, sizeof(rp->features));
+}
+
+/* Bogus handler for BT_HCI_OP_READ_SUPPORTED_COMMANDS. */
+static void read_supported_commands(struct net_buf *buf, struct net_buf **evt,
+				    uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_rp_read_supported_commands *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	(void)memset(&rp->commands[0], 0xFF, sizeof(rp->commands));
+	rp->status = 0x00;
+}
+
+/* Handler for BT_HCI_OP_LE_READ_BUFFER_SIZE. */
+static void le_read_buffer_size(struct net_buf *buf, struct net_buf **evt,
+				uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_rp_le_read_buffer_size *rp;
+
+	rp = cmd_complete(evt, sizeof(*rp), opcode);
+	rp->status = 0x00;
+	rp->le_max_len = sys_cpu_to_le16(ACL_MTU);
+	rp->le_max_num = 16U;
+}
+
+/* Handlers needed for bt_enable to function, anything else succeeds. */
+static const struct cmd_handler cmds[] = {
+	{ BT_HCI_OP_READ_LOCAL_VERSION_INFO,
+	  sizeof(struct bt_hci_rp_read_local_version_info),
+	  generic_success },
+	{ BT_HCI_OP_READ_SUPPORTED_COMMANDS,
+	  sizeof(struct bt_hci_rp_read_supported_commands),
+	  read_supported_commands },
+	{ BT_HCI_OP_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_read_local_features),
+	  read_local_features },
+	{ BT_HCI_OP_READ_BD_ADDR,
+	  sizeof(struct bt_hci_rp_read_bd_addr),
+	  generic_success },
+	{ BT_HCI_OP_LE_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_le_read_local_features),
+	  generic_success },
+	{ BT_HCI_OP_LE_READ_SUPP_STATES,
+	  sizeof(struct bt_hci_rp_le_read_supp_states),
+	  generic_success },
+	{ BT_HCI_OP_LE_READ_BUFFER_SIZE,
+	  sizeof(struct bt_hci_rp_le_read_buffer_size),
+	  le_read_buffer_size },
+	{ BT_HCI_OP_LE_RAND,
+	  sizeof(struct bt_hci_rp_le_rand),
+	  generic_success },
+};
+
+static void cmd_handle(struct net_buf *cmd)
+{
+	struct net_buf *evt = NULL;
+	struct bt_hci_cmd_hdr *chdr;
+	uint16_t opcode;
+	int i;
+
+	chdr = net_buf_pull_mem(cmd, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	for (i = 0; i < ARRAY_SIZE(cmds); i++) {
+		if (cmds[i].opcode == opcode) {
+			cmds[i].handler(cmd, &evt, cmds[i].len, opcode);
+			break;
+		}
+	}
+
+	if (i == ARRAY_SIZE(cmds)) {
+		generic_success(cmd, &evt, sizeof(struct bt_hci_evt_cc_status),
+				opcode);
+	}
+
+	bt_recv_prio(evt);
+}
+
+static bool in_parent(const uint8_t *data)
+{
+	return data >= parent->__buf && data < parent->__buf + parent->size;
+}
+
+static void acl_handle(struct net_buf *buf)
+{
+	zassert_true(frag_count < FRAG_MAX, "Too many fragments");
+	zassert_true(buf->len <= sizeof(frags[0].data), "Fragment too long");
+
+	frags[frag_count].by_ref = in_parent(buf->data);
+	frags[frag_count].len = buf->len;
+	memcpy(frags[frag_count].data, buf->data, buf->len);
+
+	rx_len += buf->len - sizeof(struct bt_hci_acl_hdr);
+
+	if (hold_frags) {
+		frags[frag_count++].buf = buf;
+	} else {
+		frags[frag_count++].buf = NULL;
+		net_buf_unref(buf);
+	}
+
+	if (rx_len == PDU_LEN) {
+		k_sem_give(&pdu_sent);
+	}
+}
+
+/* HCI driver open. */
+static int driver_open(void)
+{
+	return 0;
+}
+
+/* HCI driver send. */
+static int driver_send(struct net_buf *buf)
+{
+	if (bt_buf_get_type(buf) == BT_BUF_ACL_OUT) {
+		acl_handle(buf);
+		return 0;
+	}
+
+	cmd_handle(buf);
+	net_buf_unref(buf);
+
+	return 0;
+}
+
+/* HCI driver structure. */
+static const struct bt_hci_driver drv = {
+	.name         = "test",
+	.bus          = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open         = driver_open,
+	.send         = driver_send,
+	.quirks       = BT_QUIRK_NO_RESET,
+};
+
+/* Return the controller buffers of the sent fragments to the host */
+static void num_completed(int count)
+{
+	struct bt_hci_evt_num_completed_packets *ep;
+	struct net_buf *buf;
+
+	buf = bt_buf_get_evt(BT_HCI_EVT_NUM_COMPLETED_PACKETS, false,
+			     K_FOREVER);
+	evt_create(buf, BT_HCI_EVT_NUM_COMPLETED_PACKETS,
+		   sizeof(*ep) + sizeof(ep->h[0]));
+	ep = net_buf_add(buf, sizeof(*ep) + sizeof(ep->h[0]));
+	ep->num_handles = 1U;
+	ep->h[0].handle = sys_cpu_to_le16(ACL_HANDLE);
+	ep->h[0].count = sys_cpu_to_le16(count);
+
+	bt_recv_prio(buf);
+}
+
+static void pdu_send(bool hold)
+{
+	int i;
+
+	hold_frags = hold;
+	frag_count = 0;
+	rx_len = 0;
+
+	parent = bt_conn_create_pdu(NULL, 0);
+	zassert_equal(net_buf_headroom(parent),
+		      BT_BUF_RESERVE + sizeof(struct bt_hci_acl_hdr),
+		      "Unexpected headroom");
+
+	for (i = 0; i < PDU_LEN; i++) {
+		net_buf_add_u8(parent, i);
+	}
+
+	memcpy(parent_copy, parent->__buf, parent->size);
+
+	/* Keep the parent around to check it once the driver is done */
+	net_buf_ref(parent);
+
+	zassert_equal(bt_conn_send(conn, parent), 0, "Send failed");
+	zassert_equal(k_sem_take(&pdu_sent, K_SECONDS(1)), 0,
+		      "PDU not sent");
+}
+
+/* Check the ACL header and payload of a fragment */
+static void frag_check(int i, uint16_t offset, uint8_t pb)
+{
+	struct bt_hci_acl_hdr *hdr = (void *)frags[i].data;
+	uint16_t handle = sys_le16_to_cpu(hdr->handle);
+	uint16_t len = sys_le16_to_cpu(hdr->len);
+	int j;
+
+	zassert_equal(bt_acl_handle(handle), ACL_HANDLE, "Wrong handle");
+	zassert_equal(bt_acl_flags_pb(bt_acl_flags(handle)), pb,
+		      "Wrong flags in fragment %d", i);
+	zassert_equal(len, MIN(ACL_MTU, PDU_LEN - offset),
+		      "Wrong length of fragment %d", i);
+	zassert_equal(frags[i].len, sizeof(*hdr) + len, "Length mismatch");
+
+	for (j = 0; j < len; j++) {
+		zassert_equal(frags[i].data[sizeof(*hdr) + j],
+			      (uint8_t)(offset + j),
+			      "Wrong data in fragment %d", i);
+	}
+}
+
+static void test_frag_ref_released(void)
+{
+	size_t end;
+	int i;
+
+	pdu_send(false);
+
+	zassert_equal(frag_count, 4, "Wrong number of fragments");
+
+	for (i = 0; i < frag_count; i++) {
+		frag_check(i, i * ACL_MTU,
+			   i ? BT_ACL_CONT : BT_ACL_START_NO_FLUSH);
+
+		/* The previous fragment was always released in time */
+		zassert_true(frags[i].by_ref, "Fragment %d copied", i);
+	}
+
+	/* The headers of the final part are written for good, in front of
+	 * it. Everything else must have been restored.
+	 */
+	end = parent->data - parent->__buf;
+	zassert_equal(parent->len,
+		      sizeof(struct bt_hci_acl_hdr) + PDU_LEN - 3 * ACL_MTU,
+		      "Wrong final part");
+	zassert_equal(memcmp(parent->__buf, parent_copy, end), 0,
+		      "Parent not restored");
+
+	net_buf_unref(parent);
+	num_completed(frag_count);
+}
+
+static void test_frag_ref_held(void)
+{
+	int i;
+
+	/* None of the fragments is released until the whole PDU has been
+	 * handed to the driver, so sending must not wait for the driver.
+	 */
+	pdu_send(true);
+
+	zassert_equal(frag_count, 4, "Wrong number of fragments");
+	zassert_true(frags[0].by_ref, "First fragment copied");
+	zassert_false(frags[1].by_ref, "Held fragment overwritten");
+	zassert_true(frags[2].by_ref, "Third fragment copied");
+	zassert_false(frags[3].by_ref, "Held fragment overwritten");
+
+	for (i = 0; i < frag_count; i++) {
+		/* Fragments must be intact when the driver gets to them */
+		zassert_equal(memcmp(frags[i].buf->data, frags[i].data,
+				     frags[i].len), 0,
+			      "Fragment %d modified", i);
+
+		frag_check(i, i * ACL_MTU,
+			   i ? BT_ACL_CONT : BT_ACL_START_NO_FLUSH);
+	}
+
+	for (i = 0; i < frag_count; i++) {
+		net_buf_unref(frags[i].buf);
+	}
+
+	zassert_equal(memcmp(parent->__buf, parent_copy, parent->size), 0,
+		      "Parent not restored");
+
+	net_buf_unref(parent);
+	num_completed(frag_count);
+}
+
+static void test_setup(void)
+{
+	bt_hci_driver_register(&drv);
+
+	zassert_equal(bt_enable(NULL), 0, "bt_enable failed");
+
+	conn = bt_conn_add_le(BT_ID_DEFAULT, &peer);
+	zassert_not_null(conn, "No connection");
+
+	conn->handle = ACL_HANDLE;
+	bt_conn_set_state(conn, BT_CONN_CONNECTED);
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_conn_frag,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_frag_ref_released),
+			 ztest_unit_test(test_frag_ref_held));
+
+	ztest_run_test_suite(test_conn_frag);
+}
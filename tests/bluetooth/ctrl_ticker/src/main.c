@@ -0,0 +1,260 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/types.h>
+#include <ztest.h>
+
+#define CONFIG_BT_LOG_LEVEL 1
+
+#include "ticker/ticker.c"
+
+/*
+ * Unit test and benchmark of the ticker node list, driven by a simulated
+ * counter. Expiry of every node is checked against its requested period
+ * while many nodes are started, stopped and re-inserted in the same job.
+ */
+
+#define TICKER_INSTANCE 0
+#define TICKER_USER_ID 0
+#define TICKER_NODES 40
+#define TICKER_USER_OPS (TICKER_NODES + 1)
+#define TICKER_EXPIRIES 20000
+#define TICKER_ROUNDS 200
+
+static struct ticker_node nodes[TICKER_NODES];
+static struct ticker_user users[1];
+static struct ticker_user_op user_ops[TICKER_USER_OPS];
+
+static uint32_t cnt;
+static bool worker_pending;
+static bool job_pending;
+
+static uint32_t expected[TICKER_NODES];
+static uint32_t periods[TICKER_NODES];
+static bool active[TICKER_NODES];
+static uint32_t expiries;
+static uint32_t ticks_last;
+
+uint32_t cntr_cnt_get(void)
+{
+	return cnt;
+}
+
+uint32_t cntr_start(void)
+{
+	return 0;
+}
+
+uint32_t cntr_stop(void)
+{
+	return 0;
+}
+
+static uint8_t caller_id_get(uint8_t user_id)
+{
+	return TICKER_CALL_ID_JOB;
+}
+
+static void sched(uint8_t caller_id, uint8_t callee_id, uint8_t chain,
+		  void *instance)
+{
+	if (callee_id == TICKER_CALL_ID_WORKER) {
+		worker_pending = true;
+	} else {
+		job_pending = true;
+	}
+}
+
+static void trigger_set(uint32_t value)
+{
+}
+
+static void run(void)
+{
+	while (worker_pending || job_pending) {
+		if (worker_pending) {
+			worker_pending = false;
+			ticker_worker(&_instance[TICKER_INSTANCE]);
+		} else {
+			job_pending = false;
+			ticker_job(&_instance[TICKER_INSTANCE]);
+		}
+	}
+}
+
+/* Move the counter to the next expiry and let the ticker handle it */
+static void advance(void)
+{
+	struct ticker_instance *instance = &_instance[TICKER_INSTANCE];
+
+	zassert_not_equal(instance->ticker_id_head, TICKER_NULL, "no tickers");
+
+	cnt = instance->ticks_current +
+	      instance->nodes[instance->ticker_id_head].ticks_to_expire;
+	cnt &= HAL_TICKER_CNTR_MASK;
+
+	ticker_trigger(TICKER_INSTANCE);
+	run();
+}
+
+/* Check that the list holds every active node at its expected offset */
+static void check_list(void)
+{
+	struct ticker_instance *instance = &_instance[TICKER_INSTANCE];
+	uint8_t id = instance->ticker_id_head;
+	uint32_t ticks = 0U;
+	uint8_t count = 0U;
+	uint8_t count_active = 0U;
+
+	while (id != TICKER_NULL) {
+		zassert_true(nodes[id].ticks_to_expire <
+			     BIT(HAL_TICKER_CNTR_MSBIT), "list out of order");
+		ticks += nodes[id].ticks_to_expire;
+		zassert_true(active[id], "inactive node %u in list", id);
+		zassert_equal(ticker_ticks_diff_get(expected[id],
+						    instance->ticks_current),
+			      ticks, "node %u misplaced", id);
+		id = nodes[id].next;
+		count++;
+	}
+
+	for (id = 0U; id < TICKER_NODES; id++) {
+		count_active += active[id];
+	}
+	zassert_equal(count, count_active, "nodes missing from list");
+}
+
+static void timeout(uint32_t ticks_at_expire, uint32_t remainder,
+		    uint16_t lazy, void *context)
+{
+	uint8_t id = POINTER_TO_UINT(context);
+
+	zassert_true(active[id], "stopped node %u expired", id);
+	zassert_equal(lazy, 0U, "node %u skipped", id);
+	zassert_equal(ticks_at_expire, expected[id], "node %u late", id);
+	zassert_true(ticker_ticks_diff_get(ticks_at_expire, ticks_last) <
+		     BIT(HAL_TICKER_CNTR_MSBIT), "expired out of order");
+
+	ticks_last = ticks_at_expire;
+	expected[id] = (expected[id] + periods[id]) & HAL_TICKER_CNTR_MASK;
+	expiries++;
+}
+
+static void op_done(uint32_t status, void *op_context)
+{
+	zassert_equal(status, TICKER_STATUS_SUCCESS, "ticker op failed");
+}
+
+static void start(uint8_t id, uint32_t ticks_first)
+{
+	uint32_t ret;
+
+	expected[id] = (cnt + ticks_first) & HAL_TICKER_CNTR_MASK;
+	active[id] = true;
+
+	ret = ticker_start(TICKER_INSTANCE, TICKER_USER_ID, id, cnt,
+			   ticks_first, periods[id], TICKER_NULL_REMAINDER,
+			   TICKER_NULL_LAZY, TICKER_NULL_SLOT, timeout,
+			   UINT_TO_POINTER(id), op_done, NULL);
+	zassert_equal(ret, TICKER_STATUS_BUSY, "start failed");
+}
+
+static void stop(uint8_t id)
+{
+	uint32_t ret;
+
+	active[id] = false;
+
+	ret = ticker_stop(TICKER_INSTANCE, TICKER_USER_ID, id, op_done, NULL);
+	zassert_equal(ret, TICKER_STATUS_BUSY, "stop failed");
+}
+
+void test_ticker_init(void)
+{
+	uint32_t ret;
+
+	users[0].count_user_op = TICKER_USER_OPS;
+	ret = ticker_init(TICKER_INSTANCE, TICKER_NODES, nodes, 1, users,
+			  TICKER_USER_OPS, user_ops, caller_id_get, sched,
+			  trigger_set);
+	zassert_equal(ret, TICKER_STATUS_SUCCESS, "init failed");
+
+	for (uint8_t id = 0U; id < TICKER_NODES; id++) {
+		/* Co-prime periods, so that expiries keep changing order */
+		periods[id] = 400U + 13U * id;
+	}
+}
+
+void test_ticker_expire(void)
+{
+	uint32_t cycles;
+
+	/* Start all nodes in one job, in no particular order of expiry */
+	for (uint8_t id = 0U; id < TICKER_NODES; id++) {
+		start(id, 1U + (id * 17U) % TICKER_NODES * 10U);
+	}
+	run();
+	check_list();
+
+	ticks_last = cnt;
+	expiries = 0U;
+	cycles = k_cycle_get_32();
+	while (expiries < TICKER_EXPIRIES) {
+		advance();
+	}
+	cycles = k_cycle_get_32() - cycles;
+	check_list();
+
+	printk("%u tickers, %u expiries in %u cycles\n", TICKER_NODES,
+	       expiries, cycles);
+}
+
+void test_ticker_start_stop(void)
+{
+	uint32_t cycles;
+
+	cycles = k_cycle_get_32();
+	for (uint32_t round = 0U; round < TICKER_ROUNDS; round++) {
+		uint8_t offset = round % 4U;
+
+		/* Restart a quarter of the nodes in one job */
+		for (uint8_t id = offset; id < TICKER_NODES; id += 4U) {
+			stop(id);
+		}
+		run();
+		check_list();
+
+		for (uint8_t id = offset; id < TICKER_NODES; id += 4U) {
+			start(id, 1U + ((round + id) * 31U) % 500U);
+		}
+		run();
+		check_list();
+
+		ticks_last = cnt;
+		advance();
+		advance();
+	}
+	cycles = k_cycle_get_32() - cycles;
+	check_list();
+
+	printk("%u tickers, %u restarts in %u cycles\n", TICKER_NODES,
+	       TICKER_ROUNDS * TICKER_NODES / 4U, cycles);
+
+	for (uint8_t id = 0U; id < TICKER_NODES; id++) {
+		stop(id);
+	}
+	run();
+	zassert_equal(_instance[TICKER_INSTANCE].ticker_id_head, TICKER_NULL,
+		      "tickers left running");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_ctrl_ticker,
+			 ztest_unit_test(test_ticker_init),
+			 ztest_unit_test(test_ticker_expire),
+			 ztest_unit_test(test_ticker_start_stop)
+			 );
+	ztest_run_test_suite(test_ctrl_ticker);
+}
@@ -14,6 +14,9 @@
 #include <bluetooth/bluetooth.h>
 #include <bluetooth/gatt.h>
 
+#include "host/hci_core.h"
+#include "host/conn_internal.h"
+
 /* Custom Service Variables */
 static struct bt_uuid_128 test_uuid = BT_UUID_INIT_128(
 	0xf0, 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,
@@ -89,6 +92,36 @@ static struct bt_gatt_attr test1_attrs[] = {
 
 static struct bt_gatt_service test1_svc = BT_GATT_SERVICE(test1_attrs);
 
+static struct bt_conn *matched_conn;
+static uint8_t match_count;
+
+static bool test2_ccc_cfg_match(struct bt_conn *conn,
+				const struct bt_gatt_attr *attr)
+{
+	matched_conn = conn;
+	match_count++;
+
+	/* Stop before sending, the test connections have no ATT channel */
+	return false;
+}
+
+static struct _bt_gatt_ccc test2_ccc = {
+	.cfg_match = test2_ccc_cfg_match,
+};
+
+static struct bt_gatt_attr test2_attrs[] = {
+	/* Vendor Primary Service Declaration */
+	BT_GATT_PRIMARY_SERVICE(&test1_uuid),
+
+	BT_GATT_CHARACTERISTIC(&test1_nfy_uuid.uuid,
+			       BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_NONE,
+			       NULL, NULL, NULL),
+	BT_GATT_CCC_MANAGED(&test2_ccc,
+			    BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+};
+
+static struct bt_gatt_service test2_svc = BT_GATT_SERVICE(test2_attrs);
+
 void test_gatt_register(void)
 {
 	/* Attempt to register services */
@@ -265,6 +298,117 @@ void test_gatt_write(void)
 			  "Attribute write value don't match");
 }
 
+static uint8_t check_handle(const struct bt_gatt_attr *attr, uint16_t handle,
+			    void *user_data)
+{
+	const struct bt_gatt_attr *found = NULL;
+	uint16_t *count = user_data;
+
+	zassert_equal(bt_gatt_attr_get_handle(attr), handle,
+		      "Attribute handle don't match");
+
+	/* Single handle lookup */
+	bt_gatt_foreach_attr(handle, handle, find_attr, &found);
+	zassert_equal(found, attr, "Attribute don't match");
+
+	/* Lookup starting in the middle of a service */
+	found = NULL;
+	bt_gatt_foreach_attr_type(handle, 0xffff, NULL, NULL, 1, find_attr,
+				  &found);
+	zassert_equal(found, attr, "Attribute don't match");
+
+	(*count)++;
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+void test_gatt_foreach_handle(void)
+{
+	const struct bt_gatt_attr *last;
+	uint16_t count = 0;
+	uint16_t num = 0;
+
+	last = &test1_attrs[ARRAY_SIZE(test1_attrs) - 1];
+
+	bt_gatt_foreach_attr(0x0001, 0xffff, count_attr, &num);
+	bt_gatt_foreach_attr(0x0001, 0xffff, check_handle, &count);
+	zassert_equal(count, num, "Number of attributes don't match");
+
+	/* Lookups past the last service */
+	num = 0;
+	bt_gatt_foreach_attr(last->handle + 1, 0xffff, count_attr, &num);
+	zassert_equal(num, 0, "Number of attributes don't match");
+	zassert_is_null(bt_gatt_attr_next(last),
+			"Attribute past the last one");
+}
+
+static void test_conn_init(struct bt_conn *conn, uint8_t addr,
+			   bt_conn_state_t state)
+{
+	memset(conn, 0, sizeof(*conn));
+	conn->type = BT_CONN_TYPE_LE;
+	conn->state = state;
+	conn->le.dst.type = BT_ADDR_LE_PUBLIC;
+	conn->le.dst.a.val[0] = addr;
+}
+
+static void test_ccc_cfg_set(size_t i, uint8_t addr, uint16_t value)
+{
+	test2_ccc.cfg[i].id = BT_ID_DEFAULT;
+	test2_ccc.cfg[i].peer.type = BT_ADDR_LE_PUBLIC;
+	test2_ccc.cfg[i].peer.a.val[0] = addr;
+	test2_ccc.cfg[i].value = value;
+}
+
+void test_gatt_notify_multicast(void)
+{
+	static struct bt_conn nfy_conn, ind_conn, both_conn, disc_conn,
+			      unsub_conn;
+	struct bt_conn *conns[] = {
+		NULL, &ind_conn, &both_conn, &disc_conn, &unsub_conn,
+		&nfy_conn,
+	};
+	struct bt_gatt_notify_params params = {
+		.attr = &test2_attrs[1],
+		.data = test_value,
+		.len = sizeof(test_value),
+	};
+	int ret;
+
+	BUILD_ASSERT(BT_GATT_CCC_MAX >= 4, "Not enough CCC configurations");
+
+	zassert_false(bt_gatt_service_register(&test2_svc),
+		      "Test service2 registration failed");
+
+	test_conn_init(&nfy_conn, 1, BT_CONN_CONNECTED);
+	test_conn_init(&ind_conn, 2, BT_CONN_CONNECTED);
+	test_conn_init(&both_conn, 3, BT_CONN_CONNECTED);
+	test_conn_init(&disc_conn, 4, BT_CONN_DISCONNECTED);
+	test_conn_init(&unsub_conn, 5, BT_CONN_CONNECTED);
+	test_ccc_cfg_set(0, 1, BT_GATT_CCC_NOTIFY);
+	test_ccc_cfg_set(1, 2, BT_GATT_CCC_INDICATE);
+	test_ccc_cfg_set(2, 3, BT_GATT_CCC_NOTIFY | BT_GATT_CCC_INDICATE);
+	test_ccc_cfg_set(3, 4, BT_GATT_CCC_NOTIFY);
+
+	ret = bt_gatt_notify_multicast(conns, ARRAY_SIZE(conns), &params);
+	zassert_equal(ret, -EAGAIN, "Notified with Bluetooth not ready");
+	zassert_equal(match_count, 0, "Connection matched");
+
+	atomic_set_bit(bt_dev.flags, BT_DEV_READY);
+
+	/* Only the connection subscribed to notifications alone is left */
+	ret = bt_gatt_notify_multicast(conns, ARRAY_SIZE(conns), &params);
+	zassert_equal(ret, 0, "Notification sent");
+	zassert_equal(match_count, 1, "Unexpected connections matched");
+	zassert_equal_ptr(matched_conn, &nfy_conn, "Wrong connection matched");
+
+	atomic_clear_bit(bt_dev.flags, BT_DEV_READY);
+	memset(test2_ccc.cfg, 0, sizeof(test2_ccc.cfg));
+
+	zassert_false(bt_gatt_service_unregister(&test2_svc),
+		      "Test service2 unregister failed");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -273,6 +417,8 @@ void test_main(void)
 			 ztest_unit_test(test_gatt_unregister),
 			 ztest_unit_test(test_gatt_foreach),
 			 ztest_unit_test(test_gatt_read),
-			 ztest_unit_test(test_gatt_write));
+			 ztest_unit_test(test_gatt_write),
+			 ztest_unit_test(test_gatt_foreach_handle),
+			 ztest_unit_test(test_gatt_notify_multicast));
 	ztest_run_test_suite(test_gatt);
 }
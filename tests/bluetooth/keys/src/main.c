@@ -0,0 +1,214 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <ztest.h>
+
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/crypto.h>
+
+#include "host/keys.h"
+
+static const bt_addr_le_t peer_a = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a = { { 0x01, 0x00, 0x00, 0x00, 0x00, 0xc0 } },
+};
+
+static const bt_addr_le_t peer_b = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a = { { 0x02, 0x00, 0x00, 0x00, 0x00, 0xc0 } },
+};
+
+/* IRK and prand from the Core Specification sample data */
+static const uint8_t irk_a[16] = {
+	0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34,
+	0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec,
+};
+
+static const uint8_t irk_b[16] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+};
+
+/* Build the RPA hash || prand for the given IRK without going through
+ * bt_rand(), which needs an initialized host.
+ */
+static void rpa_make(const uint8_t irk[16], uint8_t prand0, bt_addr_le_t *rpa)
+{
+	uint8_t res[16] = { 0 };
+
+	res[0] = prand0;
+	res[1] = 0x81;
+	res[2] = 0x70;
+
+	zassert_ok(bt_encrypt_le(irk, res, res), "encrypt failed");
+
+	rpa->type = BT_ADDR_LE_RANDOM;
+	rpa->a.val[0] = res[0];
+	rpa->a.val[1] = res[1];
+	rpa->a.val[2] = res[2];
+	rpa->a.val[3] = prand0;
+	rpa->a.val[4] = 0x81;
+	rpa->a.val[5] = 0x70;
+}
+
+static struct bt_keys *keys_add(const bt_addr_le_t *addr,
+				const uint8_t irk[16])
+{
+	struct bt_keys *keys;
+
+	keys = bt_keys_get_type(BT_KEYS_IRK, BT_ID_DEFAULT, addr);
+	zassert_not_null(keys, "no keys");
+	memcpy(keys->irk.val, irk, sizeof(keys->irk.val));
+	(void)memset(&keys->irk.rpa, 0, sizeof(keys->irk.rpa));
+
+	return keys;
+}
+
+static void keys_reset(void)
+{
+	struct bt_keys *keys;
+
+	keys = bt_keys_find_addr(BT_ID_DEFAULT, &peer_a);
+	if (keys) {
+		bt_keys_clear(keys);
+	}
+
+	keys = bt_keys_find_addr(BT_ID_DEFAULT, &peer_b);
+	if (keys) {
+		bt_keys_clear(keys);
+	}
+}
+
+static void test_rpa_sample_data(void)
+{
+	bt_addr_le_t rpa;
+
+	rpa_make(irk_a, 0x94, &rpa);
+
+	/* Sample hash 0x0dfbaa for prand 0x708194 */
+	zassert_equal(rpa.a.val[0], 0xaa, "bad hash");
+	zassert_equal(rpa.a.val[1], 0xfb, "bad hash");
+	zassert_equal(rpa.a.val[2], 0x0d, "bad hash");
+	zassert_true(bt_addr_le_is_rpa(&rpa), "not an RPA");
+}
+
+static void test_rpa_cache_hit(void)
+{
+	struct bt_keys *keys;
+	bt_addr_le_t rpa1, rpa2;
+
+	keys_reset();
+	keys = keys_add(&peer_a, irk_a);
+
+	rpa_make(irk_a, 0x01, &rpa1);
+	rpa_make(irk_a, 0x02, &rpa2);
+
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa1), keys,
+			  "rpa1 not resolved");
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa2), keys,
+			  "rpa2 not resolved");
+	zassert_equal(bt_addr_cmp(&keys->irk.rpa, &rpa2.a), 0,
+		      "last RPA not recorded");
+
+	/* With the IRK corrupted only the cache can resolve rpa1 */
+	keys->irk.val[0] ^= 0xff;
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa1), keys,
+			  "rpa1 not served from cache");
+
+	/* Same address under another identity is a separate entry */
+	zassert_is_null(bt_keys_find_irk(BT_ID_DEFAULT + 1, &rpa1),
+			"rpa1 resolved for the wrong identity");
+
+	keys_reset();
+}
+
+static void test_rpa_cache_evict(void)
+{
+	struct bt_keys *keys;
+	bt_addr_le_t rpa1, rpa2, rpa3, rpa4;
+
+	keys_reset();
+	keys = keys_add(&peer_a, irk_a);
+
+	rpa_make(irk_a, 0x11, &rpa1);
+	rpa_make(irk_a, 0x12, &rpa2);
+	rpa_make(irk_a, 0x13, &rpa3);
+	rpa_make(irk_a, 0x14, &rpa4);
+
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa1), keys, NULL);
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa2), keys, NULL);
+	/* Touch rpa1 so that rpa2 becomes the least recently used */
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa1), keys, NULL);
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa3), keys, NULL);
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa4), keys, NULL);
+
+	keys->irk.val[0] ^= 0xff;
+
+	/* Cache of two holds rpa3 and rpa4, the last RPA is rpa4 */
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa3), keys,
+			  "rpa3 not cached");
+	zassert_is_null(bt_keys_find_irk(BT_ID_DEFAULT, &rpa1),
+			"rpa1 not evicted");
+	zassert_is_null(bt_keys_find_irk(BT_ID_DEFAULT, &rpa2),
+			"rpa2 not evicted");
+
+	keys_reset();
+}
+
+static void test_rpa_cache_negative(void)
+{
+	struct bt_keys *keys;
+	bt_addr_le_t rpa;
+
+	keys_reset();
+	(void)keys_add(&peer_a, irk_a);
+
+	rpa_make(irk_b, 0x21, &rpa);
+
+	zassert_is_null(bt_keys_find_irk(BT_ID_DEFAULT, &rpa),
+			"unexpected match");
+
+	/* Storing a new IRK must drop the cached miss */
+	keys = keys_add(&peer_b, irk_b);
+	bt_keys_add_type(keys, BT_KEYS_IRK);
+
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa), keys,
+			  "cached miss not flushed");
+
+	keys_reset();
+}
+
+static void test_rpa_cache_clear(void)
+{
+	struct bt_keys *keys;
+	bt_addr_le_t rpa1, rpa2;
+
+	keys_reset();
+	keys = keys_add(&peer_a, irk_a);
+
+	rpa_make(irk_a, 0x31, &rpa1);
+	rpa_make(irk_a, 0x32, &rpa2);
+
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa1), keys, NULL);
+	zassert_equal_ptr(bt_keys_find_irk(BT_ID_DEFAULT, &rpa2), keys, NULL);
+
+	/* Removing the bond must not leave stale pointers behind */
+	bt_keys_clear(keys);
+
+	zassert_is_null(bt_keys_find_irk(BT_ID_DEFAULT, &rpa1),
+			"stale cache entry after clear");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_bluetooth_keys,
+			 ztest_unit_test(test_rpa_sample_data),
+			 ztest_unit_test(test_rpa_cache_hit),
+			 ztest_unit_test(test_rpa_cache_evict),
+			 ztest_unit_test(test_rpa_cache_negative),
+			 ztest_unit_test(test_rpa_cache_clear));
+	ztest_run_test_suite(test_bluetooth_keys);
+}
@@ -0,0 +1,467 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <ztest.h>
+
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/mesh.h>
+#include <bluetooth/testing.h>
+
+#include "mesh.h"
+#include "net.h"
+#include "rpl.h"
+#include "subnet.h"
+#include "transport.h"
+
+#define LOCAL_ADDR  0x0001
+#define PEER_ADDR   0x0100
+#define REMOTE_ADDR 0x0200
+
+static const uint8_t net_key[16] = {
+	0x7d, 0xd7, 0x36, 0x4c, 0xd8, 0x42, 0xad, 0x18,
+	0xc1, 0x7c, 0x2b, 0x82, 0x0c, 0x84, 0xc3, 0xd6,
+};
+
+static const uint8_t dev_key[16] = {
+	0x9d, 0x6d, 0xd0, 0xe9, 0x6e, 0xb2, 0x5d, 0xc1,
+	0x9a, 0x40, 0xed, 0x99, 0x14, 0xf8, 0xf0, 0x3f,
+};
+
+static const uint8_t dev_uuid[16] = { 0xdd, 0xdd };
+
+static const struct bt_mesh_prov prov = {
+	.uuid = dev_uuid,
+};
+
+static struct bt_mesh_model root_models[] = {
+	BT_MESH_MODEL_CFG_SRV,
+};
+
+static struct bt_mesh_elem elements[] = {
+	BT_MESH_ELEM(0, root_models, BT_MESH_MODEL_NONE),
+};
+
+static const struct bt_mesh_comp comp = {
+	.cid = BT_COMP_ID_LF,
+	.elem = elements,
+	.elem_count = ARRAY_SIZE(elements),
+};
+
+static unsigned int net_recv_count;
+
+static void mesh_net_recv(uint8_t ttl, uint8_t ctl, uint16_t src, uint16_t dst,
+			  const void *payload, size_t payload_len)
+{
+	net_recv_count++;
+}
+
+static struct bt_test_cb test_cb = {
+	.mesh_net_recv = mesh_net_recv,
+};
+
+/* Encrypt a network PDU from a remote node and pass it to the network
+ * layer as if it had been received over the advertising bearer.
+ */
+static void net_pdu_recv(uint16_t src, uint16_t dst, uint32_t seq, uint8_t ttl,
+			 bool ctl, const uint8_t *payload, size_t len)
+{
+	NET_BUF_SIMPLE_DEFINE(buf, 29);
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = 0,
+		.app_idx = ctl ? BT_MESH_KEY_UNUSED : 0,
+		.addr = dst,
+		.send_ttl = ttl,
+	};
+	struct bt_mesh_net_tx tx = {
+		.sub = bt_mesh_subnet_get(0),
+		.ctx = &ctx,
+		.src = src,
+	};
+	uint32_t own_seq = bt_mesh.seq;
+
+	net_buf_simple_reserve(&buf, BT_MESH_NET_HDR_LEN);
+	net_buf_simple_add_mem(&buf, payload, len);
+
+	bt_mesh.seq = seq;
+	zassert_ok(bt_mesh_net_encode(&tx, &buf, false), "encode failed");
+	bt_mesh.seq = own_seq;
+
+	bt_mesh_net_recv(&buf, 0, BT_MESH_NET_IF_ADV);
+}
+
+static void access_pdu_recv(uint16_t src, uint32_t seq, uint8_t ttl)
+{
+	static const uint8_t pdu[] = { 0x00, 0xaa, 0xbb, 0xcc, 0xdd, 0xee };
+
+	net_pdu_recv(src, REMOTE_ADDR, seq, ttl, false, pdu, sizeof(pdu));
+}
+
+static void test_msg_cache_dup(void)
+{
+	unsigned int count = net_recv_count;
+
+	access_pdu_recv(PEER_ADDR, 0x100, 5);
+	zassert_equal(net_recv_count, count + 1, "message dropped");
+
+	/* Same message through another relay, so with a different TTL */
+	access_pdu_recv(PEER_ADDR, 0x100, 4);
+	zassert_equal(net_recv_count, count + 1, "duplicate not detected");
+
+	access_pdu_recv(PEER_ADDR, 0x101, 5);
+	zassert_equal(net_recv_count, count + 2, "next message dropped");
+
+	/* Same sequence number from another source */
+	access_pdu_recv(PEER_ADDR + 1, 0x100, 5);
+	zassert_equal(net_recv_count, count + 3, "other source dropped");
+}
+
+/* Sequence numbers that are equal modulo the size of the index start
+ * probing from the same slot. Messages go to the last two and the first
+ * home slot of the index, which gives long, interleaved probe chains that
+ * wrap around its end, and slots freed by the FIFO replacement are not
+ * simply taken again by the next message.
+ */
+static uint32_t evict_seq(int i)
+{
+	const uint32_t size = 2 * CONFIG_BT_MESH_MSG_CACHE_SIZE;
+
+	return 0x1000 + i * size + size - 2 + (i % 3);
+}
+
+static uint16_t evict_src(int i)
+{
+	return PEER_ADDR + (i % 2);
+}
+
+static void test_msg_cache_evict(void)
+{
+	const int total = 5 * CONFIG_BT_MESH_MSG_CACHE_SIZE;
+	unsigned int count;
+	int i, j;
+
+	for (i = 0; i < total; i++) {
+		count = net_recv_count;
+		access_pdu_recv(evict_src(i), evict_seq(i), 5);
+		zassert_equal(net_recv_count, count + 1,
+			      "message %d dropped", i);
+
+		/* Everything still in the cache must be detected. Use a new
+		 * TTL each time, so that the copies are not caught by the
+		 * duplicate filter in front of the cache.
+		 */
+		for (j = MAX(0, i - CONFIG_BT_MESH_MSG_CACHE_SIZE + 1); j <= i;
+		     j++) {
+			access_pdu_recv(evict_src(j), evict_seq(j), 10 + i);
+			zassert_equal(net_recv_count, count + 1,
+				      "message %d not cached at %d", j, i);
+		}
+	}
+
+	/* The entry replaced last is no longer in the cache */
+	i = total - CONFIG_BT_MESH_MSG_CACHE_SIZE - 1;
+	count = net_recv_count;
+	access_pdu_recv(evict_src(i), evict_seq(i), 100);
+	zassert_equal(net_recv_count, count + 1, "evicted message dropped");
+}
+
+static struct bt_mesh_net_rx *rpl_rx(uint16_t src, uint32_t seq, bool old_iv)
+{
+	static struct bt_mesh_net_rx rx;
+
+	(void)memset(&rx, 0, sizeof(rx));
+	rx.net_if = BT_MESH_NET_IF_ADV;
+	rx.local_match = true;
+	rx.ctx.addr = src;
+	rx.seq = seq;
+	rx.old_iv = old_iv;
+
+	return &rx;
+}
+
+/* Sources that are equal modulo the list size share the home slot */
+static uint16_t rpl_src(int i)
+{
+	return PEER_ADDR + i * CONFIG_BT_MESH_CRPL;
+}
+
+static void test_rpl_check(void)
+{
+	bt_mesh_rpl_clear();
+
+	zassert_false(bt_mesh_rpl_check(rpl_rx(PEER_ADDR, 10, false), NULL),
+		      "first message rejected");
+	zassert_true(bt_mesh_rpl_check(rpl_rx(PEER_ADDR, 10, false), NULL),
+		     "replay accepted");
+	zassert_true(bt_mesh_rpl_check(rpl_rx(PEER_ADDR, 9, false), NULL),
+		     "older message accepted");
+	zassert_false(bt_mesh_rpl_check(rpl_rx(PEER_ADDR, 11, false), NULL),
+		      "newer message rejected");
+	zassert_false(bt_mesh_rpl_check(rpl_rx(PEER_ADDR + 1, 10, false),
+					NULL), "other source rejected");
+
+	zassert_not_null(bt_mesh_rpl_find(PEER_ADDR), "entry not found");
+	zassert_equal(bt_mesh_rpl_find(PEER_ADDR)->seq, 11, "seq not updated");
+	zassert_is_null(bt_mesh_rpl_find(PEER_ADDR + 2), "unknown source");
+}
+
+static void test_rpl_collisions(void)
+{
+	struct bt_mesh_rpl *rpl;
+	int i;
+
+	bt_mesh_rpl_clear();
+
+	for (i = 0; i < CONFIG_BT_MESH_CRPL; i++) {
+		zassert_false(bt_mesh_rpl_check(rpl_rx(rpl_src(i), 1, false),
+						NULL), "source %d rejected", i);
+	}
+
+	/* The list is full */
+	zassert_true(bt_mesh_rpl_check(rpl_rx(PEER_ADDR + 1, 1, false), NULL),
+		     "message accepted with full list");
+	zassert_is_null(bt_mesh_rpl_alloc(PEER_ADDR + 1), "alloc on full list");
+
+	for (i = 0; i < CONFIG_BT_MESH_CRPL; i++) {
+		zassert_true(bt_mesh_rpl_check(rpl_rx(rpl_src(i), 1, false),
+					       NULL), "source %d replayed", i);
+	}
+
+	/* Removing an entry from the middle of the probe chain must keep
+	 * the entries behind it reachable.
+	 */
+	rpl = bt_mesh_rpl_find(rpl_src(2));
+	zassert_not_null(rpl, "entry not found");
+	bt_mesh_rpl_remove(rpl);
+
+	zassert_is_null(bt_mesh_rpl_find(rpl_src(2)), "entry not removed");
+	for (i = 0; i < CONFIG_BT_MESH_CRPL; i++) {
+		if (i == 2) {
+			continue;
+		}
+
+		rpl = bt_mesh_rpl_find(rpl_src(i));
+		zassert_not_null(rpl, "source %d lost", i);
+		zassert_equal(rpl->src, rpl_src(i), "wrong entry");
+	}
+
+	zassert_false(bt_mesh_rpl_check(rpl_rx(PEER_ADDR + 1, 1, false), NULL),
+		      "message rejected after remove");
+	zassert_not_null(bt_mesh_rpl_find(PEER_ADDR + 1), "entry not added");
+}
+
+static void test_rpl_reset(void)
+{
+	const int count = CONFIG_BT_MESH_CRPL / 2;
+	struct bt_mesh_rpl *rpl;
+	int i;
+
+	bt_mesh_rpl_clear();
+
+	for (i = 0; i < count; i++) {
+		zassert_false(bt_mesh_rpl_check(rpl_rx(rpl_src(i), 1, false),
+						NULL), "source %d rejected", i);
+	}
+
+	/* IV Index update: all entries become old */
+	bt_mesh_rpl_reset();
+
+	for (i = 0; i < count; i++) {
+		rpl = bt_mesh_rpl_find(rpl_src(i));
+		zassert_not_null(rpl, "source %d lost", i);
+		zassert_true(rpl->old_iv, "source %d not old", i);
+	}
+
+	/* Odd sources send with the new IV Index */
+	for (i = 1; i < count; i += 2) {
+		zassert_false(bt_mesh_rpl_check(rpl_rx(rpl_src(i), 1, false),
+						NULL), "source %d rejected", i);
+	}
+
+	/* Next IV Index update drops the even ones */
+	bt_mesh_rpl_reset();
+
+	for (i = 0; i < count; i++) {
+		rpl = bt_mesh_rpl_find(rpl_src(i));
+
+		if (i & 1) {
+			zassert_not_null(rpl, "source %d lost", i);
+			zassert_true(rpl->old_iv, "source %d not old", i);
+		} else {
+			zassert_is_null(rpl, "source %d not dropped", i);
+		}
+	}
+}
+
+#define SEG_TX_SEGS  12
+#define SEG_TX_TTL   2
+
+static K_SEM_DEFINE(seg_tx_sem, 0, 1);
+static int seg_tx_err;
+
+static void seg_tx_end(int err, void *cb_data)
+{
+	seg_tx_err = err;
+	k_sem_give(&seg_tx_sem);
+}
+
+static const struct bt_mesh_send_cb seg_tx_cb = {
+	.end = seg_tx_end,
+};
+
+/* Send a segmented control message of the given number of segments to
+ * the peer and return the sequence number of the first segment. Every
+ * transmitted segment takes the next sequence number, which is how the
+ * tests count the segments that have been sent.
+ */
+static uint32_t seg_tx_send(int segs)
+{
+	static uint8_t data[8 * CONFIG_BT_MESH_TX_SEG_MAX];
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = 0,
+		.addr = PEER_ADDR,
+		.send_ttl = SEG_TX_TTL,
+	};
+	struct bt_mesh_net_tx tx = {
+		.sub = bt_mesh_subnet_get(0),
+		.ctx = &ctx,
+		.src = LOCAL_ADDR,
+		.xmit = bt_mesh_net_transmit_get(),
+	};
+	uint32_t seq = bt_mesh.seq;
+
+	zassert_ok(bt_mesh_ctl_send(&tx, TRANS_CTL_OP_HEARTBEAT, data,
+				    8 * segs, &seg_tx_cb, NULL),
+		   "send failed");
+
+	return seq;
+}
+
+static void seg_ack_recv(uint32_t seq_zero, uint32_t block)
+{
+	static uint32_t peer_seq = 1;
+	uint8_t pdu[7];
+
+	pdu[0] = TRANS_CTL_OP_ACK;
+	sys_put_be16((seq_zero & TRANS_SEQ_ZERO_MASK) << 2, &pdu[1]);
+	sys_put_be32(block, &pdu[3]);
+
+	net_pdu_recv(PEER_ADDR, LOCAL_ADDR, peer_seq++, SEG_TX_TTL, true, pdu,
+		     sizeof(pdu));
+}
+
+static void test_seg_tx_window(void)
+{
+	uint32_t seq;
+
+	bt_mesh_rpl_clear();
+	k_sem_reset(&seg_tx_sem);
+
+	/* Keep the advertiser from sending anything until the state right
+	 * after starting the transfer has been checked.
+	 */
+	k_sched_lock();
+
+	seq = seg_tx_send(SEG_TX_SEGS);
+	zassert_equal(bt_mesh.seq - seq, CONFIG_BT_MESH_TX_SEG_WINDOW,
+		      "window not applied");
+
+	/* An ack while segments are queued must not start another attempt */
+	seg_ack_recv(seq, BIT_MASK(4));
+	zassert_equal(bt_mesh.seq - seq, CONFIG_BT_MESH_TX_SEG_WINDOW,
+		      "new attempt on top of queued segments");
+
+	k_sched_unlock();
+
+	/* The window moves on as segments go out, skipping acked ones */
+	k_sleep(K_MSEC(100));
+	zassert_equal(bt_mesh.seq - seq, SEG_TX_SEGS - 2,
+		      "first attempt incomplete");
+
+	/* Only the unacked segments are retransmitted */
+	k_sleep(K_MSEC(CONFIG_BT_MESH_TX_SEG_RETRANS_TIMEOUT_UNICAST +
+		       50 * SEG_TX_TTL));
+	zassert_equal(bt_mesh.seq - seq, 2 * SEG_TX_SEGS - 6,
+		      "retransmission not limited to unacked segments");
+
+	seg_ack_recv(seq, BIT_MASK(SEG_TX_SEGS));
+	zassert_ok(k_sem_take(&seg_tx_sem, K_NO_WAIT), "not completed");
+	zassert_ok(seg_tx_err, "completed with error");
+
+	/* Nothing is sent once the message has been acked */
+	seq = bt_mesh.seq;
+	k_sleep(K_MSEC(CONFIG_BT_MESH_TX_SEG_RETRANS_TIMEOUT_UNICAST +
+		       50 * SEG_TX_TTL));
+	zassert_equal(bt_mesh.seq, seq, "sent after completion");
+}
+
+static void test_seg_tx_ack_queued(void)
+{
+	uint32_t seq;
+
+	k_sem_reset(&seg_tx_sem);
+	k_sched_lock();
+
+	/* The whole attempt fits in the window and is queued */
+	seq = seg_tx_send(CONFIG_BT_MESH_TX_SEG_WINDOW);
+	zassert_equal(bt_mesh.seq - seq, CONFIG_BT_MESH_TX_SEG_WINDOW,
+		      "attempt not queued");
+
+	/* Queueing the unacked segments again would send them twice */
+	seg_ack_recv(seq, BIT(0));
+	zassert_equal(bt_mesh.seq - seq, CONFIG_BT_MESH_TX_SEG_WINDOW,
+		      "queued segments sent again");
+
+	k_sched_unlock();
+
+	k_sleep(K_MSEC(100));
+	zassert_equal(bt_mesh.seq - seq, CONFIG_BT_MESH_TX_SEG_WINDOW,
+		      "retransmitted before the timeout");
+
+	k_sleep(K_MSEC(CONFIG_BT_MESH_TX_SEG_RETRANS_TIMEOUT_UNICAST +
+		       50 * SEG_TX_TTL));
+	zassert_equal(bt_mesh.seq - seq, 2 * CONFIG_BT_MESH_TX_SEG_WINDOW - 1,
+		      "unacked segments not retransmitted");
+
+	seg_ack_recv(seq, BIT_MASK(CONFIG_BT_MESH_TX_SEG_WINDOW));
+	zassert_ok(k_sem_take(&seg_tx_sem, K_NO_WAIT), "not completed");
+	zassert_ok(seg_tx_err, "completed with error");
+}
+
+static void test_seg_tx_retransmit(void)
+{
+	uint32_t seq;
+
+	k_sem_reset(&seg_tx_sem);
+
+	seq = seg_tx_send(3);
+
+	zassert_ok(k_sem_take(&seg_tx_sem, K_SECONDS(10)), "not completed");
+	zassert_equal(seg_tx_err, -ETIMEDOUT, "unexpected result");
+	zassert_equal(bt_mesh.seq - seq,
+		      3 * CONFIG_BT_MESH_TX_SEG_RETRANS_COUNT,
+		      "wrong number of transmissions");
+}
+
+void test_main(void)
+{
+	zassert_ok(bt_mesh_init(&prov, &comp), "init failed");
+	zassert_ok(bt_mesh_provision(net_key, 0, 0, 0, LOCAL_ADDR, dev_key),
+		   "provisioning failed");
+
+	bt_test_cb_register(&test_cb);
+
+	ztest_test_suite(test_mesh_net,
+			 ztest_unit_test(test_msg_cache_dup),
+			 ztest_unit_test(test_msg_cache_evict),
+			 ztest_unit_test(test_rpl_check),
+			 ztest_unit_test(test_rpl_collisions),
+			 ztest_unit_test(test_rpl_reset),
+			 ztest_unit_test(test_seg_tx_window),
+			 ztest_unit_test(test_seg_tx_ack_queued),
+			 ztest_unit_test(test_seg_tx_retransmit));
+	ztest_run_test_suite(test_mesh_net);
+}
@@ -297,6 +297,42 @@ static void test_double_write(void)
 	zassert_equal(-EIO, rc, "Unexpected error code (%d)", rc);
 }
 
+#ifdef CONFIG_FLASH_MMAP_API
+static void test_mmap(void)
+{
+	const uint8_t *mapped;
+	uint32_t val32 = 0x12345678;
+	int rc;
+
+	rc = flash_erase(flash_dev, FLASH_SIMULATOR_BASE_OFFSET,
+			 FLASH_SIMULATOR_ERASE_UNIT);
+	zassert_equal(0, rc, "flash_erase should succeed");
+
+	rc = flash_write(flash_dev, FLASH_SIMULATOR_BASE_OFFSET + 4,
+			 &val32, sizeof(val32));
+	zassert_equal(0, rc, "flash_write should succeed");
+
+	rc = flash_mmap(flash_dev, FLASH_SIMULATOR_BASE_OFFSET,
+			FLASH_SIMULATOR_ERASE_UNIT, (const void **)&mapped);
+	zassert_equal(0, rc, "flash_mmap should succeed");
+
+	rc = flash_read(flash_dev, FLASH_SIMULATOR_BASE_OFFSET,
+			test_read_buf, FLASH_SIMULATOR_ERASE_UNIT);
+	zassert_equal(0, rc, "flash_read should succeed");
+	zassert_mem_equal(mapped, test_read_buf, FLASH_SIMULATOR_ERASE_UNIT,
+			  "mapped flash differs from read flash");
+
+	rc = flash_mmap(flash_dev, TEST_SIM_FLASH_END - 4, 8,
+			(const void **)&mapped);
+	zassert_equal(-EINVAL, rc, "Unexpected error code (%d)", rc);
+}
+#else
+static void test_mmap(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 static void test_get_erase_value(void)
 {
 	const struct flash_parameters *fp = flash_get_parameters(flash_dev);
@@ -317,6 +353,7 @@ void test_main(void)
 			 ztest_unit_test(test_out_of_bounds),
 			 ztest_unit_test(test_align),
 			 ztest_unit_test(test_get_erase_value),
+			 ztest_unit_test(test_mmap),
 			 ztest_unit_test(test_double_write));
 
 	ztest_run_test_suite(flash_sim_api);
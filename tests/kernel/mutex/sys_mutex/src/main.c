@@ -64,9 +64,13 @@ ZTEST_BMEM SYS_MUTEX_DEFINE(mutex_4);
 
 #ifdef CONFIG_USERSPACE
 static SYS_MUTEX_DEFINE(no_access_mutex);
+static K_THREAD_STACK_DEFINE(dead_thread_stack, STACKSIZE);
+static struct k_thread dead_thread;
 #endif
 static ZTEST_BMEM SYS_MUTEX_DEFINE(not_my_mutex);
 static ZTEST_BMEM SYS_MUTEX_DEFINE(bad_count_mutex);
+static ZTEST_BMEM SYS_MUTEX_DEFINE(fast_mutex);
+static ZTEST_BMEM SYS_MUTEX_DEFINE(forged_mutex);
 
 /**
  *
@@ -397,6 +401,73 @@ void test_user_access(void)
 #endif /* CONFIG_USERSPACE */
 }
 
+void test_uncontended(void)
+{
+#ifdef CONFIG_USERSPACE
+	int rv;
+
+	/* Without waiters the owner word is all the state there is */
+	rv = sys_mutex_lock(&fast_mutex, K_NO_WAIT);
+	zassert_equal(rv, 0, "failed to lock mutex");
+	zassert_not_equal(atomic_get(&fast_mutex.owner), 0,
+			  "owner not recorded");
+	rv = sys_mutex_lock(&fast_mutex, K_NO_WAIT);
+	zassert_equal(rv, 0, "failed to lock mutex recursively");
+	zassert_equal(fast_mutex.lock_count, 2, "bad lock count");
+
+	rv = sys_mutex_unlock(&fast_mutex);
+	zassert_equal(rv, 0, "failed to unlock mutex");
+	zassert_not_equal(atomic_get(&fast_mutex.owner), 0,
+			  "mutex released too early");
+	rv = sys_mutex_unlock(&fast_mutex);
+	zassert_equal(rv, 0, "failed to unlock mutex");
+	zassert_equal(atomic_get(&fast_mutex.owner), 0,
+		      "mutex not released");
+	rv = sys_mutex_unlock(&fast_mutex);
+	zassert_equal(rv, -EINVAL, "unlocked mutex that wasn't locked");
+#else
+	ztest_test_skip();
+#endif /* CONFIG_USERSPACE */
+}
+
+#ifdef CONFIG_USERSPACE
+static void dead_thread_entry(void *p1, void *p2, void *p3)
+{
+	/* Exit without unlocking */
+	(void)sys_mutex_lock(&forged_mutex, K_NO_WAIT);
+}
+#endif
+
+void test_forged_owner(void)
+{
+#ifdef CONFIG_USERSPACE
+	int rv;
+
+	/* The owner word is in user memory, the kernel must not boost
+	 * whatever it designates
+	 */
+	atomic_set(&forged_mutex.owner, (atomic_val_t)~Z_SYS_MUTEX_CONTENDED);
+	rv = sys_mutex_lock(&forged_mutex, K_MSEC(100));
+	zassert_equal(rv, -EINVAL, "accepted owner that was not a thread");
+	atomic_clear(&forged_mutex.owner);
+
+	k_thread_create(&dead_thread, dead_thread_stack, STACKSIZE,
+			dead_thread_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), K_USER | K_INHERIT_PERMS,
+			K_NO_WAIT);
+	k_thread_join(&dead_thread, K_FOREVER);
+
+	zassert_not_equal(atomic_get(&forged_mutex.owner), 0,
+			  "mutex not locked by the exited thread");
+	rv = sys_mutex_lock(&forged_mutex, K_MSEC(100));
+	zassert_equal(rv, -EINVAL, "accepted owner that was dead");
+
+	atomic_clear(&forged_mutex.owner);
+#else
+	ztest_test_skip();
+#endif /* CONFIG_USERSPACE */
+}
+
 K_THREAD_DEFINE(THREAD_05, STACKSIZE, thread_05, NULL, NULL, NULL,
 		5, K_USER, 0);
 
@@ -422,7 +493,8 @@ void test_main(void)
 
 #ifdef CONFIG_USERSPACE
 	k_thread_access_grant(k_current_get(),
-			      &thread_12_thread_data, &thread_12_stack_area);
+			      &thread_12_thread_data, &thread_12_stack_area,
+			      &dead_thread, &dead_thread_stack);
 #endif
 	rv = sys_mutex_lock(&not_my_mutex, K_NO_WAIT);
 	if (rv != 0) {
@@ -439,6 +511,8 @@ void test_main(void)
 	ztest_test_suite(mutex_complex,
 			 ztest_1cpu_user_unit_test(test_mutex),
 			 ztest_user_unit_test(test_user_access),
+			 ztest_user_unit_test(test_uncontended),
+			 ztest_user_unit_test(test_forged_owner),
 			 ztest_unit_test(test_supervisor_access));
 
 	ztest_run_test_suite(mutex_complex);
@@ -446,6 +520,8 @@ void test_main(void)
 	ztest_test_suite(mutex_complex,
 			 ztest_1cpu_unit_test(test_mutex),
 			 ztest_unit_test(test_user_access),
+			 ztest_unit_test(test_uncontended),
+			 ztest_unit_test(test_forged_owner),
 			 ztest_unit_test(test_supervisor_access));
 
 	ztest_run_test_suite(mutex_complex);
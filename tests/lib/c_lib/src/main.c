@@ -474,6 +474,83 @@ void test_memstr(void)
 		     "memmove failed");
 }
 
+/**
+ *
+ * @brief Test memory functions across buffer sizes and alignments
+ *
+ * @see memcpy(), memmove(), memset(), memcmp(), memchr(), strlen().
+ *
+ */
+#define ALIGN_TEST_MAX 48
+
+static unsigned char align_src[ALIGN_TEST_MAX + 16];
+static unsigned char align_dst[ALIGN_TEST_MAX + 16];
+
+static void align_fill(void)
+{
+	for (int i = 0; i < sizeof(align_src); i++) {
+		align_src[i] = 1 + (i * 37) % 251;
+		align_dst[i] = 0xee;
+	}
+}
+
+void test_mem_align(void)
+{
+	for (int so = 0; so < 8; so++) {
+		for (int dof = 0; dof < 8; dof++) {
+			for (int n = 0; n <= ALIGN_TEST_MAX; n++) {
+				/* Leave a guard byte in front */
+				unsigned char *s = align_src + 1 + so;
+				unsigned char *d = align_dst + 1 + dof;
+
+				align_fill();
+				zassert_equal(memcpy(d, s, n), d, "memcpy");
+				zassert_equal(memcmp(d, s, n), 0,
+					      "memcpy %d %d %d", so, dof, n);
+				zassert_equal(d[-1], 0xee, "memcpy underrun");
+				zassert_equal(d[n], 0xee, "memcpy overrun");
+
+				if (n > 0) {
+					d[n - 1]++;
+					zassert_true(memcmp(d, s, n) > 0,
+						     "memcmp %d %d %d", so,
+						     dof, n);
+					zassert_true(memcmp(s, d, n) < 0,
+						     "memcmp %d %d %d", so,
+						     dof, n);
+				}
+
+				zassert_equal(memset(d, 0x5a, n), d, "memset");
+				zassert_equal(d[-1], 0xee, "memset underrun");
+				zassert_equal(d[n], 0xee, "memset overrun");
+				zassert_equal(memchr(d, 0x5a, n),
+					      (n > 0) ? d : NULL, "memchr");
+				if (n > 0) {
+					zassert_equal(memchr(s, s[n - 1], n),
+						      s + n - 1, "memchr %d %d",
+						      so, n);
+				}
+				zassert_is_null(memchr(s, 0, n), "memchr");
+
+				s[n] = '\0';
+				zassert_equal(strlen(s), n, "strlen %d %d",
+					      so, n);
+
+				/* Overlapping, both ways */
+				align_fill();
+				memmove(align_src + dof, s, n);
+				for (int i = 0; i < n; i++) {
+					zassert_equal(align_src[dof + i],
+						      1 + ((1 + so + i) * 37) %
+						      251,
+						      "memmove %d %d %d", so,
+						      dof, n);
+				}
+			}
+		}
+	}
+}
+
 /**
  *
  * @brief test str operate functions
@@ -619,6 +696,7 @@ void test_main(void)
 			 ztest_unit_test(test_atoi),
 			 ztest_unit_test(test_checktype),
 			 ztest_unit_test(test_memstr),
+			 ztest_unit_test(test_mem_align),
 			 ztest_unit_test(test_str_operate),
 			 ztest_unit_test(test_tolower_toupper),
 			 ztest_unit_test(test_strtok_r)
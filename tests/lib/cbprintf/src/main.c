@@ -0,0 +1,176 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <sys/cbprintf.h>
+
+struct out_buf {
+	char buf[128];
+	size_t len;
+	int calls;
+	int fail_at;
+};
+
+static int out(const char *str, size_t len, void *ctx)
+{
+	struct out_buf *ob = ctx;
+
+	if (++ob->calls == ob->fail_at) {
+		return -EIO;
+	}
+
+	zassert_true(ob->len + len < sizeof(ob->buf), "output too long");
+	memcpy(&ob->buf[ob->len], str, len);
+	ob->len += len;
+	ob->buf[ob->len] = '\0';
+
+	return 0;
+}
+
+/* Not checked by the compiler, to test invalid formats */
+static int unchecked_cbprintf(struct out_buf *ob, const char *fmt, ...)
+{
+	va_list ap;
+	int ret;
+
+	va_start(ap, fmt);
+	ret = cbvprintf(out, ob, fmt, ap);
+	va_end(ap);
+
+	return ret;
+}
+
+static void test_cbprintf(void)
+{
+	struct out_buf ob = { 0 };
+	int ret;
+
+	ret = cbprintf(out, &ob, "%s: %d %u 0x%08x %-4s| %c%%%5d %lld %zu",
+		       "values", -42, 42U, 0xbeefU, "ab", 'z', 7, -5LL,
+		       (size_t)3);
+	zassert_equal(ret, ob.len, "wrong count %d", ret);
+	zassert_true(!strcmp(ob.buf,
+			     "values: -42 42 0x0000beef ab  | z%    7 -5 3"),
+		     "wrong output '%s'", ob.buf);
+
+	memset(&ob, 0, sizeof(ob));
+	ret = cbprintf(out, &ob, "plain text with no conversion");
+	zassert_equal(ret, 29, "wrong count %d", ret);
+	zassert_equal(ob.calls, 1, "literal run not output in one span");
+
+	memset(&ob, 0, sizeof(ob));
+	ret = unchecked_cbprintf(&ob, "%q %hlx trailing %");
+	zassert_true(!strcmp(ob.buf, "%q %lx trailing "),
+		     "wrong output '%s'", ob.buf);
+
+	memset(&ob, 0, sizeof(ob));
+	ob.fail_at = 2;
+	ret = cbprintf(out, &ob, "a %d b", 1);
+	zassert_equal(ret, -EIO, "output error not returned");
+	zassert_equal(ob.calls, 2, "formatting not aborted");
+}
+
+static void test_cbprintf_package(void)
+{
+	struct out_buf ob = { 0 };
+	uint8_t packaged[64];
+	char str[] = "copied";
+	int len;
+	int ret;
+
+	len = cbprintf_package(NULL, 0, "%s %d %llx %p %c", str, 1,
+			       0x123456789ULL, (void *)0x10, 'c');
+	zassert_true(len > 0, "size not computed");
+
+	ret = cbprintf_package(packaged, len - 1, "%s %d %llx %p %c", str,
+			       1, 0x123456789ULL, (void *)0x10, 'c');
+	zassert_equal(ret, -ENOSPC, "package too large for the buffer");
+
+	ret = cbprintf_package(packaged, sizeof(packaged), "%s %d %llx %p %c",
+			       str, 1, 0x123456789ULL, (void *)0x10, 'c');
+	zassert_equal(ret, len, "size mismatch");
+	zassert_equal(cbprintf_package_len(packaged), len,
+		      "size not recorded in the package");
+
+	/* Strings are captured by value */
+	memset(str, 'x', sizeof(str) - 1);
+
+	ret = cbpprintf(out, &ob, packaged);
+	zassert_equal(ret, ob.len, "wrong count %d", ret);
+	zassert_true(!strncmp(ob.buf, "copied 1 123456789 0x", 21),
+		     "wrong output '%s'", ob.buf);
+	zassert_equal(ob.buf[ob.len - 1], 'c', "wrong output '%s'", ob.buf);
+}
+
+static void test_snprintk(void)
+{
+	char buf[8];
+	int ret;
+
+	ret = snprintk(buf, sizeof(buf), "%s%d", "abcdef", 1234);
+	zassert_equal(ret, 10, "wrong count %d", ret);
+	zassert_true(!strcmp(buf, "abcdef1"), "wrong output '%s'", buf);
+
+	ret = snprintk(buf, sizeof(buf), "%d", 12);
+	zassert_equal(ret, 2, "wrong count %d", ret);
+	zassert_true(!strcmp(buf, "12"), "wrong output '%s'", buf);
+
+	ret = snprintk(NULL, 0, "%08x", 1);
+	zassert_equal(ret, 8, "wrong count %d", ret);
+}
+
+void __printk_hook_install(int (*fn)(int));
+void __printk_str_hook_install(int (*fn)(const char *str, size_t len));
+void *__printk_get_hook(void);
+
+static struct out_buf hook_ob;
+static int hook_chars;
+
+static int hook_char_out(int c)
+{
+	hook_chars++;
+
+	return c;
+}
+
+static int hook_str_out(const char *str, size_t len)
+{
+	return out(str, len, &hook_ob);
+}
+
+static void test_printk_str_hook(void)
+{
+	int (*old_char_out)(int) = __printk_get_hook();
+
+	memset(&hook_ob, 0, sizeof(hook_ob));
+	hook_chars = 0;
+
+	__printk_hook_install(hook_char_out);
+	__printk_str_hook_install(hook_str_out);
+
+	printk("span %d output\n", 42);
+	k_str_out("direct", 6);
+
+	__printk_hook_install(hook_char_out);
+	printk("chars");
+
+	__printk_hook_install(old_char_out);
+
+	zassert_true(!strcmp(hook_ob.buf, "span 42 output\ndirect"),
+		     "wrong output '%s'", hook_ob.buf);
+	zassert_equal(hook_ob.calls, 4, "output not passed on in spans");
+	zassert_equal(hook_chars, 5, "character hook not reinstated");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(cbprintf,
+			 ztest_unit_test(test_cbprintf),
+			 ztest_unit_test(test_cbprintf_package),
+			 ztest_unit_test(test_snprintk),
+			 ztest_unit_test(test_printk_str_hook)
+			 );
+	ztest_run_test_suite(cbprintf);
+}
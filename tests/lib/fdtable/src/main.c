@@ -172,6 +172,61 @@ void test_z_fd_multiple_access(void)
 	zassert_equal(errno, EBADF, "fd was found");
 }
 
+void test_z_reserve_fd_exhaustion(void)
+{
+	int fds[CONFIG_POSIX_MAX_FDS];
+	int count = 0;
+	int fd;
+
+	while ((fd = z_reserve_fd()) >= 0) {
+		zassert_true(count < ARRAY_SIZE(fds), "too many fds");
+		fds[count++] = fd;
+	}
+	zassert_equal(errno, ENFILE, "unexpected errno");
+
+	/* A freed descriptor is the one allocated next */
+	z_free_fd(fds[count / 2]);
+	fd = z_reserve_fd();
+	zassert_equal(fd, fds[count / 2], "freed fd not reused");
+
+	for (int i = 0; i < count; i++) {
+		z_free_fd(fds[i]);
+	}
+}
+
+void test_z_get_fd_ref(void)
+{
+	const struct fd_op_vtable *vtable;
+	void *obj;
+	int fd;
+
+	fd = z_reserve_fd();
+	zassert_true(fd >= 0, "fd < 0");
+
+	/* Not finalized yet */
+	zassert_equal(z_get_fd_ref(fd, &obj, &vtable), -1, NULL);
+	zassert_equal(errno, EBADF, NULL);
+
+	z_finalize_fd(fd, (void *)&fd, VTABLE_INIT);
+	zassert_equal(z_get_fd_ref(fd, &obj, &vtable), 0, NULL);
+	zassert_equal_ptr(obj, &fd, NULL);
+	zassert_equal_ptr(vtable, VTABLE_INIT, NULL);
+
+	/* Freed while referenced: lookups fail, but the fd is not reused */
+	z_free_fd(fd);
+	zassert_equal(z_get_fd_ref(fd, &obj, &vtable), -1, NULL);
+	zassert_is_null(z_get_fd_obj(fd, NULL, 0), NULL);
+	zassert_not_equal(z_reserve_fd(), fd, "referenced fd reused");
+
+	z_put_fd_ref(fd);
+	zassert_equal(z_reserve_fd(), fd, "released fd not reused");
+	z_free_fd(fd);
+
+	zassert_equal(z_get_fd_ref(-1, &obj, &vtable), -1, NULL);
+	zassert_equal(z_get_fd_ref(CONFIG_POSIX_MAX_FDS, &obj, &vtable), -1,
+		      NULL);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_fdtable,
@@ -181,7 +236,9 @@ void test_main(void)
 			 ztest_unit_test(test_z_finalize_fd),
 			 ztest_unit_test(test_z_alloc_fd),
 			 ztest_unit_test(test_z_free_fd),
-			 ztest_unit_test(test_z_fd_multiple_access)
+			 ztest_unit_test(test_z_fd_multiple_access),
+			 ztest_unit_test(test_z_reserve_fd_exhaustion),
+			 ztest_unit_test(test_z_get_fd_ref)
 		);
 	ztest_run_test_suite(test_fdtable);
 }
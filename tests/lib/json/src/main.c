@@ -381,6 +381,19 @@ static void test_json_invalid_null(void)
 	parse_harness(encoded, ARRAY_SIZE(encoded));
 }
 
+static void test_json_invalid_string_nul(void)
+{
+	struct test_struct ts;
+	/* NUL past the first words of the string, scanned a word at a time */
+	char encoded[] = "{\"some_string\":\"abcdefghijklmnopqrstuvw\0xyz\"}";
+	int ret;
+
+	ret = json_obj_parse(encoded, sizeof(encoded) - 1, test_descr,
+			     ARRAY_SIZE(test_descr), &ts);
+
+	zassert_equal(ret, -EINVAL, "Decoding has to fail");
+}
+
 static void test_json_invalid_number(void)
 {
 	struct encoding_test encoded[] = {
@@ -539,6 +552,217 @@ static void test_json_encode_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check rejected");
 }
 
+static int stream_parse(const char *json, size_t len, size_t chunk,
+			const struct json_obj_descr *descr, size_t descr_len,
+			void *val, char *buf, size_t buf_size)
+{
+	struct json_obj_stream stream;
+	int ret = -EAGAIN;
+
+	json_obj_stream_init(&stream, descr, descr_len, val, buf, buf_size);
+
+	for (size_t i = 0; i < len; i += chunk) {
+		ret = json_obj_stream_feed(&stream, &json[i],
+					   MIN(chunk, len - i));
+	}
+
+	return ret;
+}
+
+static void test_json_stream_decoding(void)
+{
+	struct test_struct ts;
+	char buf[128];
+	const char encoded[] = "{\"some_string\":\"zephyr 123\\uABCD456\","
+		"\"some_int\":\t42\n,"
+		"\"unknown\":{\"a\":[1,{\"b\":\"}]\\\"\"}],\"c\":null},"
+		"\"some_bool\":true    \t  "
+		"\n"
+		"\r   ,"
+		"\"some_nested_struct\":{    "
+		"\"nested_int\":-1234,\n\n"
+		"\"nested_bool\":false,\t"
+		"\"nested_string\":\"this should be escaped: \\t\"},"
+		"\"some_array\":[11,22, 33,\t45,\n299]"
+		"\"another_b!@l\":true,"
+		"\"if\":false,"
+		"\"another-array\":[2,3,5,7],"
+		"\"4nother_ne$+\":{\"nested_int\":1234,"
+		"\"nested_bool\":true,"
+		"\"nested_string\":\"no escape necessary\"}"
+		"}\n";
+	const int expected_array[] = { 11, 22, 33, 45, 299 };
+	const int expected_other_array[] = { 2, 3, 5, 7 };
+	int ret;
+
+	/* Every chunk size splits the tokens at different places */
+	for (size_t chunk = 1; chunk < sizeof(encoded); chunk++) {
+		memset(&ts, 0, sizeof(ts));
+
+		ret = stream_parse(encoded, sizeof(encoded) - 1, chunk,
+				   test_descr, ARRAY_SIZE(test_descr), &ts,
+				   buf, sizeof(buf));
+
+		zassert_equal(ret, (1 << ARRAY_SIZE(test_descr)) - 1,
+			      "All fields decoded with %zu byte chunks", chunk);
+		zassert_true(!strcmp(ts.some_string, "zephyr 123\\uABCD456"),
+			     "String decoded correctly");
+		zassert_equal(ts.some_int, 42,
+			      "Positive integer decoded correctly");
+		zassert_equal(ts.some_bool, true, "Boolean decoded correctly");
+		zassert_equal(ts.some_nested_struct.nested_int, -1234,
+			      "Nested negative integer decoded correctly");
+		zassert_equal(ts.some_nested_struct.nested_bool, false,
+			      "Nested boolean value decoded correctly");
+		zassert_true(!strcmp(ts.some_nested_struct.nested_string,
+				     "this should be escaped: \\t"),
+			     "Nested string decoded correctly");
+		zassert_equal(ts.some_array_len, 5,
+			      "Array has correct number of items");
+		zassert_true(!memcmp(ts.some_array, expected_array,
+				     sizeof(expected_array)),
+			     "Array decoded with expected values");
+		zassert_true(ts.another_bxxl,
+			     "Named boolean (special chars) decoded correctly");
+		zassert_false(ts.if_,
+			      "Named boolean (reserved word) decoded correctly");
+		zassert_equal(ts.another_array_len, 4,
+			      "Named array has correct number of items");
+		zassert_true(!memcmp(ts.another_array, expected_other_array,
+				     sizeof(expected_other_array)),
+			     "Decoded named array with expected values");
+		zassert_equal(ts.xnother_nexx.nested_int, 1234,
+			      "Named nested integer decoded correctly");
+		zassert_equal(ts.xnother_nexx.nested_bool, true,
+			      "Named nested boolean decoded correctly");
+		zassert_true(!strcmp(ts.xnother_nexx.nested_string,
+				     "no escape necessary"),
+			     "Named nested string decoded correctly");
+	}
+}
+
+static void test_json_stream_obj_arr_decoding(void)
+{
+	struct obj_array oa;
+	struct obj_array_array oaa;
+	char buf[128];
+	const char encoded[] = "{\"elements\":["
+		"{\"name\":\"Simón Bolívar\",\"height\":168},"
+		"{\"name\":\"Pelé\",\"height\":173},"
+		"{\"name\":\"Usain Bolt\",\"height\":195}"
+		"]}";
+	const char encoded_array_array[] = "{\"objects_array\":["
+		"[{\"height\":168,\"name\":\"Simón Bolívar\"}],"
+		"[{\"height\":173,\"name\":\"Pelé\"}],"
+		"[{\"height\":195,\"name\":\"Usain Bolt\"}]]"
+		"}";
+	int ret;
+
+	for (size_t chunk = 1; chunk < sizeof(encoded); chunk++) {
+		ret = stream_parse(encoded, sizeof(encoded) - 1, chunk,
+				   obj_array_descr, ARRAY_SIZE(obj_array_descr),
+				   &oa, buf, sizeof(buf));
+
+		zassert_equal(ret, 1, "Array of objects decoded with %zu "
+			      "byte chunks", chunk);
+		zassert_equal(oa.num_elements, 3,
+			      "Number of object fields decoded correctly");
+		zassert_true(!strcmp(oa.elements[1].name, "Pelé"),
+			     "String decoded correctly");
+		zassert_equal(oa.elements[2].height, 195,
+			      "Usain Bolt height decoded correctly");
+	}
+
+	for (size_t chunk = 1; chunk < sizeof(encoded_array_array); chunk++) {
+		ret = stream_parse(encoded_array_array,
+				   sizeof(encoded_array_array) - 1, chunk,
+				   array_array_descr,
+				   ARRAY_SIZE(array_array_descr), &oaa,
+				   buf, sizeof(buf));
+
+		zassert_equal(ret, 1, "Array of arrays decoded with %zu "
+			      "byte chunks", chunk);
+		zassert_equal(oaa.objects_array_len, 3,
+			      "Number of arrays decoded correctly");
+		zassert_true(!strcmp(oaa.objects_array[1].objects.name,
+				     "Pelé"), "String decoded correctly");
+		zassert_equal(oaa.objects_array[2].objects.height, 195,
+			      "Usain Bolt height decoded correctly");
+	}
+}
+
+static void test_json_stream_invalid(void)
+{
+	struct encoding_test encoded[] = {
+		{ "{\"some_string\":\"\\uABC@\"}", -EINVAL },
+		{ "{\"some_string\":\"\\X\"}", -EINVAL },
+		{ "{\"some_bool\":truffle }", -EINVAL },
+		{ "{\"some_string\":null }", -EINVAL },
+		{ "{\"some_int\":xxx }", -EINVAL },
+		{ "{\"some_int\":-x }", -EINVAL },
+		{ "{\"some_int\":1.5 }", -EINVAL },
+		{ "{\"some_int\":123456789012 }", -ERANGE },
+		{ "{\"some_string\",}", -EINVAL },
+		{ "{\"some_string\":false}", -EINVAL },
+		{ "{\"some_array\":[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17]}",
+		  -ENOSPC },
+		{ "{\"some_string\":\"this does not fit the buffer\"}",
+		  -ENOMEM },
+		{ "{\"some_string", -EAGAIN },
+		{ "{\"key_not_in_descr\":[{}, \"]\"]}", 0 },
+	};
+	struct test_struct ts;
+	char buf[16];
+	int ret;
+
+	for (int i = 0; i < ARRAY_SIZE(encoded); i++) {
+		size_t len = strlen(encoded[i].str);
+
+		ret = stream_parse(encoded[i].str, len, 1, test_descr,
+				   ARRAY_SIZE(test_descr), &ts,
+				   buf, sizeof(buf));
+		zassert_equal(ret, encoded[i].result,
+			      "Decoding '%s' result %d, expected %d",
+			      encoded[i].str, ret, encoded[i].result);
+
+		ret = stream_parse(encoded[i].str, len, len, test_descr,
+				   ARRAY_SIZE(test_descr), &ts,
+				   buf, sizeof(buf));
+		zassert_equal(ret, encoded[i].result,
+			      "Decoding '%s' result %d, expected %d",
+			      encoded[i].str, ret, encoded[i].result);
+	}
+}
+
+static void test_json_stream_feed(void)
+{
+	struct json_obj_stream stream;
+	struct test_struct ts;
+	char buf[4];
+	int ret;
+
+	json_obj_stream_init(&stream, test_descr, ARRAY_SIZE(test_descr),
+			     &ts, buf, sizeof(buf));
+
+	ret = json_obj_stream_feed(&stream, "{\"some_string\":\"a", 17);
+	zassert_equal(ret, -EAGAIN, "Incomplete object");
+	ret = json_obj_stream_feed(&stream, "", 0);
+	zassert_equal(ret, -EAGAIN, "Empty chunk accepted");
+	ret = json_obj_stream_feed(&stream, "bc\"}trailing", 12);
+	zassert_equal(ret, 1, "Object complete, trailing data ignored");
+	zassert_true(!strcmp(ts.some_string, "abc"), "String fits buffer");
+	ret = json_obj_stream_feed(&stream, "{", 1);
+	zassert_equal(ret, 1, "Complete object not parsed again");
+
+	json_obj_stream_init(&stream, test_descr, ARRAY_SIZE(test_descr),
+			     &ts, buf, sizeof(buf));
+
+	ret = json_obj_stream_feed(&stream, "{\"some_int\":x", 13);
+	zassert_equal(ret, -EINVAL, "Invalid number");
+	ret = json_obj_stream_feed(&stream, "}", 1);
+	zassert_equal(ret, -EINVAL, "Error is final");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -550,6 +774,7 @@ void test_main(void)
 			 ztest_unit_test(test_json_invalid_string),
 			 ztest_unit_test(test_json_invalid_bool),
 			 ztest_unit_test(test_json_invalid_null),
+			 ztest_unit_test(test_json_invalid_string_nul),
 			 ztest_unit_test(test_json_invalid_number),
 			 ztest_unit_test(test_json_missing_quote),
 			 ztest_unit_test(test_json_wrong_token),
@@ -560,7 +785,11 @@ void test_main(void)
 			 ztest_unit_test(test_json_escape_empty),
 			 ztest_unit_test(test_json_escape_no_op),
 			 ztest_unit_test(test_json_escape_bounds_check),
-			 ztest_unit_test(test_json_encode_bounds_check)
+			 ztest_unit_test(test_json_encode_bounds_check),
+			 ztest_unit_test(test_json_stream_decoding),
+			 ztest_unit_test(test_json_stream_obj_arr_decoding),
+			 ztest_unit_test(test_json_stream_invalid),
+			 ztest_unit_test(test_json_stream_feed)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
@@ -657,6 +657,229 @@ void test_reset(void)
 	zassert_true(granted == RINGBUFFER_SIZE - 1, NULL);
 }
 
+#define SPSC_SIZE 16
+RING_BUF_SPSC_DECLARE(ringbuf_spsc, SPSC_SIZE);
+
+/**
+ * @brief Test the single producer, single consumer ring buffer
+ *
+ * Data passed through in odd sized chunks has to come out unchanged across
+ * the buffer end, and the whole buffer can be filled.
+ *
+ * @see ring_buf_spsc_put(), ring_buf_spsc_get()
+ */
+void test_spsc_put_get(void)
+{
+	uint8_t indata[SPSC_SIZE];
+	uint8_t outdata[SPSC_SIZE];
+	uint8_t seq_in = 0U, seq_out = 0U;
+	uint32_t len;
+
+	ring_buf_spsc_init(&ringbuf_spsc, SPSC_SIZE, ringbuf_spsc.buf);
+
+	for (int i = 0; i < 20; i++) {
+		uint32_t chunk = 1 + (i * 7) % SPSC_SIZE;
+
+		for (int j = 0; j < chunk; j++) {
+			indata[j] = seq_in++;
+		}
+
+		len = ring_buf_spsc_put(&ringbuf_spsc, indata, chunk);
+		zassert_equal(len, chunk, NULL);
+		zassert_equal(ring_buf_spsc_size_get(&ringbuf_spsc), chunk,
+			      NULL);
+
+		len = ring_buf_spsc_get(&ringbuf_spsc, outdata, SPSC_SIZE);
+		zassert_equal(len, chunk, NULL);
+		for (int j = 0; j < chunk; j++) {
+			zassert_equal(outdata[j], seq_out++, NULL);
+		}
+	}
+
+	/* No byte is lost to tell a full buffer from an empty one. */
+	len = ring_buf_spsc_put(&ringbuf_spsc, indata, SPSC_SIZE + 1);
+	zassert_equal(len, SPSC_SIZE, NULL);
+	zassert_equal(ring_buf_spsc_space_get(&ringbuf_spsc), 0, NULL);
+	len = ring_buf_spsc_get(&ringbuf_spsc, outdata, SPSC_SIZE + 1);
+	zassert_equal(len, SPSC_SIZE, NULL);
+	zassert_equal(memcmp(indata, outdata, SPSC_SIZE), 0, NULL);
+}
+
+/**
+ * @brief Test claim and finish of the single producer, single consumer
+ * ring buffer
+ *
+ * @see ring_buf_spsc_put_claim(), ring_buf_spsc_get_claim()
+ */
+void test_spsc_claim_finish(void)
+{
+	uint8_t *data;
+	uint32_t len;
+
+	ring_buf_spsc_init(&ringbuf_spsc, SPSC_SIZE, ringbuf_spsc.buf);
+
+	len = ring_buf_spsc_put_claim(&ringbuf_spsc, &data, 10);
+	zassert_equal(len, 10, NULL);
+	zassert_equal(ring_buf_spsc_put_finish(&ringbuf_spsc, 10), 0, NULL);
+
+	/* Nothing is visible until finished. */
+	len = ring_buf_spsc_put_claim(&ringbuf_spsc, &data, 10);
+	zassert_equal(len, 6, NULL);
+	zassert_equal(ring_buf_spsc_size_get(&ringbuf_spsc), 10, NULL);
+
+	/* Finishing more than the free space fails. */
+	zassert_equal(ring_buf_spsc_put_finish(&ringbuf_spsc, 7), -EINVAL,
+		      NULL);
+	zassert_equal(ring_buf_spsc_get_finish(&ringbuf_spsc, 11), -EINVAL,
+		      NULL);
+
+	zassert_equal(ring_buf_spsc_get_finish(&ringbuf_spsc, 8), 0, NULL);
+
+	/* Claims stop at the buffer end. */
+	len = ring_buf_spsc_put_claim(&ringbuf_spsc, &data, 10);
+	zassert_equal(len, 6, NULL);
+	zassert_equal(data, &ringbuf_spsc.buf[10], NULL);
+	zassert_equal(ring_buf_spsc_put_finish(&ringbuf_spsc, 6), 0, NULL);
+
+	len = ring_buf_spsc_put_claim(&ringbuf_spsc, &data, 10);
+	zassert_equal(len, 8, NULL);
+	zassert_equal(data, ringbuf_spsc.buf, NULL);
+
+	len = ring_buf_spsc_get_claim(&ringbuf_spsc, &data, SPSC_SIZE);
+	zassert_equal(len, 8, NULL);
+	zassert_equal(data, &ringbuf_spsc.buf[8], NULL);
+}
+
+static void spsc_isr_put(const void *p)
+{
+	uint8_t data[5];
+
+	memset(data, POINTER_TO_UINT(p), sizeof(data));
+	zassert_equal(ring_buf_spsc_put(&ringbuf_spsc, data, sizeof(data)),
+		      sizeof(data), NULL);
+}
+
+/**
+ * @brief Test the single producer, single consumer ring buffer with an
+ * ISR as producer
+ *
+ * @see ring_buf_spsc_put(), ring_buf_spsc_get()
+ */
+void test_spsc_put_isr(void)
+{
+	uint8_t outdata[SPSC_SIZE];
+
+	ring_buf_spsc_init(&ringbuf_spsc, SPSC_SIZE, ringbuf_spsc.buf);
+
+	for (int i = 0; i < 10; i++) {
+		irq_offload(spsc_isr_put, UINT_TO_POINTER(i));
+		irq_offload(spsc_isr_put, UINT_TO_POINTER(i + 1));
+
+		zassert_equal(ring_buf_spsc_get(&ringbuf_spsc, outdata, 7), 7,
+			      NULL);
+		zassert_equal(outdata[4], i, NULL);
+		zassert_equal(outdata[5], i + 1, NULL);
+		zassert_equal(ring_buf_spsc_get(&ringbuf_spsc, outdata,
+						SPSC_SIZE), 3, NULL);
+	}
+}
+
+#define MPSC_SIZE32 32
+RING_BUF_MPSC_DECLARE(ringbuf_mpsc, MPSC_SIZE32);
+
+static void mpsc_put(uint32_t size, uint8_t val)
+{
+	void *data;
+
+	zassert_equal(ring_buf_mpsc_put_claim(&ringbuf_mpsc, &data, size), 0,
+		      NULL);
+	memset(data, val, size);
+	ring_buf_mpsc_put_commit(&ringbuf_mpsc, data);
+}
+
+static void mpsc_get(uint32_t size, uint8_t val)
+{
+	uint8_t *data;
+
+	zassert_equal(ring_buf_mpsc_get_claim(&ringbuf_mpsc, (void **)&data),
+		      size, NULL);
+	for (int i = 0; i < size; i++) {
+		zassert_equal(data[i], val, NULL);
+	}
+	ring_buf_mpsc_get_finish(&ringbuf_mpsc);
+}
+
+/**
+ * @brief Test records of the multiple producer, single consumer ring
+ * buffer, across the buffer end
+ *
+ * @see ring_buf_mpsc_put_claim(), ring_buf_mpsc_get_claim()
+ */
+void test_mpsc_put_get(void)
+{
+	void *data;
+
+	ring_buf_mpsc_init(&ringbuf_mpsc, MPSC_SIZE32, ringbuf_mpsc.buf);
+
+	zassert_equal(ring_buf_mpsc_get_claim(&ringbuf_mpsc, &data), -EAGAIN,
+		      NULL);
+
+	/* Records of 0 to 29 bytes, take 1 to 9 words. */
+	for (int i = 0; i < 30; i++) {
+		mpsc_put(i, i);
+		mpsc_put(29 - i, 29 - i);
+		mpsc_get(i, i);
+		mpsc_get(29 - i, 29 - i);
+		zassert_equal(ring_buf_mpsc_get_claim(&ringbuf_mpsc, &data),
+			      -EAGAIN, NULL);
+	}
+
+	/* Larger than half the buffer. */
+	zassert_equal(ring_buf_mpsc_put_claim(&ringbuf_mpsc, &data, 61),
+		      -EMSGSIZE, NULL);
+
+	/* Out of space, then room again once freed. */
+	ring_buf_mpsc_init(&ringbuf_mpsc, MPSC_SIZE32, ringbuf_mpsc.buf);
+	mpsc_put(36, 1);
+	mpsc_put(36, 2);
+	mpsc_put(36, 3);
+	zassert_equal(ring_buf_mpsc_put_claim(&ringbuf_mpsc, &data, 36),
+		      -ENOMEM, NULL);
+	mpsc_get(36, 1);
+	mpsc_put(36, 4);
+	mpsc_get(36, 2);
+	mpsc_get(36, 3);
+	mpsc_get(36, 4);
+}
+
+/**
+ * @brief Test that records of the multiple producer, single consumer ring
+ * buffer are passed in claim order
+ *
+ * @see ring_buf_mpsc_put_commit()
+ */
+void test_mpsc_commit_order(void)
+{
+	void *first, *second, *data;
+
+	ring_buf_mpsc_init(&ringbuf_mpsc, MPSC_SIZE32, ringbuf_mpsc.buf);
+
+	zassert_equal(ring_buf_mpsc_put_claim(&ringbuf_mpsc, &first, 4), 0,
+		      NULL);
+	zassert_equal(ring_buf_mpsc_put_claim(&ringbuf_mpsc, &second, 8), 0,
+		      NULL);
+
+	memset(second, 2, 8);
+	ring_buf_mpsc_put_commit(&ringbuf_mpsc, second);
+	zassert_equal(ring_buf_mpsc_get_claim(&ringbuf_mpsc, &data), -EAGAIN,
+		      NULL);
+
+	memset(first, 1, 4);
+	ring_buf_mpsc_put_commit(&ringbuf_mpsc, first);
+	mpsc_get(4, 1);
+	mpsc_get(8, 2);
+}
+
 #ifdef CONFIG_64BIT
 static uint64_t ringbuf_stored[RINGBUFFER_SIZE];
 #else
@@ -759,7 +982,12 @@ void test_main(void)
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_capacity),
-			 ztest_unit_test(test_reset)
+			 ztest_unit_test(test_reset),
+			 ztest_unit_test(test_spsc_put_get),
+			 ztest_unit_test(test_spsc_claim_finish),
+			 ztest_unit_test(test_spsc_put_isr),
+			 ztest_unit_test(test_mpsc_put_get),
+			 ztest_unit_test(test_mpsc_commit_order)
 			 );
 	ztest_run_test_suite(test_ringbuffer_api);
 }
@@ -9,10 +9,12 @@
 
 extern void test_posix_clock(void);
 extern void test_posix_mqueue(void);
+extern void test_posix_mqueue_names(void);
 extern void test_posix_normal_mutex(void);
 extern void test_posix_recursive_mutex(void);
 extern void test_posix_semaphore(void);
 extern void test_posix_rw_lock(void);
+extern void test_posix_rw_lock_writer_first(void);
 extern void test_posix_realtime(void);
 extern void test_posix_timer(void);
 extern void test_posix_pthread_execution(void);
@@ -47,9 +49,11 @@ void test_main(void)
 			ztest_unit_test(test_posix_normal_mutex),
 			ztest_unit_test(test_posix_recursive_mutex),
 			ztest_unit_test(test_posix_mqueue),
+			ztest_unit_test(test_posix_mqueue_names),
 			ztest_unit_test(test_posix_realtime),
 			ztest_unit_test(test_posix_timer),
 			ztest_unit_test(test_posix_rw_lock),
+			ztest_unit_test(test_posix_rw_lock_writer_first),
 			ztest_unit_test(test_nanosleep_NULL_NULL),
 			ztest_unit_test(test_nanosleep_NULL_notNULL),
 			ztest_unit_test(test_nanosleep_notNULL_NULL),
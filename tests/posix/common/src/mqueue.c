@@ -107,3 +107,59 @@ void test_posix_mqueue(void)
 		      "unable to close message queue descriptor.");
 	zassert_false(mq_unlink(queue), "Not able to unlink Queue");
 }
+
+void test_posix_mqueue_names(void)
+{
+	static const char * const names[] = { "mq_a", "mq_b", "mq_c" };
+	mqd_t mqd[ARRAY_SIZE(names)], other;
+	struct mq_attr attrs;
+	char data[MESSAGE_SIZE];
+	int i;
+
+	attrs.mq_msgsize = MESSAGE_SIZE;
+	attrs.mq_maxmsg = 1;
+
+	for (i = 0; i < ARRAY_SIZE(names); i++) {
+		mqd[i] = mq_open(names[i], O_RDWR | O_CREAT | O_EXCL, 0777,
+				 &attrs);
+		zassert_not_equal(mqd[i], (mqd_t)-1, "Unable to create %s",
+				  names[i]);
+		zassert_false(mq_send(mqd[i], names[i], strlen(names[i]) + 1,
+				      0), "Unable to send to %s", names[i]);
+	}
+
+	zassert_equal(mq_open(names[0], O_RDWR | O_CREAT | O_EXCL, 0777,
+			      &attrs), (mqd_t)-1, NULL);
+	zassert_equal(errno, EEXIST, NULL);
+	zassert_equal(mq_open("mq_d", O_RDWR), (mqd_t)-1, NULL);
+	zassert_equal(errno, ENOENT, NULL);
+
+	/* Each name opens its own queue */
+	for (i = ARRAY_SIZE(names) - 1; i >= 0; i--) {
+		other = mq_open(names[i], O_RDONLY);
+		zassert_not_equal(other, (mqd_t)-1, NULL);
+		zassert_equal(mq_receive(other, data, sizeof(data), NULL),
+			      MESSAGE_SIZE, NULL);
+		zassert_false(strcmp(data, names[i]), "Wrong queue for %s",
+			      names[i]);
+		zassert_false(mq_close(other), NULL);
+	}
+
+	/* An unlinked queue can still be used, but no longer be opened */
+	zassert_false(mq_unlink(names[1]), NULL);
+	zassert_equal(mq_open(names[1], O_RDWR), (mqd_t)-1, NULL);
+	zassert_equal(errno, ENOENT, NULL);
+	zassert_false(mq_send(mqd[1], data, MESSAGE_SIZE, 0), NULL);
+
+	other = mq_open(names[1], O_RDWR | O_CREAT | O_EXCL, 0777, &attrs);
+	zassert_not_equal(other, (mqd_t)-1, "Unable to create again");
+	zassert_false(mq_close(other), NULL);
+	zassert_false(mq_unlink(names[1]), NULL);
+
+	for (i = 0; i < ARRAY_SIZE(names); i++) {
+		zassert_false(mq_close(mqd[i]), NULL);
+		if (i != 1) {
+			zassert_false(mq_unlink(names[i]), NULL);
+		}
+	}
+}
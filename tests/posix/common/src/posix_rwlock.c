@@ -143,3 +143,50 @@ void test_posix_rw_lock(void)
 	zassert_false(pthread_rwlock_destroy(&rwlock),
 		      "Failed to destroy rwlock");
 }
+
+static void *writer_top(void *p1)
+{
+	zassert_false(pthread_rwlock_wrlock(&rwlock), "Failed to lock");
+	*(bool *)p1 = true;
+	zassert_false(pthread_rwlock_unlock(&rwlock), "Failed to unlock");
+	pthread_exit(NULL);
+	return NULL;
+}
+
+void test_posix_rw_lock_writer_first(void)
+{
+	pthread_attr_t attr;
+	pthread_t writer;
+	bool written = false;
+	void *status;
+
+	zassert_false(pthread_rwlock_init(&rwlock, NULL),
+		      "Failed to create rwlock");
+	zassert_false(pthread_rwlock_rdlock(&rwlock), "Failed to lock");
+	zassert_false(pthread_rwlock_tryrdlock(&rwlock), "Failed to lock");
+	zassert_equal(pthread_rwlock_trywrlock(&rwlock), EBUSY, NULL);
+
+	zassert_false(pthread_attr_init(&attr), NULL);
+	pthread_attr_setstack(&attr, &stack[0][0], STACKSZ);
+	zassert_false(pthread_create(&writer, &attr, writer_top, &written),
+		      "Unable to create thread");
+	zassert_false(pthread_attr_destroy(&attr), NULL);
+
+	/* New readers wait behind the waiting writer */
+	usleep(USEC_PER_MSEC);
+	zassert_false(written, "Writer got the lock with readers");
+	zassert_equal(pthread_rwlock_tryrdlock(&rwlock), EBUSY, NULL);
+
+	zassert_false(pthread_rwlock_unlock(&rwlock), "Failed to unlock");
+	zassert_false(written, "Writer got the lock with a reader");
+	zassert_false(pthread_rwlock_unlock(&rwlock), "Failed to unlock");
+	zassert_equal(pthread_rwlock_unlock(&rwlock), EPERM, NULL);
+
+	zassert_false(pthread_rwlock_rdlock(&rwlock), "Failed to lock");
+	zassert_true(written, "Writer did not get the lock first");
+	zassert_false(pthread_rwlock_unlock(&rwlock), "Failed to unlock");
+
+	zassert_false(pthread_join(writer, &status), "Failed to join");
+	zassert_false(pthread_rwlock_destroy(&rwlock),
+		      "Failed to destroy rwlock");
+}
@@ -81,10 +81,13 @@ void test_main(void)
 			 ztest_unit_test(test_file_write),
 			 ztest_unit_test(test_file_read),
 			 ztest_unit_test(test_file_truncate),
+			 ztest_unit_test(test_file_writev_readv),
+			 ztest_unit_test(test_file_async),
 			 ztest_unit_test(test_file_close),
 			 ztest_unit_test(test_file_sync),
 			 ztest_unit_test(test_file_rename),
 			 ztest_unit_test(test_file_stat),
+			 ztest_unit_test(test_file_stat_cache),
 			 ztest_unit_test(test_file_unlink),
 			 ztest_unit_test(test_unmount),
 			 ztest_unit_test_setup_teardown(test_mount_flags,
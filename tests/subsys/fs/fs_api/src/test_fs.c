@@ -22,6 +22,7 @@ static char *cur = buffer;
 static int file_length;
 static struct fs_mount_t *mp[FS_TYPE_EXTERNAL_BASE];
 static bool nospace;
+unsigned int temp_fs_stat_calls;
 
 static
 int temp_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
@@ -129,6 +130,17 @@ static ssize_t temp_write(struct fs_file_t *zfp, const void *ptr, size_t size)
 	return bw;
 }
 
+/* Copy the file content at offset, for tests to check where data landed */
+int temp_fs_file_data(off_t offset, void *buf, size_t len)
+{
+	if ((offset < 0) || (offset + len > file_length)) {
+		return -EINVAL;
+	}
+
+	memcpy(buf, buffer + offset, len);
+	return 0;
+}
+
 static int temp_seek(struct fs_file_t *zfp, off_t offset, int whence)
 {
 
@@ -278,6 +290,10 @@ static int temp_stat(struct fs_mount_t *mountp,
 		return -EINVAL;
 	}
 
+	temp_fs_stat_calls++;
+	entry->type = FS_DIR_ENTRY_FILE;
+	entry->name[0] = '\0';
+	entry->size = 0;
 	return 0;
 }
 
@@ -27,6 +27,8 @@
 #define TEST_FS_2 FS_LITTLEFS
 
 extern struct fs_file_system_t temp_fs;
+extern unsigned int temp_fs_stat_calls;
+int temp_fs_file_data(off_t offset, void *buf, size_t len);
 
 struct test_fs_data {
 	int reserve;
@@ -42,11 +44,14 @@ void test_lsdir(void);
 void test_file_open(void);
 void test_file_write(void);
 void test_file_read(void);
+void test_file_writev_readv(void);
+void test_file_async(void);
 void test_file_truncate(void);
 void test_file_close(void);
 void test_file_sync(void);
 void test_file_rename(void);
 void test_file_stat(void);
+void test_file_stat_cache(void);
 void test_file_unlink(void);
 void test_unmount(void);
 void test_mount_flags(void);
@@ -484,6 +484,135 @@ void test_file_read(void)
 	TC_PRINT("Data read matches data written\n");
 }
 
+/**
+ * @brief Write and read a file through multiple buffers
+ *
+ * @ingroup filesystem_api
+ */
+void test_file_writev_readv(void)
+{
+	ssize_t brw;
+	off_t off;
+	size_t sz = strlen(test_str);
+	size_t split = sz / 2;
+	char read_buff[2][40] = { 0 };
+	char file_data[40];
+	const struct fs_iovec wr_iov[] = {
+		{ .iov_base = (char *)test_str, .iov_len = split },
+		{ .iov_base = (char *)test_str + split, .iov_len = sz - split },
+	};
+	const struct fs_iovec rd_iov[] = {
+		{ .iov_base = read_buff[0], .iov_len = split },
+		{ .iov_base = read_buff[1], .iov_len = sz - split },
+	};
+
+	TC_PRINT("\nVectored write and read tests:\n");
+
+	brw = fs_writev(&filep, NULL, 1);
+	zassert_false(brw >= 0, "Write from a invalid vector");
+
+	/* read up to the end, where the data is written */
+	do {
+		brw = fs_read(&filep, file_data, sizeof(file_data));
+		zassert_true(brw >= 0, "Fail to read file");
+	} while (brw > 0);
+	off = fs_tell(&filep);
+	zassert_true(off >= 0, "Fail to tell file");
+
+	brw = fs_writev(&filep, wr_iov, ARRAY_SIZE(wr_iov));
+	zassert_equal(brw, sz, "Fail to write file");
+	zassert_equal(fs_tell(&filep), off + sz, "Wrong position after write");
+
+	zassert_equal(temp_fs_file_data(off, file_data, sz), 0,
+		      "Data not written at the file position");
+	zassert_mem_equal(file_data, test_str, sz,
+			  "Data written does not match the buffers");
+
+	brw = fs_readv(&filep, rd_iov, ARRAY_SIZE(rd_iov));
+	zassert_equal(brw, sz, "Fail to read file");
+
+	zassert_mem_equal(read_buff[0], test_str, split,
+			  "Data read does not match data written");
+	zassert_mem_equal(read_buff[1], test_str + split, sz - split,
+			  "Data read does not match data written");
+}
+
+#if defined(CONFIG_FILE_SYSTEM_ASYNC)
+static K_SEM_DEFINE(async_done, 0, 1);
+static ssize_t async_result;
+
+static void async_cb(struct fs_async_req *req, ssize_t result)
+{
+	async_result = result;
+	k_sem_give(&async_done);
+}
+
+/**
+ * @brief Write and read a file asynchronously
+ *
+ * @ingroup filesystem_api
+ */
+void test_file_async(void)
+{
+	int ret;
+	ssize_t brw;
+	off_t off;
+	size_t sz = strlen(test_str);
+	char read_buff[80] = { 0 };
+	const struct fs_iovec wr_iov = {
+		.iov_base = (char *)test_str, .iov_len = sz,
+	};
+	const struct fs_iovec rd_iov = {
+		.iov_base = read_buff, .iov_len = sz,
+	};
+	struct fs_async_req req = {
+		.zfp = &filep,
+		.op = FS_ASYNC_WRITEV,
+		.iov = &wr_iov,
+		.iovcnt = 1,
+		.cb = async_cb,
+	};
+
+	TC_PRINT("\nAsynchronous write and read tests:\n");
+
+	/* read up to the end, where the data is written */
+	do {
+		brw = fs_read(&filep, read_buff, sizeof(read_buff));
+		zassert_true(brw >= 0, "Fail to read file");
+	} while (brw > 0);
+	off = fs_tell(&filep);
+	zassert_true(off >= 0, "Fail to tell file");
+
+	fs_async_req_init(&req);
+	ret = fs_async_submit(&req);
+	zassert_equal(ret, 0, "Fail to submit write");
+	zassert_equal(k_sem_take(&async_done, K_SECONDS(1)), 0,
+		      "Write did not complete");
+	zassert_equal(async_result, sz, "Fail to write file");
+
+	zassert_equal(temp_fs_file_data(off, read_buff, sz), 0,
+		      "Data not written at the file position");
+	zassert_mem_equal(read_buff, test_str, sz,
+			  "Data written does not match the buffer");
+
+	memset(read_buff, 0, sizeof(read_buff));
+	req.op = FS_ASYNC_READV;
+	req.iov = &rd_iov;
+	ret = fs_async_submit(&req);
+	zassert_equal(ret, 0, "Fail to submit read");
+	zassert_equal(k_sem_take(&async_done, K_SECONDS(1)), 0,
+		      "Read did not complete");
+	zassert_equal(async_result, sz, "Fail to read file");
+	zassert_mem_equal(read_buff, test_str, sz,
+			  "Data read does not match data written");
+}
+#else
+void test_file_async(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
+
 static int _test_file_truncate(void)
 {
 	int ret;
@@ -690,6 +819,108 @@ void test_file_stat(void)
 	zassert_equal(ret, 0, "Fail to stat a file");
 }
 
+#if defined(CONFIG_FILE_SYSTEM_DENTRY_CACHE)
+FS_DCACHE_DEFINE(test_dcache, 2);
+#define TEST_CACHE_MNTP	"/CACHE:"
+
+/**
+ * @brief Stat repeatedly the same paths on a mount point with its own
+ *        two entry lookup cache
+ *
+ * @ingroup filesystem_api
+ */
+void test_file_stat_cache(void)
+{
+	struct fs_mount_t cache_mnt = {
+		.type = TEST_FS_2,
+		.mnt_point = TEST_CACHE_MNTP,
+		.dcache = &test_dcache,
+	};
+	struct fs_file_t file = { 0 };
+	struct fs_dirent entry;
+	int ret;
+
+	TC_PRINT("\nStat cache tests:\n");
+
+	ret = fs_register(TEST_FS_2, &temp_fs);
+	zassert_equal(ret, 0, "Fail to register file system");
+	ret = fs_mount(&cache_mnt);
+	zassert_equal(ret, 0, "Fail to mount file system");
+
+	temp_fs_stat_calls = 0;
+	ret = fs_stat(TEST_CACHE_MNTP"/a", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	ret = fs_stat(TEST_CACHE_MNTP"/a", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 1, "Stat not cached");
+
+	/* Third path evicts the least recently used one, "/b" */
+	ret = fs_stat(TEST_CACHE_MNTP"/b", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	ret = fs_stat(TEST_CACHE_MNTP"/a", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	ret = fs_stat(TEST_CACHE_MNTP"/c", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 3, "Unexpected stat calls");
+	ret = fs_stat(TEST_CACHE_MNTP"/a", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 3, "Recently used entry evicted");
+	ret = fs_stat(TEST_CACHE_MNTP"/b", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 4, "Cache larger than its size");
+
+	/* "/a" and "/b" are cached now */
+	ret = fs_rename(TEST_CACHE_MNTP"/a", TEST_CACHE_MNTP"/d");
+	zassert_equal(ret, 0, "Fail to rename a file");
+	ret = fs_stat(TEST_CACHE_MNTP"/a", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 5, "Stat not invalidated on rename");
+
+	/* "/a" and "/b" are cached, mkdir drops "/b" */
+	ret = fs_mkdir(TEST_CACHE_MNTP"/b");
+	zassert_equal(ret, 0, "Fail to create a dir");
+	ret = fs_stat(TEST_CACHE_MNTP"/a", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 5, "Unrelated entry invalidated");
+	ret = fs_stat(TEST_CACHE_MNTP"/b", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 6, "Stat not invalidated on mkdir");
+
+	/* The test file system reports files as empty */
+	ret = fs_open(&file, TEST_CACHE_MNTP"/e", FS_O_CREATE | FS_O_RDWR);
+	zassert_equal(ret, 0, "Fail to open a file");
+	ret = fs_stat(TEST_CACHE_MNTP"/e", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	ret = fs_truncate(&file, 0);
+	zassert_equal(ret, 0, "Fail to truncate a file");
+	ret = fs_stat(TEST_CACHE_MNTP"/e", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 7,
+		      "Stat invalidated without a size change");
+	ret = fs_truncate(&file, 1);
+	zassert_equal(ret, 0, "Fail to truncate a file");
+	ret = fs_close(&file);
+	zassert_equal(ret, 0, "Fail to close a file");
+	ret = fs_stat(TEST_CACHE_MNTP"/e", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 8,
+		      "Stat not invalidated on a size change");
+	ret = fs_stat(TEST_CACHE_MNTP"/b", &entry);
+	zassert_equal(ret, 0, "Fail to stat a file");
+	zassert_equal(temp_fs_stat_calls, 8, "Unrelated entry invalidated");
+
+	ret = fs_unmount(&cache_mnt);
+	zassert_equal(ret, 0, "Fail to unmount file system");
+	ret = fs_unregister(TEST_FS_2, &temp_fs);
+	zassert_equal(ret, 0, "Fail to unregister file system");
+}
+#else
+void test_file_stat_cache(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 /**
  * @brief Delete the specified file or directory
  *
@@ -156,6 +156,123 @@ out_mnt:
 	return rv;
 }
 
+#define RECORDS_PER_WRITEV 16
+
+/* Write nrec rec_size-byte records one fs_write() per record, then
+ * again batching RECORDS_PER_WRITEV records per fs_writev() call.
+ */
+static int small_records(const char *tag,
+			 struct fs_mount_t *mp,
+			 size_t rec_size,
+			 size_t nrec)
+{
+	struct fs_iovec iov[RECORDS_PER_WRITEV];
+	struct testfs_path path;
+	struct fs_file_t file;
+	size_t total = nrec * rec_size;
+	uint32_t t0;
+	uint32_t t1;
+	uint8_t *buf;
+	ssize_t rc;
+	int rv = TC_FAIL;
+
+	TC_PRINT("clearing %s for %s record test\n",
+		 mp->mnt_point, tag);
+	if (testfs_lfs_wipe_partition(mp) != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	rc = fs_mount(mp);
+	if (rc != 0) {
+		TC_PRINT("Mount %s failed: %zd\n", mp->mnt_point, rc);
+		return TC_FAIL;
+	}
+
+	buf = calloc(rec_size * RECORDS_PER_WRITEV, sizeof(uint8_t));
+	if (buf == NULL) {
+		TC_PRINT("Failed to allocate record buffer\n");
+		goto out_mnt;
+	}
+
+	for (size_t i = 0; i < RECORDS_PER_WRITEV; ++i) {
+		memset(buf + i * rec_size, i, rec_size);
+		iov[i].iov_base = buf + i * rec_size;
+		iov[i].iov_len = rec_size;
+	}
+
+	testfs_path_init(&path, mp,
+			 "write",
+			 TESTFS_PATH_END);
+
+	rc = fs_open(&file, path.path, FS_O_CREATE | FS_O_RDWR);
+	if (rc != 0) {
+		TC_PRINT("Failed to open %s for write: %zd\n", path.path, rc);
+		goto out_buf;
+	}
+
+	t0 = k_uptime_get_32();
+	for (size_t i = 0; i < nrec; ++i) {
+		rc = fs_write(&file, buf, rec_size);
+		if (rec_size != rc) {
+			TC_PRINT("Failed to write record %zu: %zd\n", i, rc);
+			goto out_file;
+		}
+	}
+	(void)fs_close(&file);
+	t1 = k_uptime_get_32();
+
+	if (t1 == t0) {
+		t1++;
+	}
+
+	TC_PRINT("%s fs_write %zu * %zu = %zu bytes in %u ms\n",
+		 tag, nrec, rec_size, total, (t1 - t0));
+
+	testfs_path_init(&path, mp,
+			 "writev",
+			 TESTFS_PATH_END);
+
+	rc = fs_open(&file, path.path, FS_O_CREATE | FS_O_RDWR);
+	if (rc != 0) {
+		TC_PRINT("Failed to open %s for write: %zd\n", path.path, rc);
+		goto out_buf;
+	}
+
+	t0 = k_uptime_get_32();
+	for (size_t i = 0; i < nrec; i += RECORDS_PER_WRITEV) {
+		int cnt = MIN(nrec - i, RECORDS_PER_WRITEV);
+
+		rc = fs_writev(&file, iov, cnt);
+		if (cnt * rec_size != rc) {
+			TC_PRINT("Failed to write record %zu: %zd\n", i, rc);
+			goto out_file;
+		}
+	}
+	(void)fs_close(&file);
+	t1 = k_uptime_get_32();
+
+	if (t1 == t0) {
+		t1++;
+	}
+
+	TC_PRINT("%s fs_writev %zu * %zu = %zu bytes in %u ms\n",
+		 tag, nrec, rec_size, total, (t1 - t0));
+
+	rv = TC_PASS;
+	goto out_buf;
+
+out_file:
+	(void)fs_close(&file);
+
+out_buf:
+	free(buf);
+
+out_mnt:
+	(void)fs_unmount(mp);
+
+	return rv;
+}
+
 static int custom_write_test(const char *tag,
 			     const struct fs_mount_t *mp,
 			     const struct lfs_config *cfgp,
@@ -235,6 +352,13 @@ void test_lfs_perf(void)
 	zassert_equal(small_8_1K_cust(), TC_PASS,
 		      "failed");
 
+	k_sleep(K_MSEC(100));   /* flush log messages */
+	zassert_equal(small_records("small 512x16 records",
+				    &testfs_small_mnt,
+				    16, 512),
+		      TC_PASS,
+		      "failed");
+
 	k_sleep(K_MSEC(100));   /* flush log messages */
 	zassert_equal(write_read("medium 32x2K dflt",
 				 &testfs_medium_mnt,
@@ -0,0 +1,277 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <fs/fs.h>
+#include <fs/logfs.h>
+#include <storage/flash_map.h>
+
+#define MNT_POINT "/log"
+#define FILE_A MNT_POINT "/a.log"
+#define FILE_B MNT_POINT "/b.log"
+
+/* Spans more than one sector of the storage partition */
+#define DATA_SIZE 6000
+#define CHUNK_SIZE 37
+
+static struct fs_logfs logfs;
+static struct fs_mount_t mnt = {
+	.type = FS_LOGFS,
+	.fs_data = &logfs,
+	.storage_dev = (void *)FLASH_AREA_ID(storage),
+	.mnt_point = MNT_POINT,
+};
+
+static uint8_t data[DATA_SIZE];
+static uint8_t buf[DATA_SIZE];
+
+static void write_chunks(struct fs_file_t *file, size_t from, size_t to)
+{
+	while (from < to) {
+		size_t n = MIN(CHUNK_SIZE, to - from);
+
+		zassert_equal(fs_write(file, &data[from], n), n,
+			      "write failed");
+		from += n;
+	}
+}
+
+static void check_file(const char *path, size_t size)
+{
+	struct fs_file_t file = { 0 };
+	struct fs_dirent entry;
+
+	zassert_equal(fs_stat(path, &entry), 0, "stat failed");
+	zassert_equal(entry.size, size, "unexpected size %zu", entry.size);
+
+	zassert_equal(fs_open(&file, path, FS_O_READ), 0, "open failed");
+	memset(buf, 0, sizeof(buf));
+	zassert_equal(fs_read(&file, buf, sizeof(buf)), size, "read failed");
+	zassert_mem_equal(buf, data, size, "data mismatch");
+	zassert_equal(fs_close(&file), 0, "close failed");
+}
+
+static void remount(void)
+{
+	zassert_equal(fs_unmount(&mnt), 0, "unmount failed");
+	zassert_equal(fs_mount(&mnt), 0, "mount failed");
+}
+
+void test_logfs_mount(void)
+{
+	const struct flash_area *fa;
+	struct fs_statvfs stat;
+
+	for (size_t i = 0; i < sizeof(data); i++) {
+		data[i] = i * 7 + (i >> 8);
+	}
+
+	zassert_equal(flash_area_open(FLASH_AREA_ID(storage), &fa), 0,
+		      "flash_area_open failed");
+	zassert_equal(flash_area_erase(fa, 0, fa->fa_size), 0,
+		      "erase failed");
+	flash_area_close(fa);
+
+	zassert_equal(fs_mount(&mnt), 0, "mount failed");
+	zassert_equal(fs_statvfs(MNT_POINT, &stat), 0, "statvfs failed");
+	zassert_equal(stat.f_bfree, stat.f_blocks, "partition not empty");
+}
+
+void test_logfs_append(void)
+{
+	struct fs_file_t file = { 0 };
+	struct fs_file_t file2 = { 0 };
+
+	zassert_equal(fs_open(&file, FILE_A, FS_O_READ), -ENOENT,
+		      "open of missing file succeeded");
+	zassert_equal(fs_open(&file, FILE_A, FS_O_CREATE | FS_O_WRITE), 0,
+		      "create failed");
+	zassert_equal(fs_open(&file2, FILE_A, FS_O_WRITE), -EBUSY,
+		      "second writer allowed");
+
+	write_chunks(&file, 0, DATA_SIZE / 2);
+	zassert_equal(fs_sync(&file), 0, "sync failed");
+	check_file(FILE_A, DATA_SIZE / 2);
+
+	write_chunks(&file, DATA_SIZE / 2, DATA_SIZE);
+	zassert_equal(fs_close(&file), 0, "close failed");
+	check_file(FILE_A, DATA_SIZE);
+
+	/* Appends continue after a remount */
+	remount();
+	check_file(FILE_A, DATA_SIZE);
+	zassert_equal(fs_open(&file, FILE_A, FS_O_WRITE), 0, "open failed");
+	zassert_equal(fs_truncate(&file, 100), 0, "truncate failed");
+	write_chunks(&file, 100, 300);
+	zassert_equal(fs_close(&file), 0, "close failed");
+
+	remount();
+	check_file(FILE_A, 300);
+}
+
+void test_logfs_truncate(void)
+{
+	struct fs_file_t file = { 0 };
+	struct fs_statvfs before;
+	struct fs_statvfs after;
+
+	zassert_equal(fs_open(&file, FILE_A, FS_O_WRITE), 0, "open failed");
+	write_chunks(&file, 300, DATA_SIZE);
+	zassert_equal(fs_statvfs(MNT_POINT, &before), 0, "statvfs failed");
+
+	zassert_equal(fs_truncate(&file, DATA_SIZE + 1), -ENOTSUP,
+		      "file extended");
+	zassert_equal(fs_truncate(&file, 10), 0, "truncate failed");
+	zassert_equal(fs_close(&file), 0, "close failed");
+	zassert_equal(fs_statvfs(MNT_POINT, &after), 0, "statvfs failed");
+	zassert_true(after.f_bfree > before.f_bfree, "sectors not released");
+	check_file(FILE_A, 10);
+
+	remount();
+	check_file(FILE_A, 10);
+}
+
+void test_logfs_mmap(void)
+{
+	struct fs_file_t file = { 0 };
+	const void *ptr;
+	size_t len;
+	int rc;
+
+	zassert_equal(fs_open(&file, FILE_B, FS_O_CREATE | FS_O_RDWR), 0,
+		      "create failed");
+	write_chunks(&file, 0, 1000);
+	zassert_equal(fs_seek(&file, 500, FS_SEEK_SET), 0, "seek failed");
+
+	rc = fs_logfs_mmap(&file, &ptr, &len);
+	if (rc == -ENOTSUP) {
+		fs_close(&file);
+		ztest_test_skip();
+	}
+	zassert_equal(rc, 0, "mmap failed");
+	zassert_equal(len, 500, "unexpected length %zu", len);
+	zassert_mem_equal(ptr, &data[500], len, "data mismatch");
+
+	zassert_equal(fs_seek(&file, 0, FS_SEEK_END), 0, "seek failed");
+	zassert_equal(fs_logfs_mmap(&file, &ptr, &len), 0, "mmap failed");
+	zassert_equal(len, 0, "data past the end");
+	zassert_equal(fs_close(&file), 0, "close failed");
+}
+
+void test_logfs_dir(void)
+{
+	struct fs_dir_t dir = { 0 };
+	struct fs_dirent entry;
+	int count = 0;
+
+	zassert_equal(fs_opendir(&dir, MNT_POINT), 0, "opendir failed");
+	while ((fs_readdir(&dir, &entry) == 0) && (entry.name[0] != '\0')) {
+		zassert_equal(entry.type, FS_DIR_ENTRY_FILE, "not a file");
+		count++;
+	}
+	zassert_equal(fs_closedir(&dir), 0, "closedir failed");
+	zassert_equal(count, 2, "unexpected file count %d", count);
+}
+
+void test_logfs_unlink(void)
+{
+	struct fs_statvfs stat;
+	struct fs_dirent entry;
+
+	zassert_equal(fs_unlink(FILE_A), 0, "unlink failed");
+	zassert_equal(fs_unlink(FILE_B), 0, "unlink failed");
+	zassert_equal(fs_stat(FILE_A, &entry), -ENOENT, "file not removed");
+
+	remount();
+	zassert_equal(fs_stat(FILE_B, &entry), -ENOENT, "file not removed");
+	zassert_equal(fs_statvfs(MNT_POINT, &stat), 0, "statvfs failed");
+	zassert_equal(stat.f_bfree, stat.f_blocks, "sectors not released");
+	zassert_equal(fs_unmount(&mnt), 0, "unmount failed");
+}
+
+void test_logfs_sync_many(void)
+{
+	struct fs_file_t file = { 0 };
+	struct fs_statvfs before;
+	struct fs_statvfs after;
+
+	zassert_equal(fs_mount(&mnt), 0, "mount failed");
+	zassert_equal(fs_statvfs(MNT_POINT, &before), 0, "statvfs failed");
+
+	/* Syncs are only bounded by the room left in the sector */
+	zassert_equal(fs_open(&file, FILE_A, FS_O_CREATE | FS_O_WRITE), 0,
+		      "create failed");
+	for (size_t i = 0; i < 100; i++) {
+		zassert_equal(fs_write(&file, &data[i * 3], 3), 3,
+			      "write failed");
+		zassert_equal(fs_sync(&file), 0, "sync %zu failed", i);
+	}
+	zassert_equal(fs_close(&file), 0, "close failed");
+
+	zassert_equal(fs_statvfs(MNT_POINT, &after), 0, "statvfs failed");
+	zassert_equal(after.f_bfree, before.f_bfree - 1,
+		      "syncs took more than one sector");
+
+	remount();
+	check_file(FILE_A, 300);
+
+	/* The sector can be shortened more than once */
+	zassert_equal(fs_open(&file, FILE_A, FS_O_WRITE), 0, "open failed");
+	zassert_equal(fs_truncate(&file, 250), 0, "truncate failed");
+	zassert_equal(fs_truncate(&file, 201), 0, "truncate failed");
+	zassert_equal(fs_close(&file), 0, "close failed");
+	check_file(FILE_A, 201);
+
+	remount();
+	check_file(FILE_A, 201);
+	zassert_equal(fs_unlink(FILE_A), 0, "unlink failed");
+}
+
+void test_logfs_reopen(void)
+{
+	struct fs_file_t file = { 0 };
+	struct fs_statvfs before;
+	struct fs_statvfs after;
+	size_t size = 0;
+
+	zassert_equal(fs_statvfs(MNT_POINT, &before), 0, "statvfs failed");
+
+	/* Partial write blocks left by close are completed on reopen */
+	for (size_t i = 0; i < 40; i++) {
+		zassert_equal(fs_open(&file, FILE_B,
+				      FS_O_CREATE | FS_O_WRITE | FS_O_APPEND),
+			      0, "open failed");
+		write_chunks(&file, size, size + 5);
+		size += 5;
+		zassert_equal(fs_close(&file), 0, "close failed");
+
+		if ((i % 8) == 7) {
+			remount();
+			check_file(FILE_B, size);
+		}
+	}
+
+	zassert_equal(fs_statvfs(MNT_POINT, &after), 0, "statvfs failed");
+	zassert_equal(after.f_bfree, before.f_bfree - 1,
+		      "reopens took more than one sector");
+
+	zassert_equal(fs_unlink(FILE_B), 0, "unlink failed");
+	zassert_equal(fs_unmount(&mnt), 0, "unmount failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(logfs_test,
+			 ztest_unit_test(test_logfs_mount),
+			 ztest_unit_test(test_logfs_append),
+			 ztest_unit_test(test_logfs_truncate),
+			 ztest_unit_test(test_logfs_mmap),
+			 ztest_unit_test(test_logfs_dir),
+			 ztest_unit_test(test_logfs_unlink),
+			 ztest_unit_test(test_logfs_sync_many),
+			 ztest_unit_test(test_logfs_reopen)
+			 );
+	ztest_run_test_suite(logfs_test);
+}
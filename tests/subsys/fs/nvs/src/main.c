@@ -43,6 +43,9 @@ void setup(void)
 	if (fs.sector_count != 0) {
 		int err;
 
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+		nvs_gc_flush(&fs);
+#endif
 		err = nvs_clear(&fs);
 		zassert_true(err == 0,  "nvs_clear call failure: %d", err);
 	}
@@ -318,6 +321,13 @@ void test_nvs_gc_3sectors(void)
 	/* 125th write will trigger 4st GC. */
 	const uint16_t max_writes_4 = 51 + 25 + 25 + 25;
 
+	if (IS_ENABLED(CONFIG_NVS_BACKGROUND_GC)) {
+		/* the oldest sector is collected ahead of time, see
+		 * test_nvs_background_gc
+		 */
+		ztest_test_skip();
+	}
+
 	fs.sector_count = 3;
 
 	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
@@ -714,6 +724,63 @@ void test_nvs_gc_corrupt_ate(void)
 	zassert_true(err == 0,  "nvs_init call failure: %d", err);
 }
 
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+/*
+ * Test that the background gc moves the entries of the oldest sector to the
+ * active sector and erases it once a write has started a new sector, without
+ * a foreground write having to do it.
+ */
+void test_nvs_background_gc(void)
+{
+	int err;
+	ssize_t len;
+	uint8_t buf[64];
+	uint16_t id, cnt;
+	uint32_t sector;
+	const uint16_t max_id = 4;
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	sector = fs.ate_wra >> ADDR_SECT_SHIFT;
+
+	/* overwrite a few ids until the first sector is full */
+	for (cnt = 0; (fs.ate_wra >> ADDR_SECT_SHIFT) == sector; cnt++) {
+		id = cnt % max_id;
+		memset(buf, cnt, sizeof(buf));
+		len = nvs_write(&fs, id, buf, sizeof(buf));
+		zassert_true(len == sizeof(buf), "nvs_write failed: %d", len);
+	}
+
+	/* wait for the background gc */
+	nvs_gc_flush(&fs);
+
+	zassert_equal(fs.free_sectors,
+		      MIN(CONFIG_NVS_BACKGROUND_GC_FREE_SECTORS,
+			  fs.sector_count - 1),
+		      "background gc did not erase the oldest sector");
+
+	for (id = 0; id < max_id; id++) {
+		uint8_t rd_buf[sizeof(buf)];
+
+		/* last value written to the id */
+		memset(buf, cnt - 1 - ((cnt - 1 - id) % max_id), sizeof(buf));
+		len = nvs_read(&fs, id, rd_buf, sizeof(rd_buf));
+		zassert_true(len == sizeof(rd_buf), "nvs_read failed: %d",
+			     len);
+		zassert_mem_equal(buf, rd_buf, sizeof(rd_buf),
+				  "RD buff should be equal to the WR buff");
+	}
+}
+#else
+void test_nvs_background_gc(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(test_nvs,
@@ -737,7 +804,9 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				 test_nvs_gc_corrupt_close_ate, setup, teardown),
 			 ztest_unit_test_setup_teardown(
-				 test_nvs_gc_corrupt_ate, setup, teardown)
+				 test_nvs_gc_corrupt_ate, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_background_gc, setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
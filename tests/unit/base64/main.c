@@ -130,10 +130,174 @@ static void test_base64_codec(void)
 	zassert_equal(rc, -ENOMEM, "Error: dst NULL: decode test return value");
 }
 
+/* Byte at a time encoder, to check the block encoder against */
+static size_t ref_encode(char *dst, const uint8_t *src, size_t slen)
+{
+	static const char map[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+				  "abcdefghijklmnopqrstuvwxyz0123456789+/";
+	size_t n = 0;
+
+	for (size_t i = 0; i < slen; i += 3) {
+		uint32_t x = src[i] << 16;
+
+		x |= (i + 1 < slen) ? src[i + 1] << 8 : 0;
+		x |= (i + 2 < slen) ? src[i + 2] : 0;
+
+		dst[n++] = map[x >> 18];
+		dst[n++] = map[(x >> 12) & 0x3F];
+		dst[n++] = (i + 1 < slen) ? map[(x >> 6) & 0x3F] : '=';
+		dst[n++] = (i + 2 < slen) ? map[x & 0x3F] : '=';
+	}
+
+	return n;
+}
+
+static uint8_t bulk_dec[200];
+static char bulk_enc[300];
+static uint8_t bulk_buf[300];
+
+static void fill_bulk(void)
+{
+	uint32_t seed = 12345U;
+
+	for (size_t i = 0; i < sizeof(bulk_dec); i++) {
+		seed = seed * 1103515245U + 12345U;
+		bulk_dec[i] = seed >> 16;
+	}
+}
+
+static void test_base64_bulk(void)
+{
+	size_t len, ref_len;
+	int rc;
+
+	fill_bulk();
+
+	for (size_t slen = 0; slen <= sizeof(bulk_dec); slen++) {
+		ref_len = ref_encode(bulk_enc, bulk_dec, slen);
+
+		rc = base64_encode(bulk_buf, sizeof(bulk_buf), &len, bulk_dec,
+				   slen);
+		zassert_equal(rc, 0, "encode %zu", slen);
+		zassert_equal(len, ref_len, "encode length %zu", slen);
+		zassert_equal(memcmp(bulk_buf, bulk_enc, len), 0,
+			      "encode %zu", slen);
+
+		rc = base64_decode(bulk_buf, sizeof(bulk_buf), &len,
+				   (const uint8_t *)bulk_enc, ref_len);
+		zassert_equal(rc, 0, "decode %zu", slen);
+		zassert_equal(len, slen, "decode length %zu", slen);
+		zassert_equal(memcmp(bulk_buf, bulk_dec, slen), 0,
+			      "decode %zu", slen);
+	}
+
+	/* A bad character in a run of plain ones is caught */
+	ref_len = ref_encode(bulk_enc, bulk_dec, 120);
+	for (size_t i = 0; i < ref_len - 2; i += 7) {
+		char c = bulk_enc[i];
+
+		bulk_enc[i] = '*';
+		rc = base64_decode(bulk_buf, sizeof(bulk_buf), &len,
+				   (const uint8_t *)bulk_enc, ref_len);
+		zassert_equal(rc, -EINVAL, "bad character at %zu", i);
+		bulk_enc[i] = c;
+	}
+}
+
+static void test_base64_stream(void)
+{
+	struct base64_stream stream;
+	size_t len, enc_len, total;
+	int rc;
+
+	fill_bulk();
+	enc_len = ref_encode(bulk_enc, bulk_dec, sizeof(bulk_dec) - 1);
+
+	for (size_t chunk = 1; chunk < 20; chunk++) {
+		base64_stream_init(&stream);
+		total = 0;
+		for (size_t i = 0; i < sizeof(bulk_dec) - 1; i += chunk) {
+			size_t n = MIN(chunk, sizeof(bulk_dec) - 1 - i);
+
+			rc = base64_encode_update(&stream, &bulk_buf[total],
+						  sizeof(bulk_buf) - total,
+						  &len, &bulk_dec[i], n);
+			zassert_equal(rc, 0, "encode chunk %zu", chunk);
+			total += len;
+		}
+		rc = base64_encode_finish(&stream, &bulk_buf[total],
+					  sizeof(bulk_buf) - total, &len);
+		zassert_equal(rc, 0, "encode finish %zu", chunk);
+		total += len;
+		zassert_equal(total, enc_len, "encode length %zu", chunk);
+		zassert_equal(memcmp(bulk_buf, bulk_enc, total), 0,
+			      "encode chunk %zu", chunk);
+
+		base64_stream_init(&stream);
+		total = 0;
+		for (size_t i = 0; i < enc_len; i += chunk) {
+			rc = base64_decode_update(&stream, &bulk_buf[total],
+						  sizeof(bulk_buf) - total,
+						  &len,
+						  (const uint8_t *)&bulk_enc[i],
+						  MIN(chunk, enc_len - i));
+			zassert_equal(rc, 0, "decode chunk %zu", chunk);
+			total += len;
+		}
+		zassert_equal(base64_decode_finish(&stream), 0, NULL);
+		zassert_equal(total, sizeof(bulk_dec) - 1,
+			      "decode length %zu", chunk);
+		zassert_equal(memcmp(bulk_buf, bulk_dec, total), 0,
+			      "decode chunk %zu", chunk);
+	}
+
+	/* Too small a buffer, the chunk is not consumed */
+	base64_stream_init(&stream);
+	rc = base64_encode_update(&stream, bulk_buf, 7, &len, bulk_dec, 6);
+	zassert_equal(rc, -ENOMEM, NULL);
+	zassert_equal(len, 8, NULL);
+	rc = base64_encode_update(&stream, bulk_buf, 8, &len, bulk_dec, 7);
+	zassert_equal(rc, 0, NULL);
+	zassert_equal(len, 8, NULL);
+	rc = base64_encode_finish(&stream, bulk_buf, 3, &len);
+	zassert_equal(rc, -ENOMEM, NULL);
+
+	/* Line breaks are skipped, anything after padding is invalid */
+	base64_stream_init(&stream);
+	rc = base64_decode_update(&stream, bulk_buf, sizeof(bulk_buf), &len,
+				  (const uint8_t *)"QU\r\nI=", 6);
+	zassert_equal(rc, 0, NULL);
+	zassert_equal(len, 2, NULL);
+	zassert_equal(memcmp(bulk_buf, "AB", 2), 0, NULL);
+	rc = base64_decode_update(&stream, bulk_buf, sizeof(bulk_buf), &len,
+				  (const uint8_t *)"QUJD", 4);
+	zassert_equal(rc, -EINVAL, NULL);
+
+	base64_stream_init(&stream);
+	rc = base64_decode_update(&stream, bulk_buf, sizeof(bulk_buf), &len,
+				  (const uint8_t *)"Q===", 4);
+	zassert_equal(rc, -EINVAL, NULL);
+
+	base64_stream_init(&stream);
+	rc = base64_decode_update(&stream, bulk_buf, sizeof(bulk_buf), &len,
+				  (const uint8_t *)"QQ=A", 4);
+	zassert_equal(rc, -EINVAL, NULL);
+
+	/* Truncated */
+	base64_stream_init(&stream);
+	rc = base64_decode_update(&stream, bulk_buf, sizeof(bulk_buf), &len,
+				  (const uint8_t *)"QUJDR", 5);
+	zassert_equal(rc, 0, NULL);
+	zassert_equal(len, 3, NULL);
+	zassert_equal(base64_decode_finish(&stream), -EINVAL, NULL);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_base64_test,
-			 ztest_unit_test(test_base64_codec));
+			 ztest_unit_test(test_base64_codec),
+			 ztest_unit_test(test_base64_bulk),
+			 ztest_unit_test(test_base64_stream));
 
 	ztest_run_test_suite(lib_base64_test);
 }
@@ -23,6 +23,44 @@ void test_crc32_ieee(void)
 	zassert_equal(crc32_ieee(test3, sizeof(test3)), 0x20089AA4, NULL);
 }
 
+static uint32_t crc32_ieee_bitwise(const uint8_t *data, size_t len)
+{
+	uint32_t crc = ~0U;
+
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (uint8_t j = 0; j < 8; j++) {
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+		}
+	}
+
+	return ~crc;
+}
+
+void test_crc32_ieee_update(void)
+{
+	uint8_t data[259];
+	uint32_t crc;
+
+	for (size_t i = 0; i < sizeof(data); i++) {
+		data[i] = i * 29 + 7;
+	}
+
+	/* Any start alignment and split of the data gives the same CRC */
+	for (size_t start = 0; start < 3; start++) {
+		size_t len = sizeof(data) - start;
+
+		for (size_t split = 0; split <= len; split += 13) {
+			crc = crc32_ieee(&data[start], split);
+			crc = crc32_ieee_update(crc, &data[start + split],
+						len - split);
+			zassert_equal(crc,
+				      crc32_ieee_bitwise(&data[start], len),
+				      "start %zu split %zu", start, split);
+		}
+	}
+}
+
 void test_crc16(void)
 {
 	uint8_t test0[] = { };
@@ -206,6 +244,7 @@ void test_main(void)
 {
 	ztest_test_suite(test_crc,
 			 ztest_unit_test(test_crc32_ieee),
+			 ztest_unit_test(test_crc32_ieee_update),
 			 ztest_unit_test(test_crc16),
 			 ztest_unit_test(test_crc16_ansi),
 			 ztest_unit_test(test_crc16_ccitt),
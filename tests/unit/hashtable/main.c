@@ -0,0 +1,256 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <stdlib.h>
+#include <sys/hashtable.h>
+
+#include "../../../lib/os/hashtable.c"
+
+#define MAX_NODES 512
+
+struct item {
+	struct sys_hashnode node;
+	uint32_t key;
+	bool inserted;
+};
+
+static struct item items[MAX_NODES];
+static struct sys_hashtable_slot slots[64];
+static struct sys_hashtable ht;
+
+/* Heap allocations are served by the host, and can be made to fail */
+static struct sys_heap heap;
+static bool heap_fail;
+static int heap_blocks;
+
+void *sys_heap_alloc(struct sys_heap *h, size_t bytes)
+{
+	if (heap_fail) {
+		return NULL;
+	}
+
+	heap_blocks++;
+	return malloc(bytes);
+}
+
+void sys_heap_free(struct sys_heap *h, void *mem)
+{
+	heap_blocks--;
+	free(mem);
+}
+
+static bool item_eq(const struct sys_hashnode *node, const void *key)
+{
+	return CONTAINER_OF(node, struct item, node)->key ==
+	       *(const uint32_t *)key;
+}
+
+/* Hash function with few distinct values, to get long probe sequences */
+static uint32_t (*hash_fn)(uint32_t key);
+
+static uint32_t bad_hash(uint32_t key)
+{
+	return key % 5U;
+}
+
+static struct item *find_key(uint32_t key)
+{
+	struct sys_hashnode *node = sys_hashtable_find(&ht, hash_fn(key),
+						       &key);
+
+	return node ? CONTAINER_OF(node, struct item, node) : NULL;
+}
+
+static void insert_item(int i)
+{
+	zassert_equal(sys_hashtable_insert(&ht, &items[i].node,
+					   hash_fn(items[i].key)), 0,
+		      "insert %d failed", i);
+	items[i].inserted = true;
+}
+
+static void remove_item(int i)
+{
+	struct sys_hashnode *node = sys_hashtable_remove(&ht,
+							 hash_fn(items[i].key),
+							 &items[i].key);
+
+	zassert_equal_ptr(node, &items[i].node, "remove %d failed", i);
+	items[i].inserted = false;
+}
+
+/* Check that every node is found, and the Robin Hood ordering holds */
+static void check_table(int n)
+{
+	uint32_t count = 0U;
+	struct sys_hashnode *node;
+	uint32_t i;
+
+	for (i = 0U; i < n; i++) {
+		zassert_equal_ptr(find_key(items[i].key),
+				  items[i].inserted ? &items[i] : NULL,
+				  "lookup of %u", i);
+	}
+
+	SYS_HASHTABLE_FOR_EACH_NODE(&ht, i, node) {
+		uint32_t next = (i + 1U) & (ht.capacity - 1U);
+
+		zassert_true(CONTAINER_OF(node, struct item, node)->inserted,
+			     "stale node");
+		zassert_equal(node->hash, ht.slots[i].hash, "hash mismatch");
+		if (ht.slots[next].node != NULL) {
+			zassert_true(probe_dist(&ht, next,
+						ht.slots[next].hash) <=
+				     probe_dist(&ht, i, node->hash) + 1U,
+				     "probe order broken at %u", i);
+		}
+		count++;
+	}
+
+	zassert_equal(count, sys_hashtable_count(&ht), "count mismatch");
+
+	/* An else after the loop belongs to the enclosing if */
+	count = 0U;
+	if (sys_hashtable_count(&ht) == 0U)
+		SYS_HASHTABLE_FOR_EACH_NODE(&ht, i, node)
+			count++;
+	else
+		count = sys_hashtable_count(&ht);
+
+	zassert_equal(count, sys_hashtable_count(&ht), "else misplaced");
+}
+
+static void setup(uint32_t (*fn)(uint32_t))
+{
+	hash_fn = fn;
+	for (int i = 0; i < MAX_NODES; i++) {
+		items[i].key = i * 7919U;
+		items[i].inserted = false;
+	}
+}
+
+void test_hashtable_fixed(void)
+{
+	uint32_t key = 1U;
+
+	setup(sys_hash32_u32);
+	sys_hashtable_init(&ht, slots, ARRAY_SIZE(slots), item_eq);
+
+	zassert_is_null(find_key(key), NULL);
+	zassert_is_null(sys_hashtable_remove(&ht, hash_fn(key), &key), NULL);
+
+	for (int i = 0; i < 56; i++) {
+		insert_item(i);
+	}
+	check_table(64);
+
+	/* 7/8 full */
+	zassert_equal(sys_hashtable_insert(&ht, &items[56].node,
+					   hash_fn(items[56].key)), -ENOMEM,
+		      NULL);
+
+	for (int i = 0; i < 56; i += 3) {
+		remove_item(i);
+	}
+	check_table(64);
+
+	zassert_true(sys_hashtable_remove_node(&ht, &items[1].node), NULL);
+	items[1].inserted = false;
+	zassert_false(sys_hashtable_remove_node(&ht, &items[1].node), NULL);
+	check_table(64);
+}
+
+void test_hashtable_collisions(void)
+{
+	setup(bad_hash);
+	sys_hashtable_init(&ht, slots, ARRAY_SIZE(slots), item_eq);
+
+	for (int i = 0; i < 50; i++) {
+		insert_item(i);
+	}
+	check_table(64);
+
+	/* Remove and re-insert in a different order, to move entries */
+	for (int round = 0; round < 200; round++) {
+		int i = (round * 37) % 50;
+
+		if (items[i].inserted) {
+			remove_item(i);
+		} else {
+			insert_item(i);
+		}
+		check_table(64);
+	}
+
+	/* Nodes with the same key are found in insertion order */
+	items[60].key = items[61].key = 12345U;
+	insert_item(60);
+	insert_item(61);
+	zassert_equal_ptr(find_key(12345U), &items[60], NULL);
+	remove_item(60);
+	zassert_equal_ptr(find_key(12345U), &items[61], NULL);
+	remove_item(61);
+	zassert_is_null(find_key(12345U), NULL);
+}
+
+void test_hashtable_heap(void)
+{
+	setup(sys_hash32_u32);
+	sys_hashtable_init_heap(&ht, &heap, item_eq);
+
+	zassert_is_null(find_key(0U), NULL);
+
+	for (int i = 0; i < 448; i++) {
+		insert_item(i);
+	}
+	zassert_equal(ht.capacity, 512U, NULL);
+	zassert_equal(heap_blocks, 1, NULL);
+
+	/* Growing fails, the table is left as it was */
+	heap_fail = true;
+	zassert_equal(sys_hashtable_insert(&ht, &items[448].node,
+					   hash_fn(items[448].key)), -ENOMEM,
+		      NULL);
+	heap_fail = false;
+	check_table(MAX_NODES);
+
+	for (int i = 448; i < MAX_NODES; i++) {
+		insert_item(i);
+	}
+	zassert_equal(ht.capacity, 1024U, NULL);
+	zassert_equal(heap_blocks, 1, NULL);
+	check_table(MAX_NODES);
+
+	for (int i = 0; i < MAX_NODES; i += 2) {
+		remove_item(i);
+	}
+	check_table(MAX_NODES);
+
+	sys_hashtable_free(&ht);
+	zassert_equal(heap_blocks, 0, NULL);
+	zassert_equal(sys_hashtable_count(&ht), 0U, NULL);
+}
+
+void test_hash_functions(void)
+{
+	/* FNV-1a test vectors */
+	zassert_equal(sys_hash32("", 0), 0x811c9dc5U, NULL);
+	zassert_equal(sys_hash32("a", 1), 0xe40c292cU, NULL);
+	zassert_equal(sys_hash32("foobar", 6), 0xbf9cf968U, NULL);
+
+	zassert_equal(sys_hash32_u32(0U), 0U, NULL);
+	zassert_not_equal(sys_hash32_u32(1U) & 0xffU,
+			  sys_hash32_u32(2U) & 0xffU, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_hashtable,
+			 ztest_unit_test(test_hashtable_fixed),
+			 ztest_unit_test(test_hashtable_collisions),
+			 ztest_unit_test(test_hashtable_heap),
+			 ztest_unit_test(test_hash_functions)
+			 );
+	ztest_run_test_suite(test_hashtable);
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <sys/util.h>
+
+#include "../../../lib/os/hex.c"
+
+/**
+ * @brief Test of bin2hex and hex2bin
+ *
+ * This test verifies conversion of buffers of all lengths, across the
+ * word at a time paths, and detection of invalid characters.
+ *
+ */
+static void test_hex_roundtrip(void)
+{
+	static const char digits[] = "0123456789abcdef";
+	uint8_t bin[19], out[19];
+	char hex[2 * sizeof(bin) + 1];
+	size_t len;
+
+	for (size_t i = 0; i < sizeof(bin); i++) {
+		bin[i] = i * 0x1d + 0x0f;
+	}
+
+	for (size_t n = 0; n <= sizeof(bin); n++) {
+		len = bin2hex(bin, n, hex, sizeof(hex));
+		zassert_equal(len, 2 * n, NULL);
+		zassert_equal(hex[len], '\0', NULL);
+		for (size_t i = 0; i < n; i++) {
+			zassert_equal(hex[2 * i], digits[bin[i] >> 4], NULL);
+			zassert_equal(hex[2 * i + 1], digits[bin[i] & 0xf],
+				      NULL);
+		}
+
+		len = hex2bin(hex, 2 * n, out, sizeof(out));
+		zassert_equal(len, n, NULL);
+		zassert_equal(memcmp(bin, out, n), 0, NULL);
+	}
+
+	/* Upper case, and every invalid character at every position */
+	for (size_t i = 0; i < 2 * sizeof(bin); i++) {
+		if (hex[i] >= 'a') {
+			hex[i] -= 'a' - 'A';
+		}
+	}
+	zassert_equal(hex2bin(hex, 2 * sizeof(bin), out, sizeof(out)),
+		      sizeof(bin), NULL);
+	zassert_equal(memcmp(bin, out, sizeof(bin)), 0, NULL);
+
+	for (size_t i = 0; i < 2 * sizeof(bin); i += 3) {
+		static const char bad[] = "/:@G`g \x80";
+		char c = hex[i];
+
+		for (size_t j = 0; j < sizeof(bad) - 1; j++) {
+			hex[i] = bad[j];
+			zassert_equal(hex2bin(hex, 2 * sizeof(bin), out,
+					      sizeof(out)), 0,
+				      "'%c' at %u", bad[j], (unsigned int)i);
+		}
+		hex[i] = c;
+	}
+
+	/* Odd length has a leading zero nibble */
+	zassert_equal(hex2bin("abc", 3, out, sizeof(out)), 2, NULL);
+	zassert_equal(out[0], 0x0a, NULL);
+	zassert_equal(out[1], 0xbc, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_hex,
+			 ztest_unit_test(test_hex_roundtrip)
+			 );
+
+	ztest_run_test_suite(test_hex);
+}